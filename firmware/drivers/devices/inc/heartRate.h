@@ -57,6 +57,38 @@
 #include <stdint.h>
 #include "stdbool.h"
 
+#define BEAT_FIR_TAPS 23 //Symmetric low pass FIR: 11 pairs of taps and the center one
+#define BEAT_BUFFER_SIZE 32 //Power of two, at least BEAT_FIR_TAPS
+
+//  Beat detector variables, processed sample by sample
+typedef struct
+{
+  int64_t irAvgReg; //DC estimator register (15 fractional bits)
+  uint8_t offset; //Position of the next sample in the first half of cbuf
+  int16_t acMax; //AC max and min of the last cycle
+  int16_t acMin;
+  int16_t acSignalCurrent; //Filtered AC signal
+  int16_t acSignalMin; //AC max and min of the current cycle
+  int16_t acSignalMax;
+  bool positiveEdge;
+  bool negativeEdge;
+} beat_state_t;
+
+//  Beat detector of one sensor. Declare one per sensor and initialize it with
+//  beatDetectorInit().
+typedef struct
+{
+  beat_state_t state;
+  int16_t cbuf[2 * BEAT_BUFFER_SIZE]; //FIR delay line, each sample written twice: the last BEAT_FIR_TAPS are contiguous
+} beat_detector_t;
+
+void beatDetectorInit(beat_detector_t *detector);
+//  Takes an IR sample, returns true if a beat is detected
+bool beatDetectorCheck(beat_detector_t *detector, int32_t sample);
+//  Takes a block of IR samples (e.g. every sample read by MAX3010X_check), returns the
+//  number of beats detected and, if beats is not NULL, the position of each one in the block
+uint16_t beatDetectorCheckBlock(beat_detector_t *detector, const uint32_t *samples, uint16_t length, uint16_t *beats);
+
 bool checkForBeat(int32_t sample);
 int16_t averageDCEstimator(int32_t *p, uint16_t x);
 int16_t lowPassFIRFilter(int16_t din);
@@ -13,6 +13,7 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include "gpio_mcu.h"
 
 #define MAX30105_ADDRESS          0x57 //7-bit I2C Address
 //Note that MAX30102 has the same I2C address and Part ID
@@ -98,6 +99,25 @@
   uint32_t MAX3010X_getFIFOIR(void); //Returns the FIFO sample pointed to by tail
   uint32_t MAX3010X_getFIFOGreen(void); //Returns the FIFO sample pointed to by tail
 
+  //Interrupt driven acquisition
+  //An acquisition task sleeps until the FIFO almost full interrupt (INT pin), then
+  //drains the FIFO in large I2C bursts into a ring buffer of timestamped samples.
+  //While it runs the polling functions above must not be used.
+  #define MAX3010X_RING_SIZE 128 //Samples of the acquisition ring buffer (power of two)
+  typedef struct
+  {
+    int64_t timestamp; //Acquisition time (us, esp_timer_get_time() time base)
+    uint32_t red;
+    uint32_t IR;
+    uint32_t green;
+  } max3010x_sample_t;
+
+  bool MAX3010X_startAcquisition(gpio_t intPin, uint8_t samples); //After MAX3010X_setup. Interrupt every samples (17 to 32) samples
+  void MAX3010X_stopAcquisition(void);
+  uint16_t MAX3010X_samplesAvailable(void); //Samples in the ring buffer
+  uint16_t MAX3010X_readSamples(max3010x_sample_t *samples, uint16_t maxSamples, uint32_t timeoutMs); //Blocks until there are new samples or timeoutMs expires. Returns number of samples copied
+  uint32_t MAX3010X_getLostSamples(void); //Samples lost by a full sensor FIFO or ring buffer
+
   uint8_t MAX3010X_getWritePointer(void);
   uint8_t MAX3010X_getReadPointer(void);
   void MAX3010X_clearFIFO(void); //Sets the read/write pointers to zero
@@ -80,9 +80,6 @@
 
 //uch_spo2_table is approximated as  -45.060*ratioAverage* ratioAverage + 30.354 *ratioAverage + 94.845 ;
 
-static  int32_t an_x[ BUFFER_SIZE]; //ir
-static  int32_t an_y[ BUFFER_SIZE]; //red
-
 
 void maxim_heart_rate_and_oxygen_saturation(uint32_t *pun_ir_buffer, int32_t n_ir_buffer_length, uint32_t *pun_red_buffer, int32_t *pn_spo2, int8_t *pch_spo2_valid, int32_t *pn_heart_rate, int8_t *pch_hr_valid);
 
@@ -93,5 +90,57 @@ void maxim_remove_close_peaks(int32_t *pn_locs, int32_t *pn_npks, int32_t *pn_x,
 void maxim_sort_ascend(int32_t  *pn_x, int32_t n_size);
 void maxim_sort_indices_descend(int32_t  *pn_x, int32_t *pn_indx, int32_t n_size);
 
+/* Streaming engine: same method as maxim_heart_rate_and_oxygen_saturation(), one
+ * sample at a time. DC mean, moving average and threshold are running sums over the
+ * last STREAM_WINDOW_S seconds, valleys are detected as the samples arrive and the
+ * SpO2 ratio of each beat goes to a sliding median of the last STREAM_MAX_RATIOS beats.
+ * Each sample costs a constant amount of work, plus the search of the AC maximum of
+ * a beat when its valley is found (each sample is visited once). */
+#ifndef MAXIM_STREAM_MAX_FREQ
+#define MAXIM_STREAM_MAX_FREQ 100   //maximum sampling frequency of the streaming engine
+#endif
+#define STREAM_WINDOW_S 4           //seconds of signal used for DC, threshold, HR and SpO2 (as BUFFER_SIZE)
+#define STREAM_BUFFER_SIZE (MAXIM_STREAM_MAX_FREQ * STREAM_WINDOW_S)
+#define STREAM_MAX_VALLEYS 15
+#define STREAM_MAX_RATIOS 5
+
+typedef struct {
+  int32_t n_freq;                           //sampling frequency
+  int32_t n_window;                         //samples of the window
+  int32_t n_min_distance;                   //minimum distance between valleys
+  int32_t n_min_beat;                       //minimum samples of a beat used for SpO2
+  uint32_t un_window_mul;                   //multiplier and shift that divide by n_window (full window)
+  int32_t n_window_shift;
+  uint32_t un_count;                        //samples received
+  int32_t n_pos;                            //position of the next sample in the rings of the window
+  uint32_t aun_ir[STREAM_BUFFER_SIZE];      //raw IR of the window (ring)
+  uint32_t aun_red[STREAM_BUFFER_SIZE];     //raw red of the window (ring)
+  int32_t an_ma[STREAM_BUFFER_SIZE];        //inverted, DC removed, 4 pt averaged IR of the window (ring)
+  uint32_t un_ir_sum;                       //sum of aun_ir
+  int32_t n_ma_sum;                         //sum of an_ma
+  int32_t an_x[MA4_SIZE];                   //last inverted, DC removed IR samples (ring)
+  int32_t n_x_sum;                          //sum of an_x
+  bool b_cand;                              //a valley candidate is rising
+  uint32_t un_cand_loc;
+  int32_t n_cand_val;
+  bool b_pend;                              //a valley waits for n_min_distance samples
+  uint32_t un_pend_loc;
+  int32_t n_pend_val;
+  uint32_t aun_valley_locs[STREAM_MAX_VALLEYS]; //valleys of the window, oldest first
+  int32_t n_valleys;
+  uint32_t un_beats;                        //valleys found
+  int32_t an_ratio[STREAM_MAX_RATIOS];      //ratios of the last beats, oldest first
+  uint32_t aun_ratio_locs[STREAM_MAX_RATIOS];
+  int32_t n_ratios;
+  int32_t n_spo2;                           //last published values, as maxim_heart_rate_and_oxygen_saturation()
+  int8_t ch_spo2_valid;
+  int32_t n_heart_rate;
+  int8_t ch_hr_valid;
+} maxim_spo2_stream_t;
+
+void maxim_spo2_stream_init(maxim_spo2_stream_t *ps_stream, int32_t n_sample_freq);
+bool maxim_spo2_stream_add_sample(maxim_spo2_stream_t *ps_stream, uint32_t un_ir, uint32_t un_red);
+void maxim_spo2_stream_get(maxim_spo2_stream_t *ps_stream, int32_t *pn_spo2, int8_t *pch_spo2_valid, int32_t *pn_heart_rate, int8_t *pch_hr_valid);
+
 
 #endif /* MODULES_INC_SPO2_ALGORITHM_H_ */
@@ -51,57 +51,64 @@
 *
 */
 
+#include <string.h>
 #include "heartRate.h"
 
-int16_t IR_AC_Max = 20;
-int16_t IR_AC_Min = -20;
+static const uint16_t FIRCoeffs[12] = {172, 321, 579, 927, 1360, 1858, 2390, 2916, 3391, 3768, 4012, 4096};
 
-int16_t IR_AC_Signal_Current = 0;
-int16_t IR_AC_Signal_Previous;
-int16_t IR_AC_Signal_min = 0;
-int16_t IR_AC_Signal_max = 0;
-int16_t IR_Average_Estimated;
+//  Detector used by checkForBeat() and lowPassFIRFilter()
+static beat_detector_t defaultDetector = {.state = {.acMax = 20, .acMin = -20}};
 
-int16_t positiveEdge = 0;
-int16_t negativeEdge = 0;
-int32_t ir_avg_reg = 0;
+//  Adds a sample to the delay line and returns the low pass filtered value.
+//  The delay line is written twice (offset and offset + BEAT_BUFFER_SIZE), so the
+//  last BEAT_FIR_TAPS samples are contiguous, and the symmetric taps are folded:
+//  12 multiplications per sample instead of 23.
+static inline int16_t firFilter(int16_t *cbuf, uint8_t offset, int16_t din)
+{
+  cbuf[offset] = din;
+  cbuf[offset + BEAT_BUFFER_SIZE] = din;
+  const int16_t *x = &cbuf[offset + BEAT_BUFFER_SIZE - (BEAT_FIR_TAPS - 1)]; //Oldest sample first
 
-int16_t cbuf[32];
-uint8_t offset = 0;
+  int32_t z = (int32_t)FIRCoeffs[11] * x[11];
+  for (uint8_t i = 0 ; i < 11 ; i++)
+  {
+    z += (int32_t)FIRCoeffs[i] * (x[i] + x[BEAT_FIR_TAPS - 1 - i]);
+  }
 
-static const uint16_t FIRCoeffs[12] = {172, 321, 579, 927, 1360, 1858, 2390, 2916, 3391, 3768, 4012, 4096};
+  //  DC gain of 1.45: saturate instead of wrapping around with big AC signals
+  z >>= 15;
+  if (z > INT16_MAX) z = INT16_MAX;
+  if (z < INT16_MIN) z = INT16_MIN;
+  return(z);
+}
 
-//  Heart Rate Monitor functions takes a sample value and the sample number
-//  Returns true if a beat is detected
-//  A running average of four samples is recommended for display on the screen.
-bool checkForBeat(int32_t sample)
+//  Processes one IR sample, returns true if a beat is detected
+static inline bool beatStep(beat_state_t *st, int16_t *cbuf, uint32_t sample)
 {
   bool beatDetected = false;
 
   //  Save current state
-  IR_AC_Signal_Previous = IR_AC_Signal_Current;
-
-  //This is good to view for debugging
-  //Serial.print("Signal_Current: ");
-  //Serial.println(IR_AC_Signal_Current);
+  int16_t acSignalPrevious = st->acSignalCurrent;
 
-  //  Process next data sample
-  IR_Average_Estimated = averageDCEstimator(&ir_avg_reg, sample);
-  IR_AC_Signal_Current = lowPassFIRFilter(sample - IR_Average_Estimated);
+  //  Process next data sample: average DC estimator (full 32 bit samples) and low pass filter
+  st->irAvgReg += ((((int64_t)sample << 15) - st->irAvgReg) >> 4);
+  int32_t ac = (int32_t)sample - (int32_t)(st->irAvgReg >> 15);
+  if (ac > INT16_MAX) ac = INT16_MAX;
+  if (ac < INT16_MIN) ac = INT16_MIN;
+  st->acSignalCurrent = firFilter(cbuf, st->offset, ac);
+  st->offset = (st->offset + 1) & (BEAT_BUFFER_SIZE - 1); //Wrap condition
 
   //  Detect positive zero crossing (rising edge)
-  if ((IR_AC_Signal_Previous < 0) & (IR_AC_Signal_Current >= 0))
+  if ((acSignalPrevious < 0) && (st->acSignalCurrent >= 0))
   {
+    st->acMax = st->acSignalMax; //Adjust our AC max and min
+    st->acMin = st->acSignalMin;
 
-    IR_AC_Max = IR_AC_Signal_max; //Adjust our AC max and min
-    IR_AC_Min = IR_AC_Signal_min;
-
-    positiveEdge = 1;
-    negativeEdge = 0;
-    IR_AC_Signal_max = 0;
+    st->positiveEdge = true;
+    st->negativeEdge = false;
+    st->acSignalMax = 0;
 
-    //if ((IR_AC_Max - IR_AC_Min) > 100 & (IR_AC_Max - IR_AC_Min) < 1000)
-    if (((IR_AC_Max - IR_AC_Min) > 20) & ((IR_AC_Max - IR_AC_Min) < 1000))
+    if (((st->acMax - st->acMin) > 20) && ((st->acMax - st->acMin) < 1000))
     {
       //Heart beat!!!
       beatDetected = true;
@@ -109,51 +116,81 @@ bool checkForBeat(int32_t sample)
   }
 
   //  Detect negative zero crossing (falling edge)
-  if ((IR_AC_Signal_Previous > 0) & (IR_AC_Signal_Current <= 0))
+  if ((acSignalPrevious > 0) && (st->acSignalCurrent <= 0))
   {
-    positiveEdge = 0;
-    negativeEdge = 1;
-    IR_AC_Signal_min = 0;
+    st->positiveEdge = false;
+    st->negativeEdge = true;
+    st->acSignalMin = 0;
   }
 
   //  Find Maximum value in positive cycle
-  if (positiveEdge & (IR_AC_Signal_Current > IR_AC_Signal_Previous))
+  if (st->positiveEdge && (st->acSignalCurrent > acSignalPrevious))
   {
-    IR_AC_Signal_max = IR_AC_Signal_Current;
+    st->acSignalMax = st->acSignalCurrent;
   }
 
   //  Find Minimum value in negative cycle
-  if (negativeEdge & (IR_AC_Signal_Current < IR_AC_Signal_Previous))
+  if (st->negativeEdge && (st->acSignalCurrent < acSignalPrevious))
   {
-    IR_AC_Signal_min = IR_AC_Signal_Current;
+    st->acSignalMin = st->acSignalCurrent;
   }
 
   return(beatDetected);
 }
 
-//  Average DC Estimator
-int16_t averageDCEstimator(int32_t *p, uint16_t x)
+void beatDetectorInit(beat_detector_t *detector)
 {
-  *p += ((((long) x << 15) - *p) >> 4);
-  return (*p >> 15);
+  memset(detector, 0, sizeof(beat_detector_t));
+  detector->state.acMax = 20;
+  detector->state.acMin = -20;
 }
 
-//  Low Pass FIR Filter
-int16_t lowPassFIRFilter(int16_t din)
+bool beatDetectorCheck(beat_detector_t *detector, int32_t sample)
 {
-  cbuf[offset] = din;
+  return(beatStep(&detector->state, detector->cbuf, sample));
+}
 
-  int32_t z = mul16(FIRCoeffs[11], cbuf[(offset - 11) & 0x1F]);
+uint16_t beatDetectorCheckBlock(beat_detector_t *detector, const uint32_t *samples, uint16_t length, uint16_t *beats)
+{
+  //  Local copy: the variables stay in registers along the block
+  beat_state_t st = detector->state;
+  uint16_t beatCount = 0;
 
-  for (uint8_t i = 0 ; i < 11 ; i++)
+  for (uint16_t n = 0 ; n < length ; n++)
   {
-    z += mul16(FIRCoeffs[i], cbuf[(offset - i) & 0x1F] + cbuf[(offset - 22 + i) & 0x1F]);
+    if (beatStep(&st, detector->cbuf, samples[n]))
+    {
+      if (beats != NULL) beats[beatCount] = n;
+      beatCount++;
+    }
   }
 
-  offset++;
-  offset %= 32; //Wrap condition
+  detector->state = st;
+  return(beatCount);
+}
 
-  return(z >> 15);
+//  Heart Rate Monitor functions takes a sample value and the sample number
+//  Returns true if a beat is detected
+//  A running average of four samples is recommended for display on the screen.
+//  Single sensor version of beatDetectorCheck()
+bool checkForBeat(int32_t sample)
+{
+  return(beatDetectorCheck(&defaultDetector, sample));
+}
+
+//  Average DC Estimator
+int16_t averageDCEstimator(int32_t *p, uint16_t x)
+{
+  *p += ((((long) x << 15) - *p) >> 4);
+  return (*p >> 15);
+}
+
+//  Low Pass FIR Filter (delay line of the checkForBeat() detector)
+int16_t lowPassFIRFilter(int16_t din)
+{
+  int16_t z = firFilter(defaultDetector.cbuf, defaultDetector.state.offset, din);
+  defaultDetector.state.offset = (defaultDetector.state.offset + 1) & (BEAT_BUFFER_SIZE - 1); //Wrap condition
+  return(z);
 }
 
 //  Integer multiplier
@@ -161,4 +198,3 @@ int32_t mul16(int16_t x, int16_t y)
 {
   return((long)x * (long)y);
 }
-
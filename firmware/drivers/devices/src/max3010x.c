@@ -11,6 +11,11 @@
 #include "i2c_mcu.h"
 #include "string.h"
 #include "delay_mcu.h"
+#include "esp_attr.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
 
 
 uint8_t activeLEDs; //Gets set during setup. Allows check() to calculate how many bytes to read from FIFO
@@ -143,6 +148,27 @@ static const uint8_t MAX3010X_SLOT4_MASK = 		0x8F;
 
 static const uint8_t MAX_30105_EXPECTEDPARTID = 0x15;
 
+#define MAX3010X_FIFO_DEPTH       32  //Samples stored by the sensor FIFO
+#define MAX3010X_MAX_BURST        255 //I2C_requestBytes length is 8 bits
+#define MAX3010X_TASK_PRIORITY    10  //Above the application tasks, so the FIFO is drained in time
+#define MAX3010X_TASK_STACK       2048
+
+static uint8_t fifoBuffer[MAX3010X_FIFO_DEPTH * 3 * 3]; //Whole FIFO, 3 LEDs of 3 bytes
+
+//Interrupt driven acquisition: single producer (acquisition task), single
+//consumer (MAX3010X_readSamples) ring buffer, each index written by one side only
+static max3010x_sample_t ring[MAX3010X_RING_SIZE];
+static uint32_t ringHead; //Written by the acquisition task
+static uint32_t ringTail; //Written by the consumer
+static volatile uint32_t lostSamples;
+static TaskHandle_t acquisitionTask = NULL;
+static SemaphoreHandle_t newDataSemaphore = NULL;
+static volatile bool acquisitionRunning = false;
+static volatile int64_t interruptTime;
+static uint8_t samplesPerInterrupt;
+static gpio_t interruptPin;
+static uint32_t samplePeriodUs;
+
 
 
 bool MAX3010X_begin(void) {
@@ -589,142 +615,269 @@ void MAX3010X_nextSample(void)
   }
 }
 
+//Reads numberOfSamples samples from FIFO_DATA into fifoBuffer
+//The FIFO (at most 288 bytes) is read in as few I2C transactions as possible,
+//each one a whole number of samples
+static void readFIFOData(int numberOfSamples)
+{
+  int bytesPerSample = activeLEDs * 3;
+  int bytesLeftToRead = numberOfSamples * bytesPerSample;
+  uint8_t *data = fifoBuffer;
+
+  I2C_SelectRegister(MAX30105_ADDRESS, MAX3010X_FIFODATA);
+  while (bytesLeftToRead > 0)
+  {
+    int toGet = bytesLeftToRead;
+    if (toGet > MAX3010X_MAX_BURST)
+      toGet = MAX3010X_MAX_BURST - (MAX3010X_MAX_BURST % bytesPerSample);
+
+    I2C_requestBytes(MAX30105_ADDRESS, toGet, data, 0);
+    data += toGet;
+    bytesLeftToRead -= toGet;
+  }
+}
+
+//Converts the 3 bytes of a LED reading (MSB first) to its 18 bit value
+static inline uint32_t unpackSample(const uint8_t *data)
+{
+  return (((uint32_t)data[0] << 16) | ((uint32_t)data[1] << 8) | data[2]) & 0x3FFFF;
+}
+
+//Number of unread samples in the sensor FIFO
+//With roll over enabled a full FIFO has both pointers equal and the overflow counter set
+static int fifoSamples(void)
+{
+  uint8_t readPointer = MAX3010X_getReadPointer();
+  uint8_t writePointer = MAX3010X_getWritePointer();
+
+  int numberOfSamples = writePointer - readPointer;
+  if (numberOfSamples < 0) numberOfSamples += MAX3010X_FIFO_DEPTH; //Wrap condition
+  return (numberOfSamples);
+}
+
 //Polls the sensor for new data
 //Call regularly
 //If new data is available, it updates the head and tail in the main struct
 //Returns number of new samples obtained
 uint16_t MAX3010X_check(void)
 {
-  //Read register FIDO_DATA in (3-uint8_t * number of active LED) chunks
+  //Read register FIFO_DATA in (3-uint8_t * number of active LED) chunks
   //Until FIFO_RD_PTR = FIFO_WR_PTR
-
-  uint8_t readPointer = MAX3010X_getReadPointer();
-  uint8_t writePointer = MAX3010X_getWritePointer();
-
-  int numberOfSamples = 0;
+  int numberOfSamples = fifoSamples();
 
   //Do we have new data?
-  if (readPointer != writePointer)
+  if (numberOfSamples > 0)
   {
-    //Calculate the number of readings we need to get from sensor
-    numberOfSamples = writePointer - readPointer;
-    if (numberOfSamples < 0) numberOfSamples += 32; //Wrap condition
-
-    //We now have the number of readings, now calc uint8_ts to read
-    //For this example we are just doing Red and IR (3 uint8_ts each)
-    int uint8_tsLeftToRead = numberOfSamples * activeLEDs * 3;
-
-    //Get ready to read a burst of data from the FIFO register
-    uint8_t transmit_data_buffer;
-    transmit_data_buffer = MAX3010X_FIFODATA;
-    I2C_SelectRegister(MAX30105_ADDRESS, transmit_data_buffer);
-   // _i2cPort->beginTransmission(MAX3010X_ADDRESS);
-   // _i2cPort->write(MAX3010X_FIFODATA);
-   // _i2cPort->endTransmission();
-
-    //We may need to read as many as 288 uint8_ts so we read in blocks no larger than I2C_BUFFER_LENGTH
-    //I2C_BUFFER_LENGTH changes based on the platform. 64 uint8_ts for SAMD21, 32 uint8_ts for Uno.
-    //Wire.requestFrom() is limited to BUFFER_LENGTH which is 32 on the Uno
-    while (uint8_tsLeftToRead > 0)
+    readFIFOData(numberOfSamples);
+
+    const uint8_t *data = fifoBuffer;
+    for (int i = 0; i < numberOfSamples; i++)
     {
-      int toGet = uint8_tsLeftToRead;
-      if (toGet > I2C_BUFFER_LENGTH)
-      {
-        //If toGet is 32 this is bad because we read 6 uint8_ts (Red+IR * 3 = 6) at a time
-        //32 % 6 = 2 left over. We don't want to request 32 uint8_ts, we want to request 30.
-        //32 % 9 (Red+IR+GREEN) = 5 left over. We want to request 27.
+      sense.head++; //Advance the head of the storage struct
+      sense.head %= STORAGE_SIZE; //Wrap condition
 
-        toGet = I2C_BUFFER_LENGTH - (I2C_BUFFER_LENGTH % (activeLEDs * 3)); //Trim toGet to be a multiple of the samples we need to read
-      }
+      sense.red[sense.head] = unpackSample(data);
+      if (activeLEDs > 1) sense.IR[sense.head] = unpackSample(data + 3);
+      if (activeLEDs > 2) sense.green[sense.head] = unpackSample(data + 6);
 
-      uint8_tsLeftToRead -= toGet;
+      data += activeLEDs * 3;
+    }
+  }
 
-      //Request toGet number of uint8_ts from sensor
-      //_i2cPort->requestFrom(MAX3010X_ADDRESS, toGet);
-      uint8_t data_to_read_buffer[32];
-      uint8_t data = 0;
-      //data_to_read_buffer = reg;
-      I2C_requestBytes(MAX30105_ADDRESS, toGet, data_to_read_buffer, 0);
+  return (numberOfSamples); //Let the world know how much new data we found
+}
 
-      while (toGet > 0)
-      {
-        sense.head++; //Advance the head of the storage struct
-        sense.head %= STORAGE_SIZE; //Wrap condition
+//Check for new data but give up after a certain amount of time
+//Returns true if new data was found
+//Returns false if new data was not found
+bool MAX3010X_safeCheck(uint8_t maxTimeToCheck)
+{
+  uint32_t markTime = 0;
 
-        uint8_t temp[sizeof(uint32_t)]; //Array of 4 uint8_ts that we will convert into long
-        uint32_t tempLong;
+  while(1)
+  {
+	if(markTime > maxTimeToCheck) return(false);
+
+	if(MAX3010X_check() == true) //We found new data!
+	  return(true);
+	markTime++;
+	DelayMs(1);
+  }
+}
 
-        //Burst read three uint8_ts - RED
-        temp[3] = 0;
-        temp[2] = data_to_read_buffer[0];
-        temp[1] = data_to_read_buffer[1];
-        temp[0] = data_to_read_buffer[2];
+//
+// Interrupt driven acquisition
+//
 
-        //Convert array to long
-        memcpy(&tempLong, temp, sizeof(tempLong));
+//INT pin falls when the FIFO reaches samplesPerInterrupt samples
+static void IRAM_ATTR MAX3010X_intISR(void *args)
+{
+  BaseType_t higherPriorityTaskWoken = pdFALSE;
 
-		tempLong &= 0x3FFFF; //Zero out all but 18 bits
+  interruptTime = esp_timer_get_time();
+  if (acquisitionTask != NULL)
+    vTaskNotifyGiveFromISR(acquisitionTask, &higherPriorityTaskWoken);
+  portYIELD_FROM_ISR(higherPriorityTaskWoken);
+}
 
-        sense.red[sense.head] = tempLong; //Store this reading into the sense array
+//Time between FIFO samples, from the sample rate and averaging set in the sensor
+static uint32_t readSamplePeriod(void)
+{
+  static const uint16_t rates[] = {50, 100, 200, 400, 800, 1000, 1600, 3200};
 
-        if (activeLEDs > 1)
-        {
-          //Burst read three more uint8_ts - IR
-          temp[3] = 0;
-          temp[2] = data_to_read_buffer[3];
-          temp[1] = data_to_read_buffer[4];
-          temp[0] = data_to_read_buffer[5];
+  uint8_t rate = (readRegister8(MAX3010X_PARTICLECONFIG) & ~MAX3010X_SAMPLERATE_MASK) >> 2;
+  uint8_t average = (readRegister8(MAX3010X_FIFOCONFIG) & ~MAX3010X_SAMPLEAVG_MASK) >> 5;
+  if (average > 5) average = 5; //32 samples
 
-          //Convert array to long
-          memcpy(&tempLong, temp, sizeof(tempLong));
+  return ((uint32_t)1000000 << average) / rates[rate];
+}
 
-		  tempLong &= 0x3FFFF; //Zero out all but 18 bits
+//Sleeps until the almost full interrupt, then drains the sensor FIFO into the ring buffer
+static void MAX3010X_acquisitionTask(void *param)
+{
+  //A missed edge (e.g. INT already low) must not stop the acquisition:
+  //without interrupt the FIFO is drained anyway before it fills up
+  TickType_t timeout = pdMS_TO_TICKS((uint64_t)samplePeriodUs * MAX3010X_FIFO_DEPTH / 1000);
+  if (timeout == 0) timeout = 1;
 
-		  sense.IR[sense.head] = tempLong;
-        }
+  while (acquisitionRunning)
+  {
+    bool interrupted = ulTaskNotifyTake(pdTRUE, timeout) > 0;
+    if (acquisitionRunning == false) break;
+
+    //A_FULL keeps INT low until INT_STATUS1 is read: without this read there
+    //would be no new falling edge after the first burst
+    MAX3010X_getINT1();
+
+    uint8_t overflow = readRegister8(MAX3010X_FIFOOVERFLOW); //Samples lost by the sensor FIFO
+    int numberOfSamples = fifoSamples();
+    if ((numberOfSamples == 0) && (overflow > 0)) numberOfSamples = MAX3010X_FIFO_DEPTH;
+    if (numberOfSamples == 0) continue;
+    lostSamples += overflow;
+
+    //Timestamps: at the interrupt the newest sample was number samplesPerInterrupt,
+    //otherwise (timeout, overflow) the newest one is taken as just acquired
+    int64_t anchorTime;
+    int anchorSample;
+    if (interrupted && (overflow == 0) && (numberOfSamples >= samplesPerInterrupt))
+    {
+      anchorTime = interruptTime;
+      anchorSample = samplesPerInterrupt - 1;
+    }
+    else
+    {
+      anchorTime = esp_timer_get_time();
+      anchorSample = numberOfSamples - 1;
+    }
 
-        if (activeLEDs > 2)
-        {
-          //Burst read three more uint8_ts - Green
-          temp[3] = 0;
-          temp[2] = data_to_read_buffer[6];
-          temp[1] = data_to_read_buffer[7];
-          temp[0] = data_to_read_buffer[8];
+    readFIFOData(numberOfSamples);
 
-          //Convert array to long
-          memcpy(&tempLong, temp, sizeof(tempLong));
+    uint32_t head = ringHead;
+    uint32_t freeSamples = MAX3010X_RING_SIZE - (head - __atomic_load_n(&ringTail, __ATOMIC_ACQUIRE));
+    const uint8_t *data = fifoBuffer;
+    for (int i = 0; i < numberOfSamples; i++, data += activeLEDs * 3)
+    {
+      if (freeSamples == 0)
+      {
+        lostSamples++; //Consumer too slow: newest samples are dropped
+        continue;
+      }
+      max3010x_sample_t *sample = &ring[head & (MAX3010X_RING_SIZE - 1)];
+      sample->timestamp = anchorTime + (int64_t)(i - anchorSample) * samplePeriodUs;
+      sample->red = unpackSample(data);
+      sample->IR = (activeLEDs > 1) ? unpackSample(data + 3) : 0;
+      sample->green = (activeLEDs > 2) ? unpackSample(data + 6) : 0;
+      head++;
+      freeSamples--;
+    }
+    //Samples are visible to the consumer once they are complete
+    __atomic_store_n(&ringHead, head, __ATOMIC_RELEASE);
+    xSemaphoreGive(newDataSemaphore);
+  }
 
-		  tempLong &= 0x3FFFF; //Zero out all but 18 bits
+  MAX3010X_disableAFULL();
+  acquisitionTask = NULL;
+  vTaskDelete(NULL);
+}
 
-          sense.green[sense.head] = tempLong;
-        }
+bool MAX3010X_startAcquisition(gpio_t intPin, uint8_t samples)
+{
+  //MAX3010X_setup must be called first
+  if ((acquisitionTask != NULL) || (activeLEDs == 0)) return (false);
+
+  if (samples < MAX3010X_FIFO_DEPTH - 15) samples = MAX3010X_FIFO_DEPTH - 15;
+  if (samples > MAX3010X_FIFO_DEPTH) samples = MAX3010X_FIFO_DEPTH;
+  samplesPerInterrupt = samples;
+  samplePeriodUs = readSamplePeriod();
+
+  if (newDataSemaphore == NULL) newDataSemaphore = xSemaphoreCreateBinary();
+  if (newDataSemaphore == NULL) return (false);
+  ringHead = 0;
+  ringTail = 0;
+  lostSamples = 0;
+
+  //Almost full register holds the free FIFO slots that trigger the interrupt
+  MAX3010X_setFIFOAlmostFull(MAX3010X_FIFO_DEPTH - samples);
+  MAX3010X_clearFIFO();
+  MAX3010X_getINT1(); //Clears pending interrupts, INT pin goes back high
+
+  acquisitionRunning = true;
+  if (xTaskCreate(&MAX3010X_acquisitionTask, "MAX3010X", MAX3010X_TASK_STACK, NULL, MAX3010X_TASK_PRIORITY, &acquisitionTask) != pdPASS)
+  {
+    acquisitionRunning = false;
+    acquisitionTask = NULL;
+    return (false);
+  }
 
-        toGet -= activeLEDs * 3;
-      }
+  //INT is open drain, active low
+  interruptPin = intPin;
+  GPIOInit(intPin, GPIO_INPUT);
+  GPIOActivInt(intPin, MAX3010X_intISR, false, NULL);
+  MAX3010X_enableAFULL();
+  return (true);
+}
 
-    } //End while (uint8_tsLeftToRead > 0)
+void MAX3010X_stopAcquisition(void)
+{
+  if (acquisitionTask == NULL) return;
 
-  } //End readPtr != writePtr
+  //No interrupt may notify the task once it is deleted
+  GPIODeactivInt(interruptPin);
+  acquisitionRunning = false;
+  xTaskNotifyGive(acquisitionTask);
+  while (acquisitionTask != NULL) vTaskDelay(1); //Wait for the current burst to end
+}
 
-  return (numberOfSamples); //Let the world know how much new data we found
+uint16_t MAX3010X_samplesAvailable(void)
+{
+  return (__atomic_load_n(&ringHead, __ATOMIC_ACQUIRE) - ringTail);
 }
 
-//Check for new data but give up after a certain amount of time
-//Returns true if new data was found
-//Returns false if new data was not found
-bool MAX3010X_safeCheck(uint8_t maxTimeToCheck)
+uint16_t MAX3010X_readSamples(max3010x_sample_t *samples, uint16_t maxSamples, uint32_t timeoutMs)
 {
-  uint32_t markTime = 0;
+  uint32_t tail = ringTail;
+  uint32_t available = __atomic_load_n(&ringHead, __ATOMIC_ACQUIRE) - tail;
 
-  while(1)
+  //Block until the acquisition task stores new samples
+  while (available == 0)
   {
-	if(markTime > maxTimeToCheck) return(false);
-
-	if(MAX3010X_check() == true) //We found new data!
-	  return(true);
-	markTime++;
-	DelayMs(1);
+    if ((newDataSemaphore == NULL) || (xSemaphoreTake(newDataSemaphore, pdMS_TO_TICKS(timeoutMs)) != pdTRUE))
+      return (0);
+    available = __atomic_load_n(&ringHead, __ATOMIC_ACQUIRE) - tail;
   }
+  if (available > maxSamples) available = maxSamples;
+
+  for (uint32_t i = 0; i < available; i++)
+    samples[i] = ring[(tail + i) & (MAX3010X_RING_SIZE - 1)];
+
+  //Slots are given back to the producer once they are copied
+  __atomic_store_n(&ringTail, tail + available, __ATOMIC_RELEASE);
+  return (available);
+}
+
+uint32_t MAX3010X_getLostSamples(void)
+{
+  return (lostSamples);
 }
 
 //Given a register, read it, mask it, and then set the thing
@@ -57,9 +57,11 @@
 *******************************************************************************
 */
 
+#include <string.h>
 #include "spo2_algorithm.h"
 
 #define MIN(a,b) (((a)<(b))?(a):(b))
+#define MAX(a,b) (((a)>(b))?(a):(b))
 
 const uint8_t uch_spo2_table[184]={ 95, 95, 95, 96, 96, 96, 97, 97, 97, 97, 97, 98, 98, 98, 98, 98, 99, 99, 99, 99,
               99, 99, 99, 99, 100, 100, 100, 100, 100, 100, 100, 100, 100, 100, 100, 100, 100, 100, 100, 100,
@@ -71,6 +73,8 @@ const uint8_t uch_spo2_table[184]={ 95, 95, 95, 96, 96, 96, 97, 97, 97, 97, 97,
               49, 48, 47, 46, 45, 44, 43, 42, 41, 40, 39, 38, 37, 36, 35, 34, 33, 31, 30, 29,
               28, 27, 26, 25, 23, 22, 21, 20, 19, 17, 16, 15, 14, 12, 11, 10, 9, 7, 6, 5,
               3, 2, 1 } ;
+static  int32_t an_x[ BUFFER_SIZE]; //ir
+static  int32_t an_y[ BUFFER_SIZE]; //red
 
 void maxim_heart_rate_and_oxygen_saturation(uint32_t *pun_ir_buffer, int32_t n_ir_buffer_length, uint32_t *pun_red_buffer, int32_t *pn_spo2, int8_t *pch_spo2_valid,
                 int32_t *pn_heart_rate, int8_t *pch_hr_valid)
@@ -322,3 +326,283 @@ void maxim_sort_indices_descend(  int32_t  *pn_x, int32_t *pn_indx, int32_t n_si
 }
 
 
+
+
+static void maxim_spo2_stream_update_spo2(maxim_spo2_stream_t *ps_stream)
+/**
+* \brief        Publish SpO2
+* \par          Details
+*               Median of the ratios of the last beats, as maxim_heart_rate_and_oxygen_saturation()
+*
+* \retval       None
+*/
+{
+  int32_t an_ratio[STREAM_MAX_RATIOS];
+  int32_t n_middle_idx, n_ratio_average;
+
+  memcpy(an_ratio, ps_stream->an_ratio, ps_stream->n_ratios * sizeof(int32_t));
+  maxim_sort_ascend(an_ratio, ps_stream->n_ratios);
+  n_middle_idx = ps_stream->n_ratios/2;
+  if (n_middle_idx >1)
+    n_ratio_average =( an_ratio[n_middle_idx-1] +an_ratio[n_middle_idx])/2; // use median
+  else
+    n_ratio_average = (ps_stream->n_ratios > 0) ? an_ratio[n_middle_idx] : 0;
+
+  if( n_ratio_average>2 && n_ratio_average <184){
+    ps_stream->n_spo2 = uch_spo2_table[n_ratio_average];
+    ps_stream->ch_spo2_valid = 1;
+  }
+  else{
+    ps_stream->n_spo2 = -999;
+    ps_stream->ch_spo2_valid = 0;
+  }
+}
+
+static void maxim_spo2_stream_update_hr(maxim_spo2_stream_t *ps_stream)
+/**
+* \brief        Publish heart rate
+* \par          Details
+*               Mean interval between the valleys of the window
+*
+* \retval       None
+*/
+{
+  int32_t n_peak_interval;
+
+  if (ps_stream->n_valleys >= 2){
+    n_peak_interval = (int32_t)(ps_stream->aun_valley_locs[ps_stream->n_valleys-1] - ps_stream->aun_valley_locs[0]) / (ps_stream->n_valleys-1);
+    ps_stream->n_heart_rate = (ps_stream->n_freq*60) / n_peak_interval;
+    ps_stream->ch_hr_valid = 1;
+  }
+  else{
+    ps_stream->n_heart_rate = -999;
+    ps_stream->ch_hr_valid = 0;
+  }
+}
+
+static void maxim_spo2_stream_add_valley(maxim_spo2_stream_t *ps_stream, uint32_t un_loc)
+/**
+* \brief        Add a valley
+* \par          Details
+*               Ratio of the beat that ends at the valley (AC/DC of red and IR between the last two
+*               valleys), and new heart rate and SpO2
+*
+* \retval       None
+*/
+{
+  uint32_t un_prev, i;
+  int32_t n_size, n_pos;
+  int64_t n_x_dc_max, n_y_dc_max, n_x_ac, n_y_ac, n_nume, n_denom;
+  uint32_t un_x_dc_max_idx, un_y_dc_max_idx;
+
+  if (ps_stream->n_valleys > 0){
+    un_prev = ps_stream->aun_valley_locs[ps_stream->n_valleys-1];
+    n_size = (int32_t)(un_loc - un_prev);
+    // the whole beat must be in the window
+    if (n_size > ps_stream->n_min_beat && ps_stream->un_count - un_prev <= (uint32_t)ps_stream->n_window){
+      n_x_dc_max = -16777216;
+      n_y_dc_max = -16777216;
+      un_x_dc_max_idx = un_prev;
+      un_y_dc_max_idx = un_prev;
+      for (i = un_prev; i != un_loc; i++){
+        n_pos = i % ps_stream->n_window;
+        if (ps_stream->aun_ir[n_pos] > n_x_dc_max) {n_x_dc_max = ps_stream->aun_ir[n_pos]; un_x_dc_max_idx = i;}
+        if (ps_stream->aun_red[n_pos] > n_y_dc_max) {n_y_dc_max = ps_stream->aun_red[n_pos]; un_y_dc_max_idx = i;}
+      }
+      // subtract the linear DC component (between both valleys) from the maximum
+      n_y_ac = (int64_t)ps_stream->aun_red[un_loc % ps_stream->n_window] - ps_stream->aun_red[un_prev % ps_stream->n_window];
+      n_y_ac = ps_stream->aun_red[un_prev % ps_stream->n_window] + n_y_ac * (int32_t)(un_y_dc_max_idx - un_prev) / n_size;
+      n_y_ac = n_y_dc_max - n_y_ac;
+      n_x_ac = (int64_t)ps_stream->aun_ir[un_loc % ps_stream->n_window] - ps_stream->aun_ir[un_prev % ps_stream->n_window];
+      n_x_ac = ps_stream->aun_ir[un_prev % ps_stream->n_window] + n_x_ac * (int32_t)(un_x_dc_max_idx - un_prev) / n_size;
+      n_x_ac = n_x_dc_max - n_x_ac;
+      n_nume = (n_y_ac * n_x_dc_max) >> 7;
+      n_denom = (n_x_ac * n_y_dc_max) >> 7;
+      if (n_denom > 0 && n_nume != 0){
+        if (ps_stream->n_ratios == STREAM_MAX_RATIOS){
+          memmove(ps_stream->an_ratio, &ps_stream->an_ratio[1], (STREAM_MAX_RATIOS-1) * sizeof(int32_t));
+          memmove(ps_stream->aun_ratio_locs, &ps_stream->aun_ratio_locs[1], (STREAM_MAX_RATIOS-1) * sizeof(uint32_t));
+          ps_stream->n_ratios--;
+        }
+        ps_stream->an_ratio[ps_stream->n_ratios] = (int32_t)((n_nume*100) / n_denom);
+        ps_stream->aun_ratio_locs[ps_stream->n_ratios] = un_loc;
+        ps_stream->n_ratios++;
+      }
+    }
+  }
+  if (ps_stream->n_valleys == STREAM_MAX_VALLEYS){
+    memmove(ps_stream->aun_valley_locs, &ps_stream->aun_valley_locs[1], (STREAM_MAX_VALLEYS-1) * sizeof(uint32_t));
+    ps_stream->n_valleys--;
+  }
+  ps_stream->aun_valley_locs[ps_stream->n_valleys++] = un_loc;
+  ps_stream->un_beats++;
+  maxim_spo2_stream_update_hr(ps_stream);
+  maxim_spo2_stream_update_spo2(ps_stream);
+}
+
+static void maxim_spo2_stream_add_peak(maxim_spo2_stream_t *ps_stream, uint32_t un_loc, int32_t n_val)
+/**
+* \brief        Add a peak of the inverted signal
+* \par          Details
+*               Peaks closer than n_min_distance: only the highest one is kept, as maxim_remove_close_peaks()
+*
+* \retval       None
+*/
+{
+  if (ps_stream->b_pend && un_loc - ps_stream->un_pend_loc <= (uint32_t)ps_stream->n_min_distance){
+    if (n_val > ps_stream->n_pend_val){
+      ps_stream->un_pend_loc = un_loc;
+      ps_stream->n_pend_val = n_val;
+    }
+    return;
+  }
+  if (ps_stream->b_pend)
+    maxim_spo2_stream_add_valley(ps_stream, ps_stream->un_pend_loc);
+  ps_stream->b_pend = true;
+  ps_stream->un_pend_loc = un_loc;
+  ps_stream->n_pend_val = n_val;
+}
+
+static uint32_t maxim_spo2_stream_div_window(const maxim_spo2_stream_t *ps_stream, uint32_t un_x)
+/**
+* \brief        Divide by the samples of the window
+* \par          Details
+*               Same result as un_x / n_window for every un_x (Granlund-Montgomery): a multiplication
+*               and two shifts instead of a division per sample once the window is full
+*
+* \retval       un_x / n_window
+*/
+{
+  uint32_t un_t = (uint32_t)(((uint64_t)un_x * ps_stream->un_window_mul) >> 32);
+  return (un_t + ((un_x - un_t) >> 1)) >> ps_stream->n_window_shift;
+}
+
+void maxim_spo2_stream_init(maxim_spo2_stream_t *ps_stream, int32_t n_sample_freq)
+/**
+* \brief        Initialize the streaming engine
+* \par          Details
+*               Distances of maxim_heart_rate_and_oxygen_saturation() are scaled from FreqS to n_sample_freq
+*
+* \param[out]   *ps_stream              - Streaming engine
+* \param[in]    n_sample_freq           - Sampling frequency, up to MAXIM_STREAM_MAX_FREQ
+*
+* \retval       None
+*/
+{
+  memset(ps_stream, 0, sizeof(maxim_spo2_stream_t));
+  ps_stream->n_freq = MAX(1, MIN(n_sample_freq, MAXIM_STREAM_MAX_FREQ));
+  ps_stream->n_window = ps_stream->n_freq * STREAM_WINDOW_S;
+  ps_stream->n_min_distance = MAX(1, 4 * ps_stream->n_freq / FreqS);
+  ps_stream->n_min_beat = 3 * ps_stream->n_freq / FreqS;
+  // n_window >= 4: multiplier of 2^32 * (2^l - n_window) / n_window + 1, l = ceil(log2(n_window))
+  int32_t n_l = 0;
+  while ((1L << n_l) < ps_stream->n_window) n_l++;
+  ps_stream->un_window_mul = (uint32_t)((((uint64_t)1 << 32) * ((1UL << n_l) - ps_stream->n_window)) / ps_stream->n_window + 1);
+  ps_stream->n_window_shift = n_l - 1;
+  ps_stream->n_spo2 = -999;
+  ps_stream->n_heart_rate = -999;
+}
+
+bool maxim_spo2_stream_add_sample(maxim_spo2_stream_t *ps_stream, uint32_t un_ir, uint32_t un_red)
+/**
+* \brief        Add a sample to the streaming engine
+* \par          Details
+*               Heart rate and SpO2 are published when a valley is found, MA4_SIZE + n_min_distance
+*               samples after it (the delay of the 4 pt moving average and of the removal of close
+*               valleys). They become invalid when the valleys leave the window (e.g. no finger).
+*
+* \param[in]    *ps_stream              - Streaming engine
+* \param[in]    un_ir                   - IR sensor sample
+* \param[in]    un_red                  - Red sensor sample
+*
+* \retval       true if heart rate or SpO2 were published
+*/
+{
+  uint32_t t = ps_stream->un_count;
+  uint32_t un_loc;
+  int32_t n_pos = ps_stream->n_pos;
+  int32_t n_prev = ps_stream->an_ma[(n_pos > 0 ? n_pos : ps_stream->n_window) - 1];
+  int32_t n_x, n_ma, n_n, n_th1;
+  uint32_t un_ir_mean;
+  bool b_full = t >= (uint32_t)ps_stream->n_window;
+  int8_t ch_hr_valid = ps_stream->ch_hr_valid;
+  int8_t ch_spo2_valid = ps_stream->ch_spo2_valid;
+  uint32_t un_beats = ps_stream->un_beats;
+
+  // running sums over the window: DC mean and threshold
+  if (b_full){
+    ps_stream->un_ir_sum -= ps_stream->aun_ir[n_pos];
+    ps_stream->n_ma_sum -= ps_stream->an_ma[n_pos];
+  }
+  ps_stream->aun_ir[n_pos] = un_ir;
+  ps_stream->aun_red[n_pos] = un_red;
+  ps_stream->un_ir_sum += un_ir;
+  n_n = b_full ? ps_stream->n_window : (int32_t)t + 1;
+  un_ir_mean = b_full ? maxim_spo2_stream_div_window(ps_stream, ps_stream->un_ir_sum) : ps_stream->un_ir_sum / n_n;
+  // remove DC and invert signal so that we can use peak detector as valley detector
+  n_x = -1 * (int32_t)(un_ir - un_ir_mean);
+  // 4 pt Moving Average
+  ps_stream->n_x_sum += n_x - ps_stream->an_x[t & (MA4_SIZE - 1)];
+  ps_stream->an_x[t & (MA4_SIZE - 1)] = n_x;
+  n_ma = ps_stream->n_x_sum / (int)4;
+  ps_stream->an_ma[n_pos] = n_ma;
+  ps_stream->n_ma_sum += n_ma;
+  // threshold: mean of the window, between 30 and 60
+  if (ps_stream->n_ma_sum < 30 * n_n) n_th1 = 30;
+  else if (ps_stream->n_ma_sum > 60 * n_n) n_th1 = 60;
+  else n_th1 = b_full ? (int32_t)maxim_spo2_stream_div_window(ps_stream, ps_stream->n_ma_sum) : ps_stream->n_ma_sum / n_n;
+  ps_stream->un_count++;
+  ps_stream->n_pos = (n_pos + 1 < ps_stream->n_window) ? n_pos + 1 : 0;
+
+  if (t >= MA4_SIZE){
+    // the average ends at t, maxim_heart_rate_and_oxygen_saturation() places it at its first sample
+    un_loc = t - (MA4_SIZE - 1);
+    if (ps_stream->b_cand){
+      if (n_ma < ps_stream->n_cand_val){        // right edge of the peak
+        ps_stream->b_cand = false;
+        maxim_spo2_stream_add_peak(ps_stream, ps_stream->un_cand_loc, ps_stream->n_cand_val);
+      }
+      else if (n_ma > ps_stream->n_cand_val)    // still rising
+        ps_stream->b_cand = false;
+    }
+    if (!ps_stream->b_cand && n_ma > n_th1 && n_ma > n_prev){   // left edge of potential peak
+      ps_stream->b_cand = true;
+      ps_stream->un_cand_loc = un_loc;
+      ps_stream->n_cand_val = n_ma;
+    }
+    // no other valley can be closer than n_min_distance
+    if (ps_stream->b_pend && un_loc - ps_stream->un_pend_loc > (uint32_t)ps_stream->n_min_distance){
+      ps_stream->b_pend = false;
+      maxim_spo2_stream_add_valley(ps_stream, ps_stream->un_pend_loc);
+    }
+  }
+
+  // valleys and ratios that leave the window
+  while (ps_stream->n_valleys > 0 && t - ps_stream->aun_valley_locs[0] >= (uint32_t)ps_stream->n_window){
+    memmove(ps_stream->aun_valley_locs, &ps_stream->aun_valley_locs[1], (ps_stream->n_valleys-1) * sizeof(uint32_t));
+    ps_stream->n_valleys--;
+    maxim_spo2_stream_update_hr(ps_stream);
+  }
+  while (ps_stream->n_ratios > 0 && t - ps_stream->aun_ratio_locs[0] >= (uint32_t)ps_stream->n_window){
+    memmove(ps_stream->an_ratio, &ps_stream->an_ratio[1], (ps_stream->n_ratios-1) * sizeof(int32_t));
+    memmove(ps_stream->aun_ratio_locs, &ps_stream->aun_ratio_locs[1], (ps_stream->n_ratios-1) * sizeof(uint32_t));
+    ps_stream->n_ratios--;
+    maxim_spo2_stream_update_spo2(ps_stream);
+  }
+  return (ps_stream->un_beats != un_beats) || (ps_stream->ch_hr_valid != ch_hr_valid) || (ps_stream->ch_spo2_valid != ch_spo2_valid);
+}
+
+void maxim_spo2_stream_get(maxim_spo2_stream_t *ps_stream, int32_t *pn_spo2, int8_t *pch_spo2_valid, int32_t *pn_heart_rate, int8_t *pch_hr_valid)
+/**
+* \brief        Last published heart rate and SpO2
+* \par          Details
+*               Same outputs as maxim_heart_rate_and_oxygen_saturation()
+*
+* \retval       None
+*/
+{
+  *pn_spo2 = ps_stream->n_spo2;
+  *pch_spo2_valid = ps_stream->ch_spo2_valid;
+  *pn_heart_rate = ps_stream->n_heart_rate;
+  *pch_hr_valid = ps_stream->ch_hr_valid;
+}
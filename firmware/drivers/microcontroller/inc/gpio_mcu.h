@@ -134,6 +134,13 @@ bool GPIORead(gpio_t pin);
  */
 void GPIOActivInt(gpio_t pin, void *ptr_int_func, bool edge, void *args);
 
+/**
+ * @brief Disable GPIO input interruption and remove its callback
+ * 
+ * @param pin GPIO number
+ */
+void GPIODeactivInt(gpio_t pin);
+
 /**
  * @brief Configure an input glitch filter to a GPIO
  * 
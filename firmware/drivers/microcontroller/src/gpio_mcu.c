@@ -116,6 +116,11 @@ void GPIOActivInt(gpio_t pin, void *ptr_int_func, bool edge, void *args){
     gpio_isr_handler_add(gpio_list[pin].pin, ptr_int_func, (void *)args);	
 }
 
+void GPIODeactivInt(gpio_t pin){
+	gpio_set_intr_type(gpio_list[pin].pin, GPIO_INTR_DISABLE);
+	gpio_isr_handler_remove(gpio_list[pin].pin);
+}
+
 void GPIOInputFilter(gpio_t pin){
 	static uint8_t filter_count = 0;
 	gpio_glitch_filter_handle_t filter;
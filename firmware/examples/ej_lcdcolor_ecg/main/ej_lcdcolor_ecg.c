@@ -7,6 +7,7 @@
  * graficar una señal temporal. Emula la interfaz del Monito de 
  * ECG Portable BeC: [bececg.com](https://bececg.com/).
  * También se ejemplifica el uso del reloj de tiempo real (RTC).
+ * La frecuencia cardíaca se calcula con el detector de QRS (Pan-Tompkins).
  * 
  * @section hardConn Hardware Connection
  *
@@ -27,6 +28,7 @@
  * |   Date	    | Description                                    |
  * |:----------:|:-----------------------------------------------|
  * | 05/04/2024 | Document creation		                         |
+ * | 16/10/2026 | Frecuencia cardíaca con detector de QRS        |
  *
  * @author Albano Peñalva (albano.penalva@uner.edu.ar)
  *
@@ -39,6 +41,7 @@
 #include "sys/time.h"
 
 #include "iir_filter.h"
+#include "qrs_detector.h"
 #include "timer_mcu.h"
 #include "gpio_mcu.h"
 #include "rtc_mcu.h"
@@ -53,9 +56,10 @@
 /*==================[macros and definitions]=================================*/
 #define BUFFER_SIZE         256
 #define SAMPLE_FREQ	        200
-#define T_SENIAL            4000 
+#define T_SENIAL            (1000000 / SAMPLE_FREQ)
 #define CHUNK               16 
 #define LIGHT_BLUE_COLOR    0x0B2F
+#define MAX_BEATS           2
 /*==================[internal data definition]===============================*/
 float ecg[] = {
      76,  76,  77,  77,  76,  83,  85,  78,  76,  85,  93,  85,  79,
@@ -80,8 +84,10 @@ float ecg[] = {
      71,  72,  82,  82,  76,  77,  76,  76,  75
 };
 static float ecg_filt[CHUNK];
+static qrs_beat_t latidos[MAX_BEATS];
+qrs_detector_t * detector_qrs = NULL;
 TaskHandle_t plot_task_handle = NULL;
-uint8_t frecuencia_cardiaca = 71;
+uint8_t frecuencia_cardiaca = 0;
 /*==================[internal functions declaration]=========================*/
 /**
  * @brief Función ejecutada en la interrupción del Timer
@@ -136,15 +142,13 @@ static void PlotTask(void *pvParameter){
         }
         indice += CHUNK;
 
-        if(indice == 0){
-            /* Actualización de datos en display */
+        /* Detección de latidos */
+        if(QrsDetect(detector_qrs, ecg_filt, CHUNK, latidos, MAX_BEATS) > 0){
+            frecuencia_cardiaca = QrsHeartRate(detector_qrs) + 0.5f;
+            /* Actualización de frecuencia cardíaca en display */
             ILI9341DrawString(20, 60, freq, &font_89, ILI9341_WHITE, ILI9341_WHITE);
-            ILI9341DrawString(10, 8, hour_min, &font_30, LIGHT_BLUE_COLOR, LIGHT_BLUE_COLOR);
             sprintf(freq, "%03i", frecuencia_cardiaca);
-            RtcRead(&actual_time);
-            sprintf(hour_min, "%02i:%02i", actual_time.hour%MAX_HOUR, actual_time.min%MAX_MIN);
             ILI9341DrawString(20, 60, freq, &font_89, LIGHT_BLUE_COLOR, ILI9341_WHITE);
-            ILI9341DrawString(10, 8, hour_min, &font_30, ILI9341_WHITE, LIGHT_BLUE_COLOR);
             if(beat){
                 ILI9341DrawPicture(170, 65, HEART_WIDTH, HEART_HEIGHT, heart);
             }else{
@@ -152,6 +156,14 @@ static void PlotTask(void *pvParameter){
             }
             beat = !beat;
         }
+
+        if(indice == 0){
+            /* Actualización de hora en display */
+            ILI9341DrawString(10, 8, hour_min, &font_30, LIGHT_BLUE_COLOR, LIGHT_BLUE_COLOR);
+            RtcRead(&actual_time);
+            sprintf(hour_min, "%02i:%02i", actual_time.hour%MAX_HOUR, actual_time.min%MAX_MIN);
+            ILI9341DrawString(10, 8, hour_min, &font_30, ILI9341_WHITE, LIGHT_BLUE_COLOR);
+        }
     }
 }
 /*==================[external functions definition]==========================*/
@@ -181,6 +193,11 @@ void app_main(void){
     /* Filtros */
     LowPassInit(SAMPLE_FREQ, 30, ORDER_2);
     HiPassInit(SAMPLE_FREQ, 1, ORDER_2);
+    detector_qrs = QrsCreate(SAMPLE_FREQ);
+    if(detector_qrs == NULL){
+        printf("Error: no se pudo crear el detector de QRS\n");
+        return;
+    }
 
     /* Tarea para actualizar pantalla */
     xTaskCreate(&PlotTask, "Plot", 4096, NULL, 5, &plot_task_handle);
@@ -12,12 +12,15 @@
  * | 	3V3		 	| 	3V3			|
  * | 	SCL		 	| 	SCL 		|
  * | 	GND		 	| 	GND			|
+ * | 	INT		 	| 	GPIO_23		|
  * 
  * @section changelog Changelog
  *
  * |   Date	    | Description                                    |
  * |:----------:|:-----------------------------------------------|
  * | 21/05/2024 | Document creation		                         |
+ * | 16/10/2026 | Calculo de HR y SpO2 muestra a muestra         |
+ * | 17/10/2026 | Adquisicion por interrupcion (pin INT)         |
  *
  * @author Juan Ignacio Cerrudo (juan.cerrudo@uner.edu.ar)
  *
@@ -37,13 +40,17 @@
 #define BUFFER_SIZE 256
 #define SAMPLE_FREQ	100
 #define CONFIG_BLINK_PERIOD 100
+#define GPIO_MAX_INT GPIO_23
+#define SAMPLES_PER_INT 25
+#define READ_TIMEOUT_MS 1000
 /*==================[internal data definition]===============================*/
 float dato_filt;
 float dato;
 
-uint32_t irBuffer[100]; //infrared LED sensor data
-uint32_t redBuffer[100];  //red LED sensor data
-int32_t bufferLength=100; //data length
+max3010x_sample_t samples[SAMPLES_PER_INT]; //red and infrared LED sensor data
+uint32_t irSample; //infrared LED sensor data
+uint32_t redSample;  //red LED sensor data
+maxim_spo2_stream_t spo2Stream; //HR and SPO2 calculation, sample by sample
 int32_t spo2; //SPO2 value
 int8_t validSPO2; //indicator to show if the SPO2 calculation is valid
 int32_t heartRate; //heart rate value
@@ -60,37 +67,36 @@ void app_main(void){
     /* Se imprimen por consola los valores de frequencia y magnitud correspondiente */
     printf("****MAX30102 Test****\n");
 
+    maxim_spo2_stream_init(&spo2Stream, SAMPLE_FREQ);
+    /* El sensor interrumpe cada SAMPLES_PER_INT muestras: la CPU y el bus I2C
+     * quedan libres entre lecturas */
+    MAX3010X_startAcquisition(GPIO_MAX_INT, SAMPLES_PER_INT);
+
     while(1){
-        uint8_t i;
-	    for (i = 25; i < 100; i++)
-	    {
-		    redBuffer[i - 25] = redBuffer[i];
-		    irBuffer[i - 25] = irBuffer[i];
+	    //Wait for new data
+	    uint16_t n = MAX3010X_readSamples(samples, SAMPLES_PER_INT, READ_TIMEOUT_MS);
+	    if (n == 0){
+		    printf("No data from MAX30102\n");
+		    continue;
 	    }
 
-	    //take 25 sets of samples before calculating the heart rate.
-	    for ( i = 75; i < 100; i++)
-	    {
-		    while (MAX3010X_available() == false) //do we have new data?
-			    MAX3010X_check(); //Check the sensor for new data
-            
-		    redBuffer[i] = MAX3010X_getRed();
-		    irBuffer[i] = MAX3010X_getIR();
-		    MAX3010X_nextSample(); //We're finished with this sample so move to next sample
-		            
-            //send samples and calculation result to terminal program through UART
-	     	dato = (float)redBuffer[i];
-			HiPassFilter(&dato, &dato_filt, 1);
-	        //printf("%ld,%2.2f,%ld\n", redBuffer[i], dato_filt, heartRate);
-             
-	}
+	    for (uint16_t i = 0; i < n; i++){
+		    redSample = samples[i].red;
+		    irSample = samples[i].IR;
+
+		    //send samples and calculation result to terminal program through UART
+		    dato = (float)redSample;
+		    HiPassFilter(&dato, &dato_filt, 1);
+		    //printf("%ld,%2.2f,%ld\n", redSample, dato_filt, heartRate);
 
-	//After gathering 25 new samples recalculate HR and SP02
-	maxim_heart_rate_and_oxygen_saturation(irBuffer, bufferLength, redBuffer, &spo2, &validSPO2, &heartRate, &validHeartRate);
-    printf("HR= %ld, HRvalid= %d \n", heartRate, validHeartRate);
-    printf("SPO2= %ld, SPO2Valid= %d \n", spo2, validSPO2);
-	LedToggle(LED_1);
-    //vTaskDelay(CONFIG_BLINK_PERIOD / portTICK_PERIOD_MS);
+		    //HR and SP02 are updated after each beat
+		    if (maxim_spo2_stream_add_sample(&spo2Stream, irSample, redSample)){
+			    maxim_spo2_stream_get(&spo2Stream, &spo2, &validSPO2, &heartRate, &validHeartRate);
+			    printf("HR= %ld, HRvalid= %d \n", heartRate, validHeartRate);
+			    printf("SPO2= %ld, SPO2Valid= %d \n", spo2, validSPO2);
+			    LedToggle(LED_1);
+		    }
+	    }
     }
 }
 /*==================[end of file]============================================*/
\ No newline at end of file
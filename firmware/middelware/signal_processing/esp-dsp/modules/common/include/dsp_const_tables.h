@@ -0,0 +1,126 @@
+// Copyright 2018-2023 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _dsp_const_tables_H_
+#define _dsp_const_tables_H_
+
+// Helpers to calculate the constant tables of the library (FFT twiddles, windows) by the
+// compiler. C++14 or newer only: the tables are defined in .cpp files with C linkage, as
+//
+//     extern "C" constexpr float table_N[N] = { DSP_TABLE_REPEAT_N(func, N, 0) };
+//
+// and every element is func(N, i), a constexpr function. constexpr makes sure that the
+// whole table is calculated at compile time and stored in flash (.rodata).
+
+namespace dsp_const {
+
+constexpr double pi = 3.14159265358979323846;
+
+// Taylor series, for |x| <= pi/4: error < 1e-17
+constexpr double sin_poly(double x)
+{
+    double x2 = x * x;
+    double term = x;
+    double sum = x;
+    for (int k = 1; k < 10; k++) {
+        term *= -x2 / ((2 * k) * (2 * k + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double cos_poly(double x)
+{
+    double x2 = x * x;
+    double term = 1;
+    double sum = 1;
+    for (int k = 1; k < 10; k++) {
+        term *= -x2 / ((2 * k - 1) * (2 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+// cos(x), with the quadrant of x: x = q * pi/2 + r, |r| <= pi/4
+constexpr double cos(double x)
+{
+    long long q = (long long)(x / (pi / 2) + ((x >= 0) ? 0.5 : -0.5));
+    double r = x - q * (pi / 2);
+    switch (q & 3) {
+    case 0:
+        return cos_poly(r);
+    case 1:
+        return -sin_poly(r);
+    case 2:
+        return -cos_poly(r);
+    default:
+        return sin_poly(r);
+    }
+}
+
+constexpr double sin(double x)
+{
+    long long q = (long long)(x / (pi / 2) + ((x >= 0) ? 0.5 : -0.5));
+    double r = x - q * (pi / 2);
+    switch (q & 3) {
+    case 0:
+        return sin_poly(r);
+    case 1:
+        return cos_poly(r);
+    case 2:
+        return -sin_poly(r);
+    default:
+        return -cos_poly(r);
+    }
+}
+
+// Bit reverse of x, with bits bits
+constexpr int reverse(int x, int bits)
+{
+    int result = 0;
+    for (int i = 0; i < bits; i++) {
+        result = (result << 1) | ((x >> i) & 1);
+    }
+    return result;
+}
+
+constexpr int power_of_two(int x)
+{
+    int pow = 0;
+    while ((1 << pow) < x) {
+        pow++;
+    }
+    return pow;
+}
+
+} // namespace dsp_const
+
+// func(N, i) for i = start .. start + 2^k - 1, separated by commas
+#define DSP_TABLE_REPEAT_1(func, N, i) func(N, (i))
+#define DSP_TABLE_REPEAT_2(func, N, i) DSP_TABLE_REPEAT_1(func, N, i), DSP_TABLE_REPEAT_1(func, N, (i) + 1)
+#define DSP_TABLE_REPEAT_4(func, N, i) DSP_TABLE_REPEAT_2(func, N, i), DSP_TABLE_REPEAT_2(func, N, (i) + 2)
+#define DSP_TABLE_REPEAT_8(func, N, i) DSP_TABLE_REPEAT_4(func, N, i), DSP_TABLE_REPEAT_4(func, N, (i) + 4)
+#define DSP_TABLE_REPEAT_16(func, N, i) DSP_TABLE_REPEAT_8(func, N, i), DSP_TABLE_REPEAT_8(func, N, (i) + 8)
+#define DSP_TABLE_REPEAT_32(func, N, i) DSP_TABLE_REPEAT_16(func, N, i), DSP_TABLE_REPEAT_16(func, N, (i) + 16)
+#define DSP_TABLE_REPEAT_64(func, N, i) DSP_TABLE_REPEAT_32(func, N, i), DSP_TABLE_REPEAT_32(func, N, (i) + 32)
+#define DSP_TABLE_REPEAT_128(func, N, i) DSP_TABLE_REPEAT_64(func, N, i), DSP_TABLE_REPEAT_64(func, N, (i) + 64)
+#define DSP_TABLE_REPEAT_256(func, N, i) DSP_TABLE_REPEAT_128(func, N, i), DSP_TABLE_REPEAT_128(func, N, (i) + 128)
+#define DSP_TABLE_REPEAT_512(func, N, i) DSP_TABLE_REPEAT_256(func, N, i), DSP_TABLE_REPEAT_256(func, N, (i) + 256)
+#define DSP_TABLE_REPEAT_1024(func, N, i) DSP_TABLE_REPEAT_512(func, N, i), DSP_TABLE_REPEAT_512(func, N, (i) + 512)
+#define DSP_TABLE_REPEAT_2048(func, N, i) DSP_TABLE_REPEAT_1024(func, N, i), DSP_TABLE_REPEAT_1024(func, N, (i) + 1024)
+#define DSP_TABLE_REPEAT_4096(func, N, i) DSP_TABLE_REPEAT_2048(func, N, i), DSP_TABLE_REPEAT_2048(func, N, (i) + 2048)
+#define DSP_TABLE_REPEAT_8192(func, N, i) DSP_TABLE_REPEAT_4096(func, N, i), DSP_TABLE_REPEAT_4096(func, N, (i) + 4096)
+#define DSP_TABLE_REPEAT_16384(func, N, i) DSP_TABLE_REPEAT_8192(func, N, i), DSP_TABLE_REPEAT_8192(func, N, (i) + 8192)
+
+#endif // _dsp_const_tables_H_
@@ -23,6 +23,7 @@
 #define ESP_ERR_DSP_UNINITIALIZED       (ESP_ERR_DSP_BASE + 4)
 #define ESP_ERR_DSP_REINITIALIZED       (ESP_ERR_DSP_BASE + 5)
 #define ESP_ERR_DSP_ARRAY_NOT_ALIGNED   (ESP_ERR_DSP_BASE + 6)
+#define ESP_ERR_DSP_SINGULAR_MATRIX     (ESP_ERR_DSP_BASE + 7)
 
 
 #endif // _dsp_error_codes_H_
@@ -33,6 +33,7 @@ extern "C"
 #include "dsps_wind.h"
 #include "dsps_conv.h"
 #include "dsps_corr.h"
+#include "dsps_conv_fft.h"
 
 #include "dsps_d_gen.h"
 #include "dsps_h_gen.h"
@@ -43,6 +44,7 @@ extern "C"
 #include "dsps_fft2r.h"
 #include "dsps_fft4r.h"
 #include "dsps_dct.h"
+#include "dsps_dct_plan.h"
 
 // Matrix operations
 #include "dspm_matrix.h"
@@ -60,6 +62,7 @@ extern "C"
 
 #ifdef __cplusplus
 #include "mat.h"
+#include "mat_n.h"
 #endif
 
 #endif // _esp_dsp_H_
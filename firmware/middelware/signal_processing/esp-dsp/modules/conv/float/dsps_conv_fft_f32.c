@@ -0,0 +1,278 @@
+// Copyright 2018-2020 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdbool.h>
+#include <string.h>
+#include <malloc.h>
+#include "dsps_conv_fft.h"
+#include "dsps_conv.h"
+#include "dsps_corr.h"
+#include "dsps_ccorr.h"
+#include "dsps_fft2r.h"
+#include "dsp_common.h"
+#include "esp_log.h"
+
+static const char *TAG = "dsps_conv_fft";
+
+// Relative cost of the operations, in multiply-accumulates of the direct method
+// (measured with the ANSI implementations)
+#define CONV_FFT_COST_BUTTERFLY     1.6f    // per point and stage of FFT + bit reversal
+#define CONV_FFT_COST_POINT         6.0f    // per point of load, spectrum product and store
+
+// Operations of the overlap-save method with an fft_size points FFT, two segments per transform
+static float conv_fft_cost(int fft_size, int kernlen, int nout)
+{
+    int seg_len = fft_size - kernlen + 1;
+    int n_fft = (nout + 2 * seg_len - 1) / (2 * seg_len);
+    float fft_cost = CONV_FFT_COST_BUTTERFLY * fft_size * dsp_power_of_two(fft_size);
+    return n_fft * (2 * fft_cost + CONV_FFT_COST_POINT * fft_size);
+}
+
+// FFT size with the lowest cost for nout outputs of a kernlen kernel, 0 if the direct method is cheaper
+// (or the FFT is not available)
+static int conv_fft_size(int kernlen, int nout, bool kernel_fft)
+{
+    float best_cost = (float)kernlen * nout;
+    int best_size = 0;
+    if (!dsps_fft2r_initialized) {
+        return 0;
+    }
+    for (int fft_size = 8; fft_size <= dsps_fft_w_table_size; fft_size <<= 1) {
+        if (fft_size < 2 * kernlen) {
+            continue;
+        }
+        float cost = conv_fft_cost(fft_size, kernlen, nout);
+        if (kernel_fft) {
+            cost += CONV_FFT_COST_BUTTERFLY * fft_size * dsp_power_of_two(fft_size);
+        }
+        if (cost < best_cost) {
+            best_cost = cost;
+            best_size = fft_size;
+        }
+    }
+    ESP_LOGD(TAG, "kernel %i, %i outputs: fft size %i", kernlen, nout, best_size);
+    return best_size;
+}
+
+// Kernel spectrum, scaled by 1/fft_size and left in bit reversed order (products are done in that order)
+static void conv_fft_kernel(float *spectrum, const float *kernel, int kernlen, bool reverse, int fft_size)
+{
+    for (int i = 0; i < fft_size; i++) {
+        float k = 0;
+        if (i < kernlen) {
+            k = reverse ? kernel[kernlen - 1 - i] : kernel[i];
+        }
+        spectrum[2 * i] = k / fft_size;
+        spectrum[2 * i + 1] = 0;
+    }
+    dsps_fft2r_fc32(spectrum, fft_size);
+}
+
+// Copy len samples of x starting at start (zero outside [0, xlen)) to every second position of dest
+static void conv_fft_load(float *dest, const float *x, int xlen, int start, int len)
+{
+    for (int i = 0; i < len; i++) {
+        int n = start + i;
+        dest[2 * i] = ((n >= 0) && (n < xlen)) ? x[n] : 0;
+    }
+}
+
+// Overlap-save: out[j] = sum(h[k] * x[first + j - k]), with x = 0 outside [0, xlen).
+// Two segments go through each transform, one as the real part and the other as the imaginary part:
+// both products with the real kernel spectrum stay separated after the inverse FFT. The inverse FFT is
+// computed with the forward one: ifft(Y) = conj(fft(conj(Y))) / N (the 1/N is in the kernel spectrum).
+static void conv_fft_overlap_save(const float *x, int xlen, const float *spectrum, int kernlen, int fft_size,
+                                  int first, int nout, float *out, float *buff)
+{
+    int seg_len = fft_size - kernlen + 1;
+    for (int done = 0; done < nout; done += 2 * seg_len) {
+        int n0 = first + done;
+        int len1 = ((nout - done) < seg_len) ? (nout - done) : seg_len;
+        int len2 = ((nout - done - len1) < seg_len) ? (nout - done - len1) : seg_len;
+        conv_fft_load(buff, x, xlen, n0 - kernlen + 1, kernlen - 1 + len1);
+        conv_fft_load(&buff[1], x, xlen, n0 + seg_len - kernlen + 1, kernlen - 1 + len2);
+        for (int i = kernlen - 1 + len1; i < fft_size; i++) {
+            buff[2 * i] = 0;
+        }
+        for (int i = kernlen - 1 + len2; i < fft_size; i++) {
+            buff[2 * i + 1] = 0;
+        }
+        dsps_fft2r_fc32(buff, fft_size);
+        for (int i = 0; i < fft_size; i++) {
+            float re = buff[2 * i] * spectrum[2 * i] - buff[2 * i + 1] * spectrum[2 * i + 1];
+            float im = buff[2 * i] * spectrum[2 * i + 1] + buff[2 * i + 1] * spectrum[2 * i];
+            buff[2 * i] = re;
+            buff[2 * i + 1] = -im;
+        }
+        dsps_bit_rev_fc32(buff, fft_size);
+        dsps_fft2r_fc32(buff, fft_size);
+        dsps_bit_rev_fc32(buff, fft_size);
+        // First kernlen - 1 outputs of each segment are wrapped around
+        const float *y = &buff[2 * (kernlen - 1)];
+        for (int i = 0; i < len1; i++) {
+            out[done + i] = y[2 * i];
+        }
+        for (int i = 0; i < len2; i++) {
+            out[done + len1 + i] = -y[2 * i + 1];
+        }
+    }
+}
+
+// One shot convolution with the FFT (reverse: use the kernel backwards). Returns false if the direct method
+// must be used
+static bool conv_fft_run(const float *x, int xlen, const float *kernel, int kernlen, bool reverse,
+                         int first, int nout, float *out)
+{
+    int fft_size = conv_fft_size(kernlen, nout, true);
+    if (fft_size == 0) {
+        return false;
+    }
+    float *spectrum = (float *)malloc(4 * fft_size * sizeof(float));
+    if (spectrum == NULL) {
+        ESP_LOGW(TAG, "Not enough memory for fft size %i, using direct method", fft_size);
+        return false;
+    }
+    float *buff = &spectrum[2 * fft_size];
+    conv_fft_kernel(spectrum, kernel, kernlen, reverse, fft_size);
+    conv_fft_overlap_save(x, xlen, spectrum, kernlen, fft_size, first, nout, out, buff);
+    free(spectrum);
+    return true;
+}
+
+esp_err_t dsps_conv_fft_f32(const float *Signal, const int siglen, const float *Kernel, const int kernlen, float *convout)
+{
+    if ((NULL == Signal) || (NULL == Kernel) || (NULL == convout)) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    if ((siglen <= 0) || (kernlen <= 0)) {
+        return ESP_ERR_DSP_INVALID_LENGTH;
+    }
+    // The shortest array is the kernel
+    const float *sig = Signal;
+    const float *kern = Kernel;
+    int lsig = siglen;
+    int lkern = kernlen;
+    if (siglen < kernlen) {
+        sig = Kernel;
+        kern = Signal;
+        lsig = kernlen;
+        lkern = siglen;
+    }
+    if (conv_fft_run(sig, lsig, kern, lkern, false, 0, lsig + lkern - 1, convout)) {
+        return ESP_OK;
+    }
+    return dsps_conv_f32(Signal, siglen, Kernel, kernlen, convout);
+}
+
+esp_err_t dsps_corr_fft_f32(const float *Signal, const int siglen, const float *Pattern, const int patlen, float *dest)
+{
+    if ((NULL == Signal) || (NULL == Pattern) || (NULL == dest)) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    if ((patlen <= 0) || (siglen < patlen)) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    // Convolution with the reversed pattern, only where the pattern overlaps the whole signal
+    if (conv_fft_run(Signal, siglen, Pattern, patlen, true, patlen - 1, siglen - patlen + 1, dest)) {
+        return ESP_OK;
+    }
+    return dsps_corr_f32(Signal, siglen, Pattern, patlen, dest);
+}
+
+esp_err_t dsps_ccorr_fft_f32(const float *Signal, const int siglen, const float *Pattern, const int patlen, float *corrout)
+{
+    if ((NULL == Signal) || (NULL == Pattern) || (NULL == corrout)) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    if ((siglen <= 0) || (patlen <= 0)) {
+        return ESP_ERR_DSP_INVALID_LENGTH;
+    }
+    // Same swap as dsps_ccorr_f32: the shortest array is reversed
+    const float *sig = Signal;
+    const float *kern = Pattern;
+    int lsig = siglen;
+    int lkern = patlen;
+    if (siglen < patlen) {
+        sig = Pattern;
+        kern = Signal;
+        lsig = patlen;
+        lkern = siglen;
+    }
+    if (conv_fft_run(sig, lsig, kern, lkern, true, 0, lsig + lkern - 1, corrout)) {
+        return ESP_OK;
+    }
+    return dsps_ccorr_f32(Signal, siglen, Pattern, patlen, corrout);
+}
+
+esp_err_t dsps_conv_fft_init_f32(conv_fft_f32_t *conv, const float *kernel, int kernlen, int block_len)
+{
+    if ((NULL == conv) || (NULL == kernel)) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    if ((kernlen <= 0) || (block_len <= 0)) {
+        return ESP_ERR_DSP_INVALID_LENGTH;
+    }
+    // The kernel spectrum is computed once: only the cost of each block matters
+    int fft_size = conv_fft_size(kernlen, block_len, false);
+    int kernel_size = (fft_size > 0) ? 2 * fft_size : kernlen;
+    int history_size = kernlen - 1 + block_len;
+    int buff_size = 2 * fft_size;
+    float *mem = (float *)malloc((kernel_size + history_size + buff_size) * sizeof(float));
+    if (mem == NULL) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    conv->kernel = mem;
+    conv->history = &mem[kernel_size];
+    conv->buff = (fft_size > 0) ? &mem[kernel_size + history_size] : NULL;
+    conv->kernlen = kernlen;
+    conv->block_len = block_len;
+    conv->fft_size = fft_size;
+    if (fft_size > 0) {
+        conv_fft_kernel(conv->kernel, kernel, kernlen, false, fft_size);
+    } else {
+        // The direct method correlates the history with the reversed kernel
+        for (int i = 0; i < kernlen; i++) {
+            conv->kernel[i] = kernel[kernlen - 1 - i];
+        }
+    }
+    memset(conv->history, 0, history_size * sizeof(float));
+    return ESP_OK;
+}
+
+esp_err_t dsps_conv_fft_process_f32(conv_fft_f32_t *conv, const float *input, float *output)
+{
+    if ((NULL == conv) || (NULL == conv->kernel) || (NULL == input) || (NULL == output)) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    int history_size = conv->kernlen - 1 + conv->block_len;
+    memcpy(&conv->history[conv->kernlen - 1], input, conv->block_len * sizeof(float));
+    esp_err_t ret = ESP_OK;
+    if (conv->fft_size > 0) {
+        conv_fft_overlap_save(conv->history, history_size, conv->kernel, conv->kernlen, conv->fft_size,
+                              conv->kernlen - 1, conv->block_len, output, conv->buff);
+    } else {
+        ret = dsps_corr_f32(conv->history, history_size, conv->kernel, conv->kernlen, output);
+    }
+    memmove(conv->history, &conv->history[conv->block_len], (conv->kernlen - 1) * sizeof(float));
+    return ret;
+}
+
+esp_err_t dsps_conv_fft_free_f32(conv_fft_f32_t *conv)
+{
+    free(conv->kernel);
+    conv->kernel = NULL;
+    conv->history = NULL;
+    conv->buff = NULL;
+    return ESP_OK;
+}
@@ -0,0 +1,154 @@
+// Copyright 2018-2020 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _dsps_conv_fft_H_
+#define _dsps_conv_fft_H_
+#include "dsp_err.h"
+
+#include "dsps_conv_platform.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Data struct of f32 streaming FFT convolution
+ *
+ * This structure is used by the streaming convolution internally. A user should access this structure
+ * only in case of extensions for the DSP Library.
+ * All fields of this structure are initialized by the dsps_conv_fft_init_f32(...) function.
+ */
+typedef struct conv_fft_f32_s {
+    float  *kernel;     /*!< Kernel spectrum (bit reversed order, scaled by 1/fft_size) or reversed kernel (direct path).*/
+    float  *history;    /*!< Last kernlen - 1 input samples followed by the current block.*/
+    float  *buff;       /*!< FFT working buffer, 2 * fft_size values.*/
+    int     kernlen;    /*!< Kernel length.*/
+    int     block_len;  /*!< Samples processed by each call to dsps_conv_fft_process_f32.*/
+    int     fft_size;   /*!< Complex FFT length, 0 if the direct path is used.*/
+} conv_fft_f32_t;
+
+/**@{*/
+/**
+ * @brief   Convolution with automatic selection of the direct or the FFT method
+ *
+ * Same result as dsps_conv_f32 (within float rounding). Long convolutions are computed by overlap-save
+ * with the radix-2 complex FFT, two real segments per transform; the method is chosen by the number of
+ * operations of each one. The direct method is used when the FFT tables are not initialized, when the
+ * kernel is longer than half the FFT table or if there is not enough memory for the working buffers.
+ *
+ * @param[in] Signal:  input array with signal
+ * @param[in] siglen:  length of the input signal
+ * @param[in] Kernel:  input array with convolution kernel
+ * @param[in] kernlen: length of the Kernel array
+ * @param convout: output array with convolution result length of (siglen + Kernel -1)
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - One of the error codes from DSP library
+ */
+esp_err_t dsps_conv_fft_f32(const float *Signal, const int siglen, const float *Kernel, const int kernlen, float *convout);
+/**@}*/
+
+/**@{*/
+/**
+ * @brief   Correlation with automatic selection of the direct or the FFT method
+ *
+ * Same result as dsps_corr_f32 (within float rounding), see dsps_conv_fft_f32 for the selection of the method.
+ *
+ * @param[in] Signal: input array with signal values
+ * @param[in] siglen: length of the signal array
+ * @param[in] Pattern: input array with pattern values
+ * @param[in] patlen: length of the pattern array. The siglen must be bigger then patlen!
+ * @param dest: output array with result of correlation, length of (siglen - patlen + 1)
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - One of the error codes from DSP library (one of the input array are NULL, or if (siglen < patlen))
+ */
+esp_err_t dsps_corr_fft_f32(const float *Signal, const int siglen, const float *Pattern, const int patlen, float *dest);
+/**@}*/
+
+/**@{*/
+/**
+ * @brief   Cross correlation with automatic selection of the direct or the FFT method
+ *
+ * Same result as dsps_ccorr_f32 (within float rounding), see dsps_conv_fft_f32 for the selection of the method.
+ *
+ * @param[in] Signal: input array with input 1 signal values
+ * @param[in] siglen: length of the input 1 signal array
+ * @param[in] Pattern: input array with input 2 signal values
+ * @param[in] patlen: length of the input 2 signal array
+ * @param corrout: output array with result of cross correlation. The size of dest array must be (siglen + patlen - 1) !!!
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - One of the error codes from DSP library
+ */
+esp_err_t dsps_ccorr_fft_f32(const float *Signal, const int siglen, const float *Pattern, const int patlen, float *corrout);
+/**@}*/
+
+/**@{*/
+/**
+ * @brief   initialize structure for streaming FFT convolution
+ *
+ * Selects the direct or the overlap-save method for blocks of block_len samples and allocates the
+ * buffers. The kernel spectrum is computed here, so the FFT must be initialized before
+ * (dsps_fft2r_init_fc32), otherwise the direct method is used.
+ *
+ * @param conv: pointer to convolution structure, that must be preallocated
+ * @param[in] kernel: array with the kernel (e.g. FIR filter coefficients), copied by the function
+ * @param[in] kernlen: length of the kernel array
+ * @param[in] block_len: samples processed by each call to dsps_conv_fft_process_f32
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - One of the error codes from DSP library
+ */
+esp_err_t dsps_conv_fft_init_f32(conv_fft_f32_t *conv, const float *kernel, int kernlen, int block_len);
+
+/**
+ * @brief   Streaming FFT convolution
+ *
+ * Filters a block of block_len samples: output[n] = sum(kernel[k] * input[n - k]), using the samples of
+ * the previous blocks (zero before the first one), like dsps_fir_f32.
+ *
+ * @param conv: pointer to convolution structure, that must be initialized before
+ * @param[in] input: input array, length of block_len
+ * @param[out] output: output array, length of block_len (may be the same as input)
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - One of the error codes from DSP library
+ */
+esp_err_t dsps_conv_fft_process_f32(conv_fft_f32_t *conv, const float *input, float *output);
+
+/**
+ * @brief   support arrays freeing function
+ *
+ * Function frees the buffers allocated by dsps_conv_fft_init_f32.
+ *
+ * @param conv: pointer to convolution structure, that must be initialized before
+ *
+ * @return
+ *      - ESP_OK on success
+ */
+esp_err_t dsps_conv_fft_free_f32(conv_fft_f32_t *conv);
+/**@}*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _dsps_conv_fft_H_
@@ -0,0 +1,178 @@
+// Copyright 2018-2020 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string.h>
+#include <math.h>
+#include "unity.h"
+#include "dsp_platform.h"
+#include "esp_log.h"
+
+#include "dsps_conv_fft.h"
+#include "dsps_ccorr.h"
+#include "esp_attr.h"
+#include "esp_dsp.h"
+
+static const char *TAG = "dsps_conv_fft";
+
+#define max_len 1500
+
+static const int test_len[] = {1, 3, 8, 33, 100, 257, 1000, max_len};
+#define test_len_count (sizeof(test_len) / sizeof(test_len[0]))
+
+// Maximum error relative to the biggest output
+static float rel_error(const float *ref, const float *out, int len)
+{
+    float max_ref = 0;
+    float max_err = 0;
+    for (int i = 0; i < len; i++) {
+        max_ref = fmaxf(max_ref, fabsf(ref[i]));
+        max_err = fmaxf(max_err, fabsf(ref[i] - out[i]));
+    }
+    return (max_ref > 0) ? max_err / max_ref : max_err;
+}
+
+TEST_CASE("dsps_conv_fft_f32 functionality", "[dsps]")
+{
+    float *x = (float *)malloc(max_len * sizeof(float));
+    TEST_ASSERT_NOT_NULL(x);
+    float *y = (float *)malloc(max_len * sizeof(float));
+    TEST_ASSERT_NOT_NULL(y);
+    float *ref = (float *)malloc(2 * max_len * sizeof(float));
+    TEST_ASSERT_NOT_NULL(ref);
+    float *out = (float *)malloc(2 * max_len * sizeof(float));
+    TEST_ASSERT_NOT_NULL(out);
+    esp_err_t ret = dsps_fft2r_init_fc32(NULL, CONFIG_DSP_MAX_FFT_SIZE);
+    TEST_ASSERT_EQUAL(ret, ESP_OK);
+
+    for (int i = 0 ; i < max_len ; i++) {
+        x[i] = (float)rand() / INT32_MAX - 0.5;
+        y[i] = (float)rand() / INT32_MAX - 0.5;
+    }
+    float max_eps = 0.00001;
+    for (int a = 0; a < test_len_count; a++) {
+        for (int b = 0; b < test_len_count; b++) {
+            int la = test_len[a];
+            int lb = test_len[b];
+            dsps_conv_f32_ansi(x, la, y, lb, ref);
+            dsps_conv_fft_f32(x, la, y, lb, out);
+            float err = rel_error(ref, out, la + lb - 1);
+            if (err > max_eps) {
+                ESP_LOGE(TAG, "conv la=%i, lb=%i, error=%g", la, lb, err);
+            }
+            TEST_ASSERT_LESS_THAN_FLOAT(max_eps, err);
+
+            dsps_ccorr_f32_ansi(x, la, y, lb, ref);
+            dsps_ccorr_fft_f32(x, la, y, lb, out);
+            err = rel_error(ref, out, la + lb - 1);
+            if (err > max_eps) {
+                ESP_LOGE(TAG, "ccorr la=%i, lb=%i, error=%g", la, lb, err);
+            }
+            TEST_ASSERT_LESS_THAN_FLOAT(max_eps, err);
+
+            if (la >= lb) {
+                dsps_corr_f32_ansi(x, la, y, lb, ref);
+                dsps_corr_fft_f32(x, la, y, lb, out);
+                err = rel_error(ref, out, la - lb + 1);
+                if (err > max_eps) {
+                    ESP_LOGE(TAG, "corr la=%i, lb=%i, error=%g", la, lb, err);
+                }
+                TEST_ASSERT_LESS_THAN_FLOAT(max_eps, err);
+            }
+        }
+    }
+    dsps_fft2r_deinit_fc32();
+    free(x);
+    free(y);
+    free(ref);
+    free(out);
+}
+
+TEST_CASE("dsps_conv_fft_process_f32 functionality", "[dsps]")
+{
+    int kernlen = 129;
+    float *x = (float *)malloc(max_len * sizeof(float));
+    TEST_ASSERT_NOT_NULL(x);
+    float *h = (float *)malloc(kernlen * sizeof(float));
+    TEST_ASSERT_NOT_NULL(h);
+    float *ref = (float *)malloc((max_len + kernlen) * sizeof(float));
+    TEST_ASSERT_NOT_NULL(ref);
+    float *out = (float *)malloc(max_len * sizeof(float));
+    TEST_ASSERT_NOT_NULL(out);
+    esp_err_t ret = dsps_fft2r_init_fc32(NULL, CONFIG_DSP_MAX_FFT_SIZE);
+    TEST_ASSERT_EQUAL(ret, ESP_OK);
+
+    for (int i = 0 ; i < max_len ; i++) {
+        x[i] = (float)rand() / INT32_MAX - 0.5;
+    }
+    for (int i = 0 ; i < kernlen ; i++) {
+        h[i] = (float)rand() / INT32_MAX - 0.5;
+    }
+    // Small blocks use the direct method, big ones the FFT
+    for (int block_len = 1; block_len <= 1024; block_len *= 4) {
+        conv_fft_f32_t conv;
+        ret = dsps_conv_fft_init_f32(&conv, h, kernlen, block_len);
+        TEST_ASSERT_EQUAL(ret, ESP_OK);
+        int len = (max_len / block_len) * block_len;
+        for (int pos = 0; pos < len; pos += block_len) {
+            ret = dsps_conv_fft_process_f32(&conv, &x[pos], &out[pos]);
+            TEST_ASSERT_EQUAL(ret, ESP_OK);
+        }
+        dsps_conv_f32_ansi(x, len, h, kernlen, ref);
+        float err = rel_error(ref, out, len);
+        ESP_LOGI(TAG, "block %i: fft size %i, error %g", block_len, conv.fft_size, err);
+        TEST_ASSERT_LESS_THAN_FLOAT(0.00001, err);
+        dsps_conv_fft_free_f32(&conv);
+    }
+    dsps_fft2r_deinit_fc32();
+    free(x);
+    free(h);
+    free(ref);
+    free(out);
+}
+
+TEST_CASE("dsps_conv_fft_f32 benchmark", "[dsps]")
+{
+    int max_N = 1024;
+    float *x = (float *)malloc(max_N * sizeof(float));
+    TEST_ASSERT_NOT_NULL(x);
+    float *y = (float *)malloc(max_N * sizeof(float));
+    TEST_ASSERT_NOT_NULL(y);
+    float *z = (float *)malloc((max_N * 2 + 1) * sizeof(float));
+    TEST_ASSERT_NOT_NULL(z);
+    esp_err_t ret = dsps_fft2r_init_fc32(NULL, CONFIG_DSP_MAX_FFT_SIZE);
+    TEST_ASSERT_EQUAL(ret, ESP_OK);
+
+    for (int i = 0 ; i < max_N ; i++) {
+        x[i] = 0;
+        y[i] = 1000;
+    }
+
+    for (int conv_size = 8; conv_size <= 256; conv_size *= 2) {
+        unsigned int start_b = xthal_get_ccount();
+        dsps_conv_f32_ansi(x, max_N, y, conv_size, &z[0]);
+        unsigned int end_b = xthal_get_ccount();
+        float cycles_direct = end_b - start_b;
+
+        start_b = xthal_get_ccount();
+        dsps_conv_fft_f32(x, max_N, y, conv_size, &z[0]);
+        end_b = xthal_get_ccount();
+        float cycles_fft = end_b - start_b;
+        ESP_LOGI(TAG, "signal %i, kernel %i: dsps_conv_f32_ansi %f cycles, dsps_conv_fft_f32 %f cycles",
+                 max_N, conv_size, cycles_direct, cycles_fft);
+    }
+    dsps_fft2r_deinit_fc32();
+    free(x);
+    free(y);
+    free(z);
+}
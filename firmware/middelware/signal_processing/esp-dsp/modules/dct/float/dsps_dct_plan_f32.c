@@ -0,0 +1,319 @@
+// Copyright 2018-2020 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <math.h>
+#include <malloc.h>
+#include "dsp_common.h"
+#include "dsps_dct_plan.h"
+
+// Complex a * b, with b = (br, bi)
+#define CPLX_MUL_RE(ar, ai, br, bi) ((ar) * (br) - (ai) * (bi))
+#define CPLX_MUL_IM(ar, ai, br, bi) ((ar) * (bi) + (ai) * (br))
+
+static int dct_bit_reverse(int x, int order)
+{
+    int r = 0;
+    for (int i = 0; i < order; i++) {
+        r = (r << 1) | ((x >> i) & 1);
+    }
+    return r;
+}
+
+// In place radix-2 complex FFT of N/2 points, with the tables of the plan
+static void dct_fft(const dct_plan_f32_t *plan, float *z)
+{
+    int M = plan->N / 2;
+    for (int i = 0; i < plan->n_swaps; i++) {
+        int a = 2 * plan->swaps[2 * i];
+        int b = 2 * plan->swaps[2 * i + 1];
+        float re = z[a];
+        float im = z[a + 1];
+        z[a] = z[b];
+        z[a + 1] = z[b + 1];
+        z[b] = re;
+        z[b + 1] = im;
+    }
+    for (int len = 2; len <= M; len <<= 1) {
+        int half = len >> 1;
+        int step = M / len;
+        for (int i = 0; i < M; i += len) {
+            for (int j = 0; j < half; j++) {
+                float wr = plan->fft_w[2 * j * step];
+                float wi = plan->fft_w[2 * j * step + 1];
+                int p = 2 * (i + j);
+                int q = p + 2 * half;
+                float tr = CPLX_MUL_RE(z[q], z[q + 1], wr, wi);
+                float ti = CPLX_MUL_IM(z[q], z[q + 1], wr, wi);
+                z[q] = z[p] - tr;
+                z[q + 1] = z[p + 1] - ti;
+                z[p] += tr;
+                z[p + 1] += ti;
+            }
+        }
+    }
+}
+
+// DCT-IV of N points: result[k] = sum(u[n] * cos(pi / N * (n + 0.5) * (k + 0.5))), with u[n] stored in work.
+// Calculated as a N/2 points complex FFT of (u[2n] + j u[N-1-2n]) e^(-jpi (n + 1/4) / N), the output
+// (after a e^(-jpi k / N) rotation) holds result[2k] as real part and -result[N-1-2k] as imaginary part.
+// Result is left in work in that format.
+static void dct_iv(const dct_plan_f32_t *plan, float *work)
+{
+    int N = plan->N;
+    int M = N / 2;
+    const float *pre = plan->mdct_w;
+    const float *post = &plan->mdct_w[N];
+    // Pairs (2n, N-1-2n) and (N-2-2n, 2n+1) share their inputs: process them together
+    for (int n = 0; n < M / 2; n++) {
+        int m = M - 1 - n;
+        float a = work[2 * n];
+        float b = work[N - 1 - 2 * n];
+        float c = work[2 * m];
+        float d = work[N - 1 - 2 * m];
+        work[2 * n] = CPLX_MUL_RE(a, b, pre[2 * n], pre[2 * n + 1]);
+        work[2 * n + 1] = CPLX_MUL_IM(a, b, pre[2 * n], pre[2 * n + 1]);
+        work[2 * m] = CPLX_MUL_RE(c, d, pre[2 * m], pre[2 * m + 1]);
+        work[2 * m + 1] = CPLX_MUL_IM(c, d, pre[2 * m], pre[2 * m + 1]);
+    }
+    dct_fft(plan, work);
+    for (int k = 0; k < M; k++) {
+        float re = work[2 * k];
+        float im = work[2 * k + 1];
+        work[2 * k] = CPLX_MUL_RE(re, im, post[2 * k], post[2 * k + 1]);
+        work[2 * k + 1] = CPLX_MUL_IM(re, im, post[2 * k], post[2 * k + 1]);
+    }
+}
+
+// Writes u[m] of the DCT-IV output in the two places of the 2N points IMDCT output
+static inline void imdct_unfold(float *result, int M, int m, float u)
+{
+    if (m >= M) {
+        result[m - M] = u;
+        result[3 * M - 1 - m] = -u;
+    } else {
+        result[3 * M - 1 - m] = -u;
+        result[m + 3 * M] = -u;
+    }
+}
+
+esp_err_t dsps_dct_plan_init_f32(dct_plan_f32_t *plan, int N)
+{
+    if (NULL == plan) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    if ((N < 4) || !dsp_is_power_of_two(N) || (N > 0x10000)) {
+        return ESP_ERR_DSP_INVALID_LENGTH;
+    }
+    int M = N / 2;
+    int order = dsp_power_of_two(M);
+    int n_swaps = 0;
+    for (int i = 0; i < M; i++) {
+        if (i < dct_bit_reverse(i, order)) {
+            n_swaps++;
+        }
+    }
+    // All the tables in one block: fft_w (M / 2), split_w (M / 2 + 1), dct_w (M + 1), mdct_w (2M) complex
+    // values, followed by the swaps
+    int n_floats = M + (M + 2) + 2 * (M + 1) + 4 * M;
+    float *mem = (float *)malloc(n_floats * sizeof(float) + 2 * n_swaps * sizeof(uint16_t));
+    if (mem == NULL) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    plan->N = N;
+    plan->fft_w = mem;
+    plan->split_w = &plan->fft_w[M];
+    plan->dct_w = &plan->split_w[M + 2];
+    plan->mdct_w = &plan->dct_w[2 * (M + 1)];
+    plan->swaps = (uint16_t *)&mem[n_floats];
+    plan->n_swaps = n_swaps;
+    // Angles in double precision: the tables are calculated once
+    for (int k = 0; k < M / 2; k++) {
+        plan->fft_w[2 * k] = cos(2 * M_PI * k / M);
+        plan->fft_w[2 * k + 1] = -sin(2 * M_PI * k / M);
+    }
+    for (int k = 0; k <= M / 2; k++) {
+        plan->split_w[2 * k] = cos(2 * M_PI * k / N);
+        plan->split_w[2 * k + 1] = -sin(2 * M_PI * k / N);
+    }
+    for (int k = 0; k <= M; k++) {
+        plan->dct_w[2 * k] = cos(M_PI * k / (2 * N));
+        plan->dct_w[2 * k + 1] = -sin(M_PI * k / (2 * N));
+    }
+    for (int k = 0; k < M; k++) {
+        plan->mdct_w[2 * k] = cos(M_PI * (k + 0.25) / N);
+        plan->mdct_w[2 * k + 1] = -sin(M_PI * (k + 0.25) / N);
+        plan->mdct_w[N + 2 * k] = cos(M_PI * k / N);
+        plan->mdct_w[N + 2 * k + 1] = -sin(M_PI * k / N);
+    }
+    n_swaps = 0;
+    for (int i = 0; i < M; i++) {
+        int j = dct_bit_reverse(i, order);
+        if (i < j) {
+            plan->swaps[2 * n_swaps] = i;
+            plan->swaps[2 * n_swaps + 1] = j;
+            n_swaps++;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t dsps_dct_plan_free_f32(dct_plan_f32_t *plan)
+{
+    free(plan->fft_w);
+    plan->fft_w = NULL;
+    plan->N = 0;
+    return ESP_OK;
+}
+
+esp_err_t dsps_dct_plan_f32(const dct_plan_f32_t *plan, const float *data, float *result, float *work)
+{
+    if ((NULL == plan) || (NULL == plan->fft_w) || (NULL == data) || (NULL == result) || (NULL == work)) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    int N = plan->N;
+    int M = N / 2;
+    // Even samples in order followed by odd samples reversed, as the real and imaginary parts of a N/2
+    // points complex array
+    for (int n = 0; n < M; n++) {
+        work[n] = data[2 * n];
+        work[N - 1 - n] = data[2 * n + 1];
+    }
+    dct_fft(plan, work);
+    // Spectrum V of the N points real sequence from the N/2 points complex one, then
+    // result[k] = Re(V[k] e^(-jpi k/(2N))) and result[N-k] = -Im(V[k] e^(-jpi k/(2N)))
+    float z0_re = work[0];
+    float z0_im = work[1];
+    result[0] = z0_re + z0_im;
+    result[M] = (z0_re - z0_im) * plan->dct_w[2 * M];
+    for (int k = 1; k <= M / 2; k++) {
+        int m = M - k;
+        float e_re = 0.5f * (work[2 * k] + work[2 * m]);
+        float e_im = 0.5f * (work[2 * k + 1] - work[2 * m + 1]);
+        float o_re = 0.5f * (work[2 * k + 1] + work[2 * m + 1]);
+        float o_im = -0.5f * (work[2 * k] - work[2 * m]);
+        float t_re = CPLX_MUL_RE(o_re, o_im, plan->split_w[2 * k], plan->split_w[2 * k + 1]);
+        float t_im = CPLX_MUL_IM(o_re, o_im, plan->split_w[2 * k], plan->split_w[2 * k + 1]);
+        // V[k] = E + w O, V[M-k] = conj(E - w O)
+        float vk_re = e_re + t_re;
+        float vk_im = e_im + t_im;
+        float vm_re = e_re - t_re;
+        float vm_im = t_im - e_im;
+        result[k] = CPLX_MUL_RE(vk_re, vk_im, plan->dct_w[2 * k], plan->dct_w[2 * k + 1]);
+        result[N - k] = -CPLX_MUL_IM(vk_re, vk_im, plan->dct_w[2 * k], plan->dct_w[2 * k + 1]);
+        result[m] = CPLX_MUL_RE(vm_re, vm_im, plan->dct_w[2 * m], plan->dct_w[2 * m + 1]);
+        result[N - m] = -CPLX_MUL_IM(vm_re, vm_im, plan->dct_w[2 * m], plan->dct_w[2 * m + 1]);
+    }
+    return ESP_OK;
+}
+
+esp_err_t dsps_dct_inv_plan_f32(const dct_plan_f32_t *plan, const float *data, float *result, float *work)
+{
+    if ((NULL == plan) || (NULL == plan->fft_w) || (NULL == data) || (NULL == result) || (NULL == work)) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    int N = plan->N;
+    int M = N / 2;
+    // V[k] = (data[k] - j data[N-k]) e^(jpi k/(2N)) is the spectrum of the N points real sequence, whose
+    // even and odd samples are obtained with a N/2 points complex inverse FFT of
+    // Z[k] = (V[k] + conj(V[M-k])) + j e^(j2pi k/N) (V[k] - conj(V[M-k])).
+    // The inverse FFT is calculated as conj(FFT(conj(Z))): work holds conj(Z).
+    float v0 = data[0];
+    float vm = data[M] * 2 * plan->dct_w[2 * M];
+    work[0] = v0 + vm;
+    work[1] = -(v0 - vm);
+    for (int k = 1; k <= M / 2; k++) {
+        int m = M - k;
+        float vk_re = CPLX_MUL_RE(data[k], -data[N - k], plan->dct_w[2 * k], -plan->dct_w[2 * k + 1]);
+        float vk_im = CPLX_MUL_IM(data[k], -data[N - k], plan->dct_w[2 * k], -plan->dct_w[2 * k + 1]);
+        float vm_re = CPLX_MUL_RE(data[m], -data[N - m], plan->dct_w[2 * m], -plan->dct_w[2 * m + 1]);
+        float vm_im = CPLX_MUL_IM(data[m], -data[N - m], plan->dct_w[2 * m], -plan->dct_w[2 * m + 1]);
+        // E = V[k] + conj(V[M-k]), D = V[k] - conj(V[M-k]), Z[k] = E + j w* D, Z[M-k] = conj(E) + j w conj(D)
+        // (the twiddle of M-k is -w, with w = e^(-j2pi k/N))
+        float e_re = vk_re + vm_re;
+        float e_im = vk_im - vm_im;
+        float d_re = vk_re - vm_re;
+        float d_im = vk_im + vm_im;
+        float w_re = plan->split_w[2 * k];
+        float w_im = plan->split_w[2 * k + 1];
+        float t_re = CPLX_MUL_RE(d_re, d_im, w_re, -w_im);
+        float t_im = CPLX_MUL_IM(d_re, d_im, w_re, -w_im);
+        float u_re = CPLX_MUL_RE(d_re, -d_im, w_re, w_im);
+        float u_im = CPLX_MUL_IM(d_re, -d_im, w_re, w_im);
+        work[2 * k] = e_re - t_im;
+        work[2 * k + 1] = -(e_im + t_re);
+        work[2 * m] = e_re - u_im;
+        work[2 * m + 1] = -(-e_im + u_re);
+    }
+    dct_fft(plan, work);
+    // Even samples in order and odd samples reversed, the imaginary parts (odd positions) conjugated back
+    for (int n = 0; n < M; n++) {
+        int i = N - 1 - n;
+        result[2 * n] = (n & 1) ? -0.5f * work[n] : 0.5f * work[n];
+        result[2 * n + 1] = (i & 1) ? -0.5f * work[i] : 0.5f * work[i];
+    }
+    return ESP_OK;
+}
+
+esp_err_t dsps_mdct_f32(const dct_plan_f32_t *plan, const float *data, const float *window, float *result, float *work)
+{
+    if ((NULL == plan) || (NULL == plan->fft_w) || (NULL == data) || (NULL == result) || (NULL == work)) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    int N = plan->N;
+    int M = N / 2;
+    // Windowed input (a, b, c, d) folded into the DCT-IV input (-c_r - d, a - b_r)
+    for (int n = 0; n < M; n++) {
+        int c = 3 * M - 1 - n;
+        int d = 3 * M + n;
+        int b = N - 1 - n;
+        if (window != NULL) {
+            work[n] = -data[c] * window[c] - data[d] * window[d];
+            work[M + n] = data[n] * window[n] - data[b] * window[b];
+        } else {
+            work[n] = -data[c] - data[d];
+            work[M + n] = data[n] - data[b];
+        }
+    }
+    dct_iv(plan, work);
+    for (int k = 0; k < M; k++) {
+        result[2 * k] = work[2 * k];
+        result[N - 1 - 2 * k] = -work[2 * k + 1];
+    }
+    return ESP_OK;
+}
+
+esp_err_t dsps_imdct_f32(const dct_plan_f32_t *plan, const float *data, const float *window, float *result, float *work)
+{
+    if ((NULL == plan) || (NULL == plan->fft_w) || (NULL == data) || (NULL == result) || (NULL == work)) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    int N = plan->N;
+    int M = N / 2;
+    for (int n = 0; n < N; n++) {
+        work[n] = data[n];
+    }
+    dct_iv(plan, work);
+    // DCT-IV output u unfolded into (u[M..N), -u_r[M..N), -u_r[0..M), -u[0..M)), scaled by 2/N
+    float scale = 2.0f / N;
+    for (int k = 0; k < M; k++) {
+        imdct_unfold(result, M, 2 * k, work[2 * k] * scale);
+        imdct_unfold(result, M, N - 1 - 2 * k, -work[2 * k + 1] * scale);
+    }
+    if (window != NULL) {
+        for (int n = 0; n < 2 * N; n++) {
+            result[n] *= window[n];
+        }
+    }
+    return ESP_OK;
+}
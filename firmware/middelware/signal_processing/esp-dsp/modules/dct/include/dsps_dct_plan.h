@@ -0,0 +1,155 @@
+// Copyright 2018-2020 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _dsps_dct_plan_H_
+#define _dsps_dct_plan_H_
+#include <stdint.h>
+#include "dsp_err.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Data struct of a DCT / MDCT plan
+ *
+ * Tables needed by the transforms of one size. The plan does not use the global FFT tables
+ * (dsps_fft2r_init_fc32 is not needed) and is not modified by the transforms: several tasks can
+ * use the same plan, each one with its own work buffer.
+ * All fields of this structure are initialized by the dsps_dct_plan_init_f32(...) function.
+ */
+typedef struct dct_plan_f32_s {
+    int       N;            /*!< Transform size: DCT of N points, MDCT of 2N inputs and N outputs.*/
+    float    *fft_w;        /*!< N/2 points complex FFT twiddles, e^(-j2pi k/(N/2)), k < N/4.*/
+    float    *split_w;      /*!< Real FFT split twiddles, e^(-j2pi k/N), k <= N/4.*/
+    float    *dct_w;        /*!< DCT twiddles, e^(-jpi k/(2N)), k <= N/2.*/
+    float    *mdct_w;       /*!< DCT-IV twiddles, e^(-jpi (k + 1/4)/N) and e^(-jpi k/N), k < N/2.*/
+    uint16_t *swaps;        /*!< Pairs of indexes exchanged by the bit reversal.*/
+    int       n_swaps;      /*!< Number of pairs in swaps.*/
+} dct_plan_f32_t;
+
+/**@{*/
+/**
+ * @brief   initialize a DCT / MDCT plan
+ *
+ * Allocates and calculates the tables of a size.
+ *
+ * @param plan: pointer to plan structure, that must be preallocated
+ * @param N: transform size, power of two (>= 4)
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - One of the error codes from DSP library
+ */
+esp_err_t dsps_dct_plan_init_f32(dct_plan_f32_t *plan, int N);
+
+/**
+ * @brief   support arrays freeing function
+ *
+ * Function frees the tables allocated by dsps_dct_plan_init_f32.
+ *
+ * @param plan: pointer to plan structure, that must be initialized before
+ *
+ * @return
+ *      - ESP_OK on success
+ */
+esp_err_t dsps_dct_plan_free_f32(dct_plan_f32_t *plan);
+/**@}*/
+
+/**@{*/
+/**
+ * @brief      DCT type II, unscaled (same result as dsps_dct_f32)
+ *
+ * result[k] = sum(data[n] * cos(pi / N * (n + 0.5) * k))
+ * Calculated with a N/2 points complex FFT.
+ *
+ * Precision (random input, N = 16 to 4096): the error against a double precision DCT is
+ * below 2e-7 of the largest output. dsps_dct_f32_ref sums in float, so it differs from
+ * this function by up to 3e-4 of the largest output at N = 4096 (its own error).
+ *
+ * @param[in] plan: plan of the transform size
+ * @param[in] data: input array with size of N
+ * @param[out] result: output array with size of N (may be the same as data)
+ * @param work: work array with size of N
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - One of the error codes from DSP library
+ */
+esp_err_t dsps_dct_plan_f32(const dct_plan_f32_t *plan, const float *data, float *result, float *work);
+
+/**
+ * @brief      Inverse DCT (type III), unscaled (same result as dsps_dct_inv_f32)
+ *
+ * result[n] = data[0] / 2 + sum(data[k] * cos(pi / N * (n + 0.5) * k)), k = 1..N-1:
+ * the DCT followed by the inverse DCT multiplies the signal by N/2.
+ *
+ * @param[in] plan: plan of the transform size
+ * @param[in] data: input array with size of N
+ * @param[out] result: output array with size of N (may be the same as data)
+ * @param work: work array with size of N
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - One of the error codes from DSP library
+ */
+esp_err_t dsps_dct_inv_plan_f32(const dct_plan_f32_t *plan, const float *data, float *result, float *work);
+/**@}*/
+
+/**@{*/
+/**
+ * @brief      Windowed MDCT
+ *
+ * result[k] = sum(window[n] * data[n] * cos(pi / N * (n + 0.5 + N / 2) * (k + 0.5))), n = 0..2N-1
+ * Consecutive blocks must overlap by N samples. With a window that meets
+ * window[n]^2 + window[n + N]^2 = 1 (e.g. sine window: sin(pi / (2N) * (n + 0.5))) the overlap-add of
+ * the dsps_imdct_f32 outputs gives the signal back.
+ *
+ * @param[in] plan: plan of the transform size
+ * @param[in] data: input array with size of 2N
+ * @param[in] window: window with size of 2N, NULL for a rectangular window
+ * @param[out] result: output array with size of N
+ * @param work: work array with size of N
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - One of the error codes from DSP library
+ */
+esp_err_t dsps_mdct_f32(const dct_plan_f32_t *plan, const float *data, const float *window, float *result, float *work);
+
+/**
+ * @brief      Windowed inverse MDCT
+ *
+ * result[n] = window[n] * 2 / N * sum(data[k] * cos(pi / N * (n + 0.5 + N / 2) * (k + 0.5))), n = 0..2N-1
+ * The first N samples of the result must be added to the last N of the previous block.
+ *
+ * @param[in] plan: plan of the transform size
+ * @param[in] data: input array with size of N
+ * @param[in] window: window with size of 2N, NULL for a rectangular window
+ * @param[out] result: output array with size of 2N
+ * @param work: work array with size of N
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - One of the error codes from DSP library
+ */
+esp_err_t dsps_imdct_f32(const dct_plan_f32_t *plan, const float *data, const float *window, float *result, float *work);
+/**@}*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _dsps_dct_plan_H_
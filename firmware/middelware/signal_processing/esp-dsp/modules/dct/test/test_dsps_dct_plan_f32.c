@@ -0,0 +1,166 @@
+// Copyright 2018-2020 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string.h>
+#include "unity.h"
+#include "dsp_platform.h"
+#include "esp_log.h"
+
+#include "dsps_dct.h"
+#include "dsps_dct_plan.h"
+#include "dsps_fft2r.h"
+#include "dsp_tests.h"
+#include <malloc.h>
+
+
+static const char *TAG = "dsps_dct_plan";
+
+TEST_CASE("dsps_dct_plan_f32 functionality", "[dsps]")
+{
+    float *data = calloc(1024, sizeof(float));
+    TEST_ASSERT_NOT_NULL(data);
+    float *data_ref = calloc(1024, sizeof(float));
+    TEST_ASSERT_NOT_NULL(data_ref);
+    float *result = calloc(1024, sizeof(float));
+    TEST_ASSERT_NOT_NULL(result);
+    float *work = calloc(1024, sizeof(float));
+    TEST_ASSERT_NOT_NULL(work);
+
+    // The plans do not need the FFT tables
+    for (int N = 4; N <= 1024; N *= 2) {
+        dct_plan_f32_t plan;
+        esp_err_t ret = dsps_dct_plan_init_f32(&plan, N);
+        TEST_ESP_OK(ret);
+        for (int i = 0 ; i < N ; i++) {
+            data[i] = (float)rand() / INT32_MAX - 0.5;
+        }
+        dsps_dct_f32_ref(data, N, data_ref);
+        ret = dsps_dct_plan_f32(&plan, data, result, work);
+        TEST_ESP_OK(ret);
+        float abs_tol = 1e-5;
+        for (size_t i = 0; i < N; i++) {
+            float error = fabs(result[i] - data_ref[i]) / (N / 2);
+            if (error > abs_tol) {
+                ESP_LOGE(TAG, "N = %i, DCT data[%i] = %f, ref = %f, error = %f\n", N, i, result[i], data_ref[i], error);
+                TEST_ASSERT_MESSAGE (false, "Result out of range!\n");
+            }
+        }
+        // In place inverse: N/2 times the input
+        ret = dsps_dct_inv_plan_f32(&plan, result, result, work);
+        TEST_ESP_OK(ret);
+        for (size_t i = 0; i < N; i++) {
+            float error = fabs(data[i] - result[i] / N * 2);
+            if (error > abs_tol) {
+                ESP_LOGE(TAG, "N = %i, IDCT data[%i] = %f, result = %f, error = %f\n", N, i, data[i], result[i] / N * 2, error);
+                TEST_ASSERT_MESSAGE (false, "Result out of range!\n");
+            }
+        }
+        dsps_dct_plan_free_f32(&plan);
+    }
+    free(data);
+    free(data_ref);
+    free(result);
+    free(work);
+}
+
+TEST_CASE("dsps_mdct_f32 functionality", "[dsps]")
+{
+    int N = 128;
+    int len = 16 * N;
+    float *data = calloc(len, sizeof(float));
+    TEST_ASSERT_NOT_NULL(data);
+    float *result = calloc(len + N, sizeof(float));
+    TEST_ASSERT_NOT_NULL(result);
+    float *window = calloc(2 * N, sizeof(float));
+    TEST_ASSERT_NOT_NULL(window);
+    float *coeffs = calloc(N, sizeof(float));
+    TEST_ASSERT_NOT_NULL(coeffs);
+    float *block = calloc(2 * N, sizeof(float));
+    TEST_ASSERT_NOT_NULL(block);
+    float *work = calloc(N, sizeof(float));
+    TEST_ASSERT_NOT_NULL(work);
+
+    dct_plan_f32_t plan;
+    esp_err_t ret = dsps_dct_plan_init_f32(&plan, N);
+    TEST_ESP_OK(ret);
+    for (int i = 0 ; i < len ; i++) {
+        data[i] = (float)rand() / INT32_MAX - 0.5;
+    }
+    for (int i = 0 ; i < 2 * N ; i++) {
+        window[i] = sinf(M_PI / (2 * N) * (i + 0.5));
+    }
+    // Overlap-add of the blocks gives the signal back, except the first and last N samples
+    for (int pos = 0; pos + 2 * N <= len; pos += N) {
+        ret = dsps_mdct_f32(&plan, &data[pos], window, coeffs, work);
+        TEST_ESP_OK(ret);
+        ret = dsps_imdct_f32(&plan, coeffs, window, block, work);
+        TEST_ESP_OK(ret);
+        for (int i = 0; i < 2 * N; i++) {
+            result[pos + i] += block[i];
+        }
+    }
+    float abs_tol = 1e-5;
+    for (int i = N; i < len - N; i++) {
+        float error = fabs(data[i] - result[i]);
+        if (error > abs_tol) {
+            ESP_LOGE(TAG, "data[%i] = %f, result = %f, error = %f\n", i, data[i], result[i], error);
+            TEST_ASSERT_MESSAGE (false, "Result out of range!\n");
+        }
+    }
+    dsps_dct_plan_free_f32(&plan);
+    free(data);
+    free(result);
+    free(window);
+    free(coeffs);
+    free(block);
+    free(work);
+}
+
+TEST_CASE("dsps_dct_plan_f32 benchmark", "[dsps]")
+{
+    esp_err_t ret = dsps_fft2r_init_fc32(NULL, CONFIG_DSP_MAX_FFT_SIZE);
+    TEST_ESP_OK(ret);
+
+    float *data = calloc(1024 * 2, sizeof(float));
+    TEST_ASSERT_NOT_NULL(data);
+    float *work = calloc(1024, sizeof(float));
+    TEST_ASSERT_NOT_NULL(work);
+
+    for (int N = 64; N <= 1024; N *= 4) {
+        dct_plan_f32_t plan;
+        ret = dsps_dct_plan_init_f32(&plan, N);
+        TEST_ESP_OK(ret);
+        for (int i = 0 ; i < N ; i++) {
+            data[i] = 2 * sin(M_PI / N * 4 * 2 * i);
+        }
+
+        unsigned int start_b = xthal_get_ccount();
+        ret = dsps_dct_f32(data, N);
+        unsigned int end_b = xthal_get_ccount();
+        TEST_ESP_OK(ret);
+        int cycles_fft = end_b - start_b;
+
+        start_b = xthal_get_ccount();
+        ret = dsps_dct_plan_f32(&plan, data, data, work);
+        end_b = xthal_get_ccount();
+        TEST_ESP_OK(ret);
+        int cycles_plan = end_b - start_b;
+
+        ESP_LOGI(TAG, "Benchmark %4i points: dsps_dct_f32 - %6i cycles, dsps_dct_plan_f32 - %6i cycles.", N, cycles_fft, cycles_plan);
+        dsps_dct_plan_free_f32(&plan);
+    }
+    dsps_fft2r_deinit_fc32();
+    free(data);
+    free(work);
+}
@@ -82,6 +82,25 @@ esp_err_t dsps_fft4r_init_fc32(float *fft_table_buff, int max_fft_size)
     return ESP_OK;
 }
 
+esp_err_t dsps_fft4r_init_const_fc32(const float *fft_table, int max_fft_size)
+{
+    if (dsps_fft4r_initialized != 0) {
+        return ESP_OK;
+    }
+    if ((fft_table == NULL) || (max_fft_size > CONFIG_DSP_MAX_FFT_SIZE)) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    if (dsps_fft4r_mem_allocated) {
+        return ESP_ERR_DSP_REINITIALIZED;
+    }
+    // The table is only read by the FFT
+    dsps_fft4r_w_table_fc32 = (float *)fft_table;
+    dsps_fft4r_w_table_size = max_fft_size * 2;
+    dsps_fft4r_initialized = 1;
+
+    return ESP_OK;
+}
+
 void dsps_fft4r_deinit_fc32()
 {
     if (dsps_fft4r_mem_allocated) {
@@ -0,0 +1,83 @@
+// Copyright 2018-2023 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdint.h>
+#include "dsps_fft2r.h"
+#include "dsps_fft_tables.h"
+#include "dsp_const_tables.h"
+
+// Coefficients tables of the FFT, calculated by the compiler (see dsp_const_tables.h).
+// Every table is a separate symbol, so only the tables used by the application are linked
+// (-fdata-sections and --gc-sections), and only sizes up to CONFIG_DSP_MAX_FFT_SIZE are defined.
+
+// Same as dsps_gen_w_r2_fc32(w, N) followed by dsps_bit_rev_fc32_ansi(w, N >> 1)
+static constexpr float dsps_w2r_fc32(int N, int i)
+{
+    int k = dsp_const::reverse(i >> 1, dsp_const::power_of_two(N >> 1));
+    double angle = 2 * dsp_const::pi * k / N;
+    return (i & 1) ? (float)dsp_const::sin(angle) : (float)dsp_const::cos(angle);
+}
+
+// Same as the table of dsps_fft4r_init_fc32(NULL, max_fft_size): 2 * max_fft_size complex
+// values, N = 4 * max_fft_size floats
+static constexpr float dsps_w4r_fc32(int N, int i)
+{
+    double angle = 2 * dsp_const::pi * (i >> 1) / (N >> 1);
+    return (i & 1) ? (float)dsp_const::sin(angle) : (float)dsp_const::cos(angle);
+}
+
+#if CONFIG_DSP_MAX_FFT_SIZE >= 16
+extern "C" constexpr float w2r_table_16_fc32[16] = {DSP_TABLE_REPEAT_16(dsps_w2r_fc32, 16, 0)};
+extern "C" constexpr float w4r_table_16_fc32[64] = {DSP_TABLE_REPEAT_64(dsps_w4r_fc32, 64, 0)};
+#endif // CONFIG_DSP_MAX_FFT_SIZE >= 16
+
+#if CONFIG_DSP_MAX_FFT_SIZE >= 32
+extern "C" constexpr float w2r_table_32_fc32[32] = {DSP_TABLE_REPEAT_32(dsps_w2r_fc32, 32, 0)};
+extern "C" constexpr float w4r_table_32_fc32[128] = {DSP_TABLE_REPEAT_128(dsps_w4r_fc32, 128, 0)};
+#endif // CONFIG_DSP_MAX_FFT_SIZE >= 32
+
+#if CONFIG_DSP_MAX_FFT_SIZE >= 64
+extern "C" constexpr float w2r_table_64_fc32[64] = {DSP_TABLE_REPEAT_64(dsps_w2r_fc32, 64, 0)};
+extern "C" constexpr float w4r_table_64_fc32[256] = {DSP_TABLE_REPEAT_256(dsps_w4r_fc32, 256, 0)};
+#endif // CONFIG_DSP_MAX_FFT_SIZE >= 64
+
+#if CONFIG_DSP_MAX_FFT_SIZE >= 128
+extern "C" constexpr float w2r_table_128_fc32[128] = {DSP_TABLE_REPEAT_128(dsps_w2r_fc32, 128, 0)};
+extern "C" constexpr float w4r_table_128_fc32[512] = {DSP_TABLE_REPEAT_512(dsps_w4r_fc32, 512, 0)};
+#endif // CONFIG_DSP_MAX_FFT_SIZE >= 128
+
+#if CONFIG_DSP_MAX_FFT_SIZE >= 256
+extern "C" constexpr float w2r_table_256_fc32[256] = {DSP_TABLE_REPEAT_256(dsps_w2r_fc32, 256, 0)};
+extern "C" constexpr float w4r_table_256_fc32[1024] = {DSP_TABLE_REPEAT_1024(dsps_w4r_fc32, 1024, 0)};
+#endif // CONFIG_DSP_MAX_FFT_SIZE >= 256
+
+#if CONFIG_DSP_MAX_FFT_SIZE >= 512
+extern "C" constexpr float w2r_table_512_fc32[512] = {DSP_TABLE_REPEAT_512(dsps_w2r_fc32, 512, 0)};
+extern "C" constexpr float w4r_table_512_fc32[2048] = {DSP_TABLE_REPEAT_2048(dsps_w4r_fc32, 2048, 0)};
+#endif // CONFIG_DSP_MAX_FFT_SIZE >= 512
+
+#if CONFIG_DSP_MAX_FFT_SIZE >= 1024
+extern "C" constexpr float w2r_table_1024_fc32[1024] = {DSP_TABLE_REPEAT_1024(dsps_w2r_fc32, 1024, 0)};
+extern "C" constexpr float w4r_table_1024_fc32[4096] = {DSP_TABLE_REPEAT_4096(dsps_w4r_fc32, 4096, 0)};
+#endif // CONFIG_DSP_MAX_FFT_SIZE >= 1024
+
+#if CONFIG_DSP_MAX_FFT_SIZE >= 2048
+extern "C" constexpr float w2r_table_2048_fc32[2048] = {DSP_TABLE_REPEAT_2048(dsps_w2r_fc32, 2048, 0)};
+extern "C" constexpr float w4r_table_2048_fc32[8192] = {DSP_TABLE_REPEAT_8192(dsps_w4r_fc32, 8192, 0)};
+#endif // CONFIG_DSP_MAX_FFT_SIZE >= 2048
+
+#if CONFIG_DSP_MAX_FFT_SIZE >= 4096
+extern "C" constexpr float w2r_table_4096_fc32[4096] = {DSP_TABLE_REPEAT_4096(dsps_w2r_fc32, 4096, 0)};
+extern "C" constexpr float w4r_table_4096_fc32[16384] = {DSP_TABLE_REPEAT_16384(dsps_w4r_fc32, 16384, 0)};
+#endif // CONFIG_DSP_MAX_FFT_SIZE >= 4096
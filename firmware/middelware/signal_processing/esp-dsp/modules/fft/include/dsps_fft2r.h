@@ -62,6 +62,25 @@ esp_err_t dsps_fft2r_init_fc32(float *fft_table_buff, int table_size);
 esp_err_t dsps_fft2r_init_sc16(int16_t *fft_table_buff, int table_size);
 /**@}*/
 
+/**
+ * @brief      init fft with a constant table
+ *
+ * Initialization of Complex FFT with a coefficients table in flash, calculated at compile time:
+ * DSPS_FFT2R_W_TABLE_FC32(table_size), see dsps_fft_tables.h.
+ * Nothing is calculated and no memory is allocated: the bit reverse tables also stay in flash.
+ * The table serves every FFT with N <= table_size, as the table of dsps_fft2r_init_fc32.
+ * The implementation use ANSI C and could be compiled and run on any platform
+ *
+ * @param[in] fft_table: coefficients table, table_size floats
+ * @param[in] table_size: size of the table in float words
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_DSP_PARAM_OUTOFRANGE if table_size > CONFIG_DSP_MAX_FFT_SIZE or fft_table is NULL
+ *      - ESP_ERR_DSP_REINITIALIZED if buffer already allocated internally by other function
+ */
+esp_err_t dsps_fft2r_init_const_fc32(const float *fft_table, int table_size);
+
 /**@{*/
 /**
  * @brief      deinit fft tables
@@ -205,6 +224,8 @@ esp_err_t dsps_gen_bitrev2r_table(int N, int step, char *name_ext);
 #if CONFIG_DSP_OPTIMIZED
 #define dsps_bit_rev_fc32 dsps_bit_rev_fc32_ansi
 #define dsps_cplx2reC_fc32 dsps_cplx2reC_fc32_ansi
+#define dsps_bit_rev_sc16 dsps_bit_rev_sc16_ansi
+#define dsps_cplx2real_sc16 dsps_cplx2real_sc16_ansi
 
 #if (dsps_fft2r_fc32_aes3_enabled == 1)
 #define dsps_fft2r_fc32 dsps_fft2r_fc32_aes3
@@ -235,9 +256,11 @@ esp_err_t dsps_gen_bitrev2r_table(int N, int step, char *name_ext);
 #else // CONFIG_DSP_OPTIMIZED
 
 #define dsps_fft2r_fc32 dsps_fft2r_fc32_ansi
+#define dsps_fft2r_sc16 dsps_fft2r_sc16_ansi
 #define dsps_bit_rev_fc32 dsps_bit_rev_fc32_ansi
 #define dsps_cplx2reC_fc32 dsps_cplx2reC_fc32_ansi
 #define dsps_bit_rev_sc16 dsps_bit_rev_sc16_ansi
+#define dsps_cplx2real_sc16 dsps_cplx2real_sc16_ansi
 #define dsps_bit_rev_lookup_fc32 dsps_bit_rev_lookup_fc32_ansi
 
 #endif // CONFIG_DSP_OPTIMIZED
@@ -57,6 +57,24 @@ extern uint8_t dsps_fft4r_sc16_initialized;
 esp_err_t dsps_fft4r_init_fc32(float *fft_table_buff, int max_fft_size);
 /**@}*/
 
+/**
+ * @brief      init fft radix-4 with a constant table
+ *
+ * Initialization of Complex FFT Radix-4 with a coefficients table in flash, calculated at compile time:
+ * DSPS_FFT4R_W_TABLE_FC32(max_fft_size), see dsps_fft_tables.h.
+ * Nothing is calculated and no memory is allocated: the bit reverse tables also stay in flash.
+ * The implementation use ANSI C and could be compiled and run on any platform
+ *
+ * @param[in] fft_table: coefficients table, 4 * max_fft_size floats
+ * @param[in] max_fft_size: maximum fft size
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_DSP_PARAM_OUTOFRANGE if max_fft_size > CONFIG_DSP_MAX_FFT_SIZE or fft_table is NULL
+ *      - ESP_ERR_DSP_REINITIALIZED if buffer already allocated internally by other function
+ */
+esp_err_t dsps_fft4r_init_const_fc32(const float *fft_table, int max_fft_size);
+
 /**@{*/
 /**
  * @brief      deinit fft tables
@@ -82,6 +82,43 @@ void dsps_fft4r_rev_tables_init_fc32(void);
 extern uint16_t *dsps_fft4r_rev_tables_fc32[];
 extern const uint16_t dsps_fft4r_rev_tables_fc32_size[];
 
+// Coefficients tables in flash, calculated at compile time (dsps_fft_w_tables_fc32.cpp), for
+// each power of two size up to CONFIG_DSP_MAX_FFT_SIZE. Only the tables used are linked.
+// w2r_table_N_fc32: N floats, same as dsps_fft2r_init_fc32(NULL, N)
+// w4r_table_N_fc32: 4 * N floats, same as dsps_fft4r_init_fc32(NULL, N)
+extern const float w2r_table_16_fc32[];
+extern const float w4r_table_16_fc32[];
+
+extern const float w2r_table_32_fc32[];
+extern const float w4r_table_32_fc32[];
+
+extern const float w2r_table_64_fc32[];
+extern const float w4r_table_64_fc32[];
+
+extern const float w2r_table_128_fc32[];
+extern const float w4r_table_128_fc32[];
+
+extern const float w2r_table_256_fc32[];
+extern const float w4r_table_256_fc32[];
+
+extern const float w2r_table_512_fc32[];
+extern const float w4r_table_512_fc32[];
+
+extern const float w2r_table_1024_fc32[];
+extern const float w4r_table_1024_fc32[];
+
+extern const float w2r_table_2048_fc32[];
+extern const float w4r_table_2048_fc32[];
+
+extern const float w2r_table_4096_fc32[];
+extern const float w4r_table_4096_fc32[];
+
+// Table of a size given by a constant or a macro, e.g. DSPS_FFT2R_W_TABLE_FC32(CONFIG_DSP_MAX_FFT_SIZE)
+#define DSPS_FFT2R_W_TABLE_FC32(N) DSPS_FFT_W_TABLE_FC32_(w2r, N)
+#define DSPS_FFT4R_W_TABLE_FC32(N) DSPS_FFT_W_TABLE_FC32_(w4r, N)
+#define DSPS_FFT_W_TABLE_FC32_(type, N) DSPS_FFT_W_TABLE_FC32__(type, N)
+#define DSPS_FFT_W_TABLE_FC32__(type, N) type##_table_##N##_fc32
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,150 @@
+// Copyright 2018-2023 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string.h>
+#include <stdio.h>
+#include "unity.h"
+#include "esp_dsp.h"
+#include "dsp_platform.h"
+#include "esp_log.h"
+#include <malloc.h>
+
+#include "dsps_fft2r.h"
+#include "dsps_fft4r.h"
+#include "dsp_tests.h"
+
+static const char *TAG = "dsps_fft_tables";
+
+// Only the tables up to CONFIG_DSP_MAX_FFT_SIZE are defined
+#if CONFIG_DSP_MAX_FFT_SIZE >= 1024
+#define W_TABLE_1024(type) , DSPS_FFT_W_TABLE_FC32_(type, 1024)
+#else
+#define W_TABLE_1024(type)
+#endif
+#if CONFIG_DSP_MAX_FFT_SIZE >= 2048
+#define W_TABLE_2048(type) , DSPS_FFT_W_TABLE_FC32_(type, 2048)
+#else
+#define W_TABLE_2048(type)
+#endif
+#if CONFIG_DSP_MAX_FFT_SIZE >= 4096
+#define W_TABLE_4096(type) , DSPS_FFT_W_TABLE_FC32_(type, 4096)
+#else
+#define W_TABLE_4096(type)
+#endif
+
+#define W_TABLES(type) { \
+    DSPS_FFT_W_TABLE_FC32_(type, 16), DSPS_FFT_W_TABLE_FC32_(type, 32), DSPS_FFT_W_TABLE_FC32_(type, 64), \
+    DSPS_FFT_W_TABLE_FC32_(type, 128), DSPS_FFT_W_TABLE_FC32_(type, 256), DSPS_FFT_W_TABLE_FC32_(type, 512) \
+    W_TABLE_1024(type) W_TABLE_2048(type) W_TABLE_4096(type)}
+
+// The tables in flash are the same as the tables calculated by the init functions
+TEST_CASE("dsps_fft_w_tables_fc32 functionality", "[dsps]")
+{
+    const float *w2r[] = W_TABLES(w2r);
+    const float *w4r[] = W_TABLES(w4r);
+    char message[60];
+
+    for (int pow = 4; pow <= 12; pow++) {
+        int N = 1 << pow;
+        if (N > CONFIG_DSP_MAX_FFT_SIZE) {
+            break;
+        }
+        float *table = (float *)malloc(4 * N * sizeof(float));
+        TEST_ASSERT_NOT_NULL(table);
+
+        dsps_fft2r_deinit_fc32();
+        TEST_ESP_OK(dsps_fft2r_init_fc32(table, N));
+        sprintf(message, "w2r_table_%i_fc32", N);
+        for (int i = 0; i < N; i++) {
+            TEST_ASSERT_FLOAT_WITHIN_MESSAGE(1e-6, table[i], w2r[pow - 4][i], message);
+        }
+        dsps_fft2r_deinit_fc32();
+
+        dsps_fft4r_deinit_fc32();
+        TEST_ESP_OK(dsps_fft4r_init_fc32(table, N));
+        sprintf(message, "w4r_table_%i_fc32", N);
+        for (int i = 0; i < 4 * N; i++) {
+            TEST_ASSERT_FLOAT_WITHIN_MESSAGE(1e-6, table[i], w4r[pow - 4][i], message);
+        }
+        dsps_fft4r_deinit_fc32();
+        free(table);
+    }
+}
+
+TEST_CASE("dsps_fft2r_init_const_fc32 functionality", "[dsps]")
+{
+    // Smallest CONFIG_DSP_MAX_FFT_SIZE: the table is always defined
+    const int N = 512;
+    float *data = (float *)memalign(16, sizeof(float) * N * 2);
+    TEST_ASSERT_NOT_NULL(data);
+    float *check_data = (float *)memalign(16, sizeof(float) * N * 2);
+    TEST_ASSERT_NOT_NULL(check_data);
+
+    for (int i = 0; i < N; i++) {
+        data[i * 2] = cosf(2 * M_PI * 4 / 256 * i);
+        data[i * 2 + 1] = sinf(2 * M_PI * 18 / 256 * i);
+    }
+    memcpy(check_data, data, sizeof(float) * N * 2);
+
+    // Reference: tables calculated by the init functions
+    dsps_fft2r_deinit_fc32();
+    dsps_fft4r_deinit_fc32();
+    TEST_ESP_OK(dsps_fft2r_init_fc32(NULL, CONFIG_DSP_MAX_FFT_SIZE));
+    TEST_ESP_OK(dsps_fft4r_init_fc32(NULL, N));
+    dsps_fft2r_fc32_ansi(check_data, N / 2);
+    dsps_bit_rev_fc32_ansi(check_data, N / 2);
+    dsps_cplx2real_fc32_ansi(check_data, N / 2);
+    dsps_fft2r_deinit_fc32();
+    dsps_fft4r_deinit_fc32();
+
+    // Tables in flash: no memory is allocated
+    TEST_ESP_OK(dsps_fft2r_init_const_fc32(DSPS_FFT2R_W_TABLE_FC32(CONFIG_DSP_MAX_FFT_SIZE), CONFIG_DSP_MAX_FFT_SIZE));
+    TEST_ESP_OK(dsps_fft4r_init_const_fc32(DSPS_FFT4R_W_TABLE_FC32(512), N));
+    TEST_ASSERT_EQUAL_PTR(DSPS_FFT2R_W_TABLE_FC32(CONFIG_DSP_MAX_FFT_SIZE), dsps_fft_w_table_fc32);
+    dsps_fft2r_fc32_ansi(data, N / 2);
+    dsps_bit_rev_fc32_ansi(data, N / 2);
+    dsps_cplx2real_fc32_ansi(data, N / 2);
+
+    float diff = 0;
+    for (int i = 0; i < N * 2; i++) {
+        diff = fmaxf(diff, fabsf(data[i] - check_data[i]));
+    }
+    ESP_LOGI(TAG, "max diff = %g", diff);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3, 0, diff);
+
+    dsps_fft2r_deinit_fc32();
+    dsps_fft4r_deinit_fc32();
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_PARAM_OUTOFRANGE, dsps_fft2r_init_const_fc32(NULL, 512));
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_PARAM_OUTOFRANGE, dsps_fft2r_init_const_fc32(DSPS_FFT2R_W_TABLE_FC32(512), CONFIG_DSP_MAX_FFT_SIZE * 2));
+
+    free(data);
+    free(check_data);
+}
+
+TEST_CASE("dsps_fft2r_init_const_fc32 benchmark", "[dsps]")
+{
+    dsps_fft2r_deinit_fc32();
+    unsigned int start_b = xthal_get_ccount();
+    dsps_fft2r_init_fc32(NULL, CONFIG_DSP_MAX_FFT_SIZE);
+    unsigned int cycles_init = xthal_get_ccount() - start_b;
+    dsps_fft2r_deinit_fc32();
+
+    start_b = xthal_get_ccount();
+    dsps_fft2r_init_const_fc32(DSPS_FFT2R_W_TABLE_FC32(CONFIG_DSP_MAX_FFT_SIZE), CONFIG_DSP_MAX_FFT_SIZE);
+    unsigned int cycles_const = xthal_get_ccount() - start_b;
+    dsps_fft2r_deinit_fc32();
+
+    ESP_LOGI(TAG, "%i points table: dsps_fft2r_init_fc32 - %u cycles, dsps_fft2r_init_const_fc32 - %u cycles",
+             CONFIG_DSP_MAX_FFT_SIZE, cycles_init, cycles_const);
+}
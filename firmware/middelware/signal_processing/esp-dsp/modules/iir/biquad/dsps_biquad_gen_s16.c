@@ -0,0 +1,58 @@
+// Copyright 2018-2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dsps_biquad_gen.h"
+#include <math.h>
+#include <stdbool.h>
+
+// Sum of the absolute values of the coefficients of a section: with Q15 inputs and outputs
+// the accumulator of dsps_biquad_sos_s16 stays under 2^31
+#define DSPS_BIQUAD_S16_SUM_MAX 65535
+
+esp_err_t dsps_biquad_sos_quant_s16(const float *coef, int16_t *coef_q, int n_sos)
+{
+    for (int s = 0 ; s < n_sos ; s++) {
+        const float *c = &coef[s * 5];
+        int16_t *q = &coef_q[s * 6];
+        int shift;
+        for (shift = 15 ; shift >= 0 ; shift--) {
+            int32_t sum = 0;
+            bool fits = true;
+            for (int i = 0 ; i < 5 ; i++) {
+                int32_t value = (int32_t)lroundf(c[i] * (1 << shift));
+                if ((value > INT16_MAX) || (value < INT16_MIN)) {
+                    fits = false;
+                    break;
+                }
+                q[i] = value;
+                sum += (value < 0) ? -value : value;
+            }
+            if (fits && (sum <= DSPS_BIQUAD_S16_SUM_MAX)) {
+                break;
+            }
+        }
+        if (shift < 0) {
+            return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+        }
+        q[5] = shift;
+        // Stability triangle of the quantized poles: |a2| < 1, |a1| < 1 + a2
+        int32_t one = 1 << shift;
+        int32_t a1 = q[3];
+        int32_t a2 = q[4];
+        if ((a2 >= one) || (a2 <= -one) || (a1 >= one + a2) || (-a1 >= one + a2)) {
+            return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+        }
+    }
+    return ESP_OK;
+}
@@ -0,0 +1,88 @@
+// Copyright 2018-2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "dsps_biquad.h"
+
+// Maximum number of sections processed by the unrolled kernels
+#define DSPS_BIQUAD_SOS_UNROLL_MAX 8
+
+// All sections of the cascade are processed for one sample before moving to the next one.
+// With n_sos known at compile time the compiler unrolls the section loop and keeps
+// the delay lines and the intermediate results in registers.
+static inline __attribute__((always_inline)) void dsps_biquad_sos_f32_kernel(const float *input, float *output, int len, const float *coef, float *w, const int n_sos, int step)
+{
+    float w0[DSPS_BIQUAD_SOS_UNROLL_MAX];
+    float w1[DSPS_BIQUAD_SOS_UNROLL_MAX];
+    for (int s = 0 ; s < n_sos ; s++) {
+        w0[s] = w[s * 2 + 0];
+        w1[s] = w[s * 2 + 1];
+    }
+    for (int i = 0 ; i < len ; i++) {
+        float x = input[i * step];
+        for (int s = 0 ; s < n_sos ; s++) {
+            const float *c = &coef[s * 5];
+            float d0 = x - c[3] * w0[s] - c[4] * w1[s];
+            x = c[0] * d0 +  c[1] * w0[s] + c[2] * w1[s];
+            w1[s] = w0[s];
+            w0[s] = d0;
+        }
+        output[i * step] = x;
+    }
+    for (int s = 0 ; s < n_sos ; s++) {
+        w[s * 2 + 0] = w0[s];
+        w[s * 2 + 1] = w1[s];
+    }
+}
+
+esp_err_t dsps_biquad_sos_f32_ansi(const float *input, float *output, int len, float *coef, float *w, int n_sos, int step)
+{
+    if ((n_sos <= 0) || (step <= 0)) {
+        return ESP_ERR_DSP_INVALID_PARAM;
+    }
+    switch (n_sos) {
+    case 1:
+        dsps_biquad_sos_f32_kernel(input, output, len, coef, w, 1, step);
+        break;
+    case 2:
+        dsps_biquad_sos_f32_kernel(input, output, len, coef, w, 2, step);
+        break;
+    case 3:
+        dsps_biquad_sos_f32_kernel(input, output, len, coef, w, 3, step);
+        break;
+    case 4:
+        dsps_biquad_sos_f32_kernel(input, output, len, coef, w, 4, step);
+        break;
+    case 5:
+        dsps_biquad_sos_f32_kernel(input, output, len, coef, w, 5, step);
+        break;
+    case 6:
+        dsps_biquad_sos_f32_kernel(input, output, len, coef, w, 6, step);
+        break;
+    case 7:
+        dsps_biquad_sos_f32_kernel(input, output, len, coef, w, 7, step);
+        break;
+    case 8:
+        dsps_biquad_sos_f32_kernel(input, output, len, coef, w, 8, step);
+        break;
+    default:
+        // Longer cascades: run blocks of DSPS_BIQUAD_SOS_UNROLL_MAX sections in place
+        dsps_biquad_sos_f32_kernel(input, output, len, coef, w, DSPS_BIQUAD_SOS_UNROLL_MAX, step);
+        return dsps_biquad_sos_f32_ansi(output, output, len,
+                                        &coef[DSPS_BIQUAD_SOS_UNROLL_MAX * 5],
+                                        &w[DSPS_BIQUAD_SOS_UNROLL_MAX * 2],
+                                        n_sos - DSPS_BIQUAD_SOS_UNROLL_MAX, step);
+    }
+    return ESP_OK;
+}
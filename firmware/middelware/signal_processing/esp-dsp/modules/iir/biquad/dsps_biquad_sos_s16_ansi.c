@@ -0,0 +1,109 @@
+// Copyright 2018-2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "dsps_biquad.h"
+
+// Maximum number of sections processed by the unrolled kernels
+#define DSPS_BIQUAD_SOS_UNROLL_MAX 8
+
+// Direct form I: the state is the last inputs and outputs of each section, all of them Q15,
+// so there are no internal signals that could overflow. Same loop order as dsps_biquad_sos_f32.
+static inline __attribute__((always_inline)) void dsps_biquad_sos_s16_kernel(const int16_t *input, int16_t *output, int len, const int16_t *coef, int32_t *w, const int n_sos, int step)
+{
+    int32_t x1[DSPS_BIQUAD_SOS_UNROLL_MAX];
+    int32_t x2[DSPS_BIQUAD_SOS_UNROLL_MAX];
+    int32_t y1[DSPS_BIQUAD_SOS_UNROLL_MAX];
+    int32_t y2[DSPS_BIQUAD_SOS_UNROLL_MAX];
+    int32_t err[DSPS_BIQUAD_SOS_UNROLL_MAX];
+    for (int s = 0 ; s < n_sos ; s++) {
+        x1[s] = w[s * 5 + 0];
+        x2[s] = w[s * 5 + 1];
+        y1[s] = w[s * 5 + 2];
+        y2[s] = w[s * 5 + 3];
+        err[s] = w[s * 5 + 4];
+    }
+    for (int i = 0 ; i < len ; i++) {
+        int32_t x = input[i * step];
+        for (int s = 0 ; s < n_sos ; s++) {
+            const int16_t *c = &coef[s * 6];
+            int shift = c[5];
+            // Truncation error of the previous sample is added back (error feedback)
+            int32_t acc = err[s] + c[0] * x + c[1] * x1[s] + c[2] * x2[s] - c[3] * y1[s] - c[4] * y2[s];
+            int32_t y = acc >> shift;
+            err[s] = acc & ((1 << shift) - 1);
+            if (y > INT16_MAX) {
+                y = INT16_MAX;
+                err[s] = 0;
+            } else if (y < INT16_MIN) {
+                y = INT16_MIN;
+                err[s] = 0;
+            }
+            x2[s] = x1[s];
+            x1[s] = x;
+            y2[s] = y1[s];
+            y1[s] = y;
+            x = y;
+        }
+        output[i * step] = x;
+    }
+    for (int s = 0 ; s < n_sos ; s++) {
+        w[s * 5 + 0] = x1[s];
+        w[s * 5 + 1] = x2[s];
+        w[s * 5 + 2] = y1[s];
+        w[s * 5 + 3] = y2[s];
+        w[s * 5 + 4] = err[s];
+    }
+}
+
+esp_err_t dsps_biquad_sos_s16_ansi(const int16_t *input, int16_t *output, int len, const int16_t *coef, int32_t *w, int n_sos, int step)
+{
+    if ((n_sos <= 0) || (step <= 0)) {
+        return ESP_ERR_DSP_INVALID_PARAM;
+    }
+    switch (n_sos) {
+    case 1:
+        dsps_biquad_sos_s16_kernel(input, output, len, coef, w, 1, step);
+        break;
+    case 2:
+        dsps_biquad_sos_s16_kernel(input, output, len, coef, w, 2, step);
+        break;
+    case 3:
+        dsps_biquad_sos_s16_kernel(input, output, len, coef, w, 3, step);
+        break;
+    case 4:
+        dsps_biquad_sos_s16_kernel(input, output, len, coef, w, 4, step);
+        break;
+    case 5:
+        dsps_biquad_sos_s16_kernel(input, output, len, coef, w, 5, step);
+        break;
+    case 6:
+        dsps_biquad_sos_s16_kernel(input, output, len, coef, w, 6, step);
+        break;
+    case 7:
+        dsps_biquad_sos_s16_kernel(input, output, len, coef, w, 7, step);
+        break;
+    case 8:
+        dsps_biquad_sos_s16_kernel(input, output, len, coef, w, 8, step);
+        break;
+    default:
+        // Longer cascades: run blocks of DSPS_BIQUAD_SOS_UNROLL_MAX sections in place
+        dsps_biquad_sos_s16_kernel(input, output, len, coef, w, DSPS_BIQUAD_SOS_UNROLL_MAX, step);
+        return dsps_biquad_sos_s16_ansi(output, output, len,
+                                        &coef[DSPS_BIQUAD_SOS_UNROLL_MAX * 6],
+                                        &w[DSPS_BIQUAD_SOS_UNROLL_MAX * 5],
+                                        n_sos - DSPS_BIQUAD_SOS_UNROLL_MAX, step);
+    }
+    return ESP_OK;
+}
@@ -48,6 +48,60 @@ esp_err_t dsps_biquad_f32_ae32(const float *input, float *output, int len, float
 esp_err_t dsps_biquad_f32_aes3(const float *input, float *output, int len, float *coef, float *w);
 /**@}*/
 
+/**@{*/
+/**
+ * @brief   Cascade of IIR filters
+ *
+ * Cascade of n_sos 2nd order direct form II sections (bi quads), processed in a single
+ * pass over the input: every sample goes through all the sections before the next one
+ * is read, so the delay lines stay in registers and the signal is streamed only once.
+ * Result is the same as calling dsps_biquad_f32 n_sos times.
+ * The extension (_ansi) use ANSI C and could be compiled and run on any platform.
+ *
+ * @param[in] input: input array
+ * @param output: output array. Could be the same as input
+ * @param len: number of samples to process
+ * @param coef: array of coefficients, 5 per section: b0,b1,b2,a1,a2 of section 0, then section 1, ...
+ *              expected that a0 = 1. b0..b2 - numerator, a0..a2 - denominator
+ * @param w: delay lines w0,w1 of each section. Length of 2*n_sos.
+ * @param n_sos: number of sections of the cascade
+ * @param step: distance between consecutive samples in input and output arrays
+ *              (1 for contiguous signals, number of channels for interleaved ones)
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_DSP_INVALID_PARAM if n_sos or step are not positive
+ */
+esp_err_t dsps_biquad_sos_f32_ansi(const float *input, float *output, int len, float *coef, float *w, int n_sos, int step);
+/**@}*/
+
+/**@{*/
+/**
+ * @brief   Cascade of IIR filters, fixed point
+ *
+ * Cascade of n_sos 2nd order direct form I sections with Q15 data, as
+ * dsps_biquad_sos_f32. Products and sums of each section are calculated in a 32 bit
+ * accumulator, that can not overflow with coefficients from dsps_biquad_sos_quant_s16.
+ * The truncation error of each section is added to its next sample (first order
+ * error feedback), so the quantization noise is shaped away from DC, and the output of
+ * each section saturates to the int16 range.
+ * The extension (_ansi) use ANSI C and could be compiled and run on any platform.
+ *
+ * @param[in] input: input array, Q15
+ * @param output: output array, Q15. Could be the same as input
+ * @param len: number of samples to process
+ * @param coef: array of coefficients, 6 per section: b0,b1,b2,a1,a2 with shift fractional
+ *              bits, and shift. Calculated by dsps_biquad_sos_quant_s16.
+ * @param w: delay lines x1,x2,y1,y2 and error of each section. Length of 5*n_sos.
+ * @param n_sos: number of sections of the cascade
+ * @param step: distance between consecutive samples in input and output arrays
+ *              (1 for contiguous signals, number of channels for interleaved ones)
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_DSP_INVALID_PARAM if n_sos or step are not positive
+ */
+esp_err_t dsps_biquad_sos_s16_ansi(const int16_t *input, int16_t *output, int len, const int16_t *coef, int32_t *w, int n_sos, int step);
+/**@}*/
+
 
 #ifdef __cplusplus
 }
@@ -69,5 +123,8 @@ esp_err_t dsps_biquad_f32_aes3(const float *input, float *output, int len, float
 
 #endif // CONFIG_DSP_OPTIMIZED
 
+#define dsps_biquad_sos_f32 dsps_biquad_sos_f32_ansi
+#define dsps_biquad_sos_s16 dsps_biquad_sos_s16_ansi
+
 
 #endif // _dsps_biquad_H_
@@ -193,6 +193,26 @@ esp_err_t dsps_biquad_gen_lowShelf_f32(float *coeffs, float f, float gain, float
  */
 esp_err_t dsps_biquad_gen_highShelf_f32(float *coeffs, float f, float gain, float qFactor);
 
+/**
+ * @brief   Fixed point coefficients of a cascade of IIR filters
+ *
+ * Quantization of the coefficients of n_sos sections (5 per section, as dsps_biquad_sos_f32)
+ * for dsps_biquad_sos_s16. Each section gets the biggest shift (fractional bits, up to 15)
+ * that keeps its coefficients in int16 and the sum of their absolute values under 2^16, so the
+ * 32 bit accumulator of dsps_biquad_sos_s16 never overflows.
+ * The poles of every quantized section are checked: |a2| < 1 and |a1| < 1 + a2.
+ * The implementation use ANSI C and could be compiled and run on any platform
+ *
+ * @param[in] coef: coefficients, 5 per section: b0,b1,b2,a1,a2
+ * @param coef_q: result coefficients, 6 per section: b0,b1,b2,a1,a2 and shift
+ * @param n_sos: number of sections
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_DSP_PARAM_OUTOFRANGE if a coefficient is too big or a quantized section is not stable
+ */
+esp_err_t dsps_biquad_sos_quant_s16(const float *coef, int16_t *coef_q, int n_sos);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,113 @@
+// Copyright 2018-2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string.h>
+#include "unity.h"
+#include "dsp_platform.h"
+#include "esp_log.h"
+
+#include "dsp_common.h"
+#include "dsps_tone_gen.h"
+#include "dsps_biquad_gen.h"
+#include "dsps_biquad.h"
+
+static const char *TAG = "dsps_biquad_sos_f32_ansi";
+
+#define N_SOS_MAX 8
+
+static float x[1024];
+static float y[1024];
+static float y_ref[1024];
+
+static void gen_cascade(float *coeffs, int n_sos)
+{
+    // Alternate low and high pass sections, as in a band pass built from two Butterworth cascades
+    for (int s = 0 ; s < n_sos ; s++) {
+        if (s & 1) {
+            dsps_biquad_gen_hpf_f32(&coeffs[s * 5], 0.01, 0.5 + 0.25 * s);
+        } else {
+            dsps_biquad_gen_lpf_f32(&coeffs[s * 5], 0.2, 0.5 + 0.25 * s);
+        }
+    }
+}
+
+TEST_CASE("dsps_biquad_sos_f32_ansi functionality", "[dsps]")
+{
+    int len = sizeof(x) / sizeof(float);
+    dsps_tone_gen_f32(x, len, 1, 0.05, 0);
+
+    float coeffs[N_SOS_MAX * 5];
+    for (int n_sos = 1 ; n_sos <= N_SOS_MAX ; n_sos++) {
+        float w[N_SOS_MAX * 2] = {0};
+        float w_ref[N_SOS_MAX * 2] = {0};
+        gen_cascade(coeffs, n_sos);
+
+        // Reference: one pass over the signal per section, processed in two blocks
+        // to check that the delay lines are kept between calls
+        for (int b = 0 ; b < 2 ; b++) {
+            float *in = &x[b * len / 2];
+            float *out = &y_ref[b * len / 2];
+            dsps_biquad_f32_ansi(in, out, len / 2, coeffs, w_ref);
+            for (int s = 1 ; s < n_sos ; s++) {
+                dsps_biquad_f32_ansi(out, out, len / 2, &coeffs[s * 5], &w_ref[s * 2]);
+            }
+            TEST_ESP_OK(dsps_biquad_sos_f32_ansi(in, &y[b * len / 2], len / 2, coeffs, w, n_sos, 1));
+        }
+        for (int i = 0 ; i < len ; i++) {
+            if (fabsf(y[i] - y_ref[i]) > 1e-5) {
+                ESP_LOGE(TAG, "n_sos=%i: y[%i] = %f, expected %f", n_sos, i, y[i], y_ref[i]);
+                TEST_ASSERT_MESSAGE (false, "Result differs from the per-section cascade");
+            }
+        }
+    }
+    // Interleaved input: channel 1 of 2 must match the contiguous result
+    float w[N_SOS_MAX * 2] = {0};
+    float w_ref[N_SOS_MAX * 2] = {0};
+    gen_cascade(coeffs, 4);
+    for (int i = 0 ; i < len / 2 ; i++) {
+        y[2 * i] = 0;
+        y[2 * i + 1] = x[i];
+    }
+    TEST_ESP_OK(dsps_biquad_sos_f32_ansi(&y[1], &y[1], len / 2, coeffs, w, 4, 2));
+    TEST_ESP_OK(dsps_biquad_sos_f32_ansi(x, y_ref, len / 2, coeffs, w_ref, 4, 1));
+    for (int i = 0 ; i < len / 2 ; i++) {
+        TEST_ASSERT_EQUAL_FLOAT(y_ref[i], y[2 * i + 1]);
+        TEST_ASSERT_EQUAL_FLOAT(0, y[2 * i]);
+    }
+}
+
+TEST_CASE("dsps_biquad_sos_f32_ansi benchmark", "[dsps]")
+{
+    int len = sizeof(x) / sizeof(float);
+    dsps_tone_gen_f32(x, len, 1, 0.05, 0);
+
+    float coeffs[N_SOS_MAX * 5];
+    float w[N_SOS_MAX * 2] = {0};
+    gen_cascade(coeffs, N_SOS_MAX);
+
+    for (int n_sos = 1 ; n_sos <= N_SOS_MAX ; n_sos++) {
+        unsigned int start_b = dsp_get_cpu_cycle_count();
+        for (int s = 0 ; s < n_sos ; s++) {
+            dsps_biquad_f32(s == 0 ? x : y, y, len, &coeffs[s * 5], &w[s * 2]);
+        }
+        unsigned int cycles_stages = dsp_get_cpu_cycle_count() - start_b;
+
+        start_b = dsp_get_cpu_cycle_count();
+        dsps_biquad_sos_f32_ansi(x, y, len, coeffs, w, n_sos, 1);
+        unsigned int cycles_sos = dsp_get_cpu_cycle_count() - start_b;
+
+        ESP_LOGI(TAG, "%i sections: per-stage dsps_biquad_f32 = %.2f cycles/sample, single pass = %.2f cycles/sample",
+                 n_sos, (float)cycles_stages / len, (float)cycles_sos / len);
+    }
+}
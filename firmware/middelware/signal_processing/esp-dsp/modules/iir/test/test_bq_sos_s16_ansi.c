@@ -0,0 +1,189 @@
+// Copyright 2018-2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string.h>
+#include <math.h>
+#include "unity.h"
+#include "dsp_platform.h"
+#include "esp_log.h"
+
+#include "dsp_common.h"
+#include "dsps_tone_gen.h"
+#include "dsps_biquad_gen.h"
+#include "dsps_biquad.h"
+
+static const char *TAG = "dsps_biquad_sos_s16_ansi";
+
+#define N_SOS_MAX 8
+
+static float x[1024];
+static float y[1024];
+static int16_t x_s16[1024];
+static int16_t y_s16[1024];
+
+// Low pass Butterworth cascade, cut off at 0.05
+static void gen_cascade(float *coeffs, int n_sos)
+{
+    for (int s = 0 ; s < n_sos ; s++) {
+        float q = 1 / (2 * cosf(M_PI * (2 * s + 1) / (4 * n_sos)));
+        dsps_biquad_gen_lpf_f32(&coeffs[s * 5], 0.05, q);
+    }
+}
+
+TEST_CASE("dsps_biquad_sos_s16_ansi functionality", "[dsps]")
+{
+    int len = sizeof(x) / sizeof(float);
+    dsps_tone_gen_f32(x, len, 0.5, 0.01, 0);
+    for (int i = 0 ; i < len ; i++) {
+        x_s16[i] = x[i] * 32768;
+    }
+
+    float coeffs[N_SOS_MAX * 5];
+    int16_t coeffs_s16[N_SOS_MAX * 6];
+    for (int n_sos = 1 ; n_sos <= N_SOS_MAX ; n_sos++) {
+        float w[N_SOS_MAX * 2] = {0};
+        int32_t w_s16[N_SOS_MAX * 5] = {0};
+        gen_cascade(coeffs, n_sos);
+        TEST_ESP_OK(dsps_biquad_sos_quant_s16(coeffs, coeffs_s16, n_sos));
+        // Reference: float cascade with the quantized coefficients, so only the
+        // arithmetic of the fixed point kernel is measured
+        for (int s = 0 ; s < n_sos ; s++) {
+            for (int i = 0 ; i < 5 ; i++) {
+                coeffs[s * 5 + i] = (float)coeffs_s16[s * 6 + i] / (1 << coeffs_s16[s * 6 + 5]);
+            }
+        }
+
+        // Two blocks, to check that the delay lines are kept between calls
+        TEST_ESP_OK(dsps_biquad_sos_f32_ansi(x, y, len, coeffs, w, n_sos, 1));
+        TEST_ESP_OK(dsps_biquad_sos_s16_ansi(x_s16, y_s16, len / 2, coeffs_s16, w_s16, n_sos, 1));
+        TEST_ESP_OK(dsps_biquad_sos_s16_ansi(&x_s16[len / 2], &y_s16[len / 2], len / 2, coeffs_s16, w_s16, n_sos, 1));
+        float signal = 0;
+        float noise = 0;
+        for (int i = 0 ; i < len ; i++) {
+            float err = y_s16[i] / 32768.0f - y[i];
+            signal += y[i] * y[i];
+            noise += err * err;
+        }
+        float snr = 10 * log10f(signal / noise);
+        ESP_LOGI(TAG, "n_sos=%i: SNR = %.1f dB", n_sos, snr);
+        TEST_ASSERT_GREATER_THAN(60, (int)snr);
+    }
+    // Interleaved input: channel 1 of 2 must match the contiguous result
+    int32_t w[N_SOS_MAX * 5] = {0};
+    int32_t w_ref[N_SOS_MAX * 5] = {0};
+    static int16_t y_ref[1024];
+    for (int i = 0 ; i < len / 2 ; i++) {
+        y_s16[2 * i] = 0;
+        y_s16[2 * i + 1] = x_s16[i];
+    }
+    TEST_ESP_OK(dsps_biquad_sos_s16_ansi(&y_s16[1], &y_s16[1], len / 2, coeffs_s16, w, N_SOS_MAX, 2));
+    TEST_ESP_OK(dsps_biquad_sos_s16_ansi(x_s16, y_ref, len / 2, coeffs_s16, w_ref, N_SOS_MAX, 1));
+    for (int i = 0 ; i < len / 2 ; i++) {
+        TEST_ASSERT_EQUAL_INT16(y_ref[i], y_s16[2 * i + 1]);
+        TEST_ASSERT_EQUAL_INT16(0, y_s16[2 * i]);
+    }
+}
+
+TEST_CASE("dsps_biquad_sos_s16_ansi saturation and DC", "[dsps]")
+{
+    float coeffs[5];
+    int16_t coeffs_s16[6];
+    int32_t w[5] = {0};
+    int len = sizeof(x_s16) / sizeof(int16_t);
+
+    // Gain of 2: the output saturates instead of wrapping around
+    dsps_biquad_gen_lpf_f32(coeffs, 0.1, M_SQRT1_2);
+    for (int i = 0 ; i < 3 ; i++) {
+        coeffs[i] *= 2;
+    }
+    TEST_ESP_OK(dsps_biquad_sos_quant_s16(coeffs, coeffs_s16, 1));
+    for (int i = 0 ; i < len ; i++) {
+        x_s16[i] = (i & 64) ? INT16_MIN : INT16_MAX;
+    }
+    TEST_ESP_OK(dsps_biquad_sos_s16_ansi(x_s16, y_s16, len, coeffs_s16, w, 1, 1));
+    for (int i = 100 ; i < len ; i++) {
+        TEST_ASSERT_TRUE((y_s16[i] > 0) == ((i & 64) == 0) || (i % 64) < 16);
+    }
+
+    // Low cut off, poles close to 1: without the error feedback the truncation would leave
+    // a dead band of several LSB. The output converges to the DC gain of the quantized section
+    dsps_biquad_gen_lpf_f32(coeffs, 0.005, M_SQRT1_2);
+    TEST_ESP_OK(dsps_biquad_sos_quant_s16(coeffs, coeffs_s16, 1));
+    float gain = (float)(coeffs_s16[0] + coeffs_s16[1] + coeffs_s16[2]) /
+                 ((1 << coeffs_s16[5]) + coeffs_s16[3] + coeffs_s16[4]);
+    memset(w, 0, sizeof(w));
+    for (int i = 0 ; i < len ; i++) {
+        x_s16[i] = 1000;
+    }
+    for (int b = 0 ; b < 4 ; b++) {
+        TEST_ESP_OK(dsps_biquad_sos_s16_ansi(x_s16, y_s16, len, coeffs_s16, w, 1, 1));
+    }
+    TEST_ASSERT_INT_WITHIN(1, lrintf(1000 * gain), y_s16[len - 1]);
+}
+
+TEST_CASE("dsps_biquad_sos_quant_s16 stability", "[dsps]")
+{
+    int16_t coeffs_s16[6];
+    // Poles at 0.99999 * exp(+-j*0.001): they go to the unit circle once quantized
+    float r = 0.99999;
+    float coeffs[5] = {1, 0, 0, -2 * r * cosf(0.001), r * r};
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_PARAM_OUTOFRANGE, dsps_biquad_sos_quant_s16(coeffs, coeffs_s16, 1));
+    // Unstable section
+    float unstable[5] = {1, 0, 0, 0, 1.5};
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_PARAM_OUTOFRANGE, dsps_biquad_sos_quant_s16(unstable, coeffs_s16, 1));
+    // Gain too big for int16 coefficients
+    float big[5] = {40000, 0, 0, 0, 0};
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_PARAM_OUTOFRANGE, dsps_biquad_sos_quant_s16(big, coeffs_s16, 1));
+
+    float lpf[5];
+    dsps_biquad_gen_lpf_f32(lpf, 0.05, M_SQRT1_2);
+    TEST_ESP_OK(dsps_biquad_sos_quant_s16(lpf, coeffs_s16, 1));
+    // Sum of the coefficients under 2^16, and as many fractional bits as possible
+    int sum = 0;
+    for (int i = 0 ; i < 5 ; i++) {
+        sum += abs(coeffs_s16[i]);
+        TEST_ASSERT_INT_WITHIN(1, lrintf(lpf[i] * (1 << coeffs_s16[5])), coeffs_s16[i]);
+    }
+    TEST_ASSERT_LESS_OR_EQUAL(65535, sum);
+    TEST_ASSERT_GREATER_THAN(32767, sum * 2);
+}
+
+TEST_CASE("dsps_biquad_sos_s16_ansi benchmark", "[dsps]")
+{
+    int len = sizeof(x) / sizeof(float);
+    dsps_tone_gen_f32(x, len, 0.5, 0.01, 0);
+    for (int i = 0 ; i < len ; i++) {
+        x_s16[i] = x[i] * 32768;
+    }
+
+    float coeffs[N_SOS_MAX * 5];
+    int16_t coeffs_s16[N_SOS_MAX * 6];
+    float w[N_SOS_MAX * 2] = {0};
+    int32_t w_s16[N_SOS_MAX * 5] = {0};
+    gen_cascade(coeffs, N_SOS_MAX);
+    dsps_biquad_sos_quant_s16(coeffs, coeffs_s16, N_SOS_MAX);
+
+    for (int n_sos = 1 ; n_sos <= N_SOS_MAX ; n_sos++) {
+        unsigned int start_b = dsp_get_cpu_cycle_count();
+        dsps_biquad_sos_f32_ansi(x, y, len, coeffs, w, n_sos, 1);
+        unsigned int cycles_f32 = dsp_get_cpu_cycle_count() - start_b;
+
+        start_b = dsp_get_cpu_cycle_count();
+        dsps_biquad_sos_s16_ansi(x_s16, y_s16, len, coeffs_s16, w_s16, n_sos, 1);
+        unsigned int cycles_s16 = dsp_get_cpu_cycle_count() - start_b;
+
+        ESP_LOGI(TAG, "%i sections: float = %.2f cycles/sample, Q15 = %.2f cycles/sample",
+                 n_sos, (float)cycles_f32 / len, (float)cycles_s16 / len);
+    }
+}
@@ -22,6 +22,7 @@ ekf::ekf(int x, int w) : NUMX(x),
     F(*new dspm::Mat(x, x)),
     G(*new dspm::Mat(x, w)),
     P(*new dspm::Mat(x, x)),
+    PackedP(false),
     Q(*new dspm::Mat(w, w))
 {
 
@@ -37,6 +38,24 @@ ekf::ekf(int x, int w) : NUMX(x),
     }
 }
 
+ekf::ekf(int x, int w, float *x_data, float *f_data, float *g_data, float *p_data, float *q_data, bool p_packed) : NUMX(x),
+    NUMW(w),
+    X(*new dspm::Mat(x_data, x, 1)),
+
+    F(*new dspm::Mat(f_data, x, x)),
+    G(*new dspm::Mat(g_data, x, w)),
+    P(p_packed ? *new dspm::Mat(p_data, x * (x + 1) / 2, 1) : *new dspm::Mat(p_data, x, x)),
+    PackedP(p_packed),
+    Q(*new dspm::Mat(q_data, w, w))
+{
+    this->HP = new float[this->NUMX];
+    this->Km = new float[this->NUMX];
+    for (size_t i = 0; i < this->NUMX; i++) {
+        this->HP[i] = 0;
+        this->Km[i] = 0;
+    }
+}
+
 ekf::~ekf()
 {
     delete &X;
@@ -78,63 +97,70 @@ void ekf::RungeKutta(dspm::Mat &x, float *U, float dt)
 }
 
 dspm::Mat ekf::SkewSym4x4(float w[3])
+{
+    dspm::Mat result(4, 4);
+    SkewSym4x4(w, result.data);
+    return result;
+}
+
+void ekf::SkewSym4x4(const float w[3], float *result)
 {
     //={    0,  -w[0],  -w[1],  -w[2],
     //   w[0],      0,   w[2],  -w[1],
     //   w[1],  -w[2],      0,   w[0],
     //   w[2],   w[1],  -w[0],     0 };
 
-    dspm::Mat result(4, 4);
-    result.data[0] = 0;
-    result.data[1] = -w[0];
-    result.data[2] = -w[1];
-    result.data[3] = -w[2];
-
-    result.data[4] = w[0];
-    result.data[5] = 0;
-    result.data[6] = w[2];
-    result.data[7] = -w[1];
-
-    result.data[8] = w[1];
-    result.data[9] = -w[2];
-    result.data[10] = 0;
-    result.data[11] = w[0];
-
-    result.data[12] = w[2];
-    result.data[13] = w[1];
-    result.data[14] = -w[0];
-    result.data[15] = 0;
-
-    return result;
+    result[0] = 0;
+    result[1] = -w[0];
+    result[2] = -w[1];
+    result[3] = -w[2];
+
+    result[4] = w[0];
+    result[5] = 0;
+    result[6] = w[2];
+    result[7] = -w[1];
+
+    result[8] = w[1];
+    result[9] = -w[2];
+    result[10] = 0;
+    result[11] = w[0];
+
+    result[12] = w[2];
+    result[13] = w[1];
+    result[14] = -w[0];
+    result[15] = 0;
 }
 
 dspm::Mat ekf::qProduct(float *q)
 {
     dspm::Mat result(4, 4);
-
-    result.data[0] = q[0];
-    result.data[1] = -q[1];
-    result.data[2] = -q[2];
-    result.data[3] = -q[3];
-
-    result.data[4] = q[1];
-    result.data[5] = q[0];
-    result.data[6] = -q[3];
-    result.data[7] = q[2];
-
-    result.data[8] = q[2];
-    result.data[9] = q[3];
-    result.data[10] = q[0];
-    result.data[11] = -q[1];
-
-    result.data[12] = q[3];
-    result.data[13] = -q[2];
-    result.data[14] = q[1];
-    result.data[15] = q[0];
-
+    qProduct(q, result.data);
     return result;
 }
 
+void ekf::qProduct(const float *q, float *result)
+{
+    result[0] = q[0];
+    result[1] = -q[1];
+    result[2] = -q[2];
+    result[3] = -q[3];
+
+    result[4] = q[1];
+    result[5] = q[0];
+    result[6] = -q[3];
+    result[7] = q[2];
+
+    result[8] = q[2];
+    result[9] = q[3];
+    result[10] = q[0];
+    result[11] = -q[1];
+
+    result[12] = q[3];
+    result[13] = -q[2];
+    result[14] = q[1];
+    result[15] = q[0];
+}
+
 void ekf::CovariancePrediction(float dt)
 {
     dspm::Mat f = this->F * dt;
@@ -142,11 +168,22 @@ void ekf::CovariancePrediction(float dt)
     f = f + dspm::Mat::eye(this->NUMX);
 
     dspm::Mat f_t = f.t();
+    if (this->PackedP) {
+        dspm::Mat P_full(this->NUMX, this->NUMX);
+        UnpackUpper(this->P.data, P_full);
+        P_full = ((f * P_full) * f_t) + (dt * dt) * ((G * Q) * G.t());
+        PackUpper(P_full, this->P.data);
+        return;
+    }
     this->P = ((f * this->P) * f_t) + (dt * dt) * ((G * Q) * G.t());
 }
 
 void ekf::Update(dspm::Mat &H, float *measured, float *expected, float *R)
 {
+    if (this->PackedP) {
+        this->UpdateSequential(H, measured, expected, R);
+        return;
+    }
     float HPHR, Error;
     dspm::Mat Y(measured, H.rows, 1);
     dspm::Mat Z(expected, H.rows, 1);
@@ -185,18 +222,88 @@ void ekf::Update(dspm::Mat &H, float *measured, float *expected, float *R)
     }
 }
 
+void ekf::UpdateSequential(dspm::Mat &H, float *measured, float *expected, float *R)
+{
+    const int n = this->NUMX;
+    for (int m = 0; m < H.rows; m++) {
+        const float *h = &H.data[m * H.stride];
+        for (int i = 0; i < n; i++) {
+            HP[i] = 0;
+        }
+        for (int k = 0; k < n; k++) {
+            // Find HP = P*h' (P is symmetric), only for non zero elements of h
+            if (h[k] == 0) {
+                continue;
+            }
+            for (int i = 0; i < k; i++) {
+                HP[i] += PUpperRow(i)[k - i] * h[k];
+            }
+            const float *p_row = PUpperRow(k);
+            for (int i = k; i < n; i++) {
+                HP[i] += p_row[i - k] * h[k];
+            }
+        }
+        float HPHR = R[m]; // Find  HPHR = h*P*h' + r
+        for (int k = 0; k < n; k++) {
+            HPHR += HP[k] * h[k];
+        }
+        float invHPHR = 1.0f / HPHR;
+        for (int k = 0; k < n; k++) {
+            Km[k] = HP[k] * invHPHR; // find K = HP/HPHR
+        }
+        for (int i = 0; i < n; i++) {
+            // Joseph form: P(m) = (I - K*h)*P(m-1)*(I - K*h)' + K*r*K' = P(m-1) - K*HP' + (K*HPHR - HP)*K'
+            float *p_row = PUpperRow(i);
+            float Ki = Km[i];
+            float Ki_HPHR_HPi = Ki * HPHR - HP[i];
+            for (int j = i; j < n; j++) {
+                p_row[j - i] += Ki_HPHR_HPi * Km[j] - Ki * HP[j];
+            }
+            if (!this->PackedP) {
+                for (int j = i + 1; j < n; j++) {
+                    P(j, i) = p_row[j - i];
+                }
+            }
+        }
+
+        float Error = measured[m] - expected[m];
+        for (int i = 0; i < n; i++) {
+            // Find X(m)= X(m-1) + K*Error
+            X(i, 0) = X(i, 0) + Km[i] * Error;
+        }
+    }
+}
+
 void ekf::UpdateRef(dspm::Mat &H, float *measured, float *expected, float *R)
 {
+    dspm::Mat P_full;
+    if (this->PackedP) {
+        P_full = dspm::Mat(this->NUMX, this->NUMX);
+        UnpackUpper(this->P.data, P_full);
+    }
+    dspm::Mat &P = this->PackedP ? P_full : this->P;
+
     dspm::Mat h_t = H.t();
     dspm::Mat S = H * P * h_t; // +diag(R);
     for (size_t i = 0; i < H.rows; i++) {
         S(i, i) += R[i];
     }
 
-    dspm::Mat S_ = S.pinv(); // 1 / S
-
-    dspm::Mat K = (P * h_t) * S_;
-    this->P = (dspm::Mat::eye(this->NUMX) - K * H) * P;
+    // S is symmetric positive definite: K = P * H' / S = (S \ (H * P))', without inverse matrix
+    dspm::Mat K;
+    if (S.cholesky() == ESP_OK) {
+        K = S.choleskySolve(H * P).t();
+    } else {
+        S = H * P * h_t;
+        for (size_t i = 0; i < H.rows; i++) {
+            S(i, i) += R[i];
+        }
+        K = (P * h_t) * S.pinv();
+    }
+    P = (dspm::Mat::eye(this->NUMX) - K * H) * P;
+    if (this->PackedP) {
+        PackUpper(P, this->P.data);
+    }
 
     dspm::Mat Y(measured, H.rows, 1);
     dspm::Mat Z(expected, H.rows, 1);
@@ -205,25 +312,47 @@ void ekf::UpdateRef(dspm::Mat &H, float *measured, float *expected, float *R)
     this->X += (K * Err);
 }
 
+void ekf::PackUpper(dspm::Mat &A, float *packed)
+{
+    for (int i = 0; i < A.rows; i++) {
+        for (int j = i; j < A.cols; j++) {
+            *packed++ = A(i, j);
+        }
+    }
+}
+
+void ekf::UnpackUpper(const float *packed, dspm::Mat &A)
+{
+    for (int i = 0; i < A.rows; i++) {
+        for (int j = i; j < A.cols; j++) {
+            A(i, j) = A(j, i) = *packed++;
+        }
+    }
+}
+
 dspm::Mat ekf::quat2rotm(float q[4])
+{
+    dspm::Mat Rm(3, 3);
+    quat2rotm(q, Rm.data);
+    return Rm;
+}
+
+void ekf::quat2rotm(const float q[4], float *Rm)
 {
     float q0 = q[0];
     float q1 = q[1];
     float q2 = q[2];
     float q3 = q[3];
-    dspm::Mat Rm(3, 3);
-
-    Rm(0, 0) = q0 * q0 + q1 * q1 - q2 * q2 - q3 * q3;
-    Rm(1, 0) = 2.0f * (q1 * q2 + q0 * q3);
-    Rm(2, 0) = 2.0f * (q1 * q3 - q0 * q2);
-    Rm(0, 1) = 2.0f * (q1 * q2 - q0 * q3);
-    Rm(1, 1) = (q0 * q0 - q1 * q1 + q2 * q2 - q3 * q3);
-    Rm(2, 1) = 2.0f * (q2 * q3 + q0 * q1);
-    Rm(0, 2) = 2.0f * (q1 * q3 + q0 * q2);
-    Rm(1, 2) = 2.0f * (q2 * q3 - q0 * q1);
-    Rm(2, 2) = (q0 * q0 - q1 * q1 - q2 * q2 + q3 * q3);
 
-    return Rm;
+    Rm[0] = q0 * q0 + q1 * q1 - q2 * q2 - q3 * q3;
+    Rm[3] = 2.0f * (q1 * q2 + q0 * q3);
+    Rm[6] = 2.0f * (q1 * q3 - q0 * q2);
+    Rm[1] = 2.0f * (q1 * q2 - q0 * q3);
+    Rm[4] = (q0 * q0 - q1 * q1 + q2 * q2 - q3 * q3);
+    Rm[7] = 2.0f * (q2 * q3 + q0 * q1);
+    Rm[2] = 2.0f * (q1 * q3 + q0 * q2);
+    Rm[5] = 2.0f * (q2 * q3 - q0 * q1);
+    Rm[8] = (q0 * q0 - q1 * q1 - q2 * q2 + q3 * q3);
 }
 
 dspm::Mat ekf::quat2eul(const float q[4])
@@ -388,25 +517,32 @@ dspm::Mat ekf::dFdq(dspm::Mat &vector, dspm::Mat &q)
 dspm::Mat ekf::dFdq_inv(dspm::Mat &vector, dspm::Mat &q)
 {
     dspm::Mat result(3, 4);
-    result(0, 0) = q.data[0] * vector.data[0] + q.data[3] * vector.data[1] - q.data[2] * vector.data[2];
-    result(0, 1) = q.data[1] * vector.data[0] + q.data[2] * vector.data[1] + q.data[3] * vector.data[2];
-    result(0, 2) = -q.data[2] * vector.data[0] + q.data[1] * vector.data[1] - q.data[0] * vector.data[2];
-    result(0, 3) = -q.data[3] * vector.data[0] + q.data[0] * vector.data[1] + q.data[1] * vector.data[2];
-
-    result(1, 0) = -q.data[3] * vector.data[0] + q.data[0] * vector.data[1] + q.data[1] * vector.data[2];
-    result(1, 1) = q.data[2] * vector.data[0] - q.data[1] * vector.data[1] + q.data[0] * vector.data[2];
-    result(1, 2) = q.data[1] * vector.data[0] + q.data[2] * vector.data[1] + q.data[3] * vector.data[2];
-    result(1, 3) = -q.data[0] * vector.data[0] - q.data[3] * vector.data[1] + q.data[2] * vector.data[2];
-
-    result(2, 0) = q.data[2] * vector.data[0] - q.data[1] * vector.data[1] + q.data[0] * vector.data[2];
-    result(2, 1) = q.data[3] * vector.data[0] - q.data[0] * vector.data[1] - q.data[1] * vector.data[2];
-    result(2, 2) = q.data[0] * vector.data[0] + q.data[3] * vector.data[1] - q.data[2] * vector.data[2];
-    result(2, 3) = q.data[1] * vector.data[0] + q.data[2] * vector.data[1] + q.data[3] * vector.data[2];
-
-    result *= 2;
+    dFdq_inv(vector.data, q.data, result.data);
     return result;
 }
 
+void ekf::dFdq_inv(const float *vector, const float *q, float *result)
+{
+    result[0] = q[0] * vector[0] + q[3] * vector[1] - q[2] * vector[2];
+    result[1] = q[1] * vector[0] + q[2] * vector[1] + q[3] * vector[2];
+    result[2] = -q[2] * vector[0] + q[1] * vector[1] - q[0] * vector[2];
+    result[3] = -q[3] * vector[0] + q[0] * vector[1] + q[1] * vector[2];
+
+    result[4] = -q[3] * vector[0] + q[0] * vector[1] + q[1] * vector[2];
+    result[5] = q[2] * vector[0] - q[1] * vector[1] + q[0] * vector[2];
+    result[6] = q[1] * vector[0] + q[2] * vector[1] + q[3] * vector[2];
+    result[7] = -q[0] * vector[0] - q[3] * vector[1] + q[2] * vector[2];
+
+    result[8] = q[2] * vector[0] - q[1] * vector[1] + q[0] * vector[2];
+    result[9] = q[3] * vector[0] - q[0] * vector[1] - q[1] * vector[2];
+    result[10] = q[0] * vector[0] + q[3] * vector[1] - q[2] * vector[2];
+    result[11] = q[1] * vector[0] + q[2] * vector[1] + q[3] * vector[2];
+
+    for (int i = 0; i < 12; i++) {
+        result[i] *= 2;
+    }
+}
+
 dspm::Mat ekf::StateXdot(dspm::Mat &x, float *u)
 {
     dspm::Mat U(u, this->G.cols, 1);
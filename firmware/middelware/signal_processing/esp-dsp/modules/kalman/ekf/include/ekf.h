@@ -37,6 +37,21 @@ public:
     */
     ekf(int x, int w);
 
+    /**
+     * Constructor of EKF with external memory for the matrices.
+     * The matrices X, F, G, P and Q use the buffers (the data is not allocated and not initialized),
+     * so the derived class can keep them in fixed size members (see dspm::MatN).
+     * @param[in] x: - amount of states in EKF. x[n] = F*x[n-1] + G*u + W. Size of matrix F
+     * @param[in] w: - amount of control measurements and noise inputs. Size of matrix G
+     * @param[in] x_data: - buffer of X, x elements
+     * @param[in] f_data: - buffer of F, x*x elements
+     * @param[in] g_data: - buffer of G, x*w elements
+     * @param[in] p_data: - buffer of P, x*x elements, or x*(x+1)/2 elements if p_packed
+     * @param[in] q_data: - buffer of Q, w*w elements
+     * @param[in] p_packed: - store only the upper triangle of P (see PackedP)
+    */
+    ekf(int x, int w, float *x_data, float *f_data, float *g_data, float *p_data, float *q_data, bool p_packed = false);
+
 
     /**
      * Distructor of EKF
@@ -82,10 +97,17 @@ public:
     dspm::Mat &G;
 
     /**
-    * Covariance matrix and state vector
+    * Covariance matrix and state vector.
+    * If PackedP, P is a vector [x*(x+1)/2]x[1] with the upper triangle of the matrix, row by row
     */
     dspm::Mat &P;
 
+    /**
+     * P is stored as packed upper triangle: about half memory, and Update(...)
+     * uses the sequential update UpdateSequential(...).
+     */
+    bool PackedP;
+
     /**
      * Input noise and measurement noise variances
     */
@@ -139,6 +161,19 @@ public:
      * @param[in] R: measurement noise covariance values
      */
     virtual void Update(dspm::Mat &H, float *measured, float *expected, float *R);
+    /**
+     * Sequential update of current state by measured values, for non correlated values.
+     * The measurements are applied one by one, as scalars: no matrix inverse.
+     * P is updated in Joseph form, P = (I - K*h)*P*(I - K*h)' + K*r*K', that keeps it
+     * symmetric and positive definite also with rounding errors. Only the upper triangle
+     * is calculated, and zero elements of H are skipped.
+     * With PackedP it works directly on the packed P.
+     * @param[in] H: derivative matrix
+     * @param[in] measured: array of measured values
+     * @param[in] expected: array of expected values
+     * @param[in] R: measurement noise covariance values
+     */
+    virtual void UpdateSequential(dspm::Mat &H, float *measured, float *expected, float *R);
     /**
      * Update of current state by measured values.
      * This method just as a reference for research purpose.
@@ -161,6 +196,32 @@ public:
 
 public:
     // Additional universal helper methods
+    /**
+     * Index of the element [row][col], row <= col, in a packed upper triangle.
+     * @param[in] row: row of the element
+     * @param[in] col: column of the element, col >= row
+     * @param[in] n: size of the matrix
+     *
+     * @return
+     *      - index in the packed upper triangle
+     */
+    static inline int PackedIndex(int row, int col, int n)
+    {
+        return row * (2 * n - row - 1) / 2 + col;
+    }
+    /**
+     * Store the upper triangle of a symmetric matrix, row by row.
+     * @param[in] A: symmetric matrix NxN
+     * @param[out] packed: upper triangle, N*(N+1)/2 elements
+     */
+    static void PackUpper(dspm::Mat &A, float *packed);
+    /**
+     * Symmetric matrix from its packed upper triangle.
+     * @param[in] packed: upper triangle, N*(N+1)/2 elements
+     * @param[out] A: symmetric matrix NxN
+     */
+    static void UnpackUpper(const float *packed, dspm::Mat &A);
+
     /**
      * Convert quaternion to rotation matrix.
      * @param[in] q: quaternion
@@ -169,6 +230,12 @@ public:
      *      - rotation matrix 3x3
      */
     static dspm::Mat quat2rotm(float q[4]);
+    /**
+     * Convert quaternion to rotation matrix, without allocation.
+     * @param[in] q: quaternion
+     * @param[out] Rm: rotation matrix 3x3, 9 elements row by row
+     */
+    static void quat2rotm(const float q[4], float *Rm);
 
     /**
      * Convert rotation matrix to quaternion.
@@ -224,6 +291,13 @@ public:
      *      - Derivative matrix 3x4
      */
     static dspm::Mat dFdq_inv(dspm::Mat &vector, dspm::Mat &quat);
+    /**
+     * Df/dq: Derivative of vector by inverted quaternion, without allocation.
+     * @param[in] vector: input vector, 3 elements
+     * @param[in] quat: quaternion
+     * @param[out] result: derivative matrix 3x4, 12 elements row by row
+     */
+    static void dFdq_inv(const float *vector, const float *quat, float *result);
 
     /**
      * Make skew-symmetric matrix of vector.
@@ -233,6 +307,12 @@ public:
      *      - skew-symmetric matrix 4x4
      */
     static dspm::Mat SkewSym4x4(float *w);
+    /**
+     * Make skew-symmetric matrix of vector, without allocation.
+     * @param[in] w: source vector
+     * @param[out] result: skew-symmetric matrix 4x4, 16 elements row by row
+     */
+    static void SkewSym4x4(const float *w, float *result);
 
     // q product
     // Rl = [q(1) - q(2) - q(3) - q(4); ...
@@ -248,7 +328,21 @@ public:
      *      - right quaternion-product matrix 4x4
      */
     static dspm::Mat qProduct(float *q);
+    /**
+     * Make right quaternion-product matrices, without allocation.
+     * @param[in] q: source quaternion
+     * @param[out] result: right quaternion-product matrix 4x4, 16 elements row by row
+     */
+    static void qProduct(const float *q, float *result);
 
+private:
+    /**
+     * Element [row][row] of P, dense or packed: the elements [row][col >= row] follow it.
+     */
+    inline float *PUpperRow(int row)
+    {
+        return this->PackedP ? &this->P.data[PackedIndex(row, row, this->NUMX)] : &this->P.data[row * this->P.stride + row];
+    }
 };
 
 #endif // _ekf_h_
@@ -14,11 +14,13 @@
 
 #include "ekf_imu13states.h"
 
-ekf_imu13states::ekf_imu13states() : ekf(13, 18),
+ekf_imu13states::ekf_imu13states() : ekf_imu13states_mat(),
+    ekf(13, 18, Xn.data, Fn.data, Gn.data, Pn.data, Qn.data, true),
     mag0(3, 1),
     accel0(3, 1)
 {
     this->NUMU = 3;
+    this->X.data[0] = 1; // direction to 0
 }
 
 ekf_imu13states::~ekf_imu13states()
@@ -52,23 +54,27 @@ void ekf_imu13states::Init()
 
 dspm::Mat ekf_imu13states::StateXdot(dspm::Mat &x, float *u)
 {
-    float wx = u[0] - x(4, 0); // subtract the biases on gyros
-    float wy = u[1] - x(5, 0);
-    float wz = u[2] - x(6, 0);
+    dspm::MatN<13, 1> xdot;
+    StateXdot(x.data, u, xdot);
+    return dspm::Mat(xdot);
+}
 
-    float w[] = {wx, wy, wz};
-    dspm::Mat q = dspm::Mat(x.data, 4, 1);
+void ekf_imu13states::StateXdot(const float *x, const float *u, dspm::MatN<13, 1> &xdot)
+{
+    float w[] = {u[0] - x[4], u[1] - x[5], u[2] - x[6]}; // subtract the biases on gyros
+    dspm::MatN<4, 1> q(x);
 
     // qdot = Q * w
-    dspm::Mat Omega = 0.5 * SkewSym4x4(w);
-    dspm::Mat qdot = Omega * q;
-    dspm::Mat Xdot(this->NUMX, 1);
-    Xdot *= 0;
-    Xdot.Copy(qdot, 0, 0);
+    dspm::MatN<4, 4> Omega;
+    ekf::SkewSym4x4(w, Omega.data);
+    Omega *= 0.5f;
+    dspm::MatN<4, 1> qdot;
+    dspm::mult(Omega, q, qdot);
+    xdot *= 0;
+    xdot.Copy(qdot, 0, 0);
     // dwbias = 0
     // dMang_Ampl = 0
     // dMang_offset = 0
-    return Xdot;
 }
 
 void ekf_imu13states::LinearizeFG(dspm::Mat &x, float *u)
@@ -76,28 +82,149 @@ void ekf_imu13states::LinearizeFG(dspm::Mat &x, float *u)
     float w[3] = {(u[0] - x(4, 0)), (u[1] - x(5, 0)), (u[2] - x(6, 0))}; // subtract the biases on gyros
     // float w[3] = {u[0], u[1], u[2]}; // subtract the biases on gyros
 
-    this->F *= 0; // Initialize F and G matrixes.
-    this->G *= 0;
+    this->Fn *= 0; // Initialize F and G matrixes.
+    this->Gn *= 0;
 
     // dqdot / dq - skey matrix
-    F.Copy(0.5 * ekf::SkewSym4x4(w), 0, 0);
+    dspm::MatN<4, 4> m4;
+    ekf::SkewSym4x4(w, m4.data);
+    m4 *= 0.5f;
+    Fn.Copy(m4, 0, 0);
 
     // dqdot/dvector
-    dspm::Mat dq = -0.5 * qProduct(x.data);
-    dspm::Mat dq_q = dq.Get(0, 4, 1, 3);
+    ekf::qProduct(x.data, m4.data);
+    dspm::MatN<4, 3> dq_q = m4.Get<4, 3>(0, 1);
+    dq_q *= -0.5f;
 
     // dqdot / dnw
-    G.Copy(dq_q, 0, 0);
+    Gn.Copy(dq_q, 0, 0);
     // dqdot / dwbias
-    F.Copy(dq_q, 0, 4);
+    Fn.Copy(dq_q, 0, 4);
+
+    dspm::MatN<3, 3> rotm;
+    ekf::quat2rotm(x.data, rotm.data); // Convert quat to rotation matrix
+    rotm *= -1;
+
+    const dspm::MatN<3, 3> eye3 = dspm::MatN<3, 3>::eye();
+    Gn.Copy(rotm, 7, 6);
+    Gn.Copy(eye3, 4, 3);   // random noise wbias
+    Gn.Copy(eye3, 7, 12);  // random noise magnetometer amplitude
+    Gn.Copy(eye3, 10, 9);  // magnetometer offset constant
+    Gn.Copy(eye3, 10, 15); // random noise offset constant
+}
+
+void ekf_imu13states::Process(float *u, float dt)
+{
+    this->LinearizeFG(this->X, u);
+    this->PredictState(u, dt);
+    this->CovariancePrediction(dt);
+}
+
+void ekf_imu13states::PredictState(float *u, float dt)
+{
+    // Runge-Kutta, as ekf::RungeKutta(...)
+    float dt2 = dt / 2.0f;
+    x_last = Xn;
+    StateXdot(x_last.data, u, k); // k1 = f(x, u)
+    k_sum = k;
+    Xn = x_last + k * dt2;
+
+    StateXdot(Xn.data, u, k);     // k2 = f(x + 0.5*dT*k1, u)
+    k_sum += 2.0f * k;
+    Xn = x_last + k * dt2;
+
+    StateXdot(Xn.data, u, k);     // k3 = f(x + 0.5*dT*k2, u)
+    k_sum += 2.0f * k;
+    Xn = x_last + k * dt;
+
+    StateXdot(Xn.data, u, k);     // k4 = f(x + dT * k3, u)
+
+    // Xnew = X + dT * (k1 + 2 * k2 + 2 * k3 + k4) / 6
+    Xn = x_last + (k_sum + k) * (dt / 6.0f);
+}
+
+static inline float dot_product(const float *a, const float *b, int len)
+{
+    float acc = 0;
+    for (int k = 0; k < len; k++) {
+        acc += a[k] * b[k];
+    }
+    return acc;
+}
+
+void ekf_imu13states::CovariancePrediction(float dt)
+{
+    this->CovariancePrediction(dt, dt * dt);
+}
+
+void ekf_imu13states::CovariancePrediction(float dt, float noise_dt2)
+{
+    fk = Fn * dt;
+    for (int i = 0; i < 13; i++) {
+        fk(i, i) += 1;
+    }
+    // fP = f*P, with the columns of P from the packed upper triangle
+    float p_col[13];
+    for (int j = 0; j < 13; j++) {
+        for (int k = 0; k < j; k++) {
+            p_col[k] = Pn.data[PackedIndex(k, j, 13)];
+        }
+        for (int k = j; k < 13; k++) {
+            p_col[k] = Pn.data[PackedIndex(j, k, 13)];
+        }
+        for (int i = 0; i < 13; i++) {
+            fP(i, j) = dot_product(&fk.data[i * 13], p_col, 13);
+        }
+    }
+    dspm::mult(Gn, Qn, GQ);
+    // P = f*P*f' + dt^2*G*Q*G', upper triangle
+    float *p = Pn.data;
+    for (int i = 0; i < 13; i++) {
+        for (int j = i; j < 13; j++) {
+            *p++ = dot_product(&fP.data[i * 13], &fk.data[j * 13], 13) + noise_dt2 * dot_product(&GQ.data[i * 18], &Gn.data[j * 18], 18);
+        }
+    }
+}
+
+static void normalize_quat(float *q)
+{
+    float norm = sqrtf(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+    for (int i = 0; i < 4; i++) {
+        q[i] /= norm;
+    }
+}
+
+template <int M>
+void ekf_imu13states::MeasurementAccelMagn(dspm::MatN<M, 13> &H, float *expected, bool magn_state)
+{
+    dspm::MatN<3, 3> rotm;
+    ekf::quat2rotm(Xn.data, rotm.data);
+    dspm::MatN<3, 3> Re = rotm.t();
+    dspm::MatN<3, 1> accel(this->accel0.data);
+    dspm::MatN<3, 1> magn(&Xn.data[7]);
+    dspm::MatN<3, 1> magn_offset(&Xn.data[10]);
+
+    if (magn_state) {
+        // We include these two line to update magnetometer initial state
+        H.Copy(Re, 0, 7);
+        H.Copy(dspm::MatN<3, 3>::eye(), 0, 10);
+    }
 
-    dspm::Mat rotm = -1 * this->quat2rotm(x.data); // Convert quat to rotation matrix
+    // dAccel/dq
+    dspm::MatN<3, 4> dq;
+    ekf::dFdq_inv(accel.data, Xn.data, dq.data);
+    H.Copy(dq, 3, 0);
+
+    // dMagn/dq
+    ekf::dFdq_inv(magn.data, Xn.data, dq.data);
+    H.Copy(dq, 0, 0);
 
-    G.Copy(rotm, 7, 6);
-    G.Copy(dspm::Mat::eye(3), 4, 3);   // random noise wbias
-    G.Copy(dspm::Mat::eye(3), 7, 12);  // random noise magnetometer amplitude
-    G.Copy(dspm::Mat::eye(3), 10, 9);  // magnetometer offset constant
-    G.Copy(dspm::Mat::eye(3), 10, 15); // random noise offset constant
+    dspm::MatN<3, 1> expected_magn = Re * magn + magn_offset;
+    dspm::MatN<3, 1> expected_accel = Re * accel;
+    for (size_t i = 0; i < 3; i++) {
+        expected[i] = expected_magn.data[i];
+        expected[i + 3] = expected_accel.data[i];
+    }
 }
 
 void ekf_imu13states::Test()
@@ -186,108 +313,79 @@ void ekf_imu13states::TestFull(bool enable_att)
 
 void ekf_imu13states::UpdateRefMeasurement(float *accel_data, float *magn_data, float R[6])
 {
-    dspm::Mat quat(this->X.data, 4, 1);
-    dspm::Mat H = 0 * dspm::Mat(6, this->NUMX);
-    dspm::Mat Re = this->quat2rotm(quat.data).t();
-
-    // dAccel/dq
-    dspm::Mat dAccel_dq = ekf::dFdq_inv(this->accel0, quat);
-    H.Copy(dAccel_dq, 3, 0);
-
-    // dMagn/dq
-    dspm::Mat magn(&this->X.data[7], 3, 1);
-    dspm::Mat magn_offset(&this->X.data[10], 3, 1);
-    dspm::Mat dMagn_dq = ekf::dFdq_inv(magn, quat);
-    H.Copy(dMagn_dq, 0, 0);
-
-    dspm::Mat expected_magn = Re * magn + magn_offset;
-    dspm::Mat expected_accel = Re * this->accel0;
-
+    dspm::MatN<6, 13> H;
     float measured_data[6];
     float expected_data[6];
+    MeasurementAccelMagn(H, expected_data, false);
     for (size_t i = 0; i < 3; i++) {
         measured_data[i] = magn_data[i];
-        expected_data[i] = expected_magn.data[i];
         measured_data[i + 3] = accel_data[i];
-        expected_data[i + 3] = expected_accel.data[i];
     }
 
-    this->Update(H, measured_data, expected_data, R);
-    quat /= quat.norm();
+    dspm::Mat H_mat = H.view();
+    this->Update(H_mat, measured_data, expected_data, R);
+    normalize_quat(Xn.data);
 }
 
 void ekf_imu13states::UpdateRefMeasurementMagn(float *accel_data, float *magn_data, float R[6])
 {
-    dspm::Mat quat(this->X.data, 4, 1);
-    dspm::Mat H = 0 * dspm::Mat(6, this->NUMX);
-    dspm::Mat Re = this->quat2rotm(quat.data).t();
-
-    // We include these two line to update magnetometer initial state
-    H.Copy(Re, 0, 7);
-    H.Copy(dspm::Mat::eye(3), 0, 10);
-
-    // dAccel/dq
-    dspm::Mat dAccel_dq = ekf::dFdq_inv(this->accel0, quat);
-    H.Copy(dAccel_dq, 3, 0);
-
-    // dMagn/dq
-    dspm::Mat magn(&this->X.data[7], 3, 1);
-    dspm::Mat magn_offset(&this->X.data[10], 3, 1);
-    dspm::Mat dMagn_dq = ekf::dFdq_inv(magn, quat);
-    H.Copy(dMagn_dq, 0, 0);
-
-    dspm::Mat expected_magn = Re * magn + magn_offset;
-    dspm::Mat expected_accel = Re * this->accel0;
-
+    dspm::MatN<6, 13> H;
     float measured_data[6];
     float expected_data[6];
+    MeasurementAccelMagn(H, expected_data, true);
     for (size_t i = 0; i < 3; i++) {
         measured_data[i] = magn_data[i];
-        expected_data[i] = expected_magn.data[i];
         measured_data[i + 3] = accel_data[i];
-        expected_data[i + 3] = expected_accel.data[i];
     }
 
-    this->Update(H, measured_data, expected_data, R);
-    quat /= quat.norm();
+    dspm::Mat H_mat = H.view();
+    this->Update(H_mat, measured_data, expected_data, R);
+    normalize_quat(Xn.data);
 }
 
 void ekf_imu13states::UpdateRefMeasurement(float *accel_data, float *magn_data, float *attitude, float R[10])
 {
-    dspm::Mat quat(this->X.data, 4, 1);
-    dspm::Mat H = 0 * dspm::Mat(10, this->NUMX);
-    dspm::Mat Re = this->quat2rotm(quat.data).t();
-
-    H.Copy(Re, 0, 7);
-    H.Copy(dspm::Mat::eye(3), 0, 10);
-    // dAccel/dq
-    dspm::Mat dAccel_dq = ekf::dFdq_inv(this->accel0, quat);
-    H.Copy(dAccel_dq, 3, 0);
-    // dMagn/dq
-    dspm::Mat magn(&this->X.data[7], 3, 1);
-    dspm::Mat magn_offset(&this->X.data[10], 3, 1);
-    dspm::Mat dMagn_dq = ekf::dFdq_inv(magn, quat);
-    H.Copy(dMagn_dq, 0, 0);
-
-    // dq/dq
-    H.Copy(dspm::Mat::eye(4), 6, 1);
-
-    dspm::Mat expected_magn = Re * magn + magn_offset;
-    dspm::Mat expected_accel = Re * this->accel0;
-
+    dspm::MatN<10, 13> H;
     float measured_data[10];
     float expected_data[10];
+    MeasurementAccelMagn(H, expected_data, true);
+    // dq/dq
+    H.Copy(dspm::MatN<4, 4>::eye(), 6, 1);
+
     for (size_t i = 0; i < 3; i++) {
         measured_data[i] = magn_data[i];
-        expected_data[i] = expected_magn.data[i];
         measured_data[i + 3] = accel_data[i];
-        expected_data[i + 3] = expected_accel.data[i];
     }
     for (size_t i = 0; i < 4; i++) {
         measured_data[i + 6] = attitude[i];
         expected_data[i + 6] = this->X.data[i];
     }
 
-    this->Update(H, measured_data, expected_data, R);
-    quat /= quat.norm();
+    dspm::Mat H_mat = H.view();
+    this->Update(H_mat, measured_data, expected_data, R);
+    normalize_quat(Xn.data);
+}
+
+void ekf_imu13states::UpdateRefAccel(float *accel_data, float R[3])
+{
+    dspm::MatN<6, 13> H;
+    float expected_data[6];
+    MeasurementAccelMagn(H, expected_data, false);
+
+    // Rows 3..5 of H: accelerometer
+    dspm::Mat H_accel(&H.data[3 * 13], 3, 13);
+    this->Update(H_accel, accel_data, &expected_data[3], R);
+    normalize_quat(Xn.data);
+}
+
+void ekf_imu13states::UpdateRefMagn(float *magn_data, float R[3])
+{
+    dspm::MatN<6, 13> H;
+    float expected_data[6];
+    MeasurementAccelMagn(H, expected_data, false);
+
+    // Rows 0..2 of H: magnetometer
+    dspm::Mat H_magn(H.data, 3, 13);
+    this->Update(H_magn, magn_data, expected_data, R);
+    normalize_quat(Xn.data);
 }
@@ -0,0 +1,285 @@
+// Copyright 2020-2021 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string.h>
+#include "ekf_imu13states_fusion.h"
+
+ekf_imu13states_fusion::ekf_imu13states_fusion(int predict_batch) : filter()
+{
+    this->predict_batch = predict_batch > 0 ? predict_batch : 1;
+    for (int i = 0; i < 3; i++) {
+        this->R_accel[i] = 0.01;
+        this->R_magn[i] = 0.01;
+    }
+    this->Init();
+}
+
+ekf_imu13states_fusion::~ekf_imu13states_fusion()
+{
+}
+
+void ekf_imu13states_fusion::Init()
+{
+    this->filter.Init();
+    for (int s = 0; s < EKF_FUSION_SENSORS; s++) {
+        this->queue[s].head = 0;
+        this->queue[s].count = 0;
+    }
+    this->history_start = 0;
+    this->history_end = 0;
+    this->checkpoint_count = 0;
+    this->checkpoint_last = 0;
+
+    this->time = 0;
+    this->started = false;
+    this->pending = 0;
+    this->pending_dt = 0;
+    this->pending_dt2 = 0;
+    for (int i = 0; i < 3; i++) {
+        this->pending_gyro[i] = 0;
+    }
+    this->predictions = 0;
+    this->late_samples = 0;
+    this->dropped_samples = 0;
+}
+
+bool ekf_imu13states_fusion::Push(ekf_fusion_sensor_t sensor, int64_t time, const float *data)
+{
+    queue_t &q = this->queue[sensor];
+    if (q.count >= QUEUE_SIZE) {
+        return false;
+    }
+    ekf_fusion_sample_t &sample = q.samples[(q.head + q.count) % QUEUE_SIZE];
+    sample.time = time;
+    sample.sensor = sensor;
+    for (int i = 0; i < 3; i++) {
+        sample.data[i] = data[i];
+    }
+    q.count++;
+    return true;
+}
+
+bool ekf_imu13states_fusion::PushGyro(int64_t time, const float *gyro)
+{
+    return this->Push(EKF_FUSION_GYRO, time, gyro);
+}
+
+bool ekf_imu13states_fusion::PushAccel(int64_t time, const float *accel)
+{
+    return this->Push(EKF_FUSION_ACCEL, time, accel);
+}
+
+bool ekf_imu13states_fusion::PushMagn(int64_t time, const float *magn)
+{
+    return this->Push(EKF_FUSION_MAGN, time, magn);
+}
+
+bool ekf_imu13states_fusion::Before(const ekf_fusion_sample_t &a, const ekf_fusion_sample_t &b)
+{
+    // Measurements are before the gyroscope sample with the same time, as in Run()
+    return (a.time < b.time) || ((a.time == b.time) && (b.sensor == EKF_FUSION_GYRO));
+}
+
+ekf_fusion_sample_t &ekf_imu13states_fusion::History(uint32_t seq)
+{
+    return this->history[seq % HISTORY_SIZE];
+}
+
+int ekf_imu13states_fusion::Run()
+{
+    int processed = 0;
+    queue_t &gyro = this->queue[EKF_FUSION_GYRO];
+    while (true) {
+        // Oldest accelerometer / magnetometer sample
+        queue_t *meas = NULL;
+        for (int s = EKF_FUSION_ACCEL; s < EKF_FUSION_SENSORS; s++) {
+            queue_t &q = this->queue[s];
+            if ((q.count > 0) && ((meas == NULL) || (q.samples[q.head].time < meas->samples[meas->head].time))) {
+                meas = &q;
+            }
+        }
+        if (meas != NULL) {
+            ekf_fusion_sample_t sample = meas->samples[meas->head];
+            // The state is already at its time, or the next gyroscope sample is after it
+            bool ready = (this->started && (sample.time <= this->time)) ||
+                         ((gyro.count > 0) && (sample.time <= gyro.samples[gyro.head].time));
+            if (ready) {
+                meas->head = (meas->head + 1) % QUEUE_SIZE;
+                meas->count--;
+                if ((this->history_end != this->history_start) && this->Before(sample, this->History(this->history_end - 1))) {
+                    this->ProcessLate(sample);
+                } else {
+                    uint32_t seq = this->history_end++;
+                    if (this->history_end - this->history_start > HISTORY_SIZE) {
+                        this->history_start++;
+                    }
+                    this->History(seq) = sample;
+                    this->ProcessSample(sample, seq);
+                }
+                processed++;
+                continue;
+            }
+        }
+        if (gyro.count > 0) {
+            ekf_fusion_sample_t sample = gyro.samples[gyro.head];
+            gyro.head = (gyro.head + 1) % QUEUE_SIZE;
+            gyro.count--;
+            processed++;
+            if (this->started && (sample.time <= this->time)) {
+                // The gyroscope samples must be in time order
+                this->dropped_samples++;
+                continue;
+            }
+            uint32_t seq = this->history_end++;
+            if (this->history_end - this->history_start > HISTORY_SIZE) {
+                this->history_start++;
+            }
+            this->History(seq) = sample;
+            this->ProcessSample(sample, seq);
+            continue;
+        }
+        break;
+    }
+    return processed;
+}
+
+void ekf_imu13states_fusion::ProcessSample(const ekf_fusion_sample_t &sample, uint32_t seq)
+{
+    float data[3] = {sample.data[0], sample.data[1], sample.data[2]};
+    switch (sample.sensor) {
+    case EKF_FUSION_GYRO: {
+        if (this->pending == 0) {
+            // Save the state before the sample, to calculate again from it
+            this->checkpoint_last = (this->checkpoint_last + 1) % CHECKPOINTS;
+            if (this->checkpoint_count < CHECKPOINTS) {
+                this->checkpoint_count++;
+            }
+            checkpoint_t &cp = this->checkpoint[this->checkpoint_last];
+            cp.seq = seq;
+            cp.time = this->time;
+            cp.started = this->started;
+            memcpy(cp.X, this->filter.X.data, sizeof(cp.X));
+            memcpy(cp.P, this->filter.P.data, sizeof(cp.P));
+        }
+        if (!this->started) {
+            // First sample: start time of the filter
+            this->time = sample.time;
+            this->started = true;
+            break;
+        }
+        float dt = (sample.time - this->time) * 0.000001f;
+        this->filter.PredictState(data, dt);
+        this->time = sample.time;
+
+        this->pending++;
+        this->pending_dt += dt;
+        this->pending_dt2 += dt * dt;
+        for (int i = 0; i < 3; i++) {
+            this->pending_gyro[i] += data[i];
+        }
+        if (this->pending >= this->predict_batch) {
+            this->FlushPrediction();
+        }
+    } break;
+    case EKF_FUSION_ACCEL:
+        this->FlushPrediction();
+        this->filter.UpdateRefAccel(data, this->R_accel);
+        break;
+    case EKF_FUSION_MAGN:
+        this->FlushPrediction();
+        this->filter.UpdateRefMagn(data, this->R_magn);
+        break;
+    default:
+        break;
+    }
+}
+
+void ekf_imu13states_fusion::FlushPrediction()
+{
+    if (this->pending == 0) {
+        return;
+    }
+    // Linearization with the mean angular velocity of the pending samples
+    float u[3];
+    for (int i = 0; i < 3; i++) {
+        u[i] = this->pending_gyro[i] / this->pending;
+        this->pending_gyro[i] = 0;
+    }
+    this->filter.LinearizeFG(this->filter.X, u);
+    this->filter.CovariancePrediction(this->pending_dt, this->pending_dt2);
+    this->predictions++;
+
+    this->pending = 0;
+    this->pending_dt = 0;
+    this->pending_dt2 = 0;
+}
+
+void ekf_imu13states_fusion::ProcessLate(const ekf_fusion_sample_t &sample)
+{
+    // Position of the sample in the history
+    uint32_t pos = this->history_end;
+    while ((pos > this->history_start) && this->Before(sample, this->History(pos - 1))) {
+        pos--;
+    }
+    // The newest checkpoint before the position, that stays in the history
+    bool full = (this->history_end - this->history_start) >= HISTORY_SIZE;
+    uint32_t oldest = this->history_start + (full ? 1 : 0);
+    int index = -1;
+    int newer = 0;
+    for (int i = 0; i < this->checkpoint_count; i++) {
+        int c = (this->checkpoint_last - i + CHECKPOINTS) % CHECKPOINTS;
+        if (this->checkpoint[c].seq <= pos) {
+            if (this->checkpoint[c].seq >= oldest) {
+                index = c;
+                newer = i;
+            }
+            break;
+        }
+    }
+    if (index < 0) {
+        this->dropped_samples++;
+        return;
+    }
+
+    // Insert the sample
+    for (uint32_t seq = this->history_end; seq > pos; seq--) {
+        this->History(seq) = this->History(seq - 1);
+    }
+    this->History(pos) = sample;
+    this->history_end++;
+    if (full) {
+        this->history_start++;
+    }
+
+    // Restore the state of the checkpoint, it is saved again by the calculation
+    checkpoint_t &cp = this->checkpoint[index];
+    uint32_t start = cp.seq;
+    memcpy(this->filter.X.data, cp.X, sizeof(cp.X));
+    memcpy(this->filter.P.data, cp.P, sizeof(cp.P));
+    this->time = cp.time;
+    this->started = cp.started;
+    this->pending = 0;
+    this->pending_dt = 0;
+    this->pending_dt2 = 0;
+    for (int i = 0; i < 3; i++) {
+        this->pending_gyro[i] = 0;
+    }
+    this->checkpoint_count -= newer + 1;
+    this->checkpoint_last = (index - 1 + CHECKPOINTS) % CHECKPOINTS;
+
+    for (uint32_t seq = start; seq != this->history_end; seq++) {
+        this->ProcessSample(this->History(seq), seq);
+    }
+    this->late_samples++;
+}
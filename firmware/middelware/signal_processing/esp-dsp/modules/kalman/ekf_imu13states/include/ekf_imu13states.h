@@ -16,6 +16,21 @@
 #define _ekf_imu13states_H_
 
 #include "ekf.h"
+#include "mat_n.h"
+
+/**
+* @brief Fixed size matrices of the ekf_imu13states filter.
+*
+*   This is the first base class of ekf_imu13states: the matrices are constructed before
+*   the ekf base class, that uses their elements for X, F, G, P and Q.
+*/
+struct ekf_imu13states_mat {
+    dspm::MatN<13, 1> Xn;   /*!< Elements of X, state vector*/
+    dspm::MatN<13, 13> Fn;  /*!< Elements of F*/
+    dspm::MatN<13, 18> Gn;  /*!< Elements of G*/
+    dspm::MatN<13 * 14 / 2, 1> Pn;  /*!< Elements of P, covariance matrix: upper triangle, row by row*/
+    dspm::MatN<18, 18> Qn;  /*!< Elements of Q, input noise variances*/
+};
 
 /**
 * @brief This class is used to process and calculate attitude from imu sensors.
@@ -27,8 +42,14 @@
 *   X[10..12] - magnetometer offset value - magn_offset
 *
 *   where, reference magnetometer value = magn_ampl*rotation_matrix' + magn_offset
+*
+*   All matrices of the filter have fixed size (dspm::MatN) and are members of the object:
+*   Process(...) and the UpdateRefMeasurement(...) methods do not use the heap, and take
+*   the same time on every call.
+*   The covariance matrix P is stored packed (ekf::PackedP), and the measurements are applied
+*   with the sequential update ekf::UpdateSequential(...).
 */
-class ekf_imu13states: public ekf {
+class ekf_imu13states: protected ekf_imu13states_mat, public ekf {
 public:
     ekf_imu13states();
     virtual ~ekf_imu13states();
@@ -39,6 +60,40 @@ public:
     virtual dspm::Mat StateXdot(dspm::Mat &x, float *u);
     virtual void LinearizeFG(dspm::Mat &x, float *u);
 
+    /**
+     * Main processing method, same result as ekf::Process(...) without allocations:
+     * the Runge-Kutta state update uses StateXdot(...) of fixed size.
+     *
+     * @param[in] u: gyroscope values in radian per seconds (rad/sec)
+     * @param[in] dt: time difference from the last call in seconds
+     */
+    virtual void Process(float *u, float dt);
+    /**
+     * State prediction only (Runge-Kutta), without covariance prediction.
+     * Process(...) = LinearizeFG(...) + PredictState(...) + CovariancePrediction(...).
+     * Used to propagate the state with every gyroscope sample, and the covariance less often.
+     *
+     * @param[in] u: gyroscope values in radian per seconds (rad/sec)
+     * @param[in] dt: time difference from the last call in seconds
+     */
+    void PredictState(float *u, float dt);
+    /**
+     * Covariance prediction P = f*P*f' + dt^2*G*Q*G', where f = I + F*dt.
+     * Only the upper triangle of the symmetric result is calculated, directly in the packed P.
+     *
+     * @param[in] dt: time interval from last update
+     */
+    virtual void CovariancePrediction(float dt);
+    /**
+     * Covariance prediction P = f*P*f' + noise_dt2*G*Q*G', where f = I + F*dt.
+     * One prediction for several state predictions dt[i]: dt = sum(dt[i]) and
+     * noise_dt2 = sum(dt[i]^2) add the same noise as a prediction for each of them.
+     *
+     * @param[in] dt: time interval from last covariance prediction
+     * @param[in] noise_dt2: factor of the input noise G*Q*G'
+     */
+    void CovariancePrediction(float dt, float noise_dt2);
+
     /**
     *     Method for development and tests only.
     */
@@ -92,7 +147,49 @@ public:
      * @param[in] R: measurement noise covariance values for diagonal covariance matrix. Then smaller value, then more you trust them.
      */
     void UpdateRefMeasurement(float *accel_data, float *magn_data, float *attitude, float R[10]);
+    /**
+     * Update of attitude and gyro bias by accelerometer measurement only,
+     * for accelerometers with their own sample rate.
+     *
+     * @param[in] accel_data: accelerometer measurement vector XYZ in g, where 1 g ~ 9.81 m/s^2
+     * @param[in] R: measurement noise covariance values of XYZ
+     */
+    void UpdateRefAccel(float *accel_data, float R[3]);
+    /**
+     * Update of attitude and gyro bias by magnetometer measurement only,
+     * for magnetometers with their own sample rate.
+     *
+     * @param[in] magn_data: magnetometer measurement vector XYZ
+     * @param[in] R: measurement noise covariance values of XYZ
+     */
+    void UpdateRefMagn(float *magn_data, float R[3]);
+
+protected:
+    /**
+     * Derivative of state vector, without allocation.
+     *
+     * @param[in] x: state vector, only the elements 0..6 are used
+     * @param[in] u: gyroscope values in radian per seconds (rad/sec)
+     * @param[out] xdot: derivative of x
+     */
+    void StateXdot(const float *x, const float *u, dspm::MatN<13, 1> &xdot);
+    /**
+     * Measurement matrix of the accelerometer and magnetometer (rows 0..5) and
+     * the expected values of the measurements.
+     *
+     * @param[out] H: measurement matrix, rows 0..5 are written
+     * @param[out] expected: expected values of magnetometer (0..2) and accelerometer (3..5)
+     * @param[in] magn_state: include magnetometer amplitude and offset in the measurement matrix
+     */
+    template <int M>
+    void MeasurementAccelMagn(dspm::MatN<M, 13> &H, float *expected, bool magn_state);
 
+    dspm::MatN<13, 1> x_last;   /*!< Runge-Kutta: state at the start of the step*/
+    dspm::MatN<13, 1> k;        /*!< Runge-Kutta: derivative of the current stage*/
+    dspm::MatN<13, 1> k_sum;    /*!< Runge-Kutta: weighted sum of the derivatives*/
+    dspm::MatN<13, 13> fk;      /*!< Covariance prediction: I + F*dt*/
+    dspm::MatN<13, 13> fP;      /*!< Covariance prediction: f*P*/
+    dspm::MatN<13, 18> GQ;      /*!< Covariance prediction: G*Q*/
 };
 
 #endif // _ekf_imu13states_H_
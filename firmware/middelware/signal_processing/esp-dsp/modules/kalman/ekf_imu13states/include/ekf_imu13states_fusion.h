@@ -0,0 +1,198 @@
+// Copyright 2020-2021 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _ekf_imu13states_fusion_H_
+#define _ekf_imu13states_fusion_H_
+
+#include <stdint.h>
+#include "ekf_imu13states.h"
+
+/**
+* @brief Type of a sensor sample
+*/
+typedef enum {
+    EKF_FUSION_GYRO = 0,    /*!< gyroscope, rad/sec*/
+    EKF_FUSION_ACCEL,       /*!< accelerometer, g*/
+    EKF_FUSION_MAGN,        /*!< magnetometer*/
+    EKF_FUSION_SENSORS,     /*!< amount of sensors*/
+} ekf_fusion_sensor_t;
+
+/**
+* @brief Timestamped sensor sample
+*/
+typedef struct {
+    int64_t time;               /*!< timestamp of the sample, us (as esp_timer_get_time())*/
+    float data[3];              /*!< XYZ values*/
+    ekf_fusion_sensor_t sensor; /*!< sensor of the sample*/
+} ekf_fusion_sample_t;
+
+/**
+* @brief Multi-rate sensor fusion with ekf_imu13states.
+*
+*   Gyroscope, accelerometer and magnetometer have their own sample rate (e.g. 1 kHz, 200 Hz
+*   and 100 Hz). The timestamped samples are pushed to a queue for each sensor, and Run()
+*   processes them in time order:
+*   - every gyroscope sample propagates the state (attitude at gyroscope rate), the covariance
+*     prediction is done once for predict_batch gyroscope samples, or before an update;
+*   - every accelerometer / magnetometer sample updates the filter at its time.
+*
+*   Samples that arrive late (older than samples already processed) are inserted in the
+*   history of the last samples, and the filter is calculated again from the last checkpoint
+*   before them. Samples older than the history are discarded.
+*
+*   All the memory is allocated with the object. The queues are not thread safe:
+*   Push...() and Run() must be called from the same task.
+*/
+class ekf_imu13states_fusion {
+public:
+    static const int QUEUE_SIZE = 32;       /*!< samples in the queue of each sensor*/
+    static const int HISTORY_SIZE = 64;     /*!< processed samples that can be calculated again*/
+    static const int CHECKPOINTS = 8;       /*!< saved states of the filter, one each predict_batch gyroscope samples*/
+
+    /**
+     * Constructor of the fusion.
+     * @param[in] predict_batch: gyroscope samples for each covariance prediction
+     */
+    ekf_imu13states_fusion(int predict_batch = 4);
+    virtual ~ekf_imu13states_fusion();
+
+    /**
+     * Initialization of the filter and of the queues.
+     * The method should be called befare the first use.
+     */
+    void Init();
+
+    /**
+     * Add a gyroscope sample to its queue.
+     * @param[in] time: timestamp, us
+     * @param[in] gyro: angular velocity XYZ, rad/sec
+     *
+     * @return
+     *      - true if the sample is added, false if the queue is full
+     */
+    bool PushGyro(int64_t time, const float *gyro);
+    /**
+     * Add an accelerometer sample to its queue.
+     * @param[in] time: timestamp, us
+     * @param[in] accel: acceleration XYZ, g
+     *
+     * @return
+     *      - true if the sample is added, false if the queue is full
+     */
+    bool PushAccel(int64_t time, const float *accel);
+    /**
+     * Add a magnetometer sample to its queue.
+     * @param[in] time: timestamp, us
+     * @param[in] magn: magnetometer XYZ
+     *
+     * @return
+     *      - true if the sample is added, false if the queue is full
+     */
+    bool PushMagn(int64_t time, const float *magn);
+
+    /**
+     * Process the samples of the queues, in time order.
+     * Accelerometer and magnetometer samples newer than the last gyroscope sample stay
+     * in their queue, until the gyroscope samples reach their time.
+     *
+     * @return
+     *      - amount of processed samples
+     */
+    int Run();
+
+    /**
+     * The filter: X is the state, with the attitude quaternion in X.data[0..3]
+     */
+    ekf_imu13states filter;
+
+    float R_accel[3];   /*!< measurement noise covariance values of the accelerometer*/
+    float R_magn[3];    /*!< measurement noise covariance values of the magnetometer*/
+
+    int64_t time;                   /*!< time of the state of the filter, us*/
+    uint32_t predictions;           /*!< amount of covariance predictions*/
+    uint32_t late_samples;          /*!< amount of samples that were processed late*/
+    uint32_t dropped_samples;       /*!< amount of samples discarded: too late, or not in time order*/
+
+protected:
+    /**
+     * Queue of samples of a sensor
+     */
+    typedef struct {
+        ekf_fusion_sample_t samples[QUEUE_SIZE];
+        int head;   /*!< oldest sample*/
+        int count;  /*!< amount of samples*/
+    } queue_t;
+
+    /**
+     * State of the filter before a sample of the history
+     */
+    typedef struct {
+        uint32_t seq;           /*!< sequence number of the sample in the history*/
+        int64_t time;           /*!< time of the filter*/
+        bool started;           /*!< time of the filter is valid*/
+        float X[13];            /*!< state vector*/
+        float P[13 * 14 / 2];   /*!< covariance matrix, packed*/
+    } checkpoint_t;
+
+    bool Push(ekf_fusion_sensor_t sensor, int64_t time, const float *data);
+    /**
+     * Calculate a sample: state prediction or update.
+     * @param[in] sample: the sample
+     * @param[in] seq: sequence number of the sample in the history
+     */
+    void ProcessSample(const ekf_fusion_sample_t &sample, uint32_t seq);
+    /**
+     * Covariance prediction for the pending gyroscope samples.
+     */
+    void FlushPrediction();
+    /**
+     * Insert a late sample in the history and calculate the filter again.
+     * @param[in] sample: the late sample
+     */
+    void ProcessLate(const ekf_fusion_sample_t &sample);
+    /**
+     * Order of the samples: a measurement sample is before a gyroscope sample with the same time.
+     * @param[in] a: measurement sample
+     * @param[in] b: sample of the history
+     *
+     * @return
+     *      - true if a must be processed before b
+     */
+    static bool Before(const ekf_fusion_sample_t &a, const ekf_fusion_sample_t &b);
+    /**
+     * Sample of the history.
+     * @param[in] seq: sequence number of the sample
+     */
+    ekf_fusion_sample_t &History(uint32_t seq);
+
+    int predict_batch;
+
+    queue_t queue[EKF_FUSION_SENSORS];
+
+    ekf_fusion_sample_t history[HISTORY_SIZE];
+    uint32_t history_start;     /*!< sequence number of the oldest sample of the history*/
+    uint32_t history_end;       /*!< sequence number of the next sample*/
+
+    checkpoint_t checkpoint[CHECKPOINTS];
+    int checkpoint_count;       /*!< valid checkpoints, the newest is checkpoint[checkpoint_last]*/
+    int checkpoint_last;
+
+    bool started;           /*!< time of the filter is valid*/
+    int pending;            /*!< gyroscope samples without covariance prediction*/
+    float pending_dt;       /*!< sum of dt of the pending samples*/
+    float pending_dt2;      /*!< sum of dt^2 of the pending samples*/
+    float pending_gyro[3];  /*!< sum of gyroscope values of the pending samples*/
+};
+
+#endif // _ekf_imu13states_fusion_H_
@@ -19,9 +19,15 @@
 
 #include "ekf_imu13states.h"
 #include "esp_attr.h"
+#include "esp_heap_trace.h"
 
 static const char *TAG = "ekf_imu13states";
 
+#if CONFIG_HEAP_TRACING_STANDALONE
+#define TRACE_RECORDS 16
+static heap_trace_record_t trace_records[TRACE_RECORDS];
+#endif
+
 
 TEST_CASE("ekf_imu13states functionality gyro only", "[dspm]")
 {
@@ -58,3 +64,85 @@ TEST_CASE("ekf_imu13states functionality gyro and magn", "[dspm]")
     printf("Expected result = %i, calculated result = %i\n", 200, (int)(1000 * ekf13->X.data[5] + 0.5));
     printf("Expected result = %i, calculated result = %i\n", 300, (int)(1000 * ekf13->X.data[6] + 0.5));
 }
+
+TEST_CASE("ekf_imu13states step time", "[dspm]")
+{
+    ekf_imu13states *ekf13 = new  ekf_imu13states();
+    ekf13->Init();
+    float gyro[] = {0.1, 0.2, 0.3};
+    float accel[] = {0, 0, 1};
+    float magn[] = {1, 0, 0};
+    float R[] = {0.01, 0.01, 0.01, 0.01, 0.01, 0.01};
+    // The matrices are members of the filter: every step takes the same time
+    // and the heap is not used (every malloc and free is recorded by the heap
+    // tracing, even the ones freed in the same step)
+#if CONFIG_HEAP_TRACING_STANDALONE
+    TEST_ESP_OK(heap_trace_init_standalone(trace_records, TRACE_RECORDS));
+    TEST_ESP_OK(heap_trace_start(HEAP_TRACE_ALL));
+#else
+    ESP_LOGW(TAG, "CONFIG_HEAP_TRACING_STANDALONE disabled, heap allocations are not checked");
+#endif
+    unsigned int min_cycles = UINT32_MAX;
+    unsigned int max_cycles = 0;
+    for (int i = 0; i < 100; i++) {
+        unsigned int start_b = xthal_get_ccount();
+        ekf13->Process(gyro, 0.01);
+        ekf13->UpdateRefMeasurement(accel, magn, R);
+        unsigned int cycles = xthal_get_ccount() - start_b;
+        min_cycles = cycles < min_cycles ? cycles : min_cycles;
+        max_cycles = cycles > max_cycles ? cycles : max_cycles;
+    }
+#if CONFIG_HEAP_TRACING_STANDALONE
+    TEST_ESP_OK(heap_trace_stop());
+    TEST_ASSERT_EQUAL(0, heap_trace_get_count());
+#endif
+    ESP_LOGI(TAG, "Process + UpdateRefMeasurement: min %i, max %i cycles", min_cycles, max_cycles);
+    TEST_ASSERT_LESS_THAN(100, (int)(1000 * abs(ekf13->X.data[4] - 0.1)));
+    delete ekf13;
+}
+
+TEST_CASE("ekf_imu13states sequential update", "[dspm]")
+{
+    ekf_imu13states *ekf_seq = new  ekf_imu13states();
+    ekf_imu13states *ekf_ref = new  ekf_imu13states();
+    ekf_seq->Init();
+    ekf_ref->Init();
+    float gyro[] = {0.1, 0.2, 0.3};
+    for (int i = 0; i < 50; i++) {
+        ekf_seq->Process(gyro, 0.01);
+        ekf_ref->Process(gyro, 0.01);
+    }
+    // P is stored packed: 13*14/2 elements
+    TEST_ASSERT_TRUE(ekf_seq->PackedP);
+    TEST_ASSERT_EQUAL_INT(91, ekf_seq->P.length);
+
+    // Sequential scalar updates give the same result as the full matrix update
+    dspm::Mat H(6, 13);
+    for (int i = 0; i < H.length; i++) {
+        H.data[i] = ((i * 7) % 5 == 0) ? 0 : sinf(i);
+    }
+    float measured[] = {1, 0.1, 0.2, -0.1, 0.05, 0.9};
+    float expected[] = {0.9, 0, 0.1, 0, 0, 1};
+    float R[] = {0.01, 0.02, 0.01, 0.1, 0.1, 0.1};
+    ekf_seq->UpdateSequential(H, measured, expected, R);
+    ekf_ref->UpdateRef(H, measured, expected, R);
+    for (int i = 0; i < 13; i++) {
+        TEST_ASSERT_FLOAT_WITHIN(1e-4, ekf_ref->X.data[i], ekf_seq->X.data[i]);
+    }
+    for (int i = 0; i < 91; i++) {
+        TEST_ASSERT_FLOAT_WITHIN(1e-5, ekf_ref->P.data[i], ekf_seq->P.data[i]);
+    }
+
+    // P stays positive definite
+    float accel[] = {0, 0, 1};
+    float magn[] = {1, 0, 0};
+    for (int i = 0; i < 1000; i++) {
+        ekf_seq->Process(gyro, 0.01);
+        ekf_seq->UpdateRefMeasurementMagn(accel, magn, R);
+    }
+    dspm::Mat P_full(13, 13);
+    ekf::UnpackUpper(ekf_seq->P.data, P_full);
+    TEST_ESP_OK(P_full.cholesky());
+    delete ekf_seq;
+    delete ekf_ref;
+}
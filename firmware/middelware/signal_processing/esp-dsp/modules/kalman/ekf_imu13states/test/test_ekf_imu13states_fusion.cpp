@@ -0,0 +1,111 @@
+// Copyright 2018-2019 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string.h>
+#include "unity.h"
+#include "dsp_platform.h"
+#include "esp_log.h"
+
+#include "ekf_imu13states_fusion.h"
+#include "esp_attr.h"
+
+static const char *TAG = "ekf_imu13states_fusion";
+
+// Static sensor with gyroscope bias: gyro 1 kHz, accel 200 Hz, magn 100 Hz.
+// The magnetometer samples are pushed magn_delay_ms later than their time,
+// Run() is called each run_ms.
+static void fusion_simulation(ekf_imu13states_fusion *fusion, int duration_ms, int magn_delay_ms, int run_ms)
+{
+    float gyro[] = {0.1, 0.2, 0.3};
+    float accel[] = {0, 0, 1};
+    float magn[] = {1, 0, 0};
+    for (int t = 0; t < duration_ms + magn_delay_ms; t++) {
+        int64_t time = (int64_t)t * 1000;
+        if (t < duration_ms) {
+            TEST_ASSERT_TRUE(fusion->PushGyro(time, gyro));
+            if ((t % 5) == 0) {
+                TEST_ASSERT_TRUE(fusion->PushAccel(time, accel));
+            }
+        }
+        int t_magn = t - magn_delay_ms;
+        if ((t_magn >= 0) && ((t_magn % 10) == 0)) {
+            TEST_ASSERT_TRUE(fusion->PushMagn((int64_t)t_magn * 1000, magn));
+        }
+        if ((t % run_ms) == (run_ms - 1)) {
+            fusion->Run();
+        }
+    }
+    fusion->Run();
+}
+
+TEST_CASE("ekf_imu13states_fusion multi-rate sensors", "[dspm]")
+{
+    const int duration_ms = 10000;
+    ekf_imu13states_fusion *fusion = new ekf_imu13states_fusion(4);
+    // Reference: covariance prediction for every gyroscope sample
+    ekf_imu13states_fusion *reference = new ekf_imu13states_fusion(1);
+    unsigned int start_b = xthal_get_ccount();
+    fusion_simulation(fusion, duration_ms, 0, 10);
+    unsigned int end_b = xthal_get_ccount();
+    int cycles = (end_b - start_b) / duration_ms;
+    start_b = xthal_get_ccount();
+    fusion_simulation(reference, duration_ms, 0, 10);
+    end_b = xthal_get_ccount();
+    ESP_LOGI(TAG, "%i gyro samples: %i covariance predictions - %i cycles per gyro sample, %i predictions - %i cycles",
+             duration_ms, (int)fusion->predictions, cycles, (int)reference->predictions, (end_b - start_b) / duration_ms);
+
+    TEST_ASSERT_EQUAL(duration_ms * 1000 - 1000, fusion->time);
+    TEST_ASSERT_LESS_THAN(duration_ms / 2, (int)fusion->predictions);
+    TEST_ASSERT_EQUAL(duration_ms - 1, reference->predictions);
+    TEST_ASSERT_EQUAL(0, fusion->late_samples);
+    TEST_ASSERT_EQUAL(0, fusion->dropped_samples);
+    // Attitude and gyroscope bias as with a covariance prediction for each gyroscope sample
+    for (int i = 0; i < 7; i++) {
+        TEST_ASSERT_FLOAT_WITHIN(0.0005, reference->filter.X.data[i], fusion->filter.X.data[i]);
+    }
+    // The bias estimation goes to the gyroscope values
+    TEST_ASSERT_TRUE(fusion->filter.X.data[4] > 0.002);
+    TEST_ASSERT_FLOAT_WITHIN(0.002, 2 * fusion->filter.X.data[4], fusion->filter.X.data[5]);
+    TEST_ASSERT_FLOAT_WITHIN(0.002, 3 * fusion->filter.X.data[4], fusion->filter.X.data[6]);
+    delete fusion;
+    delete reference;
+}
+
+TEST_CASE("ekf_imu13states_fusion late samples", "[dspm]")
+{
+    const int duration_ms = 2000;
+    ekf_imu13states_fusion *in_time = new ekf_imu13states_fusion();
+    ekf_imu13states_fusion *late = new ekf_imu13states_fusion();
+    fusion_simulation(in_time, duration_ms, 0, 10);
+    // Magnetometer samples 3 ms late, Run() for each gyro sample
+    fusion_simulation(late, duration_ms, 3, 1);
+    TEST_ASSERT_EQUAL(0, in_time->late_samples);
+    TEST_ASSERT_EQUAL(duration_ms / 10, late->late_samples);
+    TEST_ASSERT_EQUAL(0, late->dropped_samples);
+    // Same result as with the samples in time order
+    for (int i = 0; i < 13; i++) {
+        TEST_ASSERT_EQUAL_FLOAT(in_time->filter.X.data[i], late->filter.X.data[i]);
+    }
+    for (int i = 0; i < in_time->filter.P.length; i++) {
+        TEST_ASSERT_EQUAL_FLOAT(in_time->filter.P.data[i], late->filter.P.data[i]);
+    }
+
+    // Samples older than the history are discarded
+    float magn[] = {1, 0, 0};
+    late->PushMagn(late->time - 500000, magn);
+    late->Run();
+    TEST_ASSERT_EQUAL(1, late->dropped_samples);
+    delete in_time;
+    delete late;
+}
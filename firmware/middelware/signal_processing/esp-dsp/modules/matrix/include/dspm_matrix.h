@@ -12,5 +12,6 @@
 #include "dspm_mult.h"
 #include "dspm_mulc.h"
 #include "dspm_sub.h"
+#include "dspm_solve.h"
 
 #endif // _dspm_matrix_H_
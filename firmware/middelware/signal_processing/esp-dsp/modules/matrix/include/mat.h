@@ -15,6 +15,7 @@
 #ifndef _dspm_mat_h_
 #define _dspm_mat_h_
 #include <iostream>
+#include "dsp_err.h"
 
 /**
  * @brief   DSP matrix namespace
@@ -22,6 +23,10 @@
  * DSP library matrix namespace.
  */
 namespace dspm {
+namespace expr {
+template <class E> struct Base;
+}
+
 /**
  * @brief   Matrix
  *
@@ -116,6 +121,24 @@ public:
      */
     Mat(const Mat &src);
 
+    /**
+     * @brief Move constructor
+     *
+     * The buffer of src is taken without copying it (src is left empty).
+     * If src is a sub-matrix or uses an external buffer, it works as the copy constructor.
+     *
+     * @param[in] src: source matrix
+     */
+    Mat(Mat &&src);
+
+    /**
+     * @brief Calculate an element-wise expression (see mat_expr.h)
+     *
+     * @param[in] src: expression
+     */
+    template <class E>
+    Mat(const expr::Base<E> &src);
+
     /**
      * @brief Create a subset of matrix as ROI (Region of Interest)
      *
@@ -207,6 +230,31 @@ public:
      */
     Mat &operator=(const Mat &src);
 
+    /**
+     * Move operator
+     *
+     * If both matrices own their buffers and the dimensions are different, the buffer of src
+     * is taken instead of allocating a new one. Otherwise it works as the copy operator.
+     *
+     * @param[in] src: source matrix
+     *
+     * @return
+     *      - matrix
+     */
+    Mat &operator=(Mat &&src);
+
+    /**
+     * Assign an element-wise expression (see mat_expr.h)
+     * The expression is written directly on the matrix buffer, without temporary matrices.
+     *
+     * @param[in] src: expression
+     *
+     * @return
+     *      - result matrix
+     */
+    template <class E>
+    Mat &operator=(const expr::Base<E> &src);
+
     /**
      * Access to the matrix elements.
      * @param[in] row: row position
@@ -243,6 +291,17 @@ public:
      */
     Mat &operator+=(const Mat &A);
 
+    /**
+     * += operator with an element-wise expression (see mat_expr.h)
+     *
+     * @param[in] src: expression
+     *
+     * @return
+     *      - result matrix: result += src
+     */
+    template <class E>
+    Mat &operator+=(const expr::Base<E> &src);
+
     /**
      * += operator
      * The operator use DSP optimized implementation of multiplication.
@@ -264,6 +323,17 @@ public:
      */
     Mat &operator-=(const Mat &A);
 
+    /**
+     * -= operator with an element-wise expression (see mat_expr.h)
+     *
+     * @param[in] src: expression
+     *
+     * @return
+     *      - result matrix: result -= src
+     */
+    template <class E>
+    Mat &operator-=(const expr::Base<E> &src);
+
     /**
      * -= operator
      * The operator use DSP optimized implementation of multiplication.
@@ -513,6 +583,83 @@ public:
      *      - determinant value
      */
     float det(int n);
+
+    /**
+     * @brief   Cholesky factorization
+     *
+     * Factorization of a symmetric positive definite matrix (e.g. a covariance matrix),
+     * in place: A = L * L', the matrix is replaced by L (the upper triangle is set to 0).
+     * Systems A * X = B are then solved with choleskySolve(...), without inverse matrix:
+     * about n^3/6 operations, instead of the cofactors of inverse().
+     *
+     * @return
+     *      - ESP_OK on success
+     *      - ESP_ERR_DSP_SINGULAR_MATRIX if the matrix is not positive definite
+     *      - One of the error codes from DSP library
+     */
+    esp_err_t cholesky();
+
+    /**
+     * @brief   Solve A * X = B after cholesky()
+     *
+     * @param[in] B: matrix [N]x[M], M right hand sides
+     *
+     * @return
+     *      - matrix [N]x[M] with the solutions, 0x0 on error
+     */
+    Mat choleskySolve(const Mat &B);
+
+    /**
+     * @brief   LDL' factorization
+     *
+     * Factorization of a symmetric matrix, in place: A = L * D * L', the matrix is replaced
+     * by L below the diagonal (its diagonal is 1) and D on the diagonal. No square roots, and
+     * the matrix does not need to be positive definite (only not singular).
+     *
+     * @return
+     *      - ESP_OK on success
+     *      - ESP_ERR_DSP_SINGULAR_MATRIX if an element of D is 0
+     *      - One of the error codes from DSP library
+     */
+    esp_err_t ldlt();
+
+    /**
+     * @brief   Solve A * X = B after ldlt()
+     *
+     * @param[in] B: matrix [N]x[M], M right hand sides
+     *
+     * @return
+     *      - matrix [N]x[M] with the solutions, 0x0 on error
+     */
+    Mat ldltSolve(const Mat &B);
+
+    /**
+     * @brief   QR factorization
+     *
+     * Householder QR factorization of a matrix [N]x[K], N >= K, in place: A = Q * R.
+     * The matrix is replaced by R (upper triangle) and the Householder vectors (below the diagonal),
+     * see dspm_qr_f32.
+     *
+     * @param[out] tau: factors of the reflections, resized to [K]x[1] if needed
+     *
+     * @return
+     *      - ESP_OK on success
+     *      - One of the error codes from DSP library
+     */
+    esp_err_t qr(Mat &tau);
+
+    /**
+     * @brief   Least squares solution of A * X = B after qr()
+     *
+     * X minimizes |A * X - B| for every column of B. With N == K it is the solution of the system.
+     *
+     * @param[in] tau: result of qr()
+     * @param[in] B: matrix [N]x[M], M right hand sides
+     *
+     * @return
+     *      - matrix [K]x[M] with the solutions, 0x0 on error
+     */
+    Mat qrSolve(const Mat &tau, const Mat &B);
 private:
     Mat cofactor(int row, int col, int n);
     Mat adjoint();
@@ -550,52 +697,6 @@ std::ostream &operator<<(std::ostream &os, const Mat::Rect &rect);
  */
 std::istream &operator>>(std::istream &is, Mat &m);
 
-/**
- * + operator, sum of two matrices
- * The operator use DSP optimized implementation of multiplication.
- *
- * @param[in] A: Input matrix A
- * @param[in] B: Input matrix B
- *
- * @return
- *     - result matrix A+B
-*/
-Mat operator+(const Mat &A, const Mat &B);
-/**
- * + operator, sum of matrix with constant
- * The operator use DSP optimized implementation of multiplication.
- *
- * @param[in] A: Input matrix A
- * @param[in] C: Input constant
- *
- * @return
- *     - result matrix A+C
-*/
-Mat operator+(const Mat &A, float C);
-
-/**
- * - operator, subtraction of two matrices
- * The operator use DSP optimized implementation of multiplication.
- *
- * @param[in] A: Input matrix A
- * @param[in] B: Input matrix B
- *
- * @return
- *     - result matrix A-B
-*/
-Mat operator-(const Mat &A, const Mat &B);
-/**
- * - operator, sum of matrix with constant
- * The operator use DSP optimized implementation of multiplication.
- *
- * @param[in] A: Input matrix A
- * @param[in] C: Input constant
- *
- * @return
- *     - result matrix A+C
-*/
-Mat operator-(const Mat &A, float C);
-
 /**
  * * operator, multiplication of two matrices.
  * The operator use DSP optimized implementation of multiplication.
@@ -608,53 +709,6 @@ Mat operator-(const Mat &A, float C);
 */
 Mat operator*(const Mat &A, const Mat &B);
 
-/**
- * * operator, multiplication of matrix with constant
- * The operator use DSP optimized implementation of multiplication.
- *
- * @param[in] A: Input matrix A
- * @param[in] C: floating point value
- *
- * @return
- *     - result matrix A*B
-*/
-Mat operator*(const Mat &A, float C);
-
-/**
- * * operator, multiplication of matrix with constant
- * The operator use DSP optimized implementation of multiplication.
- *
- * @param[in] C: floating point value
- * @param[in] A: Input matrix A
- *
- * @return
- *     - result matrix A*B
-*/
-Mat operator*(float C, const Mat &A);
-
-/**
- * / operator, divide of matrix by constant
- * The operator use DSP optimized implementation of multiplication.
- *
- * @param[in] A: Input matrix A
- * @param[in] C: floating point value
- *
- * @return
- *     - result matrix A*B
-*/
-Mat operator/(const Mat &A, float C);
-
-/**
- * / operator, divide matrix A by matrix B
- *
- * @param[in] A: Input matrix A
- * @param[in] B: Input matrix B
- *
- * @return
- *     - result matrix C, where C[i,j] = A[i,j]/B[i,j]
-*/
-Mat operator/(const Mat &A, const Mat &B);
-
 /**
  * == operator, compare two matrices
  *
@@ -668,4 +722,8 @@ Mat operator/(const Mat &A, const Mat &B);
 bool operator==(const Mat &A, const Mat &B);
 
 }
+
+// Element-wise operators
+#include "mat_expr.h"
+
 #endif //_dspm_mat_h_
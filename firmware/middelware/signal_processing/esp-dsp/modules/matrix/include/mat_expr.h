@@ -0,0 +1,529 @@
+// Copyright 2018-2023 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _dspm_mat_expr_h_
+#define _dspm_mat_expr_h_
+#include <type_traits>
+#include "esp_log.h"
+
+// Included by mat.h after the Mat class: do not include directly.
+
+namespace dspm {
+/**
+ * @brief   Element-wise matrix expressions
+ *
+ * The element-wise operators (+, - and / between matrices, +, -, * and / with constants) do not
+ * calculate anything: they return a small object that describes the operation. The whole
+ * expression is calculated when it is assigned to a Mat, in one loop that writes every element
+ * of the destination once, without temporary matrices:
+ *
+ *      x = Xlast + (K1 + 2.0f * K2 + 2.0f * K3 + K4) * (dt / 6.0f);
+ *
+ * Expressions keep references to their matrices, so they must be assigned in the same statement
+ * (do not store them with auto). Each element of the result only depends on the same element of
+ * the operands, so the destination may also be an operand (x = x + y), but it must not overlap
+ * with a sub-matrix of itself at a different position.
+ * The product of two matrices (Mat * Mat) is calculated when it is evaluated, as before.
+ */
+namespace expr {
+
+/**
+ * @brief Base of every expression (CRTP)
+ */
+template <class E>
+struct Base {
+    /**
+     * @brief Expression as its own type
+     */
+    inline const E &self() const
+    {
+        return static_cast<const E &>(*this);
+    }
+
+    /**
+     * @brief Calculate the expression
+     *
+     * @return
+     *      - result matrix
+     */
+    inline Mat eval() const
+    {
+        return Mat(*this);
+    }
+
+    /**
+     * @brief Calculate the expression and transpose it
+     *
+     * @return
+     *      - transposed matrix
+     */
+    inline Mat t() const
+    {
+        return Mat(*this).t();
+    }
+};
+
+/**
+ * @brief Matrix operand
+ */
+class Leaf : public Base<Leaf> {
+public:
+    explicit Leaf(const Mat &m) : m(m) {}
+    inline int rows() const
+    {
+        return m.rows;
+    }
+    inline int cols() const
+    {
+        return m.cols;
+    }
+    inline bool valid() const
+    {
+        return true;
+    }
+    /** Elements are stored without padding: they can be accessed as an array */
+    inline bool contiguous() const
+    {
+        return m.padding == 0;
+    }
+    inline float operator[](int i) const
+    {
+        return m.data[i];
+    }
+    inline float operator()(int row, int col) const
+    {
+        return m.data[row * m.stride + col];
+    }
+private:
+    const Mat &m;
+};
+
+/**
+ * @brief Tag of the matrix types that keep their elements inside the object (MatN):
+ * they are referenced by the expressions, not copied
+ */
+struct Storage {
+};
+
+/**
+ * @brief Operand with the elements inside the object
+ */
+template <class T>
+class Ref : public Base<Ref<T> > {
+public:
+    explicit Ref(const T &m) : m(m) {}
+    inline int rows() const
+    {
+        return m.rows();
+    }
+    inline int cols() const
+    {
+        return m.cols();
+    }
+    inline bool valid() const
+    {
+        return true;
+    }
+    inline bool contiguous() const
+    {
+        return true;
+    }
+    inline float operator[](int i) const
+    {
+        return m[i];
+    }
+    inline float operator()(int row, int col) const
+    {
+        return m(row, col);
+    }
+private:
+    const T &m;
+};
+
+/**
+ * @brief Operation between two expressions of the same dimensions
+ */
+template <class L, class R, class Op>
+class Binary : public Base<Binary<L, R, Op> > {
+public:
+    Binary(const L &a, const R &b) : a(a), b(b)
+    {
+        ok = a.valid() && b.valid() && (a.rows() == b.rows()) && (a.cols() == b.cols());
+        if (a.valid() && b.valid() && !ok) {
+            ESP_LOGW("Mat", "operator %c Error: matrices do not have equal dimensions", Op::symbol);
+        }
+    }
+    inline int rows() const
+    {
+        return a.rows();
+    }
+    inline int cols() const
+    {
+        return a.cols();
+    }
+    inline bool valid() const
+    {
+        return ok;
+    }
+    inline bool contiguous() const
+    {
+        return a.contiguous() && b.contiguous();
+    }
+    inline float operator[](int i) const
+    {
+        return Op::apply(a[i], b[i]);
+    }
+    inline float operator()(int row, int col) const
+    {
+        return Op::apply(a(row, col), b(row, col));
+    }
+private:
+    const L a;
+    const R b;
+    bool ok;
+};
+
+/**
+ * @brief Operation between an expression and a constant
+ */
+template <class E, class Op>
+class Scalar : public Base<Scalar<E, Op> > {
+public:
+    Scalar(const E &a, float c) : a(a), c(c) {}
+    inline int rows() const
+    {
+        return a.rows();
+    }
+    inline int cols() const
+    {
+        return a.cols();
+    }
+    inline bool valid() const
+    {
+        return a.valid();
+    }
+    inline bool contiguous() const
+    {
+        return a.contiguous();
+    }
+    inline float operator[](int i) const
+    {
+        return Op::apply(a[i], c);
+    }
+    inline float operator()(int row, int col) const
+    {
+        return Op::apply(a(row, col), c);
+    }
+private:
+    const E a;
+    const float c;
+};
+
+struct OpAdd {
+    static const char symbol = '+';
+    static inline float apply(float a, float b)
+    {
+        return a + b;
+    }
+};
+
+struct OpSub {
+    static const char symbol = '-';
+    static inline float apply(float a, float b)
+    {
+        return a - b;
+    }
+};
+
+struct OpMul {
+    static const char symbol = '*';
+    static inline float apply(float a, float b)
+    {
+        return a * b;
+    }
+};
+
+struct OpDiv {
+    static const char symbol = '/';
+    static inline float apply(float a, float b)
+    {
+        return a / b;
+    }
+};
+
+/**
+ * @brief Operand types: Mat (as a Leaf), MatN (as a Ref) and expressions (by value). Other types
+ * have no node, so the operators below are not taken into account for them.
+ */
+template <class T, class Enable = void>
+struct Operand {
+};
+
+template <>
+struct Operand<Mat> {
+    typedef Leaf node;
+    static inline node wrap(const Mat &m)
+    {
+        return node(m);
+    }
+};
+
+template <class T>
+struct Operand<T, typename std::enable_if<std::is_base_of<Base<T>, T>::value && !std::is_base_of<Storage, T>::value>::type> {
+    typedef T node;
+    static inline const node &wrap(const T &e)
+    {
+        return e;
+    }
+};
+
+template <class T>
+struct Operand<T, typename std::enable_if<std::is_base_of<Storage, T>::value>::type> {
+    typedef Ref<T> node;
+    static inline node wrap(const T &m)
+    {
+        return node(m);
+    }
+};
+
+/**
+ * @brief Writes an expression on a matrix of the same dimensions
+ *
+ * @param[out] dst: destination matrix
+ * @param[in] e: expression
+ * @param[in] accumulate: true - dst += e, false - dst = e
+ */
+template <class E>
+inline void evaluate(Mat &dst, const E &e, bool accumulate)
+{
+    if ((dst.padding == 0) && e.contiguous()) {
+        float *out = dst.data;
+        const int length = dst.rows * dst.cols;
+        if (accumulate) {
+            for (int i = 0; i < length; i++) {
+                out[i] += e[i];
+            }
+        } else {
+            for (int i = 0; i < length; i++) {
+                out[i] = e[i];
+            }
+        }
+        return;
+    }
+    for (int row = 0; row < dst.rows; row++) {
+        float *out = dst.data + row * dst.stride;
+        for (int col = 0; col < dst.cols; col++) {
+            out[col] = accumulate ? out[col] + e(row, col) : e(row, col);
+        }
+    }
+}
+
+} // namespace expr
+
+template <class E>
+Mat::Mat(const expr::Base<E> &src)
+{
+    const E &e = src.self();
+    this->rows = e.valid() ? e.rows() : 1;
+    this->cols = e.valid() ? e.cols() : 1;
+    this->sub_matrix = false;
+    this->stride = this->cols;
+    this->padding = 0;
+    allocate();
+    if (e.valid()) {
+        expr::evaluate(*this, e, false);
+    } else {
+        this->data[0] = 0;
+    }
+}
+
+template <class E>
+Mat &Mat::operator=(const expr::Base<E> &src)
+{
+    const E &e = src.self();
+    if (!e.valid()) {
+        // Same result as the former operators: a 1x1 matrix
+        return (*this = Mat());
+    }
+    if ((this->rows != e.rows()) || (this->cols != e.cols())) {
+        if (this->sub_matrix) {
+            ESP_LOGE("Mat", "operator = Error for sub-matrices: operands matrices dimensions %dx%d and %dx%d do not match", this->rows, this->cols, e.rows(), e.cols());
+            return *this;
+        }
+        // The expression may use the current buffer (e.g. a sub-matrix of this matrix):
+        // it is released after the evaluation
+        Mat temp(src);
+        return (*this = static_cast<Mat &&>(temp));
+    }
+    expr::evaluate(*this, e, false);
+    return *this;
+}
+
+template <class E>
+Mat &Mat::operator+=(const expr::Base<E> &src)
+{
+    const E &e = src.self();
+    if (!e.valid() || (this->rows != e.rows()) || (this->cols != e.cols())) {
+        ESP_LOGW("Mat", "operator += Error: matrices do not have equal dimensions");
+        return *this;
+    }
+    expr::evaluate(*this, e, true);
+    return *this;
+}
+
+template <class E>
+Mat &Mat::operator-=(const expr::Base<E> &src)
+{
+    const E &e = src.self();
+    if (!e.valid() || (this->rows != e.rows()) || (this->cols != e.cols())) {
+        ESP_LOGW("Mat", "operator -= Error: matrices do not have equal dimensions");
+        return *this;
+    }
+    expr::evaluate(*this, expr::Scalar<E, expr::OpMul>(e, -1.0f), true);
+    return *this;
+}
+
+/**
+ * + operator, sum of two matrices (or expressions)
+ *
+ * @param[in] A: Input matrix A
+ * @param[in] B: Input matrix B
+ *
+ * @return
+ *     - expression A+B
+*/
+template <class L, class R>
+inline expr::Binary<typename expr::Operand<L>::node, typename expr::Operand<R>::node, expr::OpAdd>
+operator+(const L &A, const R &B)
+{
+    return expr::Binary<typename expr::Operand<L>::node, typename expr::Operand<R>::node, expr::OpAdd>(expr::Operand<L>::wrap(A), expr::Operand<R>::wrap(B));
+}
+
+/**
+ * - operator, subtraction of two matrices (or expressions)
+ *
+ * @param[in] A: Input matrix A
+ * @param[in] B: Input matrix B
+ *
+ * @return
+ *     - expression A-B
+*/
+template <class L, class R>
+inline expr::Binary<typename expr::Operand<L>::node, typename expr::Operand<R>::node, expr::OpSub>
+operator-(const L &A, const R &B)
+{
+    return expr::Binary<typename expr::Operand<L>::node, typename expr::Operand<R>::node, expr::OpSub>(expr::Operand<L>::wrap(A), expr::Operand<R>::wrap(B));
+}
+
+/**
+ * / operator, divide matrix A by matrix B
+ *
+ * @param[in] A: Input matrix A
+ * @param[in] B: Input matrix B
+ *
+ * @return
+ *     - expression C, where C[i,j] = A[i,j]/B[i,j]
+*/
+template <class L, class R>
+inline expr::Binary<typename expr::Operand<L>::node, typename expr::Operand<R>::node, expr::OpDiv>
+operator/(const L &A, const R &B)
+{
+    return expr::Binary<typename expr::Operand<L>::node, typename expr::Operand<R>::node, expr::OpDiv>(expr::Operand<L>::wrap(A), expr::Operand<R>::wrap(B));
+}
+
+/**
+ * + operator, sum of matrix with constant
+ *
+ * @param[in] A: Input matrix A
+ * @param[in] C: Input constant
+ *
+ * @return
+ *     - expression A+C
+*/
+template <class E>
+inline expr::Scalar<typename expr::Operand<E>::node, expr::OpAdd> operator+(const E &A, float C)
+{
+    return expr::Scalar<typename expr::Operand<E>::node, expr::OpAdd>(expr::Operand<E>::wrap(A), C);
+}
+
+/**
+ * - operator, subtraction of constant from matrix
+ *
+ * @param[in] A: Input matrix A
+ * @param[in] C: Input constant
+ *
+ * @return
+ *     - expression A-C
+*/
+template <class E>
+inline expr::Scalar<typename expr::Operand<E>::node, expr::OpAdd> operator-(const E &A, float C)
+{
+    return expr::Scalar<typename expr::Operand<E>::node, expr::OpAdd>(expr::Operand<E>::wrap(A), -C);
+}
+
+/**
+ * * operator, multiplication of matrix with constant
+ *
+ * @param[in] A: Input matrix A
+ * @param[in] C: floating point value
+ *
+ * @return
+ *     - expression A*C
+*/
+template <class E>
+inline expr::Scalar<typename expr::Operand<E>::node, expr::OpMul> operator*(const E &A, float C)
+{
+    return expr::Scalar<typename expr::Operand<E>::node, expr::OpMul>(expr::Operand<E>::wrap(A), C);
+}
+
+/**
+ * * operator, multiplication of matrix with constant
+ *
+ * @param[in] C: floating point value
+ * @param[in] A: Input matrix A
+ *
+ * @return
+ *     - expression C*A
+*/
+template <class E>
+inline expr::Scalar<typename expr::Operand<E>::node, expr::OpMul> operator*(float C, const E &A)
+{
+    return expr::Scalar<typename expr::Operand<E>::node, expr::OpMul>(expr::Operand<E>::wrap(A), C);
+}
+
+/**
+ * / operator, divide of matrix by constant
+ *
+ * @param[in] A: Input matrix A
+ * @param[in] C: floating point value
+ *
+ * @return
+ *     - expression A/C
+*/
+template <class E>
+inline expr::Scalar<typename expr::Operand<E>::node, expr::OpMul> operator/(const E &A, float C)
+{
+    return expr::Scalar<typename expr::Operand<E>::node, expr::OpMul>(expr::Operand<E>::wrap(A), 1 / C);
+}
+
+namespace expr {
+// Operators found by argument dependent lookup with expressions as operands
+using dspm::operator+;
+using dspm::operator-;
+using dspm::operator*;
+using dspm::operator/;
+} // namespace expr
+
+} // namespace dspm
+#endif //_dspm_mat_expr_h_
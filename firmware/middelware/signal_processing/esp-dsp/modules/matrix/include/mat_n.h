@@ -0,0 +1,478 @@
+// Copyright 2018-2023 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _dspm_mat_n_h_
+#define _dspm_mat_n_h_
+#include <math.h>
+#include "mat.h"
+
+namespace dspm {
+/**
+ * @brief   Matrix with dimensions known at compile time
+ *
+ * The elements are stored inside the object (row by row, without padding): a MatN never uses
+ * the heap, it can be a member of a class or a local variable, and the loops of its operations
+ * have constant bounds, so the compiler can unroll them.
+ * It is intended for the small matrices of filters (states, covariances, rotations); big
+ * matrices should use Mat, to not overflow the stack.
+ *
+ * MatN takes part in the element-wise expressions of Mat (+, -, / and constants, see mat_expr.h),
+ * and can be assigned to a Mat of the same dimensions without allocation:
+ *
+ *      dspm::MatN<4, 4> omega = 0.5f * skew;
+ *      this->P = p;                 // Mat = MatN, copy of the elements
+ *      dspm::Mat v = p.view();      // Mat that works on the elements of p
+ *
+ * Operations with a dimensions mismatch do not compile, except with a Mat or an expression,
+ * where the error is reported at run time and the destination is not modified.
+ */
+template <int R, int C>
+class MatN : public expr::Base<MatN<R, C> >, public expr::Storage {
+public:
+    static_assert((R > 0) && (C > 0), "MatN dimensions must be positive");
+
+    static const int ROWS = R;      /*!< Amount of rows*/
+    static const int COLS = C;      /*!< Amount of columns*/
+    static const int LENGTH = R * C;/*!< Amount of elements*/
+
+    float data[R * C];              /*!< Elements of the matrix, row by row*/
+
+    /**
+     * Constructor, all elements are 0
+     */
+    MatN() : data() {}
+
+    /**
+     * Constructor from an array
+     *
+     * @param[in] src: array of R*C elements, row by row
+     */
+    explicit MatN(const float *src)
+    {
+        for (int i = 0; i < R * C; i++) {
+            data[i] = src[i];
+        }
+    }
+
+    /**
+     * Constructor from a Mat, that must have the same dimensions
+     *
+     * @param[in] m: source matrix
+     */
+    explicit MatN(const Mat &m) : data()
+    {
+        *this = m;
+    }
+
+    /**
+     * Constructor from an element-wise expression
+     *
+     * @param[in] src: expression with R rows and C columns
+     */
+    template <class E>
+    MatN(const expr::Base<E> &src) : data()
+    {
+        assign(src.self(), false);
+    }
+
+    /**
+     * Copy of a Mat, that must have the same dimensions
+     *
+     * @param[in] m: source matrix
+     *
+     * @return
+     *      - this matrix
+     */
+    MatN &operator=(const Mat &m)
+    {
+        if ((m.rows != R) || (m.cols != C)) {
+            ESP_LOGE("MatN", "operator = Error: matrix %dx%d can not be copied to MatN<%d, %d>", m.rows, m.cols, R, C);
+            return *this;
+        }
+        for (int row = 0; row < R; row++) {
+            for (int col = 0; col < C; col++) {
+                data[row * C + col] = m.data[row * m.stride + col];
+            }
+        }
+        return *this;
+    }
+
+    /**
+     * Calculation of an element-wise expression
+     *
+     * @param[in] src: expression with R rows and C columns
+     *
+     * @return
+     *      - this matrix
+     */
+    template <class E>
+    MatN &operator=(const expr::Base<E> &src)
+    {
+        assign(src.self(), false);
+        return *this;
+    }
+
+    /**
+     * += operator with an element-wise expression
+     *
+     * @param[in] src: expression with R rows and C columns
+     *
+     * @return
+     *      - this matrix
+     */
+    template <class E>
+    MatN &operator+=(const expr::Base<E> &src)
+    {
+        assign(src.self(), true);
+        return *this;
+    }
+
+    /**
+     * -= operator with an element-wise expression
+     *
+     * @param[in] src: expression with R rows and C columns
+     *
+     * @return
+     *      - this matrix
+     */
+    template <class E>
+    MatN &operator-=(const expr::Base<E> &src)
+    {
+        assign(expr::Scalar<E, expr::OpMul>(src.self(), -1.0f), true);
+        return *this;
+    }
+
+    /**
+     * *= operator, multiplication by a constant
+     *
+     * @param[in] num: constant
+     *
+     * @return
+     *      - this matrix
+     */
+    MatN &operator*=(float num)
+    {
+        for (int i = 0; i < R * C; i++) {
+            data[i] *= num;
+        }
+        return *this;
+    }
+
+    /**
+     * /= operator, division by a constant
+     *
+     * @param[in] num: constant
+     *
+     * @return
+     *      - this matrix
+     */
+    MatN &operator/=(float num)
+    {
+        return (*this *= (1 / num));
+    }
+
+    /**
+     * Access to an element
+     *
+     * @param[in] row: row index
+     * @param[in] col: column index
+     *
+     * @return
+     *      - element (row, col)
+     */
+    inline float &operator()(int row, int col)
+    {
+        return data[row * C + col];
+    }
+    inline float operator()(int row, int col) const
+    {
+        return data[row * C + col];
+    }
+    inline float &operator[](int i)
+    {
+        return data[i];
+    }
+    inline float operator[](int i) const
+    {
+        return data[i];
+    }
+
+    // Interface of the element-wise expressions
+    static inline constexpr int rows()
+    {
+        return R;
+    }
+    static inline constexpr int cols()
+    {
+        return C;
+    }
+    static inline constexpr bool valid()
+    {
+        return true;
+    }
+    static inline constexpr bool contiguous()
+    {
+        return true;
+    }
+
+    /**
+     * Mat header on the elements of this matrix, without allocation. The dimensions of
+     * the view can not be changed, and it must not be used after this matrix is destroyed.
+     *
+     * @return
+     *      - matrix R x C
+     */
+    Mat view()
+    {
+        return Mat(data, R, C, C);
+    }
+
+    /**
+     * Transposed matrix
+     *
+     * @return
+     *      - matrix C x R
+     */
+    MatN<C, R> t() const
+    {
+        MatN<C, R> result;
+        for (int row = 0; row < R; row++) {
+            for (int col = 0; col < C; col++) {
+                result.data[col * R + row] = data[row * C + col];
+            }
+        }
+        return result;
+    }
+
+    /**
+     * Euclidean norm of the matrix
+     *
+     * @return
+     *      - square root of the sum of squares of all elements
+     */
+    float norm() const
+    {
+        float sum = 0;
+        for (int i = 0; i < R * C; i++) {
+            sum += data[i] * data[i];
+        }
+        return sqrtf(sum);
+    }
+
+    /**
+     * Copy of a smaller matrix into this one
+     *
+     * @param[in] src: source matrix
+     * @param[in] row_pos: row of this matrix for the first row of src
+     * @param[in] col_pos: column of this matrix for the first column of src
+     */
+    template <int SR, int SC>
+    void Copy(const MatN<SR, SC> &src, int row_pos, int col_pos)
+    {
+        static_assert((SR <= R) && (SC <= C), "source bigger than the destination");
+        if ((row_pos < 0) || (col_pos < 0) || (row_pos + SR > R) || (col_pos + SC > C)) {
+            ESP_LOGE("MatN", "Copy Error: %dx%d block at (%d, %d) out of MatN<%d, %d>", SR, SC, row_pos, col_pos, R, C);
+            return;
+        }
+        for (int row = 0; row < SR; row++) {
+            for (int col = 0; col < SC; col++) {
+                data[(row_pos + row) * C + col_pos + col] = src.data[row * SC + col];
+            }
+        }
+    }
+
+    /**
+     * Copy of a part of this matrix
+     *
+     * @param[in] row_start: first row of the part
+     * @param[in] col_start: first column of the part
+     *
+     * @return
+     *      - matrix SR x SC
+     */
+    template <int SR, int SC>
+    MatN<SR, SC> Get(int row_start, int col_start) const
+    {
+        static_assert((SR <= R) && (SC <= C), "part bigger than the matrix");
+        MatN<SR, SC> result;
+        if ((row_start < 0) || (col_start < 0) || (row_start + SR > R) || (col_start + SC > C)) {
+            ESP_LOGE("MatN", "Get Error: %dx%d block at (%d, %d) out of MatN<%d, %d>", SR, SC, row_start, col_start, R, C);
+            return result;
+        }
+        for (int row = 0; row < SR; row++) {
+            for (int col = 0; col < SC; col++) {
+                result.data[row * SC + col] = data[(row_start + row) * C + col_start + col];
+            }
+        }
+        return result;
+    }
+
+    /**
+     * Identity matrix
+     *
+     * @return
+     *      - matrix with ones on the diagonal
+     */
+    static MatN eye()
+    {
+        MatN result;
+        for (int i = 0; i < ((R < C) ? R : C); i++) {
+            result.data[i * C + i] = 1;
+        }
+        return result;
+    }
+
+private:
+    template <class E>
+    void assign(const E &e, bool accumulate)
+    {
+        if (!e.valid() || (e.rows() != R) || (e.cols() != C)) {
+            ESP_LOGE("MatN", "operator = Error: expression %dx%d does not match MatN<%d, %d>", e.rows(), e.cols(), R, C);
+            return;
+        }
+        if (e.contiguous()) {
+            for (int i = 0; i < R * C; i++) {
+                data[i] = accumulate ? data[i] + e[i] : e[i];
+            }
+            return;
+        }
+        for (int row = 0; row < R; row++) {
+            for (int col = 0; col < C; col++) {
+                data[row * C + col] = accumulate ? data[row * C + col] + e(row, col) : e(row, col);
+            }
+        }
+    }
+};
+
+/**
+ * Matrix product: result = A * B
+ *
+ * @param[in] A: matrix R x K
+ * @param[in] B: matrix K x C
+ * @param[out] result: matrix R x C, must not be A or B
+ */
+template <int R, int K, int C>
+inline void mult(const MatN<R, K> &A, const MatN<K, C> &B, MatN<R, C> &result)
+{
+    for (int row = 0; row < R; row++) {
+        const float *a = &A.data[row * K];
+        for (int col = 0; col < C; col++) {
+            float sum = 0;
+            for (int k = 0; k < K; k++) {
+                sum += a[k] * B.data[k * C + col];
+            }
+            result.data[row * C + col] = sum;
+        }
+    }
+}
+
+/**
+ * Rotation of a vector, 3x3 * 3x1
+ */
+inline void mult(const MatN<3, 3> &A, const MatN<3, 1> &B, MatN<3, 1> &result)
+{
+    const float *a = A.data;
+    const float *b = B.data;
+    result.data[0] = a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+    result.data[1] = a[3] * b[0] + a[4] * b[1] + a[5] * b[2];
+    result.data[2] = a[6] * b[0] + a[7] * b[1] + a[8] * b[2];
+}
+
+/**
+ * Quaternion product, 4x4 * 4x1
+ */
+inline void mult(const MatN<4, 4> &A, const MatN<4, 1> &B, MatN<4, 1> &result)
+{
+    const float *a = A.data;
+    const float *b = B.data;
+    result.data[0] = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+    result.data[1] = a[4] * b[0] + a[5] * b[1] + a[6] * b[2] + a[7] * b[3];
+    result.data[2] = a[8] * b[0] + a[9] * b[1] + a[10] * b[2] + a[11] * b[3];
+    result.data[3] = a[12] * b[0] + a[13] * b[1] + a[14] * b[2] + a[15] * b[3];
+}
+
+/**
+ * Product with a transposed matrix: result = accumulate ? result + scale * A * B' : scale * A * B'
+ * Rows of A and B are read in order, B' is not calculated.
+ *
+ * @param[in] A: matrix R x K
+ * @param[in] B: matrix C x K
+ * @param[out] result: matrix R x C, must not be A or B
+ * @param[in] scale: factor of the product
+ * @param[in] accumulate: add the product to result
+ */
+template <int R, int K, int C>
+inline void mult_t(const MatN<R, K> &A, const MatN<C, K> &B, MatN<R, C> &result, float scale = 1, bool accumulate = false)
+{
+    for (int row = 0; row < R; row++) {
+        const float *a = &A.data[row * K];
+        for (int col = 0; col < C; col++) {
+            const float *b = &B.data[col * K];
+            float sum = 0;
+            for (int k = 0; k < K; k++) {
+                sum += a[k] * b[k];
+            }
+            result.data[row * C + col] = scale * sum + (accumulate ? result.data[row * C + col] : 0);
+        }
+    }
+}
+
+/**
+ * Product with a transposed matrix when the result is known to be symmetric
+ * (e.g. F*P*F', G*Q*G'): the upper triangle is calculated and copied to the lower one,
+ * about half the operations of mult_t.
+ *
+ * @param[in] A: matrix N x K
+ * @param[in] B: matrix N x K
+ * @param[out] result: matrix N x N, must not be A or B
+ * @param[in] scale: factor of the product
+ * @param[in] accumulate: add the product to result
+ */
+template <int N, int K>
+inline void mult_t_sym(const MatN<N, K> &A, const MatN<N, K> &B, MatN<N, N> &result, float scale = 1, bool accumulate = false)
+{
+    for (int row = 0; row < N; row++) {
+        const float *a = &A.data[row * K];
+        for (int col = row; col < N; col++) {
+            const float *b = &B.data[col * K];
+            float sum = 0;
+            for (int k = 0; k < K; k++) {
+                sum += a[k] * b[k];
+            }
+            float value = scale * sum + (accumulate ? result.data[row * N + col] : 0);
+            result.data[row * N + col] = value;
+            result.data[col * N + row] = value;
+        }
+    }
+}
+
+/**
+ * * operator, matrix product
+ *
+ * @param[in] A: matrix R x K
+ * @param[in] B: matrix K x C
+ *
+ * @return
+ *     - matrix R x C
+ */
+template <int R, int K, int C>
+inline MatN<R, C> operator*(const MatN<R, K> &A, const MatN<K, C> &B)
+{
+    MatN<R, C> result;
+    mult(A, B, result);
+    return result;
+}
+
+} // namespace dspm
+#endif //_dspm_mat_n_h_
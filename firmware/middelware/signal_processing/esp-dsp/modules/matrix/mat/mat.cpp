@@ -133,6 +133,34 @@ Mat::Mat(const Mat &m)
     }
 }
 
+Mat::Mat(Mat &&m)
+{
+    this->rows = m.rows;
+    this->cols = m.cols;
+    this->padding = m.padding;
+    this->stride = m.stride;
+    this->length = m.length;
+    this->data = m.data;
+    this->sub_matrix = m.sub_matrix;
+    this->ext_buff = m.ext_buff;
+
+    if (m.ext_buff) {
+        // Sub-matrix: header only, external buffer: copy of the data
+        if (!m.sub_matrix) {
+            allocate();
+            memcpy(this->data, m.data, this->length * sizeof(float));
+        }
+    } else {
+        // Take the buffer, m is left as an empty matrix
+        m.data = NULL;
+        m.rows = 0;
+        m.cols = 0;
+        m.stride = 0;
+        m.length = 0;
+        m.ext_buff = true;
+    }
+}
+
 Mat Mat::getROI(int startRow, int startCol, int roiRows, int roiCols, int stride)
 {
     Mat result(this->data, roiRows, roiCols, 0);
@@ -257,6 +285,33 @@ Mat &Mat::operator=(const Mat &m)
     return *this;
 }
 
+Mat &Mat::operator=(Mat &&m)
+{
+    // With the same dimensions the data is copied, as the copy operator does: the buffer
+    // is kept, so sub-matrices of this matrix remain valid
+    if ((this == &m) || this->ext_buff || m.ext_buff || ((this->rows == m.rows) && (this->cols == m.cols))) {
+        return (*this = static_cast<const Mat &>(m));
+    }
+    // The copy operator would allocate a new buffer: take the one of m instead,
+    // m releases the former one
+    float *data = this->data;
+    int rows = this->rows;
+    int cols = this->cols;
+    this->rows = m.rows;
+    this->cols = m.cols;
+    this->stride = m.stride;
+    this->padding = m.padding;
+    this->length = m.length;
+    this->data = m.data;
+    m.rows = rows;
+    m.cols = cols;
+    m.stride = cols;
+    m.padding = 0;
+    m.length = rows * cols;
+    m.data = data;
+    return *this;
+}
+
 Mat &Mat::operator+=(const Mat &m)
 {
     if ((this->rows != m.rows) || (this->cols != m.cols)) {
@@ -818,6 +873,110 @@ Mat Mat::inverse()
     return result;
 }
 
+esp_err_t Mat::cholesky()
+{
+    if (this->rows != this->cols) {
+        ESP_LOGW("Mat", "cholesky Error: matrix %dx%d is not square", this->rows, this->cols);
+        return ESP_ERR_DSP_INVALID_PARAM;
+    }
+    if (this->padding != 0) {
+        Mat temp = this->Get(0, this->rows, 0, this->cols);
+        esp_err_t ret = temp.cholesky();
+        this->Copy(temp, 0, 0);
+        return ret;
+    }
+    return dspm_cholesky_f32(this->data, this->rows);
+}
+
+Mat Mat::choleskySolve(const Mat &B)
+{
+    if ((this->rows != this->cols) || (B.rows != this->rows)) {
+        ESP_LOGW("Mat", "choleskySolve Error: matrices %dx%d and %dx%d do not match", this->rows, this->cols, B.rows, B.cols);
+        return Mat(0, 0);
+    }
+    if (this->padding != 0) {
+        Mat temp = this->Get(0, this->rows, 0, this->cols);
+        return temp.choleskySolve(B);
+    }
+    Mat X(B.rows, B.cols);
+    X = B;
+    dspm_cholesky_solve_f32(this->data, X.data, this->rows, X.cols);
+    return X;
+}
+
+esp_err_t Mat::ldlt()
+{
+    if (this->rows != this->cols) {
+        ESP_LOGW("Mat", "ldlt Error: matrix %dx%d is not square", this->rows, this->cols);
+        return ESP_ERR_DSP_INVALID_PARAM;
+    }
+    if (this->padding != 0) {
+        Mat temp = this->Get(0, this->rows, 0, this->cols);
+        esp_err_t ret = temp.ldlt();
+        this->Copy(temp, 0, 0);
+        return ret;
+    }
+    return dspm_ldlt_f32(this->data, this->rows);
+}
+
+Mat Mat::ldltSolve(const Mat &B)
+{
+    if ((this->rows != this->cols) || (B.rows != this->rows)) {
+        ESP_LOGW("Mat", "ldltSolve Error: matrices %dx%d and %dx%d do not match", this->rows, this->cols, B.rows, B.cols);
+        return Mat(0, 0);
+    }
+    if (this->padding != 0) {
+        Mat temp = this->Get(0, this->rows, 0, this->cols);
+        return temp.ldltSolve(B);
+    }
+    Mat X(B.rows, B.cols);
+    X = B;
+    dspm_ldlt_solve_f32(this->data, X.data, this->rows, X.cols);
+    return X;
+}
+
+esp_err_t Mat::qr(Mat &tau)
+{
+    if (this->rows < this->cols) {
+        ESP_LOGW("Mat", "qr Error: matrix %dx%d has less rows than columns", this->rows, this->cols);
+        return ESP_ERR_DSP_INVALID_PARAM;
+    }
+    if ((tau.rows != this->cols) || (tau.cols != 1)) {
+        tau = Mat(this->cols, 1);
+    }
+    if ((this->padding != 0) || (tau.padding != 0)) {
+        Mat temp = this->Get(0, this->rows, 0, this->cols);
+        Mat temp_tau(this->cols, 1);
+        esp_err_t ret = temp.qr(temp_tau);
+        this->Copy(temp, 0, 0);
+        tau.Copy(temp_tau, 0, 0);
+        return ret;
+    }
+    return dspm_qr_f32(this->data, tau.data, this->rows, this->cols);
+}
+
+Mat Mat::qrSolve(const Mat &tau, const Mat &B)
+{
+    if ((this->rows < this->cols) || (B.rows != this->rows) || (tau.rows != this->cols) || (tau.cols != 1)) {
+        ESP_LOGW("Mat", "qrSolve Error: matrices %dx%d, %dx%d and tau %dx%d do not match", this->rows, this->cols, B.rows, B.cols, tau.rows, tau.cols);
+        return Mat(0, 0);
+    }
+    if ((this->padding != 0) || (tau.padding != 0)) {
+        Mat temp = this->Get(0, this->rows, 0, this->cols);
+        Mat temp_tau(this->cols, 1);
+        temp_tau = tau;
+        return temp.qrSolve(temp_tau, B);
+    }
+    Mat QtB(B.rows, B.cols);
+    QtB = B;
+    esp_err_t ret = dspm_qr_solve_f32(this->data, tau.data, QtB.data, this->rows, this->cols, QtB.cols);
+    if (ret != ESP_OK) {
+        ESP_LOGW("Mat", "qrSolve Error: the matrix does not have full rank");
+        return Mat(0, 0);
+    }
+    return QtB.Get(0, this->cols, 0, QtB.cols);
+}
+
 void Mat::allocate()
 {
     this->ext_buff = false;
@@ -839,36 +998,6 @@ Mat Mat::expHelper(const Mat &m, int num)
     }
 }
 
-Mat operator+(const Mat &m1, const Mat &m2)
-{
-    if ((m1.rows != m2.rows) || (m1.cols != m2.cols)) {
-        ESP_LOGW("Mat", "operator + Error: matrices do not have equal dimensions");
-        Mat err_ret;
-        return err_ret;
-    }
-
-    if (m1.sub_matrix || m2.sub_matrix) {
-        Mat temp(m1.rows, m2.cols);
-        dspm_add_f32(m1.data, m2.data, temp.data, m1.rows, m1.cols, m1.padding, m2.padding, temp.padding, 1, 1, 1);
-        return temp;
-    } else {
-        Mat temp(m1);
-        return (temp += m2);
-    }
-}
-
-Mat operator+(const Mat &m, float C)
-{
-    if (m.sub_matrix) {
-        Mat temp(m.rows, m.cols);
-        dspm_addc_f32(m.data, temp.data, C, m.rows, m.cols, m.padding, temp.padding, 1, 1);
-        return temp;
-    } else {
-        Mat temp(m);
-        return (temp += C);
-    }
-}
-
 bool operator==(const Mat &m1, const Mat &m2)
 {
     if ((m1.cols != m2.cols) || (m1.rows != m2.rows)) {
@@ -887,36 +1016,6 @@ bool operator==(const Mat &m1, const Mat &m2)
     return true;
 }
 
-Mat operator-(const Mat &m1, const Mat &m2)
-{
-    if ((m1.rows != m2.rows) || (m1.cols != m2.cols)) {
-        ESP_LOGW("Mat", "operator - Error: matrices do not have equal dimensions");
-        Mat err_ret;
-        return err_ret;
-    }
-
-    if (m1.sub_matrix || m2.sub_matrix) {
-        Mat temp(m1.rows, m1.cols);
-        dspm_sub_f32(m1.data, m2.data, temp.data, m1.rows, m1.cols, m1.padding, m2.padding, temp.padding, 1, 1, 1);
-        return temp;
-    } else {
-        Mat temp(m1);
-        return (temp -= m2);
-    }
-}
-
-Mat operator-(const Mat &m, float C)
-{
-    if (m.sub_matrix) {
-        Mat temp(m.rows, m.cols);
-        dspm_addc_f32(m.data, temp.data, -C, m.rows, m.cols, m.padding, temp.padding, 1, 1);
-        return temp;
-    } else {
-        Mat temp(m);
-        return (temp -= C);
-    }
-}
-
 Mat operator*(const Mat &m1, const Mat &m2)
 {
     if (m1.cols != m2.rows) {
@@ -936,52 +1035,6 @@ Mat operator*(const Mat &m1, const Mat &m2)
 
 }
 
-Mat operator*(const Mat &m, float num)
-{
-    if (m.sub_matrix) {
-        Mat temp(m.rows, m.cols);
-        dspm_mulc_f32(m.data, temp.data, num, m.rows, m.cols, m.padding, temp.padding, 1, 1);
-        return temp;
-    } else {
-        Mat temp(m);
-        return (temp *= num);
-    }
-}
-
-Mat operator*(float num, const Mat &m)
-{
-    return (m * num);
-}
-
-Mat operator/(const Mat &m, float num)
-{
-    if (m.sub_matrix) {
-        Mat temp(m.rows, m.cols);
-        dspm_mulc_f32(m.data, temp.data, 1 / num, m.rows, m.cols, m.padding, temp.padding, 1, 1);
-        return temp;
-    } else {
-        Mat temp(m);
-        return (temp /= num);
-    }
-}
-
-Mat operator/(const Mat &A, const Mat &B)
-{
-    if ((A.rows != B.rows) || (A.cols != B.cols)) {
-        ESP_LOGW("Mat", "Operator + Error: matrices do not have equal dimensions");
-        Mat err_ret;
-        return err_ret;
-    }
-
-    Mat temp(A.rows, A.cols);
-    for (int row = 0; row < A.rows; row++) {
-        for (int col = 0; col < A.cols; col++) {
-            temp(row, col) = A(row, col) / B(row, col);
-        }
-    }
-    return temp;
-}
-
 ostream &operator<<(ostream &os, const Mat &m)
 {
     for (int i = 0; i < m.rows; ++i) {
@@ -0,0 +1,163 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <utility>
+#include "unity.h"
+#include "esp_dsp.h"
+#include "dsp_platform.h"
+#include "esp_log.h"
+
+#include "dsp_tests.h"
+#include "mat.h"
+#include "test_mat_common.h"
+
+static const char *TAG = "[dspm]";
+
+static void fill_mat(dspm::Mat &m, float scale)
+{
+    for (int row = 0; row < m.rows; row++) {
+        for (int col = 0; col < m.cols; col++) {
+            m(row, col) = scale * (row * m.cols + col + 1);
+        }
+    }
+}
+
+TEST_CASE("Mat class element-wise expressions", "[dspm]")
+{
+    int M = 5;
+    int N = 3;
+    dspm::Mat A(M, N);
+    dspm::Mat B(M, N);
+    dspm::Mat C(M, N);
+    dspm::Mat D(M, N);
+    dspm::Mat expected(M, N);
+    fill_mat(A, 1);
+    fill_mat(B, -0.5);
+    fill_mat(C, 0.25);
+    fill_mat(D, 2);
+
+    // Runge-Kutta like chain, evaluated in one loop
+    float dt = 0.01;
+    dspm::Mat result = A + (A + 2.0f * B + 2.0f * C + D) * (dt / 6.0f);
+    for (int i = 0; i < M * N; i++) {
+        expected.data[i] = A.data[i] + (A.data[i] + 2.0f * B.data[i] + 2.0f * C.data[i] + D.data[i]) * (dt / 6.0f);
+    }
+    test_assert_equal_mat_mat(expected, result, "A + (A + 2 * B + 2 * C + D) * (dt / 6)");
+
+    // Destination used as operand
+    result = result - B / 2 + 1;
+    for (int i = 0; i < M * N; i++) {
+        expected.data[i] = expected.data[i] - B.data[i] * 0.5f + 1;
+    }
+    test_assert_equal_mat_mat(expected, result, "result = result - B / 2 + 1");
+
+    result += A / D;
+    result -= 3 * C;
+    for (int i = 0; i < M * N; i++) {
+        expected.data[i] += A.data[i] / D.data[i];
+        expected.data[i] -= 3 * C.data[i];
+    }
+    test_assert_equal_mat_mat(expected, result, "result += A / D, result -= 3 * C");
+
+    // Mixed with matrix products
+    dspm::Mat product = (A - B).t() * (C + D);
+    dspm::Mat A_B = A - B;
+    dspm::Mat C_D = C + D;
+    dspm::Mat product_expected = A_B.t() * C_D;
+    test_assert_equal_mat_mat(product_expected, product, "(A - B).t() * (C + D)");
+
+    // Dimensions mismatch: 1x1 result, as the former operators
+    dspm::Mat wrong(N, M);
+    result = A + wrong;
+    TEST_ASSERT_EQUAL_INT(1, result.rows);
+    TEST_ASSERT_EQUAL_INT(1, result.cols);
+    ESP_LOGI(TAG, "Element-wise expressions checked");
+}
+
+TEST_CASE("Mat class element-wise expressions with sub-matrices", "[dspm]")
+{
+    dspm::Mat A(6, 6);
+    dspm::Mat B(6, 6);
+    dspm::Mat C(6, 6);
+    fill_mat(A, 1);
+    fill_mat(B, 3);
+    dspm::Mat C_origin = C;
+
+    dspm::Mat A_sub = A.getROI(1, 1, 4, 4);
+    dspm::Mat B_sub = B.getROI(2, 0, 4, 4);
+    dspm::Mat C_sub = C.getROI(1, 2, 4, 4);
+    C_sub = 0.5f * A_sub + B_sub - 1;
+    dspm::Mat expected(4, 4);
+    for (int row = 0; row < 4; row++) {
+        for (int col = 0; col < 4; col++) {
+            expected(row, col) = 0.5f * A(row + 1, col + 1) + B(row + 2, col) - 1;
+        }
+    }
+    test_assert_equal_mat_mat(expected, C_sub, "sub_mat = 0.5 * sub_mat + sub_mat - 1");
+    test_assert_check_area_mat_mat(C_origin, C_sub, 1, 2, "area check, sub_mat = 0.5 * sub_mat + sub_mat - 1");
+
+    // Sub-matrix of the destination, at the same position
+    dspm::Mat result = A;
+    result = result.getROI(0, 0, 6, 6) * 2;
+    dspm::Mat A2 = A * 2;
+    test_assert_equal_mat_mat(A2, result, "mat = sub_mat(mat) * 2");
+}
+
+TEST_CASE("Mat class move semantics", "[dspm]")
+{
+    dspm::Mat A(4, 4);
+    fill_mat(A, 1);
+    float *buffer = A.data;
+
+    // Move constructor takes the buffer
+    dspm::Mat B(std::move(A));
+    TEST_ASSERT_TRUE(B.data == buffer);
+    TEST_ASSERT_EQUAL_INT(0, A.rows * A.cols);
+
+    // Move to a matrix of other dimensions takes the buffer
+    dspm::Mat C(2, 2);
+    C = std::move(B);
+    TEST_ASSERT_TRUE(C.data == buffer);
+    TEST_ASSERT_EQUAL_INT(4, C.rows);
+    TEST_ASSERT_EQUAL_INT(4, C.cols);
+
+    // Same dimensions: data is copied, sub-matrices of the destination remain valid
+    dspm::Mat D(4, 4);
+    dspm::Mat D_sub = D.getROI(1, 1, 2, 2);
+    D = std::move(C);
+    TEST_ASSERT_FALSE(D.data == buffer);
+    TEST_ASSERT_EQUAL_FLOAT(C(1, 1), D_sub(0, 0));
+
+    // The moved from matrix can be used again
+    A = D * 2;
+    TEST_ASSERT_EQUAL_INT(4, A.rows);
+    TEST_ASSERT_EQUAL_FLOAT(2 * D(3, 3), A(3, 3));
+}
+
+TEST_CASE("Mat class expressions benchmark", "[dspm]")
+{
+    int N = 13;
+    dspm::Mat x(N, 1);
+    dspm::Mat K1(N, 1);
+    dspm::Mat K2(N, 1);
+    dspm::Mat K3(N, 1);
+    dspm::Mat K4(N, 1);
+    fill_mat(x, 1);
+    fill_mat(K1, 0.1);
+    fill_mat(K2, 0.2);
+    fill_mat(K3, 0.3);
+    fill_mat(K4, 0.4);
+    float dt = 0.01;
+    int repeat = 1000;
+
+    unsigned int start_b = xthal_get_ccount();
+    for (int i = 0; i < repeat; i++) {
+        x = x + (K1 + 2.0f * K2 + 2.0f * K3 + K4) * (dt / 6.0f);
+    }
+    unsigned int end_b = xthal_get_ccount();
+    ESP_LOGI(TAG, "x = x + (K1 + 2 * K2 + 2 * K3 + K4) * (dt / 6), %ix1: %i cycles", N, (end_b - start_b) / repeat);
+}
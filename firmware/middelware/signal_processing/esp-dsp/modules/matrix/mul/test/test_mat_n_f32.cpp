@@ -0,0 +1,142 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include "unity.h"
+#include "esp_dsp.h"
+#include "dsp_platform.h"
+#include "esp_log.h"
+
+#include "dsp_tests.h"
+#include "mat.h"
+#include "mat_n.h"
+#include "test_mat_common.h"
+
+static const char *TAG = "[dspm]";
+
+template <int R, int C>
+static void fill_mat_n(dspm::MatN<R, C> &m, float scale)
+{
+    for (int row = 0; row < R; row++) {
+        for (int col = 0; col < C; col++) {
+            m(row, col) = scale * (row * C + col + 1);
+        }
+    }
+}
+
+TEST_CASE("MatN class basic operations", "[dspm]")
+{
+    dspm::MatN<5, 3> A;
+    dspm::MatN<3, 4> B;
+    fill_mat_n(A, 1);
+    fill_mat_n(B, -0.5);
+
+    // Same results as Mat
+    dspm::Mat A_mat(A);
+    dspm::Mat B_mat(B);
+    dspm::Mat AB_mat = A_mat * B_mat;
+    dspm::MatN<5, 4> AB = A * B;
+    dspm::Mat AB_view = AB.view();
+    test_assert_equal_mat_mat(AB_mat, AB_view, "MatN * MatN");
+
+    dspm::Mat At_mat = A_mat.t();
+    dspm::MatN<3, 5> At = A.t();
+    dspm::Mat At_view = At.view();
+    test_assert_equal_mat_mat(At_mat, At_view, "MatN t()");
+
+    // Element-wise expressions, mixed with Mat
+    dspm::MatN<5, 3> C = 2.0f * A + A_mat / 4 - 1;
+    dspm::Mat C_mat = 2.0f * A_mat + A_mat / 4 - 1;
+    dspm::Mat C_view = C.view();
+    test_assert_equal_mat_mat(C_mat, C_view, "2 * MatN + Mat / 4 - 1");
+
+    // Mat = MatN copies the elements, without new buffer
+    dspm::Mat D_mat(5, 3);
+    float *buffer = D_mat.data;
+    D_mat = C;
+    TEST_ASSERT_TRUE(D_mat.data == buffer);
+    test_assert_equal_mat_mat(C_mat, D_mat, "Mat = MatN");
+
+    // MatN = Mat and the view work on the same elements
+    dspm::MatN<5, 3> E(D_mat);
+    dspm::Mat E_view = E.view();
+    E_view *= 2;
+    TEST_ASSERT_EQUAL_FLOAT(2 * D_mat(4, 2), E(4, 2));
+
+    // Dimensions mismatch: the destination is not modified
+    dspm::Mat wrong(3, 5);
+    E = wrong;
+    TEST_ASSERT_EQUAL_FLOAT(2 * D_mat(4, 2), E(4, 2));
+
+    // Blocks
+    dspm::MatN<6, 6> F = dspm::MatN<6, 6>::eye();
+    F.Copy(B, 2, 1);
+    dspm::MatN<3, 4> G = F.Get<3, 4>(2, 1);
+    dspm::Mat G_view = G.view();
+    test_assert_equal_mat_mat(B_mat, G_view, "MatN Copy / Get");
+    TEST_ASSERT_EQUAL_FLOAT(1, F(0, 0));
+    TEST_ASSERT_EQUAL_FLOAT(0, F(1, 0));
+    ESP_LOGI(TAG, "MatN operations checked");
+}
+
+TEST_CASE("MatN class products with transposed matrices", "[dspm]")
+{
+    dspm::MatN<6, 9> A;
+    dspm::MatN<6, 9> B;
+    dspm::MatN<9, 9> Q;
+    fill_mat_n(A, 0.1);
+    fill_mat_n(B, -0.2);
+    for (int i = 0; i < 9; i++) {
+        Q(i, i) = i + 1;
+    }
+
+    dspm::MatN<6, 6> result = dspm::MatN<6, 6>::eye();
+    dspm::mult_t(A, B, result, 2, true);
+    dspm::Mat expected = dspm::Mat::eye(6) + 2 * (dspm::Mat(A) * dspm::Mat(B).t());
+    dspm::Mat result_view = result.view();
+    test_assert_equal_mat_mat(expected, result_view, "I + 2 * A * B'");
+
+    // Symmetric result: A * Q * A'
+    dspm::MatN<6, 9> AQ = A * Q;
+    dspm::mult_t_sym(AQ, A, result);
+    expected = dspm::Mat(A) * dspm::Mat(Q) * dspm::Mat(A).t();
+    test_assert_equal_mat_mat(expected, result_view, "A * Q * A'");
+}
+
+TEST_CASE("MatN class benchmark", "[dspm]")
+{
+    const int N = 13;
+    dspm::MatN<N, N> A;
+    dspm::MatN<N, N> B;
+    dspm::MatN<N, N> C;
+    fill_mat_n(A, 0.01);
+    fill_mat_n(B, 0.02);
+    dspm::Mat A_mat(A);
+    dspm::Mat B_mat(B);
+    dspm::Mat C_mat(N, N);
+    int repeat = 100;
+
+    unsigned int start_b = xthal_get_ccount();
+    for (int i = 0; i < repeat; i++) {
+        C_mat = A_mat * B_mat;
+    }
+    unsigned int end_b = xthal_get_ccount();
+    int cycles_mat = (end_b - start_b) / repeat;
+
+    start_b = xthal_get_ccount();
+    for (int i = 0; i < repeat; i++) {
+        dspm::mult(A, B, C);
+    }
+    end_b = xthal_get_ccount();
+    int cycles_mat_n = (end_b - start_b) / repeat;
+
+    start_b = xthal_get_ccount();
+    for (int i = 0; i < repeat; i++) {
+        dspm::mult_t_sym(A, A, C);
+    }
+    end_b = xthal_get_ccount();
+    ESP_LOGI(TAG, "%ix%i product: Mat - %i cycles, MatN - %i cycles, A * A' - %i cycles", N, N, cycles_mat, cycles_mat_n, (end_b - start_b) / repeat);
+}
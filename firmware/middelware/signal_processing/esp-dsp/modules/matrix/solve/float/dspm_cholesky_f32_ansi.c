@@ -0,0 +1,89 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include <math.h>
+#include "dspm_solve.h"
+
+esp_err_t dspm_cholesky_f32_ansi(float *A, int n)
+{
+    if (NULL == A) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    if (n <= 0) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+
+    for (int j = 0; j < n; j++) {
+        float *row_j = &A[j * n];
+        float d = row_j[j];
+        for (int k = 0; k < j; k++) {
+            d -= row_j[k] * row_j[k];
+        }
+        // Also false for NaN
+        if (!(d > 0)) {
+            return ESP_ERR_DSP_SINGULAR_MATRIX;
+        }
+        d = sqrtf(d);
+        row_j[j] = d;
+        float inv_d = 1 / d;
+        for (int i = j + 1; i < n; i++) {
+            float *row_i = &A[i * n];
+            float sum = row_i[j];
+            for (int k = 0; k < j; k++) {
+                sum -= row_i[k] * row_j[k];
+            }
+            row_i[j] = sum * inv_d;
+            row_j[i] = 0;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t dspm_cholesky_solve_f32_ansi(const float *L, float *B, int n, int m)
+{
+    if (NULL == L) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    if (NULL == B) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    if ((n <= 0) || (m <= 0)) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+
+    // L * Y = B
+    for (int i = 0; i < n; i++) {
+        float *b_i = &B[i * m];
+        for (int k = 0; k < i; k++) {
+            const float l = L[i * n + k];
+            const float *b_k = &B[k * m];
+            for (int c = 0; c < m; c++) {
+                b_i[c] -= l * b_k[c];
+            }
+        }
+        const float inv_l = 1 / L[i * n + i];
+        for (int c = 0; c < m; c++) {
+            b_i[c] *= inv_l;
+        }
+    }
+    // L' * X = Y
+    for (int i = n - 1; i >= 0; i--) {
+        float *b_i = &B[i * m];
+        for (int k = i + 1; k < n; k++) {
+            const float l = L[k * n + i];
+            const float *b_k = &B[k * m];
+            for (int c = 0; c < m; c++) {
+                b_i[c] -= l * b_k[c];
+            }
+        }
+        const float inv_l = 1 / L[i * n + i];
+        for (int c = 0; c < m; c++) {
+            b_i[c] *= inv_l;
+        }
+    }
+    return ESP_OK;
+}
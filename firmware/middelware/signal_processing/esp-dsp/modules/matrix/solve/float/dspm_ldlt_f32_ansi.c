@@ -0,0 +1,90 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "dspm_solve.h"
+
+esp_err_t dspm_ldlt_f32_ansi(float *A, int n)
+{
+    if (NULL == A) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    if (n <= 0) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+
+    for (int j = 0; j < n; j++) {
+        float *row_j = &A[j * n];
+        // v[k] = L[j][k] * D[k] is kept in the upper triangle, column j, while it is used
+        float d = row_j[j];
+        for (int k = 0; k < j; k++) {
+            float v = row_j[k] * A[k * n + k];
+            A[k * n + j] = v;
+            d -= row_j[k] * v;
+        }
+        if (d == 0) {
+            return ESP_ERR_DSP_SINGULAR_MATRIX;
+        }
+        row_j[j] = d;
+        float inv_d = 1 / d;
+        for (int i = j + 1; i < n; i++) {
+            float *row_i = &A[i * n];
+            float sum = row_i[j];
+            for (int k = 0; k < j; k++) {
+                sum -= row_i[k] * A[k * n + j];
+            }
+            row_i[j] = sum * inv_d;
+        }
+        for (int k = 0; k < j; k++) {
+            A[k * n + j] = 0;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t dspm_ldlt_solve_f32_ansi(const float *LD, float *B, int n, int m)
+{
+    if (NULL == LD) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    if (NULL == B) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    if ((n <= 0) || (m <= 0)) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+
+    // L * Z = B, then Y = Z / D
+    for (int i = 0; i < n; i++) {
+        float *b_i = &B[i * m];
+        for (int k = 0; k < i; k++) {
+            const float l = LD[i * n + k];
+            const float *b_k = &B[k * m];
+            for (int c = 0; c < m; c++) {
+                b_i[c] -= l * b_k[c];
+            }
+        }
+    }
+    for (int i = 0; i < n; i++) {
+        float *b_i = &B[i * m];
+        const float inv_d = 1 / LD[i * n + i];
+        for (int c = 0; c < m; c++) {
+            b_i[c] *= inv_d;
+        }
+    }
+    // L' * X = Y
+    for (int i = n - 1; i >= 0; i--) {
+        float *b_i = &B[i * m];
+        for (int k = i + 1; k < n; k++) {
+            const float l = LD[k * n + i];
+            const float *b_k = &B[k * m];
+            for (int c = 0; c < m; c++) {
+                b_i[c] -= l * b_k[c];
+            }
+        }
+    }
+    return ESP_OK;
+}
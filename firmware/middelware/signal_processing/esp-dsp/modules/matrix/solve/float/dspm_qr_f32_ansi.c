@@ -0,0 +1,115 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include <math.h>
+#include "dspm_solve.h"
+
+esp_err_t dspm_qr_f32_ansi(float *A, float *tau, int rows, int cols)
+{
+    if (NULL == A) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    if (NULL == tau) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    if ((cols <= 0) || (rows < cols)) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+
+    for (int j = 0; j < cols; j++) {
+        // Reflection H = I - tau * v * v', with v[j] = 1, that zeroes A[j+1..rows-1][j]
+        float alpha = A[j * cols + j];
+        float norm2 = 0;
+        for (int i = j + 1; i < rows; i++) {
+            norm2 += A[i * cols + j] * A[i * cols + j];
+        }
+        if (norm2 == 0) {
+            tau[j] = 0;
+            continue;
+        }
+        float beta = sqrtf(alpha * alpha + norm2);
+        if (alpha > 0) {
+            beta = -beta;
+        }
+        tau[j] = (beta - alpha) / beta;
+        float scale = 1 / (alpha - beta);
+        for (int i = j + 1; i < rows; i++) {
+            A[i * cols + j] *= scale;
+        }
+        A[j * cols + j] = beta;
+
+        // Apply H to the next columns
+        for (int k = j + 1; k < cols; k++) {
+            float w = A[j * cols + k];
+            for (int i = j + 1; i < rows; i++) {
+                w += A[i * cols + j] * A[i * cols + k];
+            }
+            w *= tau[j];
+            A[j * cols + k] -= w;
+            for (int i = j + 1; i < rows; i++) {
+                A[i * cols + k] -= w * A[i * cols + j];
+            }
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t dspm_qr_solve_f32_ansi(const float *QR, const float *tau, float *B, int rows, int cols, int m)
+{
+    if (NULL == QR) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    if (NULL == tau) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    if (NULL == B) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    if ((cols <= 0) || (rows < cols) || (m <= 0)) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    for (int i = 0; i < cols; i++) {
+        if (QR[i * cols + i] == 0) {
+            return ESP_ERR_DSP_SINGULAR_MATRIX;
+        }
+    }
+
+    // B = Q' * B = H(cols-1) * ... * H(0) * B
+    for (int j = 0; j < cols; j++) {
+        if (tau[j] == 0) {
+            continue;
+        }
+        float *b_j = &B[j * m];
+        for (int c = 0; c < m; c++) {
+            float w = b_j[c];
+            for (int i = j + 1; i < rows; i++) {
+                w += QR[i * cols + j] * B[i * m + c];
+            }
+            w *= tau[j];
+            b_j[c] -= w;
+            for (int i = j + 1; i < rows; i++) {
+                B[i * m + c] -= w * QR[i * cols + j];
+            }
+        }
+    }
+    // R * X = B[0..cols-1]
+    for (int i = cols - 1; i >= 0; i--) {
+        float *b_i = &B[i * m];
+        for (int k = i + 1; k < cols; k++) {
+            const float r = QR[i * cols + k];
+            const float *b_k = &B[k * m];
+            for (int c = 0; c < m; c++) {
+                b_i[c] -= r * b_k[c];
+            }
+        }
+        const float inv_r = 1 / QR[i * cols + i];
+        for (int c = 0; c < m; c++) {
+            b_i[c] *= inv_r;
+        }
+    }
+    return ESP_OK;
+}
@@ -0,0 +1,155 @@
+// Copyright 2018-2023 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _dspm_solve_H_
+#define _dspm_solve_H_
+
+#include "dsp_err.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**@{*/
+/**
+ * @brief   Cholesky factorization of a symmetric positive definite matrix
+ *
+ * A = L * L', calculated in place: only the lower triangle of A is read, L is written to the
+ * lower triangle and the upper triangle is set to 0, so A contains L.
+ * About n^3/6 multiplications and n square roots.
+ * The implementation use ANSI C and could be compiled and run on any platform
+ *
+ * @param A: matrix A[n][n], row by row
+ * @param[in] n: matrix dimension
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_DSP_SINGULAR_MATRIX if A is not positive definite (A is partly modified)
+ *      - One of the error codes from DSP library
+ */
+esp_err_t dspm_cholesky_f32_ansi(float *A, int n);
+
+/**
+ * @brief   Solve A * X = B with the Cholesky factorization of A
+ *
+ * Forward and back substitution with L and L', for all columns of B at once.
+ * The implementation use ANSI C and could be compiled and run on any platform
+ *
+ * @param[in] L: result of dspm_cholesky_f32, L[n][n]
+ * @param B: right hand sides B[n][m], replaced by the solution X[n][m]
+ * @param[in] n: matrix dimension
+ * @param[in] m: amount of right hand sides (columns of B)
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - One of the error codes from DSP library
+ */
+esp_err_t dspm_cholesky_solve_f32_ansi(const float *L, float *B, int n, int m);
+/**@}*/
+
+/**@{*/
+/**
+ * @brief   LDL' factorization of a symmetric matrix
+ *
+ * A = L * D * L', where L is lower triangular with ones on the diagonal and D is diagonal.
+ * Calculated in place: only the lower triangle of A is read, L is written below the diagonal,
+ * D on the diagonal and the upper triangle is set to 0.
+ * Without square roots, so it can also be used with symmetric matrices that are not
+ * positive definite (but not singular), without pivoting.
+ * The implementation use ANSI C and could be compiled and run on any platform
+ *
+ * @param A: matrix A[n][n], row by row
+ * @param[in] n: matrix dimension
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_DSP_SINGULAR_MATRIX if an element of D is 0 (A is partly modified)
+ *      - One of the error codes from DSP library
+ */
+esp_err_t dspm_ldlt_f32_ansi(float *A, int n);
+
+/**
+ * @brief   Solve A * X = B with the LDL' factorization of A
+ *
+ * The implementation use ANSI C and could be compiled and run on any platform
+ *
+ * @param[in] LD: result of dspm_ldlt_f32, LD[n][n]
+ * @param B: right hand sides B[n][m], replaced by the solution X[n][m]
+ * @param[in] n: matrix dimension
+ * @param[in] m: amount of right hand sides (columns of B)
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - One of the error codes from DSP library
+ */
+esp_err_t dspm_ldlt_solve_f32_ansi(const float *LD, float *B, int n, int m);
+/**@}*/
+
+/**@{*/
+/**
+ * @brief   QR factorization with Householder reflections
+ *
+ * A = Q * R, calculated in place (same storage as LAPACK sgeqrf): R is written to the upper
+ * triangle of A, the Householder vectors below the diagonal (the first element of each vector
+ * is 1 and is not stored) and their factors to tau. Q is never calculated.
+ * The implementation use ANSI C and could be compiled and run on any platform
+ *
+ * @param A: matrix A[rows][cols], rows >= cols
+ * @param[out] tau: factors of the reflections, tau[cols]
+ * @param[in] rows: matrix rows
+ * @param[in] cols: matrix columns
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - One of the error codes from DSP library
+ */
+esp_err_t dspm_qr_f32_ansi(float *A, float *tau, int rows, int cols);
+
+/**
+ * @brief   Least squares solution of A * X = B with the QR factorization of A
+ *
+ * Minimizes |A * X - B| for every column of B: B is replaced by Q' * B and R * X = (Q' * B)[0..cols-1]
+ * is solved by back substitution. The solution X[cols][m] is written to the first cols rows of B,
+ * the other rows contain the residuals in the Q base (their norm is the error of the solution).
+ * With rows == cols it is the solution of a square system.
+ * The implementation use ANSI C and could be compiled and run on any platform
+ *
+ * @param[in] QR: result of dspm_qr_f32, QR[rows][cols]
+ * @param[in] tau: result of dspm_qr_f32, tau[cols]
+ * @param B: right hand sides B[rows][m], the first cols rows are replaced by the solution
+ * @param[in] rows: matrix rows
+ * @param[in] cols: matrix columns
+ * @param[in] m: amount of right hand sides (columns of B)
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_DSP_SINGULAR_MATRIX if A does not have full rank
+ *      - One of the error codes from DSP library
+ */
+esp_err_t dspm_qr_solve_f32_ansi(const float *QR, const float *tau, float *B, int rows, int cols, int m);
+/**@}*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#define dspm_cholesky_f32 dspm_cholesky_f32_ansi
+#define dspm_cholesky_solve_f32 dspm_cholesky_solve_f32_ansi
+#define dspm_ldlt_f32 dspm_ldlt_f32_ansi
+#define dspm_ldlt_solve_f32 dspm_ldlt_solve_f32_ansi
+#define dspm_qr_f32 dspm_qr_f32_ansi
+#define dspm_qr_solve_f32 dspm_qr_solve_f32_ansi
+
+#endif // _dspm_solve_H_
@@ -0,0 +1,209 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <math.h>
+#include "unity.h"
+#include "esp_dsp.h"
+#include "dsp_platform.h"
+#include "esp_log.h"
+
+#include "dsp_tests.h"
+#include "mat.h"
+#include "dspm_solve.h"
+
+static const char *TAG = "[dspm]";
+
+// Symmetric positive definite matrix, like a covariance matrix: A = M * M' + n * I
+static dspm::Mat test_spd_mat(int n)
+{
+    dspm::Mat M(n, n);
+    for (int i = 0; i < M.length; i++) {
+        M.data[i] = sinf(0.7f * i + 0.3f);
+    }
+    return M * M.t() + n * dspm::Mat::eye(n);
+}
+
+static dspm::Mat test_rhs_mat(int n, int m)
+{
+    dspm::Mat B(n, m);
+    for (int i = 0; i < B.length; i++) {
+        B.data[i] = cosf(0.4f * i) * (i % 3 + 1);
+    }
+    return B;
+}
+
+static void test_assert_solution(dspm::Mat &A, dspm::Mat &X, dspm::Mat &B, float tolerance, const char *message)
+{
+    TEST_ASSERT_EQUAL_INT_MESSAGE(B.rows, X.rows, message);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(B.cols, X.cols, message);
+    dspm::Mat AX = A * X;
+    for (int row = 0; row < B.rows; row++) {
+        for (int col = 0; col < B.cols; col++) {
+            TEST_ASSERT_FLOAT_WITHIN_MESSAGE(tolerance, B(row, col), AX(row, col), message);
+        }
+    }
+}
+
+TEST_CASE("dspm_cholesky_f32_ansi functionality", "[dspm]")
+{
+    char message[60];
+    for (int n = 1; n <= 13; n++) {
+        dspm::Mat A = test_spd_mat(n);
+        dspm::Mat B = test_rhs_mat(n, 3);
+        dspm::Mat L = A;
+        TEST_ESP_OK(L.cholesky());
+
+        // L is lower triangular and L * L' == A
+        dspm::Mat LLt = L * L.t();
+        for (int row = 0; row < n; row++) {
+            for (int col = 0; col < n; col++) {
+                if (col > row) {
+                    TEST_ASSERT_EQUAL_FLOAT(0, L(row, col));
+                }
+                TEST_ASSERT_FLOAT_WITHIN(1e-4f * n, A(row, col), LLt(row, col));
+            }
+        }
+        dspm::Mat X = L.choleskySolve(B);
+        sprintf(message, "cholesky n = %d", n);
+        test_assert_solution(A, X, B, 1e-4f * n, message);
+    }
+
+    // Not positive definite
+    float data[4] = {1, 2, 2, 1};
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_SINGULAR_MATRIX, dspm_cholesky_f32(data, 2));
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_PARAM_OUTOFRANGE, dspm_cholesky_f32(NULL, 2));
+}
+
+TEST_CASE("dspm_ldlt_f32_ansi functionality", "[dspm]")
+{
+    char message[60];
+    for (int n = 1; n <= 13; n++) {
+        dspm::Mat A = test_spd_mat(n);
+        // Symmetric, but not positive definite
+        A(0, 0) = -A(0, 0);
+        dspm::Mat B = test_rhs_mat(n, 4);
+        dspm::Mat LD = A;
+        TEST_ESP_OK(LD.ldlt());
+        dspm::Mat X = LD.ldltSolve(B);
+        sprintf(message, "ldlt n = %d", n);
+        test_assert_solution(A, X, B, 1e-4f * n, message);
+    }
+
+    float data[4] = {0, 1, 1, 0};
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_SINGULAR_MATRIX, dspm_ldlt_f32(data, 2));
+}
+
+TEST_CASE("dspm_qr_f32_ansi functionality", "[dspm]")
+{
+    char message[60];
+    // Square systems
+    for (int n = 1; n <= 13; n++) {
+        dspm::Mat A = test_rhs_mat(n, n) + n * dspm::Mat::eye(n);
+        dspm::Mat B = test_rhs_mat(n, 2);
+        dspm::Mat QR = A;
+        dspm::Mat tau;
+        TEST_ESP_OK(QR.qr(tau));
+        TEST_ASSERT_EQUAL_INT(n, tau.rows);
+        dspm::Mat X = QR.qrSolve(tau, B);
+        sprintf(message, "qr n = %d", n);
+        test_assert_solution(A, X, B, 1e-4f * n, message);
+    }
+
+    // Least squares: line fit y = a + b * x, the solution is the same as with the normal equations
+    const int points = 20;
+    dspm::Mat A(points, 2);
+    dspm::Mat y(points, 1);
+    for (int i = 0; i < points; i++) {
+        A(i, 0) = 1;
+        A(i, 1) = i;
+        y(i, 0) = 0.5f - 2.0f * i + 0.1f * sinf(i);
+    }
+    dspm::Mat At = A.t();
+    dspm::Mat AtA = At * A;
+    dspm::Mat Aty = At * y;
+    dspm::Mat expected = AtA.inverse() * Aty;
+    dspm::Mat QR = A;
+    dspm::Mat tau;
+    TEST_ESP_OK(QR.qr(tau));
+    dspm::Mat ab = QR.qrSolve(tau, y);
+    TEST_ASSERT_EQUAL_INT(2, ab.rows);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, expected(0, 0), ab(0, 0));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, expected(1, 0), ab(1, 0));
+
+    // Not full rank
+    dspm::Mat C = dspm::Mat::ones(3, 3);
+    TEST_ESP_OK(C.qr(tau));
+    dspm::Mat Y = dspm::Mat::ones(3, 1);
+    TEST_ASSERT_EQUAL_INT(0, C.qrSolve(tau, Y).rows);
+}
+
+TEST_CASE("dspm_cholesky_f32_ansi sub-matrices", "[dspm]")
+{
+    // The factorizations work also on sub-matrices (with padding)
+    const int n = 5;
+    dspm::Mat big = dspm::Mat::ones(n + 2, n + 2);
+    dspm::Mat A = test_spd_mat(n);
+    dspm::Mat B = test_rhs_mat(n, 2);
+    big.Copy(A, 1, 1);
+    dspm::Mat L = big.getROI(1, 1, n, n);
+    TEST_ESP_OK(L.cholesky());
+    dspm::Mat X = L.choleskySolve(B);
+    test_assert_solution(A, X, B, 1e-4f * n, "cholesky sub-matrix");
+    TEST_ASSERT_EQUAL_FLOAT(1, big(0, 0));
+    TEST_ASSERT_EQUAL_FLOAT(1, big(n + 1, n + 1));
+}
+
+TEST_CASE("dspm_cholesky_f32_ansi benchmark", "[dspm]")
+{
+    int repeat = 20;
+    for (int n = 3; n <= 13; n++) {
+        dspm::Mat A = test_spd_mat(n);
+        dspm::Mat B = test_rhs_mat(n, n);
+        dspm::Mat F(n, n);
+        dspm::Mat X(n, n);
+        dspm::Mat tau(n, 1);
+
+        unsigned int start_b = xthal_get_ccount();
+        for (int i = 0; i < repeat; i++) {
+            F = A;
+            F.cholesky();
+            X = F.choleskySolve(B);
+        }
+        unsigned int end_b = xthal_get_ccount();
+        int cycles_cholesky = (end_b - start_b) / repeat;
+
+        start_b = xthal_get_ccount();
+        for (int i = 0; i < repeat; i++) {
+            F = A;
+            F.ldlt();
+            X = F.ldltSolve(B);
+        }
+        end_b = xthal_get_ccount();
+        int cycles_ldlt = (end_b - start_b) / repeat;
+
+        start_b = xthal_get_ccount();
+        for (int i = 0; i < repeat; i++) {
+            F = A;
+            F.qr(tau);
+            X = F.qrSolve(tau, B);
+        }
+        end_b = xthal_get_ccount();
+        int cycles_qr = (end_b - start_b) / repeat;
+
+        // inverse() uses cofactors, its time grows with n!, so it is measured only for small matrices
+        if (n > 8) {
+            ESP_LOGI(TAG, "%2ix%-2i A \\ B: cholesky - %i, ldlt - %i, qr - %i cycles", n, n, cycles_cholesky, cycles_ldlt, cycles_qr);
+            continue;
+        }
+        start_b = xthal_get_ccount();
+        for (int i = 0; i < repeat; i++) {
+            X = A.inverse() * B;
+        }
+        end_b = xthal_get_ccount();
+        ESP_LOGI(TAG, "%2ix%-2i A \\ B: cholesky - %i, ldlt - %i, qr - %i, inverse() - %i cycles", n, n, cycles_cholesky, cycles_ldlt, cycles_qr, (end_b - start_b) / repeat);
+    }
+}
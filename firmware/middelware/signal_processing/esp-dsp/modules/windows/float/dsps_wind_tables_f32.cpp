@@ -0,0 +1,108 @@
+// Copyright 2018-2023 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dsps_fft2r.h"
+#include "dsps_wind_tables.h"
+#include "dsp_const_tables.h"
+
+// Windows calculated by the compiler (see dsp_const_tables.h), one symbol for each window and
+// length, so only the windows used by the application are linked (-fdata-sections and
+// --gc-sections). Lengths up to CONFIG_DSP_MAX_FFT_SIZE.
+
+// a0 - a1 * cos(x) + a2 * cos(2x) - a3 * cos(3x) + a4 * cos(4x), x = 2 * pi * i / (N - 1),
+// with the coefficients of the dsps_wind_..._f32 functions. cos(kx) by the Chebyshev
+// polynomials of cos(x), so only one cos() is evaluated for each element
+static constexpr float dsps_wind_cos_sum(int N, int i, float a0, float a1, float a2, float a3, float a4)
+{
+    double c = dsp_const::cos(2 * dsp_const::pi * i / (N - 1));
+    double c2 = 2 * c * c - 1;
+    double c3 = 2 * c * c2 - c;
+    double c4 = 2 * c * c3 - c2;
+    return (float)(a0 - a1 * c + a2 * c2 - a3 * c3 + a4 * c4);
+}
+
+static constexpr float dsps_wind_hann(int N, int i)
+{
+    return dsps_wind_cos_sum(N, i, 0.5, 0.5, 0, 0, 0);
+}
+
+static constexpr float dsps_wind_blackman(int N, int i)
+{
+    return dsps_wind_cos_sum(N, i, 0.42, 0.5, 0.08, 0, 0);
+}
+
+static constexpr float dsps_wind_blackman_harris(int N, int i)
+{
+    return dsps_wind_cos_sum(N, i, 0.35875, 0.48829, 0.14128, 0.01168, 0);
+}
+
+static constexpr float dsps_wind_blackman_nuttall(int N, int i)
+{
+    return dsps_wind_cos_sum(N, i, 0.3635819, 0.4891775, 0.1365995, 0.0106411, 0);
+}
+
+static constexpr float dsps_wind_nuttall(int N, int i)
+{
+    return dsps_wind_cos_sum(N, i, 0.355768, 0.487396, 0.144232, 0.012604, 0);
+}
+
+static constexpr float dsps_wind_flat_top(int N, int i)
+{
+    return dsps_wind_cos_sum(N, i, 0.21557895, 0.41663158, 0.277263158, 0.083578947, 0.006947368);
+}
+
+#define DSPS_WIND_TABLE_F32_DEFINE(name, len) \
+    extern "C" constexpr float dsps_wind_##name##_f32_##len[len] = {DSP_TABLE_REPEAT_##len(dsps_wind_##name, len, 0)};
+
+#define DSPS_WIND_TABLES_F32_DEFINE(len) \
+    DSPS_WIND_TABLE_F32_DEFINE(hann, len) \
+    DSPS_WIND_TABLE_F32_DEFINE(blackman, len) \
+    DSPS_WIND_TABLE_F32_DEFINE(blackman_harris, len) \
+    DSPS_WIND_TABLE_F32_DEFINE(blackman_nuttall, len) \
+    DSPS_WIND_TABLE_F32_DEFINE(nuttall, len) \
+    DSPS_WIND_TABLE_F32_DEFINE(flat_top, len)
+
+#if CONFIG_DSP_MAX_FFT_SIZE >= 4
+DSPS_WIND_TABLES_F32_DEFINE(4)
+#endif
+#if CONFIG_DSP_MAX_FFT_SIZE >= 8
+DSPS_WIND_TABLES_F32_DEFINE(8)
+#endif
+#if CONFIG_DSP_MAX_FFT_SIZE >= 16
+DSPS_WIND_TABLES_F32_DEFINE(16)
+#endif
+#if CONFIG_DSP_MAX_FFT_SIZE >= 32
+DSPS_WIND_TABLES_F32_DEFINE(32)
+#endif
+#if CONFIG_DSP_MAX_FFT_SIZE >= 64
+DSPS_WIND_TABLES_F32_DEFINE(64)
+#endif
+#if CONFIG_DSP_MAX_FFT_SIZE >= 128
+DSPS_WIND_TABLES_F32_DEFINE(128)
+#endif
+#if CONFIG_DSP_MAX_FFT_SIZE >= 256
+DSPS_WIND_TABLES_F32_DEFINE(256)
+#endif
+#if CONFIG_DSP_MAX_FFT_SIZE >= 512
+DSPS_WIND_TABLES_F32_DEFINE(512)
+#endif
+#if CONFIG_DSP_MAX_FFT_SIZE >= 1024
+DSPS_WIND_TABLES_F32_DEFINE(1024)
+#endif
+#if CONFIG_DSP_MAX_FFT_SIZE >= 2048
+DSPS_WIND_TABLES_F32_DEFINE(2048)
+#endif
+#if CONFIG_DSP_MAX_FFT_SIZE >= 4096
+DSPS_WIND_TABLES_F32_DEFINE(4096)
+#endif
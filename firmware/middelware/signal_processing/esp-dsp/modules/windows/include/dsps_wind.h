@@ -22,5 +22,6 @@
 #include "dsps_wind_blackman_nuttall.h"
 #include "dsps_wind_nuttall.h"
 #include "dsps_wind_flat_top.h"
+#include "dsps_wind_tables.h"
 
 #endif // _dsps_wind_H_
@@ -0,0 +1,59 @@
+// Copyright 2018-2023 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _dsps_wind_tables_H_
+#define _dsps_wind_tables_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief   Windows in flash
+ *
+ * The windows of dsps_wind.h, calculated at compile time (dsps_wind_tables_f32.cpp) for each
+ * power of two length from 4 up to CONFIG_DSP_MAX_FFT_SIZE: dsps_wind_<name>_f32_<len>[len],
+ * e.g. dsps_wind_hann_f32_256 is the same as dsps_wind_hann_f32(window, 256).
+ * Every window is a separate symbol: only the windows used by the application are linked.
+ * Use DSPS_WIND_TABLE_F32(name, len) with a constant or a macro as length.
+ */
+#define DSPS_WIND_TABLES_F32_DECLARE(name) \
+    extern const float dsps_wind_##name##_f32_4[]; \
+    extern const float dsps_wind_##name##_f32_8[]; \
+    extern const float dsps_wind_##name##_f32_16[]; \
+    extern const float dsps_wind_##name##_f32_32[]; \
+    extern const float dsps_wind_##name##_f32_64[]; \
+    extern const float dsps_wind_##name##_f32_128[]; \
+    extern const float dsps_wind_##name##_f32_256[]; \
+    extern const float dsps_wind_##name##_f32_512[]; \
+    extern const float dsps_wind_##name##_f32_1024[]; \
+    extern const float dsps_wind_##name##_f32_2048[]; \
+    extern const float dsps_wind_##name##_f32_4096[];
+
+DSPS_WIND_TABLES_F32_DECLARE(hann)
+DSPS_WIND_TABLES_F32_DECLARE(blackman)
+DSPS_WIND_TABLES_F32_DECLARE(blackman_harris)
+DSPS_WIND_TABLES_F32_DECLARE(blackman_nuttall)
+DSPS_WIND_TABLES_F32_DECLARE(nuttall)
+DSPS_WIND_TABLES_F32_DECLARE(flat_top)
+
+#define DSPS_WIND_TABLE_F32(name, len) DSPS_WIND_TABLE_F32_(name, len)
+#define DSPS_WIND_TABLE_F32_(name, len) dsps_wind_##name##_f32_##len
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _dsps_wind_tables_H_
@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include "unity.h"
 #include "dsp_platform.h"
 #include "esp_log.h"
@@ -106,3 +108,70 @@ TEST_CASE("dsps_wind_flat_top_f32: test Flat-Top window for symmetry", "[dsps]")
     }
     dsps_view(data, length, 64, 10, 0, 1, '.');
 }
+
+typedef void (*wind_gen_func)(float *window, int len);
+
+static void test_wind_table(const char *name, wind_gen_func gen, const float *const *tables)
+{
+    char message[60];
+    for (int pow = 2; pow <= 12; pow++) {
+        int len = 1 << pow;
+        if (len > CONFIG_DSP_MAX_FFT_SIZE) {
+            break;
+        }
+        float *window = (float *)malloc(len * sizeof(float));
+        TEST_ASSERT_NOT_NULL(window);
+        gen(window, len);
+        sprintf(message, "%s, %i samples", name, len);
+        for (int i = 0; i < len; i++) {
+            TEST_ASSERT_FLOAT_WITHIN_MESSAGE(1e-6, window[i], tables[pow - 2][i], message);
+        }
+        free(window);
+    }
+}
+
+// Only the tables up to CONFIG_DSP_MAX_FFT_SIZE are defined
+#if CONFIG_DSP_MAX_FFT_SIZE >= 512
+#define WIND_TABLE_512(name) , DSPS_WIND_TABLE_F32(name, 512)
+#else
+#define WIND_TABLE_512(name)
+#endif
+#if CONFIG_DSP_MAX_FFT_SIZE >= 1024
+#define WIND_TABLE_1024(name) , DSPS_WIND_TABLE_F32(name, 1024)
+#else
+#define WIND_TABLE_1024(name)
+#endif
+#if CONFIG_DSP_MAX_FFT_SIZE >= 2048
+#define WIND_TABLE_2048(name) , DSPS_WIND_TABLE_F32(name, 2048)
+#else
+#define WIND_TABLE_2048(name)
+#endif
+#if CONFIG_DSP_MAX_FFT_SIZE >= 4096
+#define WIND_TABLE_4096(name) , DSPS_WIND_TABLE_F32(name, 4096)
+#else
+#define WIND_TABLE_4096(name)
+#endif
+
+#define WIND_TABLES(name) { \
+    DSPS_WIND_TABLE_F32(name, 4), DSPS_WIND_TABLE_F32(name, 8), DSPS_WIND_TABLE_F32(name, 16), \
+    DSPS_WIND_TABLE_F32(name, 32), DSPS_WIND_TABLE_F32(name, 64), DSPS_WIND_TABLE_F32(name, 128), \
+    DSPS_WIND_TABLE_F32(name, 256) WIND_TABLE_512(name) WIND_TABLE_1024(name) \
+    WIND_TABLE_2048(name) WIND_TABLE_4096(name)}
+
+// The windows in flash are the same as the generated ones
+TEST_CASE("dsps_wind_tables_f32: windows in flash", "[dsps]")
+{
+    const float *hann[] = WIND_TABLES(hann);
+    const float *blackman[] = WIND_TABLES(blackman);
+    const float *blackman_harris[] = WIND_TABLES(blackman_harris);
+    const float *blackman_nuttall[] = WIND_TABLES(blackman_nuttall);
+    const float *nuttall[] = WIND_TABLES(nuttall);
+    const float *flat_top[] = WIND_TABLES(flat_top);
+
+    test_wind_table("hann", dsps_wind_hann_f32, hann);
+    test_wind_table("blackman", dsps_wind_blackman_f32, blackman);
+    test_wind_table("blackman_harris", dsps_wind_blackman_harris_f32, blackman_harris);
+    test_wind_table("blackman_nuttall", dsps_wind_blackman_nuttall_f32, blackman_nuttall);
+    test_wind_table("nuttall", dsps_wind_nuttall_f32, nuttall);
+    test_wind_table("flat_top", dsps_wind_flat_top_f32, flat_top);
+}
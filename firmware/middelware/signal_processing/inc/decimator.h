@@ -0,0 +1,116 @@
+#ifndef DECIMATOR_H_
+#define DECIMATOR_H_
+/** \addtogroup Drivers_Programable Drivers Programable
+ ** @{ */
+/** \addtogroup Middelware Middelware
+ ** @{ */
+/** \addtogroup Decimator Multistage decimator
+ */
+
+/** \brief Sample rate reduction by an integer factor
+ *
+ * Lets the ADC sample far above the rate needed by the application (to
+ * average noise out) and feed iir_filter or fft at the low rate. The total
+ * ratio is split into one stage per prime factor (biggest first), each one
+ * a windowed-sinc (Blackman) anti-aliasing FIR computed by dsps_fird_f32 /
+ * dsps_fird_s16: only the kept samples are calculated. Stage filters are
+ * designed on creation. Aliases are rejected by about 65 dB (float path;
+ * int16 is limited by coefficients quantization to a few dB less).
+ *
+ * Components between pass_frec and output_frec / 2 may be aliased, but only
+ * above pass_frec (stopband of each stage starts at its output frequency
+ * minus pass_frec).
+ *
+ * @author Peñalva Albano
+ *
+ * @section changelog
+ *
+ * |   Date	    | Description                                    						|
+ * |:----------:|:----------------------------------------------------------------------|
+ * | 16/10/2026 | Document creation		                         						|
+ *
+ **/
+
+/*==================[inclusions]=============================================*/
+#include <stdint.h>
+#include <stdbool.h>
+/*==================[macros]=================================================*/
+#define DECIMATOR_MAX_STAGES    8       /*!< Maximun number of stages (prime factors of ratio) */
+#define DECIMATOR_MAX_TAPS      511     /*!< Maximun number of coefficients of a stage */
+/*==================[typedef]================================================*/
+/**
+ * @brief Decimator configuration struct
+ */
+typedef struct {
+    float sample_frec;          /*!< Input sample frequency */
+    uint16_t ratio;             /*!< Decimation factor: output frequency = sample_frec / ratio (e.g. 8000 Hz / 32 = 250 Hz) */
+    float pass_frec;            /*!< Upper edge of the band to keep, below output frequency / 2 (0: 40% of output frequency) */
+    bool fixed_point;           /*!< true: int16 samples (DecimatorFilterQ15), false: float samples (DecimatorFilter) */
+} decimator_config_t;
+
+/**
+ * @brief Decimator instance
+ */
+typedef struct decimator_s decimator_t;
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/**
+ * @brief Create a decimator instance, designing the filter of each stage
+ *
+ * @param config        Pointer to configuration struct
+ * @return decimator_t* Decimator instance, NULL if configuration is not valid
+ *                      (a stage would need more than DECIMATOR_MAX_TAPS) or
+ *                      there is not enough memory
+ */
+decimator_t * DecimatorCreate(const decimator_config_t * config);
+
+/**
+ * @brief Release a decimator instance created with DecimatorCreate
+ *
+ * @param decimator     Decimator instance
+ */
+void DecimatorDelete(decimator_t * decimator);
+
+/**
+ * @brief Clear the filters state and the samples waiting to complete an output
+ *
+ * @param decimator     Decimator instance
+ */
+void DecimatorReset(decimator_t * decimator);
+
+/**
+ * @brief Decimate a block of float samples
+ *
+ * @note  Blocks can have any lenght: samples that do not complete an output
+ *        sample are kept for the next call.
+ *
+ * @param decimator     Decimator instance (created with fixed_point = false)
+ * @param input         Array with input samples
+ * @param output        Array to store output samples (of lenght >= input_lenght / ratio + 1)
+ * @param input_lenght  Number of input samples
+ * @return uint16_t     Number of output samples, 0 if decimator is fixed point
+ */
+uint16_t DecimatorFilter(decimator_t * decimator, const float * input, float * output, uint16_t input_lenght);
+
+/**
+ * @brief Decimate a block of int16 samples (e.g. ADC counts)
+ *
+ * @note  Blocks can have any lenght: samples that do not complete an output
+ *        sample are kept for the next call. Outputs are not saturated: leave
+ *        some headroom (12 bit ADC counts are fine).
+ *
+ * @param decimator     Decimator instance (created with fixed_point = true)
+ * @param input         Array with input samples
+ * @param output        Array to store output samples (of lenght >= input_lenght / ratio + 1)
+ * @param input_lenght  Number of input samples
+ * @return uint16_t     Number of output samples, 0 if decimator is not fixed point
+ */
+uint16_t DecimatorFilterQ15(decimator_t * decimator, const int16_t * input, int16_t * output, uint16_t input_lenght);
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+#endif /* DECIMATOR_H_ */
+
+/*==================[end of file]============================================*/
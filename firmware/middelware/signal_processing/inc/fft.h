@@ -16,6 +16,12 @@
  * |   Date	    | Description                                    						|
  * |:----------:|:----------------------------------------------------------------------|
  * | 15/03/2024 | Document creation		                         						|
+ * | 16/10/2026 | Real input FFT and cached windows		                                |
+ * | 16/10/2026 | Fixed point (Q15) FFT magnitude		                                |
+ * | 16/10/2026 | Reentrant FFT plans		                                            |
+ * | 16/10/2026 | Power spectrum with FFT plans		                                    |
+ * | 16/10/2026 | Twiddles and windows as constant tables in flash		                |
+ * | 17/10/2026 | Window of each plan, flash windows selected by the caller		        |
  * 
  **/
 
@@ -24,7 +30,17 @@
 #include <stdbool.h>
 /*==================[macros]=================================================*/
 #define MAX_SIGNAL_LENGHT   2048
+/** Workspace (in floats) needed by FFTPlanMagnitude for a given signal lenght */
+#define FFT_WORKSPACE_LENGHT(signal_lenght)     (signal_lenght)
 /*==================[typedef]================================================*/
+/**
+ * @brief FFT plan: tables needed to calculate the FFT of a given lenght.
+ * 
+ * Plans hold no buffers, so several tasks can use the same plan at once, as 
+ * long as each one provides its own workspace. Twiddles are constant tables 
+ * in flash, shared by all plans. Each plan has its own window.
+ */
+typedef struct fft_plan_s fft_plan_t;
 
 /*==================[external data declaration]==============================*/
 
@@ -42,12 +58,127 @@ bool FFTInit(void);
  * 
  * @note  Lenght of signal array must be a power of two (with maximun value = MAX_SIGNAL_LENGHT)
  * 
+ * @note  The signal is transformed as a signal_lenght/2 points complex FFT. The Hann 
+ *        window of each lenght is generated the first time it is used. To keep it 
+ *        in flash instead, pass DSPS_WIND_TABLE_F32(hann, lenght) to FFTMagnitudeWindow.
+ * 
+ * @note  Uses a static buffer: not reentrant. Use FFTPlanMagnitude to calculate 
+ *        FFTs from several tasks.
+ * 
  * @param signal            Array with signal values (of lenght = signal_lenght)
  * @param fft               Array to store FFT magnitude values (of lenght = signal_lenght / 2)
  * @param signal_lenght     Lenght of signal arrays
  */
 void FFTMagnitude(float * signal, float * fft, uint16_t signal_lenght);
 
+/**
+ * @brief Calculates the Fast Fourier Transform of a given signal, using a 
+ * window provided by the caller
+ * 
+ * @note  Lenght of signal array must be a power of two (with maximun value = MAX_SIGNAL_LENGHT)
+ * 
+ * @note  Not reentrant (see FFTMagnitude)
+ * 
+ * @param signal            Array with signal values (of lenght = signal_lenght)
+ * @param window            Array with window values (of lenght = signal_lenght)
+ * @param fft               Array to store FFT magnitude values (of lenght = signal_lenght / 2)
+ * @param signal_lenght     Lenght of signal arrays
+ */
+void FFTMagnitudeWindow(const float * signal, const float * window, float * fft, uint16_t signal_lenght);
+
+/**
+ * @brief Creates a FFT plan
+ * 
+ * @note  FFTInit() must be called first. FFTPlanCreate and FFTPlanDelete 
+ *        are not reentrant: call them on initialization.
+ * 
+ * @note  The Hann window is stored with the plan (signal_lenght floats of RAM). 
+ *        Use FFTPlanCreateWindow to keep it in flash.
+ * 
+ * @param signal_lenght     Lenght of signal arrays: power of two (with maximun value = MAX_SIGNAL_LENGHT)
+ * @return fft_plan_t*      Plan, NULL if the lenght is not valid or there is not enough memory
+ */
+fft_plan_t * FFTPlanCreate(uint16_t signal_lenght);
+
+/**
+ * @brief Creates a FFT plan with a window provided by the caller, e.g. a 
+ * window in flash: DSPS_WIND_TABLE_F32(hann, 256) (only the tables used are linked)
+ * 
+ * @note  Same as FFTPlanCreate. The window is not copied: it must outlive the plan.
+ * 
+ * @param signal_lenght     Lenght of signal arrays: power of two (with maximun value = MAX_SIGNAL_LENGHT)
+ * @param window            Array with window values (of lenght = signal_lenght), 
+ *                          NULL for the Hann window
+ * @return fft_plan_t*      Plan, NULL if the lenght is not valid or there is not enough memory
+ */
+fft_plan_t * FFTPlanCreateWindow(uint16_t signal_lenght, const float * window);
+
+/**
+ * @brief Deletes a FFT plan, freeing it and its Hann window (a window provided 
+ * to FFTPlanCreateWindow is not freed). The FFT tables are global (FFTInit).
+ * 
+ * @param plan              Plan to delete
+ */
+void FFTPlanDelete(fft_plan_t * plan);
+
+/**
+ * @brief Calculates the Fast Fourier Transform of a given signal with the plan 
+ * window (Hann: same result as FFTMagnitude). Reentrant.
+ * 
+ * @param plan              Plan of the signal lenght
+ * @param signal            Array with signal values (of lenght = signal_lenght)
+ * @param fft               Array to store FFT magnitude values (of lenght = signal_lenght / 2)
+ * @param workspace         Scratch array (of lenght = FFT_WORKSPACE_LENGHT(signal_lenght)), 
+ *                          one per calling task
+ */
+void FFTPlanMagnitude(const fft_plan_t * plan, const float * signal, float * fft, float * workspace);
+
+/**
+ * @brief Calculates the Fast Fourier Transform of a given signal, using a 
+ * window provided by the caller. Reentrant.
+ * 
+ * @param plan              Plan of the signal lenght
+ * @param signal            Array with signal values (of lenght = signal_lenght)
+ * @param window            Array with window values (of lenght = signal_lenght)
+ * @param fft               Array to store FFT magnitude values (of lenght = signal_lenght / 2)
+ * @param workspace         Scratch array (of lenght = FFT_WORKSPACE_LENGHT(signal_lenght)), 
+ *                          one per calling task
+ */
+void FFTPlanMagnitudeWindow(const fft_plan_t * plan, const float * signal, const float * window, float * fft, float * workspace);
+
+/**
+ * @brief Calculates the power spectrum of a given signal with the plan window
+ * (square of FFTPlanMagnitude values, without the square roots). Reentrant.
+ * 
+ * @param plan              Plan of the signal lenght
+ * @param signal            Array with signal values (of lenght = signal_lenght)
+ * @param power             Array to store power values (of lenght = signal_lenght / 2), 
+ *                          may be the workspace itself
+ * @param workspace         Scratch array (of lenght = FFT_WORKSPACE_LENGHT(signal_lenght)), 
+ *                          one per calling task
+ */
+void FFTPlanPower(const fft_plan_t * plan, const float * signal, float * power, float * workspace);
+
+/**
+ * @brief Calculates the Fast Fourier Transform of a given integer signal (e.g. ADC 
+ * samples) without floating point operations
+ * 
+ * @note  Lenght of signal array must be a power of two (with maximun value = MAX_SIGNAL_LENGHT)
+ * 
+ * @note  Uses a Q15 Hann window, block floating point scaling of the whole signal 
+ *        and the alpha-max-plus-beta-min approximation of the magnitude. Output has
+ *        the same units than FFTMagnitude (saturated to INT16_MAX). Compared to the 
+ *        float path, the error of each bin is up to 4% (magnitude approximation)
+ *        plus the int16 quantization (up to 0.3% of the biggest bin), that matters 
+ *        on the weakest bins of small signals (up to 7% with 100 counts amplitude 
+ *        signals).
+ * 
+ * @param signal            Array with signal values (of lenght = signal_lenght)
+ * @param fft               Array to store FFT magnitude values (of lenght = signal_lenght / 2)
+ * @param signal_lenght     Lenght of signal arrays
+ */
+void FFTMagnitudeQ15(const int16_t * signal, int16_t * fft, uint16_t signal_lenght);
+
 /**
  * @brief Return the FFT frequency axis vector
  * 
@@ -0,0 +1,127 @@
+#ifndef HRV_H_
+#define HRV_H_
+/** \addtogroup Drivers_Programable Drivers Programable
+ ** @{ */
+/** \addtogroup Middelware Middelware
+ ** @{ */
+/** \addtogroup HRV Heart rate variability
+ */
+
+/** \brief Heart rate variability (HRV) metrics over a sliding window
+ *
+ * RR intervals (e.g. qrs_beat_t.rr of QrsDetect) are added one by one. Each
+ * one updates, in constant time and memory:
+ *  - integer sums of the RR intervals (ms) of the window, their squares and
+ *    the squares of their successive differences: SDNN, RMSSD and pNN50
+ *  - the tachogram (RR interval vs time) linearly interpolated at a constant
+ *    rate, HRV_MIN_RESAMPLE_FREC or higher, so that the window has a power of
+ *    two number of samples
+ * HrvRead calculates the power spectrum of the tachogram (Hann window,
+ * FFTPlanPower) and its power in the LF (0.04 - 0.15 Hz) and HF (0.15 - 0.4 Hz)
+ * bands. Resolution is 1 / window_s: 60 s windows are the shortest ones
+ * recommended for LF. The interpolation attenuates the higher frequencies:
+ * about 25 % of the power at 0.25 Hz with a 75 bpm heart rate.
+ *
+ * Intervals out of HRV_MIN_RR_MS - HRV_MAX_RR_MS, or that differ more than
+ * 20 % from the previous one (ectopic beats, missed or false detections), are
+ * not used: the tachogram keeps its last value during them.
+ *
+ * @author Peñalva Albano
+ *
+ * @section changelog
+ *
+ * |   Date	    | Description                                    						|
+ * |:----------:|:----------------------------------------------------------------------|
+ * | 16/10/2026 | Document creation		                         						|
+ *
+ **/
+
+/*==================[inclusions]=============================================*/
+#include <stdint.h>
+#include <stdbool.h>
+/*==================[macros]=================================================*/
+#define HRV_MIN_WINDOW_S        60      /*!< Minimun window lenght (s) */
+#define HRV_MAX_WINDOW_S        300     /*!< Maximun window lenght (s) */
+#define HRV_MIN_RR_MS           300     /*!< Minimun valid RR interval (ms), 200 bpm */
+#define HRV_MAX_RR_MS           2000    /*!< Maximun valid RR interval (ms), 30 bpm */
+#define HRV_MIN_RESAMPLE_FREC   2.0f    /*!< Minimun tachogram sample frequency (Hz) */
+#define HRV_MAX_SAMPLES         1024    /*!< Maximun tachogram samples (HRV_MAX_WINDOW_S at HRV_MIN_RESAMPLE_FREC, next power of two) */
+#define HRV_WORKSPACE_LENGHT    (2 * HRV_MAX_SAMPLES)   /*!< Lenght of the workspace needed by HrvRead */
+/*==================[typedef]================================================*/
+/**
+ * @brief HRV metrics of a window
+ */
+typedef struct {
+    uint16_t n_beats;           /*!< Valid RR intervals in the window */
+    float mean_rr;              /*!< Mean RR interval (ms) */
+    float heart_rate;           /*!< Mean heart rate (bpm) */
+    float sdnn;                 /*!< Standard deviation of the RR intervals (ms) */
+    float rmssd;                /*!< Root mean square of successive differences (ms) */
+    float pnn50;                /*!< Successive differences greater than 50 ms (%) */
+    float lf;                   /*!< Power in the LF band, 0.04 - 0.15 Hz (ms^2) */
+    float hf;                   /*!< Power in the HF band, 0.15 - 0.4 Hz (ms^2) */
+    float lf_hf;                /*!< LF / HF ratio */
+} hrv_t;
+
+/**
+ * @brief HRV analyzer instance
+ */
+typedef struct hrv_analyzer_s hrv_analyzer_t;
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/**
+ * @brief Create a HRV analyzer instance
+ *
+ * @note  FFTInit() must be called first.
+ *
+ * @param window_s          Window lenght (s), HRV_MIN_WINDOW_S to HRV_MAX_WINDOW_S
+ * @return hrv_analyzer_t*  Analyzer instance, NULL if window_s is not valid or
+ *                          there is not enough memory
+ */
+hrv_analyzer_t * HrvCreate(uint16_t window_s);
+
+/**
+ * @brief Release an analyzer instance created with HrvCreate
+ *
+ * @param hrv           Analyzer instance
+ */
+void HrvDelete(hrv_analyzer_t * hrv);
+
+/**
+ * @brief Clear the RR intervals of an analyzer instance
+ *
+ * @param hrv           Analyzer instance
+ */
+void HrvReset(hrv_analyzer_t * hrv);
+
+/**
+ * @brief Add the RR interval of a new beat
+ *
+ * @param hrv           Analyzer instance
+ * @param rr            RR interval (s), ignored if 0 (first beat)
+ */
+void HrvAddBeat(hrv_analyzer_t * hrv, float rr);
+
+/**
+ * @brief HRV metrics of the last window_s seconds
+ *
+ * @note  Does not modify the instance. Time domain metrics are calculated from
+ *        the stored sums, the frequency domain ones need a FFT of the tachogram.
+ *
+ * @param hrv           Analyzer instance
+ * @param result        Pointer to store the metrics
+ * @param workspace     Scratch array (of lenght = HRV_WORKSPACE_LENGHT), may be
+ *                      NULL: frequency domain metrics are not calculated (0)
+ * @return true         The window is complete: every metric is valid
+ * @return false        Less than window_s seconds since the first beat (or the
+ *                      reset): only time domain metrics of the beats so far
+ */
+bool HrvRead(const hrv_analyzer_t * hrv, hrv_t * result, float * workspace);
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+#endif /* HRV_H_ */
+
+/*==================[end of file]============================================*/
@@ -0,0 +1,90 @@
+#ifndef IIR_DESIGN_H_
+#define IIR_DESIGN_H_
+/** \addtogroup Drivers_Programable Drivers Programable
+ ** @{ */
+/** \addtogroup Middelware Middelware
+ ** @{ */
+/** \addtogroup IIR_Design IIR Design
+ */
+
+/** \brief Design of IIR filters of any even order
+ *
+ * Butterworth, Chebyshev I, Chebyshev II and Bessel low pass, high pass, band
+ * pass and band stop filters. The analog prototype is transformed to the
+ * requested type (with the frequencies pre-warped) and to a digital filter by
+ * the bilinear transform. The result is a cascade of second order sections
+ * (SOS), with the coefficients in the format of dsps_biquad_f32 and
+ * dsps_biquad_sos_f32: b0, b1, b2, a1, a2 (a0 = 1) of each section.
+ *
+ * Sections are ordered from the poles farthest from the unit circle to the
+ * nearest ones, and each one gets the nearest zeros, so the cascade keeps its
+ * precision in float even with high orders. The design is calculated in double.
+ *
+ * Cut-off frequency of each prototype:
+ *  - BUTTERWORTH, BESSEL: -3 dB
+ *  - CHEBYSHEV_1: end of the pass band (-ripple dB)
+ *  - CHEBYSHEV_2: start of the stop band (-ripple dB)
+ *
+ * @author Peñalva Albano
+ *
+ * @section changelog
+ *
+ * |   Date	    | Description                                    						|
+ * |:----------:|:----------------------------------------------------------------------|
+ * | 16/10/2026 | Document creation		                         						|
+ *
+ **/
+
+/*==================[inclusions]=============================================*/
+#include <stdint.h>
+/*==================[macros]=================================================*/
+#define IIR_MAX_ORDER       20                      /*!< Maximun filter order */
+#define IIR_MAX_SOS         (IIR_MAX_ORDER / 2)     /*!< Maximun number of second order sections */
+#define IIR_SOS_COEFF       5                       /*!< Coefficients of each section: b0, b1, b2, a1, a2 */
+/*==================[typedef]================================================*/
+typedef enum filter_type {
+    LOW_PASS,           /*!< Low pass filter */
+    HIGH_PASS,          /*!< High pass filter */
+    BAND_PASS,          /*!< Band pass filter */
+    BAND_STOP           /*!< Band stop (notch) filter */
+} filter_type_t;
+
+typedef enum filter_prototype {
+    BUTTERWORTH,        /*!< Maximally flat pass band */
+    CHEBYSHEV_1,        /*!< Ripple in the pass band, steeper transition */
+    CHEBYSHEV_2,        /*!< Flat pass band, ripple in the stop band */
+    BESSEL              /*!< Maximally flat group delay (no overshoot) */
+} filter_prototype_t;
+
+/**
+ * @brief IIR filter design struct
+ */
+typedef struct {
+    filter_type_t type;             /*!< Filter's type */
+    filter_prototype_t prototype;   /*!< Filter's prototype */
+    uint8_t order;                  /*!< Filter's order: even, up to IIR_MAX_ORDER (order / 2 sections).
+                                         Band filters use a prototype of order / 2 */
+    float sample_frec;              /*!< Signal's sample frequency */
+    float cut_frec;                 /*!< Cut-off frequency (lower one of band filters) */
+    float cut_frec_high;            /*!< Upper cut-off frequency of band filters */
+    float ripple;                   /*!< dB: pass band ripple (CHEBYSHEV_1) or stop band attenuation (CHEBYSHEV_2) */
+} iir_design_t;
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/**
+ * @brief Design an IIR filter as a cascade of second order sections
+ *
+ * @param design        Pointer to design struct
+ * @param sos           Array to store the coefficients (of lenght = IIR_SOS_COEFF * order / 2):
+ *                      b0, b1, b2, a1, a2 of each section
+ * @return uint8_t      Number of sections (order / 2), 0 if the design is not valid
+ */
+uint8_t IirDesignSOS(const iir_design_t * design, float * sos);
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+#endif /* IIR_DESIGN_H_ */
+
+/*==================[end of file]============================================*/
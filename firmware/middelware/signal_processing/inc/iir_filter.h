@@ -16,12 +16,21 @@
  * |   Date	    | Description                                    						|
  * |:----------:|:----------------------------------------------------------------------|
  * | 15/03/2024 | Document creation		                         						|
+ * | 16/10/2026 | Multi-instance and multi-channel filters		                        |
+ * | 16/10/2026 | Single pass cascade and band pass filter		                        |
+ * | 16/10/2026 | Filters of any design (IIR Design) and zero-phase filtering		    |
+ * | 16/10/2026 | Fixed point (Q15) filters		                                        |
  * 
  **/
 
 /*==================[inclusions]=============================================*/
 #include <stdint.h>
+#include <stdbool.h>
+#include "iir_design.h"
 /*==================[macros]=================================================*/
+#define IIR_FILTFILT_PAD    (3 * (IIR_MAX_ORDER + 1))   /*!< Maximun samples added at each edge by IirFiltFilt */
+/** @brief Lenght of the workspace needed by IirFiltFilt */
+#define IIR_FILTFILT_WORKSPACE_LENGHT(signal_lenght)    ((signal_lenght) + 2 * IIR_FILTFILT_PAD)
 
 /*==================[typedef]================================================*/
 typedef enum filter_order {
@@ -30,9 +39,141 @@ typedef enum filter_order {
     ORDER_6 = 6,        /*!< 6th order filter */
     ORDER_8 = 8         /*!< 8th order filter */
 } filter_order_t;
+
+/**
+ * @brief Filter instance. Owns its SOS coefficients and the delay lines of 
+ * every channel it processes.
+ */
+typedef struct iir_filter_s iir_filter_t;
 /*==================[external data declaration]==============================*/
 
 /*==================[external functions declaration]=========================*/
+/**
+ * @brief Create a Butterworth filter instance
+ * 
+ * @param type          Filter's type (LOW_PASS or HIGH_PASS)
+ * @param sample_frec   Signal's sample frequency
+ * @param cut_frec      Filter's cut-off frequency
+ * @param order         Filter's order (2, 4, 6 or 8)
+ * @param n_channels    Number of interleaved channels processed by each call
+ * @return iir_filter_t* Filter instance, NULL if order is not supported or 
+ *                       there is not enough memory
+ */
+iir_filter_t * IirCreate(filter_type_t type, float sample_frec, float cut_frec, filter_order_t order, uint8_t n_channels);
+
+/**
+ * @brief Create a filter instance of any design (prototype, type and order)
+ * 
+ * @param design        Pointer to design struct (see IirDesignSOS)
+ * @param n_channels    Number of interleaved channels processed by each call
+ * @return iir_filter_t* Filter instance, NULL if the design is not valid or 
+ *                       there is not enough memory
+ */
+iir_filter_t * IirCreateDesign(const iir_design_t * design, uint8_t n_channels);
+
+/**
+ * @brief Create a filter instance of any design that also filters fixed point 
+ * (Q15) signals, with IirFilterQ15
+ * 
+ * @note  The peak gain of each section is scaled to 1 and the coefficients are 
+ *        quantized with dsps_biquad_sos_quant_s16 (Q31 accumulation, error 
+ *        feedback and saturation). Poles very close to the unit circle 
+ *        (very low cut-off frequencies or high orders) may not be stable once 
+ *        quantized: in that case the instance is not created. E.g. at 1 kHz a 
+ *        1 Hz low or high pass returns NULL from 4th order on, and 0.5 Hz at any
+ *        order (cut-off below about 0.2 % of sample_frec): use IirCreate, or 
+ *        decimate the signal first.
+ * 
+ * @param design        Pointer to design struct (see IirDesignSOS)
+ * @param n_channels    Number of interleaved channels processed by each call
+ * @return iir_filter_t* Filter instance, NULL if the design is not valid, its 
+ *                       quantized version is not stable or there is not enough memory
+ */
+iir_filter_t * IirCreateQ15(const iir_design_t * design, uint8_t n_channels);
+
+/**
+ * @brief Release a filter instance created with IirCreate, IirCreateDesign or IirCreateQ15
+ * 
+ * @param filter    Filter instance
+ */
+void IirDelete(iir_filter_t * filter);
+
+/**
+ * @brief Clear the delay lines of every channel of a filter instance
+ * 
+ * @param filter    Filter instance
+ */
+void IirReset(iir_filter_t * filter);
+
+/**
+ * @brief Apply a filter instance to a block of interleaved samples
+ * 
+ * @note  Sample i of channel c is located at signal[i * n_channels + c].
+ *        Input and output arrays can be the same.
+ * 
+ * @param filter            Filter instance
+ * @param input_signal      Input signal array (of lenght = signal_lenght * n_channels)
+ * @param output_signal     Filtered signal array (of lenght = signal_lenght * n_channels)
+ * @param signal_lenght     Number of samples per channel
+ */
+void IirFilter(iir_filter_t * filter, const float * input_signal, float * output_signal, int16_t signal_lenght);
+
+/**
+ * @brief Apply a filter instance created with IirCreateQ15 to a block of 
+ * interleaved fixed point samples
+ * 
+ * @note  Integer samples can be used directly (e.g. 12 bit ADC readings, 0 to 4095): 
+ *        the output has the same scale as the input, and saturates to the int16 range.
+ *        Wider samples must be brought into the int16 range first: shifted (18 bit 
+ *        MAX3010X samples: sample >> 3) or offset (uint16 samples: sample - 32768). 
+ *        Casting a sample above 32767 to int16 wraps it around to a negative value.
+ *        The fixed point delay lines are not the ones used by IirFilter.
+ * 
+ * @param filter            Filter instance (created with IirCreateQ15)
+ * @param input_signal      Input signal array (of lenght = signal_lenght * n_channels)
+ * @param output_signal     Filtered signal array (of lenght = signal_lenght * n_channels)
+ * @param signal_lenght     Number of samples per channel
+ */
+void IirFilterQ15(iir_filter_t * filter, const int16_t * input_signal, int16_t * output_signal, int16_t signal_lenght);
+
+/**
+ * @brief Apply a filter instance forward and backward (zero-phase) to a whole 
+ * block of interleaved samples
+ * 
+ * @note  The magnitude response is the square of the filter's one (twice the 
+ *        attenuation in dB) and the phase is zero: the output is not delayed.
+ *        The signal is extended at both edges with its odd reflection 
+ *        (3 * (order + 1) samples, at most signal_lenght - 1) and the delay lines 
+ *        start in steady state, so there are no transients at the edges.
+ *        Every call is independent: the delay lines of the instance are not used.
+ *        Input and output arrays can be the same.
+ * 
+ * @param filter            Filter instance
+ * @param input_signal      Input signal array (of lenght = signal_lenght * n_channels)
+ * @param output_signal     Filtered signal array (of lenght = signal_lenght * n_channels)
+ * @param signal_lenght     Number of samples per channel
+ * @param workspace         Array of lenght = IIR_FILTFILT_WORKSPACE_LENGHT(signal_lenght)
+ */
+void IirFiltFilt(const iir_filter_t * filter, const float * input_signal, float * output_signal, int16_t signal_lenght, float * workspace);
+
+/**
+ * @brief Apply a hi pass and a low pass filter instance (band pass) to a block 
+ * of interleaved samples, in a single pass over the signal
+ * 
+ * @note  Same result as IirFilter(hp_filter, ...) followed by IirFilter(lp_filter, ...).
+ *        Both instances must have the same number of channels.
+ * 
+ * @param hp_filter         Hi pass filter instance
+ * @param lp_filter         Low pass filter instance
+ * @param input_signal      Input signal array (of lenght = signal_lenght * n_channels)
+ * @param output_signal     Filtered signal array (of lenght = signal_lenght * n_channels)
+ * @param signal_lenght     Number of samples per channel
+ * @return true             Signal filtered
+ * @return false            The instances have different number of channels 
+ *                          (output_signal is not written)
+ */
+bool IirBandPassFilter(iir_filter_t * hp_filter, iir_filter_t * lp_filter, const float * input_signal, float * output_signal, int16_t signal_lenght);
+
 /**
  * @brief Initialize a 2nd order Butterwotrh Low Pass Filter
  * 
@@ -69,6 +210,18 @@ void LowPassFilter(float * input_signal, float * output_signal, int16_t signal_l
  */
 void HiPassFilter(float * input_signal, float * output_signal, int16_t signal_lenght);
 
+/**
+ * @brief Apply the hi pass and the low pass filters (band pass) to a signal array,
+ * in a single pass over the signal
+ * 
+ * @note  Same result as HiPassFilter() followed by LowPassFilter()
+ * 
+ * @param input_signal      Input signal array
+ * @param output_signal     Filtered signal array
+ * @param signal_lenght     Number of samples of both signals
+ */
+void BandPassFilter(float * input_signal, float * output_signal, int16_t signal_lenght);
+
 /** @} doxygen end group definition */
 /** @} doxygen end group definition */
 /** @} doxygen end group definition */
@@ -0,0 +1,114 @@
+#ifndef QRS_DETECTOR_H_
+#define QRS_DETECTOR_H_
+/** \addtogroup Drivers_Programable Drivers Programable
+ ** @{ */
+/** \addtogroup Middelware Middelware
+ ** @{ */
+/** \addtogroup QRS_Detector QRS Detector
+ */
+
+/** \brief Real time QRS detection (Pan-Tompkins) and heart rate of an ECG
+ *
+ * The ECG is processed in blocks of any lenght, as it is acquired (raw or
+ * already filtered with IirFilter / HiPassFilter / LowPassFilter):
+ *  - 5 to 15 Hz band pass filter (IIR Filter instance)
+ *  - 5 point derivative and squaring
+ *  - 150 ms moving window integration (MWI)
+ *  - peaks of the MWI classified as QRS or noise with adaptive thresholds,
+ *    200 ms refractory period, T wave discrimination (slope of peaks closer
+ *    than 360 ms to the previous QRS) and search back of missed beats (no
+ *    QRS in 166 % of the mean RR interval)
+ *
+ * Thresholds are learnt during the first QRS_LEARNING_S seconds: QRS of that
+ * period are reported at its end. After it, each QRS is reported at most
+ * QRS_MAX_LATENCY_S seconds after the R wave, except the ones found by the
+ * search back, reported when the next beat is missing.
+ *
+ * @author Peñalva Albano
+ *
+ * @section changelog
+ *
+ * |   Date	    | Description                                    						|
+ * |:----------:|:----------------------------------------------------------------------|
+ * | 16/10/2026 | Document creation		                         						|
+ *
+ **/
+
+/*==================[inclusions]=============================================*/
+#include <stdint.h>
+/*==================[macros]=================================================*/
+#define QRS_MIN_SAMPLE_FREC     100.0f  /*!< Minimun sample frequency */
+#define QRS_LEARNING_S          2.0f    /*!< Lenght of the learning period (s) */
+#define QRS_MAX_LATENCY_S       0.45f   /*!< Maximun delay between a R wave and its report (s), after the learning period */
+/*==================[typedef]================================================*/
+/**
+ * @brief Detected beat
+ */
+typedef struct {
+    uint32_t sample;            /*!< Position of the R wave: samples since QrsCreate or QrsReset */
+    float rr;                   /*!< Time since the previous beat (s), 0 on the first beat */
+    float heart_rate;           /*!< Instantaneous heart rate (bpm): 60 / rr, 0 on the first beat */
+} qrs_beat_t;
+
+/**
+ * @brief QRS detector instance
+ */
+typedef struct qrs_detector_s qrs_detector_t;
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/**
+ * @brief Create a QRS detector instance
+ *
+ * @param sample_frec       ECG's sample frequency (at least QRS_MIN_SAMPLE_FREC)
+ * @return qrs_detector_t*  Detector instance, NULL if sample_frec is not valid
+ *                          or there is not enough memory
+ */
+qrs_detector_t * QrsCreate(float sample_frec);
+
+/**
+ * @brief Release a detector instance created with QrsCreate
+ *
+ * @param detector      Detector instance
+ */
+void QrsDelete(qrs_detector_t * detector);
+
+/**
+ * @brief Restart a detector instance: clears the filters, the thresholds
+ * (a new learning period starts) and the sample count
+ *
+ * @param detector      Detector instance
+ */
+void QrsReset(qrs_detector_t * detector);
+
+/**
+ * @brief Feed a block of ECG samples to the detector
+ *
+ * @note  Beats are reported in order, once. If there are more than max_beats
+ *        in the block the last ones are not reported (they are used for the
+ *        heart rate): max_beats = lenght / (0.2 * sample_frec) + 1 is always
+ *        enough (plus QRS_LEARNING_S / 0.2 at the end of the learning period).
+ *
+ * @param detector      Detector instance
+ * @param signal        Array with new ECG samples
+ * @param lenght        Number of samples (any value)
+ * @param beats         Array to store the beats found (of lenght = max_beats)
+ * @param max_beats     Maximun number of beats to store
+ * @return uint8_t      Number of beats stored in beats
+ */
+uint8_t QrsDetect(qrs_detector_t * detector, const float * signal, uint16_t lenght, qrs_beat_t * beats, uint8_t max_beats);
+
+/**
+ * @brief Mean heart rate of the last 8 beats
+ *
+ * @param detector      Detector instance
+ * @return float        Heart rate (bpm), 0 until two beats are found
+ */
+float QrsHeartRate(const qrs_detector_t * detector);
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+#endif /* QRS_DETECTOR_H_ */
+
+/*==================[end of file]============================================*/
@@ -0,0 +1,111 @@
+#ifndef SIGNAL_QUALITY_H_
+#define SIGNAL_QUALITY_H_
+/** \addtogroup Drivers_Programable Drivers Programable
+ ** @{ */
+/** \addtogroup Middelware Middelware
+ ** @{ */
+/** \addtogroup Signal_Quality Signal quality metrics
+ */
+
+/** \brief SNR, SINAD, THD and SFDR of a tone, from one FFT per channel
+ *
+ * Each window of lenght samples is transformed once (FFTPlanPower, Hann
+ * window) and every metric is taken from that power spectrum:
+ *  - Fundamental: strongest bin (out of the DC bins), its power is the sum of
+ *    the SIGNAL_QUALITY_LOBE_BINS bins at each side. Its frequency is the
+ *    centroid of those bins.
+ *  - Harmonics: bins around 2, 3 ... n_harmonics times the fundamental (those
+ *    above sample_frec / 2 are not taken into account).
+ *  - Noise: every other bin. DC bins only when use_dc is true.
+ *
+ * The window spreads tones and noise in the same proportion, so power ratios
+ * need no window correction.
+ *
+ * Measurements do not allocate memory: the caller provides the workspace,
+ * and the instance is not modified (several tasks can use it at once, each
+ * one with its own workspace).
+ *
+ * @author Peñalva Albano
+ *
+ * @section changelog
+ *
+ * |   Date	    | Description                                    						|
+ * |:----------:|:----------------------------------------------------------------------|
+ * | 16/10/2026 | Document creation		                         						|
+ *
+ **/
+
+/*==================[inclusions]=============================================*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "fft.h"
+/*==================[macros]=================================================*/
+#define SIGNAL_QUALITY_LOBE_BINS    7       /*!< Bins at each side of a tone taken as part of it (Hann main lobe and first sidelobes) */
+/** Workspace (in floats) needed by SignalQualityMeasure for a given window lenght */
+#define SIGNAL_QUALITY_WORKSPACE_LENGHT(lenght)     FFT_WORKSPACE_LENGHT(lenght)
+/*==================[typedef]================================================*/
+/**
+ * @brief Signal quality configuration struct
+ */
+typedef struct {
+    float sample_frec;          /*!< Sample frequency */
+    uint16_t lenght;            /*!< Window lenght: power of two (with maximun value = MAX_SIGNAL_LENGHT) */
+    uint8_t n_harmonics;        /*!< Highest harmonic taken into account by THD (2 or more) */
+    bool use_dc;                /*!< true: DC bins are taken as noise, false: DC bins are ignored */
+} signal_quality_config_t;
+
+/**
+ * @brief Metrics of one channel
+ */
+typedef struct {
+    float frec;                 /*!< Fundamental frequency (Hz) */
+    float snr;                  /*!< Fundamental to noise (harmonics excluded) ratio (dB) */
+    float sinad;                /*!< Fundamental to noise plus harmonics ratio (dB) */
+    float thd;                  /*!< Harmonics to fundamental ratio (dB, negative) */
+    float sfdr;                 /*!< Fundamental peak to strongest spur (any other bin) ratio (dB) */
+} signal_quality_t;
+
+/**
+ * @brief Signal quality instance
+ */
+typedef struct signal_quality_s signal_quality_meter_t;
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/**
+ * @brief Create a signal quality instance
+ *
+ * @note  FFTInit() must be called first.
+ *
+ * @param config                    Pointer to configuration struct
+ * @return signal_quality_meter_t*  Instance, NULL if configuration is not valid
+ *                                  or there is not enough memory
+ */
+signal_quality_meter_t * SignalQualityCreate(const signal_quality_config_t * config);
+
+/**
+ * @brief Release a signal quality instance created with SignalQualityCreate
+ *
+ * @param meter         Signal quality instance
+ */
+void SignalQualityDelete(signal_quality_meter_t * meter);
+
+/**
+ * @brief Metrics of several channels (one window of each)
+ *
+ * @param meter         Signal quality instance
+ * @param signal        Array of n_channels pointers, each one to lenght samples
+ * @param n_channels    Number of channels
+ * @param result        Array to store the metrics of each channel (of lenght = n_channels)
+ * @param workspace     Scratch array (of lenght = SIGNAL_QUALITY_WORKSPACE_LENGHT(lenght)),
+ *                      one per calling task
+ */
+void SignalQualityMeasure(const signal_quality_meter_t * meter, const float * const * signal, uint8_t n_channels,
+                          signal_quality_t * result, float * workspace);
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+#endif /* SIGNAL_QUALITY_H_ */
+
+/*==================[end of file]============================================*/
@@ -0,0 +1,117 @@
+#ifndef STFT_H_
+#define STFT_H_
+/** \addtogroup Drivers_Programable Drivers Programable
+ ** @{ */
+/** \addtogroup Middelware Middelware
+ ** @{ */
+/** \addtogroup STFT Short-Time Fourier Transform
+ */
+
+/** \brief Streaming Short-Time Fourier Transform (spectrogram)
+ * 
+ * Samples are pushed incrementally (one or many at a time) and a magnitude 
+ * frame is calculated every hop_size samples over the last frame_lenght 
+ * samples. Frames are delivered through a callback function, which can 
+ * copy them to a queue if they must be processed by other task.
+ * 
+ * @note FFTInit() must be called before using this module. Each instance has 
+ *       its own FFT plan and workspace, so instances can run in different tasks.
+ * 
+ * @author Peñalva Albano
+ *
+ * @section changelog
+ *
+ * |   Date	    | Description                                    						|
+ * |:----------:|:----------------------------------------------------------------------|
+ * | 16/10/2026 | Document creation		                         						|
+ * | 16/10/2026 | FFT plan and workspace per instance		                            |
+ * 
+ **/
+
+/*==================[inclusions]=============================================*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "fft.h"
+/*==================[macros]=================================================*/
+
+/*==================[typedef]================================================*/
+/**
+ * @brief Window applied to each frame
+ */
+typedef enum stft_window {
+    STFT_WINDOW_HANN,               /*!< Hann window */
+    STFT_WINDOW_BLACKMAN,           /*!< Blackman window */
+    STFT_WINDOW_BLACKMAN_HARRIS,    /*!< Blackman-Harris window */
+    STFT_WINDOW_BLACKMAN_NUTTALL,   /*!< Blackman-Nuttall window */
+    STFT_WINDOW_NUTTALL,            /*!< Nuttall window */
+    STFT_WINDOW_FLAT_TOP            /*!< Flat-Top window */
+} stft_window_t;
+
+/**
+ * @brief Prototype of callback function called for each new frame
+ * 
+ * @param magnitude     FFT magnitude of the frame (of lenght = n_bins). Only valid during the call
+ * @param n_bins        Number of frequency bins (frame_lenght / 2)
+ * @param param         Parameter given in the configuration struct
+ */
+typedef void (*stft_frame_func) (const float * magnitude, uint16_t n_bins, void * param);
+
+/**
+ * @brief STFT configuration struct
+ */
+typedef struct {
+    uint16_t frame_lenght;      /*!< FFT lenght: power of two (with maximun value = MAX_SIGNAL_LENGHT) */
+    uint16_t hop_size;          /*!< Samples between consecutive frames (1 to frame_lenght). frame_lenght / 4 gives 75% overlap */
+    stft_window_t window;       /*!< Window applied to each frame */
+    stft_frame_func func_p;     /*!< Pointer to callback function to call for each new frame */
+    void * param_p;             /*!< Pointer to callback function parameter */
+} stft_config_t;
+
+/**
+ * @brief STFT instance
+ */
+typedef struct stft_s stft_t;
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/**
+ * @brief Create a STFT instance
+ * 
+ * @param config    Pointer to configuration struct
+ * @return stft_t*  STFT instance, NULL if configuration is not valid or 
+ *                  there is not enough memory
+ */
+stft_t * STFTCreate(const stft_config_t * config);
+
+/**
+ * @brief Release a STFT instance created with STFTCreate
+ * 
+ * @param stft  STFT instance
+ */
+void STFTDelete(stft_t * stft);
+
+/**
+ * @brief Discard all the samples stored in a STFT instance
+ * 
+ * @param stft  STFT instance
+ */
+void STFTReset(stft_t * stft);
+
+/**
+ * @brief Push new samples to a STFT instance
+ * 
+ * @note  The callback function is called from this function, once for every
+ *        frame completed by the new samples.
+ * 
+ * @param stft          STFT instance
+ * @param samples       Array with new samples
+ * @param n_samples     Number of new samples
+ */
+void STFTPush(stft_t * stft, const float * samples, uint16_t n_samples);
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+#endif /* STFT_H_ */
+
+/*==================[end of file]============================================*/
@@ -0,0 +1,128 @@
+#ifndef TONE_BANK_H_
+#define TONE_BANK_H_
+/** \addtogroup Drivers_Programable Drivers Programable
+ ** @{ */
+/** \addtogroup Middelware Middelware
+ ** @{ */
+/** \addtogroup Tone_Bank Tone detection bank
+ */
+
+/** \brief Magnitude and phase of a few frequencies (Goertzel and sliding DFT)
+ *
+ * When only some bins are needed (50/60 Hz mains, a few audio tones, a heart
+ * rate band) computing them one by one is cheaper than a full FFTMagnitude:
+ * K bins of a N samples window cost K*N operations, against N*log2(N) of the
+ * FFT. Frequencies do not need to be multiples of sample_frec / lenght.
+ *
+ * Two ways of using a bank:
+ *  - ToneBankGoertzel: Goertzel algorithm over a block of lenght samples.
+ *  - ToneBankSlide + ToneBankRead: sliding DFT, updated with every new sample
+ *    (constant cost per sample and bin), bins can be read at any moment and
+ *    cover the last lenght samples.
+ *
+ * Magnitude has the same units than FFTMagnitude (FFTMagnitudeWindow for a
+ * rectangular window): on a bin of the FFT both give the same value. Phase is
+ * the one of a cosine starting at the oldest sample of the window.
+ *
+ * @author Peñalva Albano
+ *
+ * @section changelog
+ *
+ * |   Date	    | Description                                    						|
+ * |:----------:|:----------------------------------------------------------------------|
+ * | 16/10/2026 | Document creation		                         						|
+ *
+ **/
+
+/*==================[inclusions]=============================================*/
+#include <stdint.h>
+#include <stdbool.h>
+/*==================[macros]=================================================*/
+#define TONE_BANK_MAX_BINS      32      /*!< Maximun number of frequencies of a bank */
+/*==================[typedef]================================================*/
+/**
+ * @brief Tone bank configuration struct
+ */
+typedef struct {
+    float sample_frec;          /*!< Sample frequency */
+    const float * frec;         /*!< Frequencies to detect (n_bins values, below sample_frec / 2), copied on creation */
+    uint8_t n_bins;             /*!< Number of frequencies */
+    uint16_t lenght;            /*!< Window lenght: frequency resolution = sample_frec / lenght */
+    bool hann;                  /*!< true: Hann window (as FFTMagnitude), false: rectangular window */
+} tone_bank_config_t;
+
+/**
+ * @brief Tone bank instance
+ */
+typedef struct tone_bank_s tone_bank_t;
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/**
+ * @brief Create a tone bank instance
+ *
+ * @param config        Pointer to configuration struct
+ * @return tone_bank_t* Tone bank instance, NULL if configuration is not valid
+ *                      or there is not enough memory
+ */
+tone_bank_t * ToneBankCreate(const tone_bank_config_t * config);
+
+/**
+ * @brief Release a tone bank instance created with ToneBankCreate
+ *
+ * @param bank          Tone bank instance
+ */
+void ToneBankDelete(tone_bank_t * bank);
+
+/**
+ * @brief Magnitude and phase of each frequency over a block of samples
+ * (Goertzel algorithm)
+ *
+ * @note  Does not modify the instance: several tasks can use the same bank at
+ *        once. Independent of the sliding DFT.
+ *
+ * @param bank          Tone bank instance
+ * @param signal        Array with signal values (of lenght = config lenght)
+ * @param magnitude     Array to store the magnitude of each frequency (of lenght = n_bins)
+ * @param phase         Array to store the phase (in radians) of each frequency (of lenght = n_bins), may be NULL
+ */
+void ToneBankGoertzel(const tone_bank_t * bank, const float * signal, float * magnitude, float * phase);
+
+/**
+ * @brief Feed new samples to the sliding DFT
+ *
+ * @note  Each sample costs one complex multiplication per frequency (three
+ *        with Hann window). To avoid the build up of rounding errors, bins
+ *        are recalculated from the last samples every few windows.
+ *
+ * @param bank          Tone bank instance
+ * @param signal        Array with new samples
+ * @param lenght        Number of samples (any value)
+ */
+void ToneBankSlide(tone_bank_t * bank, const float * signal, uint16_t lenght);
+
+/**
+ * @brief Magnitude and phase of each frequency over the last samples fed to
+ * the sliding DFT (same result as ToneBankGoertzel over those samples)
+ *
+ * @note  Until lenght samples are fed, missing samples are taken as zero.
+ *
+ * @param bank          Tone bank instance
+ * @param magnitude     Array to store the magnitude of each frequency (of lenght = n_bins)
+ * @param phase         Array to store the phase (in radians) of each frequency (of lenght = n_bins), may be NULL
+ */
+void ToneBankRead(const tone_bank_t * bank, float * magnitude, float * phase);
+
+/**
+ * @brief Clear the samples of the sliding DFT
+ *
+ * @param bank          Tone bank instance
+ */
+void ToneBankReset(tone_bank_t * bank);
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+#endif /* TONE_BANK_H_ */
+
+/*==================[end of file]============================================*/
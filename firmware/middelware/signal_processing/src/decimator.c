@@ -0,0 +1,304 @@
+/**
+ * @file decimator.c
+ * @author Albano Peñalva (albano.penalva@uner.edu.ar)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include "decimator.h"
+#include "esp_dsp.h"
+#include "esp_log.h"
+/*==================[macros and definitions]=================================*/
+#define TAG "Decimator"
+#define DECIMATOR_BLOCK     128     /*!< Input samples processed by all the stages at once */
+#define BLACKMAN_WIDTH      5.5f    /*!< Transition band of a Blackman windowed FIR: 5.5 * fs / taps */
+#define DEFAULT_PASS        0.4f    /*!< Default pass_frec, relative to the output frequency */
+#define FIR_ALIGN           16      /*!< Coefficients and delay lines alignment (esp32s3 fixed point FIR) */
+#define FIR_ALIGN_UP(size)  (((size) + FIR_ALIGN - 1) & ~((size_t)FIR_ALIGN - 1))
+/*==================[internal data declaration]==============================*/
+typedef struct {
+    uint16_t decim;             /*!< Decimation factor of the stage */
+    uint16_t n_taps;            /*!< Filter lenght */
+    uint16_t n_carry;           /*!< Samples waiting to complete an output */
+    fir_f32_t fir;              /*!< Float filter */
+    fir_s16_t fir_q15;          /*!< Fixed point filter */
+    void * carry;               /*!< Samples waiting to complete an output: decim */
+} decimator_stage_t;
+
+struct decimator_s {
+    uint8_t n_stages;           /*!< Number of stages */
+    bool fixed_point;           /*!< int16 or float samples */
+    decimator_stage_t stage[DECIMATOR_MAX_STAGES];
+    void * scratch[2];          /*!< Output of intermediate stages: DECIMATOR_BLOCK */
+};
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/* Frees the buffers allocated by dsps_fird_init_s16 (rounding value, and on 
+ * esp32s3 the padded coefficients and delay line) and the instance */
+static void DecimatorFree(decimator_t * decimator){
+    if(decimator->fixed_point){
+        for(uint8_t s = 0; s < DECIMATOR_MAX_STAGES; s++){
+            dsps_fird_s16_aexx_free(&decimator->stage[s].fir_q15);
+        }
+    }
+    free(decimator);
+}
+
+/* Splits ratio into its prime factors, biggest first (cheaper: the narrow
+ * last stage runs at the lowest rate). Returns the number of factors */
+static uint8_t DecimatorFactors(uint16_t ratio, uint16_t * factors){
+    uint8_t n = 0;
+    for(uint16_t f = 2; ratio > 1; f++){
+        while((ratio % f) == 0){
+            if(n == DECIMATOR_MAX_STAGES){
+                return DECIMATOR_MAX_STAGES + 1;
+            }
+            factors[n++] = f;
+            ratio /= f;
+        }
+    }
+    for(uint8_t i = 0; i < n / 2; i++){
+        uint16_t tmp = factors[i];
+        factors[i] = factors[n - 1 - i];
+        factors[n - 1 - i] = tmp;
+    }
+    return n;
+}
+
+/* Windowed-sinc low pass filter with unity DC gain (cut_frec relative to fs) */
+static void DecimatorDesign(float * coeffs, uint16_t n_taps, float cut_frec){
+    float sum = 0;
+    dsps_wind_blackman_f32(coeffs, n_taps);
+    for(int i = 0; i < n_taps; i++){
+        float x = i - (n_taps - 1) / 2.0f;
+        float sinc = (x == 0) ? 1.0f : sinf(2 * M_PI * cut_frec * x) / (2 * M_PI * cut_frec * x);
+        coeffs[i] *= sinc;
+        sum += coeffs[i];
+    }
+    for(int i = 0; i < n_taps; i++){
+        coeffs[i] /= sum;
+    }
+}
+
+static uint16_t DecimatorStage(decimator_stage_t * stage, const float * input, float * output, uint16_t lenght){
+    float * carry = stage->carry;
+    uint16_t n_out = 0;
+    /* Complete the output started on the previous block */
+    if(stage->n_carry > 0){
+        uint16_t needed = stage->decim - stage->n_carry;
+        if(lenght < needed){
+            memcpy(&carry[stage->n_carry], input, lenght * sizeof(float));
+            stage->n_carry += lenght;
+            return 0;
+        }
+        memcpy(&carry[stage->n_carry], input, needed * sizeof(float));
+        n_out = dsps_fird_f32(&stage->fir, carry, output, 1);
+        input += needed;
+        lenght -= needed;
+    }
+    uint16_t n_full = lenght / stage->decim;
+    n_out += dsps_fird_f32(&stage->fir, input, &output[n_out], n_full);
+    stage->n_carry = lenght - n_full * stage->decim;
+    memcpy(carry, &input[n_full * stage->decim], stage->n_carry * sizeof(float));
+    return n_out;
+}
+
+static uint16_t DecimatorStageQ15(decimator_stage_t * stage, const int16_t * input, int16_t * output, uint16_t lenght){
+    int16_t * carry = stage->carry;
+    uint16_t n_out = 0;
+    /* Complete the output started on the previous block */
+    if(stage->n_carry > 0){
+        uint16_t needed = stage->decim - stage->n_carry;
+        if(lenght < needed){
+            memcpy(&carry[stage->n_carry], input, lenght * sizeof(int16_t));
+            stage->n_carry += lenght;
+            return 0;
+        }
+        memcpy(&carry[stage->n_carry], input, needed * sizeof(int16_t));
+        n_out = dsps_fird_s16(&stage->fir_q15, carry, output, 1);
+        input += needed;
+        lenght -= needed;
+    }
+    uint16_t n_full = lenght / stage->decim;
+    n_out += dsps_fird_s16(&stage->fir_q15, input, &output[n_out], n_full);
+    stage->n_carry = lenght - n_full * stage->decim;
+    memcpy(carry, &input[n_full * stage->decim], stage->n_carry * sizeof(int16_t));
+    return n_out;
+}
+
+/*==================[external functions definition]==========================*/
+decimator_t * DecimatorCreate(const decimator_config_t * config){
+    uint16_t factors[DECIMATOR_MAX_STAGES];
+    if((config->ratio == 0) || (config->sample_frec <= 0)){
+        return NULL;
+    }
+    float out_frec = config->sample_frec / config->ratio;
+    float pass_frec = (config->pass_frec > 0) ? config->pass_frec : DEFAULT_PASS * out_frec;
+    if(pass_frec >= out_frec / 2){
+        ESP_LOGE(TAG, "Pass band must be below %.1f Hz", out_frec / 2);
+        return NULL;
+    }
+    uint8_t n_stages = DecimatorFactors(config->ratio, factors);
+    if(n_stages > DECIMATOR_MAX_STAGES){
+        ESP_LOGE(TAG, "Too many stages for a ratio of %d", config->ratio);
+        return NULL;
+    }
+    /* Stage lenghts: transition band from pass_frec to the stage output
+     * frequency minus pass_frec (what aliases back below pass_frec) */
+    uint16_t n_taps[DECIMATOR_MAX_STAGES];
+    size_t sample_size = config->fixed_point ? sizeof(int16_t) : sizeof(float);
+    /* Bytes after the struct: aligned start, scratch buffers and the 
+     * coefficients, delay line and carry of each stage (rounded up to FIR_ALIGN) */
+    size_t mem_size = FIR_ALIGN - 1 + 2 * DECIMATOR_BLOCK * sample_size;
+    uint16_t max_taps = 0;
+    float frec = config->sample_frec;
+    for(uint8_t s = 0; s < n_stages; s++){
+        float transition = frec / factors[s] - 2 * pass_frec;
+        n_taps[s] = (uint16_t)ceilf(BLACKMAN_WIDTH * frec / transition) | 1;
+        if(n_taps[s] > DECIMATOR_MAX_TAPS){
+            ESP_LOGE(TAG, "Stage %d needs %d taps, use a wider pass band", s, n_taps[s]);
+            return NULL;
+        }
+        max_taps = (n_taps[s] > max_taps) ? n_taps[s] : max_taps;
+        mem_size += 2 * FIR_ALIGN_UP(n_taps[s] * sample_size) + FIR_ALIGN_UP(factors[s] * sample_size);
+        frec /= factors[s];
+    }
+    decimator_t * decimator = calloc(1, sizeof(decimator_t) + mem_size);
+    float * design = malloc(max_taps * sizeof(float));
+    if((decimator == NULL) || ((design == NULL) && (max_taps > 0))){
+        free(decimator);
+        free(design);
+        return NULL;
+    }
+    decimator->n_stages = n_stages;
+    decimator->fixed_point = config->fixed_point;
+    /* Coefficients, delay lines, carry and scratch buffers follow the struct */
+    uint8_t * mem = (uint8_t *)FIR_ALIGN_UP((uintptr_t)(decimator + 1));
+    decimator->scratch[0] = mem;
+    decimator->scratch[1] = mem + DECIMATOR_BLOCK * sample_size;
+    mem += 2 * DECIMATOR_BLOCK * sample_size;
+    esp_err_t ret;
+    for(uint8_t s = 0; s < n_stages; s++){
+        decimator_stage_t * stage = &decimator->stage[s];
+        stage->decim = factors[s];
+        stage->n_taps = n_taps[s];
+        /* Cut at half the output frequency of the stage */
+        DecimatorDesign(design, n_taps[s], 0.5f / factors[s]);
+        size_t fir_size = FIR_ALIGN_UP(n_taps[s] * sample_size);
+        void * coeffs = mem;
+        void * delay = mem + fir_size;
+        stage->carry = mem + 2 * fir_size;
+        mem += 2 * fir_size + FIR_ALIGN_UP(factors[s] * sample_size);
+        if(config->fixed_point){
+            int16_t * coeffs_q15 = coeffs;
+            for(int i = 0; i < n_taps[s]; i++){
+                int32_t c = lrintf(design[i] * 32768.0f);
+                coeffs_q15[i] = (c > INT16_MAX) ? INT16_MAX : c;
+            }
+            ret = dsps_fird_init_s16(&stage->fir_q15, coeffs, delay, n_taps[s], factors[s], 0, 0);
+        } else {
+            memcpy(coeffs, design, n_taps[s] * sizeof(float));
+            ret = dsps_fird_init_f32(&stage->fir, coeffs, delay, n_taps[s], factors[s]);
+        }
+        if(ret != ESP_OK){
+            ESP_LOGE(TAG, "Stage %d: FIR initialization error 0x%x", s, ret);
+            free(design);
+            DecimatorFree(decimator);
+            return NULL;
+        }
+        ESP_LOGD(TAG, "Stage %d: decimation %d, %d taps", s, factors[s], n_taps[s]);
+    }
+    free(design);
+    DecimatorReset(decimator);
+    return decimator;
+}
+
+void DecimatorDelete(decimator_t * decimator){
+    DecimatorFree(decimator);
+}
+
+void DecimatorReset(decimator_t * decimator){
+    for(uint8_t s = 0; s < decimator->n_stages; s++){
+        decimator_stage_t * stage = &decimator->stage[s];
+        if(decimator->fixed_point){
+            /* On esp32s3 the delay line is padded to a multiple of 8 taps */
+            memset(stage->fir_q15.delay, 0, stage->fir_q15.coeffs_len * sizeof(int16_t));
+            stage->fir_q15.pos = 0;
+            stage->fir_q15.d_pos = 0;
+        } else {
+            memset(stage->fir.delay, 0, stage->n_taps * sizeof(float));
+            stage->fir.pos = 0;
+        }
+        stage->n_carry = 0;
+    }
+}
+
+uint16_t DecimatorFilter(decimator_t * decimator, const float * input, float * output, uint16_t input_lenght){
+    uint16_t n_out = 0;
+    if(decimator->fixed_point == true){
+        ESP_LOGE(TAG, "Wrong sample type for this decimator");
+        return 0;
+    }
+    if(decimator->n_stages == 0){
+        memcpy(output, input, input_lenght * sizeof(float));
+        return input_lenght;
+    }
+    /* Blocks of DECIMATOR_BLOCK samples go through all the stages, the last
+     * one writes directly to output */
+    while(input_lenght > 0){
+        uint16_t n = (input_lenght < DECIMATOR_BLOCK) ? input_lenght : DECIMATOR_BLOCK;
+        const float * src = input;
+        input += n;
+        input_lenght -= n;
+        for(uint8_t s = 0; s < decimator->n_stages; s++){
+            float * dst = (s == decimator->n_stages - 1) ? &output[n_out] : decimator->scratch[s & 1];
+            n = DecimatorStage(&decimator->stage[s], src, dst, n);
+            src = dst;
+        }
+        n_out += n;
+    }
+    return n_out;
+}
+
+uint16_t DecimatorFilterQ15(decimator_t * decimator, const int16_t * input, int16_t * output, uint16_t input_lenght){
+    uint16_t n_out = 0;
+    if(decimator->fixed_point == false){
+        ESP_LOGE(TAG, "Wrong sample type for this decimator");
+        return 0;
+    }
+    if(decimator->n_stages == 0){
+        memcpy(output, input, input_lenght * sizeof(int16_t));
+        return input_lenght;
+    }
+    /* Blocks of DECIMATOR_BLOCK samples go through all the stages, the last
+     * one writes directly to output */
+    while(input_lenght > 0){
+        uint16_t n = (input_lenght < DECIMATOR_BLOCK) ? input_lenght : DECIMATOR_BLOCK;
+        const int16_t * src = input;
+        input += n;
+        input_lenght -= n;
+        for(uint8_t s = 0; s < decimator->n_stages; s++){
+            int16_t * dst = (s == decimator->n_stages - 1) ? &output[n_out] : decimator->scratch[s & 1];
+            n = DecimatorStageQ15(&decimator->stage[s], src, dst, n);
+            src = dst;
+        }
+        n_out += n;
+    }
+    return n_out;
+}
+
+/*==================[end of file]============================================*/
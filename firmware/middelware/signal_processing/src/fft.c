@@ -11,26 +11,139 @@
 
 /*==================[inclusions]=============================================*/
 #include <string.h>
+#include <stdlib.h>
 #include <math.h>
 #include "fft.h"
 #include "esp_dsp.h"
 #include "esp_log.h"
 /*==================[macros and definitions]=================================*/
 #define TAG "FFT Module"
+#define MAX_SIGNAL_POW      11      /*!< log2(MAX_SIGNAL_LENGHT) */
+#define FFT_TABLE_SIZE      1024    /*!< MAX_SIGNAL_LENGHT / 2, as a number for the table names */
+#define Q15_BFP_MAX         0x3FFF  /*!< Input peak after block floating point normalization */
+#define AMBM_ALPHA          31470   /*!< Alpha-max-plus-beta-min alpha = 0.96043 (Q15) */
+#define AMBM_BETA           13036   /*!< Alpha-max-plus-beta-min beta = 0.39782 (Q15) */
+#if (FFT_TABLE_SIZE * 2) != MAX_SIGNAL_LENGHT
+#error "FFT_TABLE_SIZE must be MAX_SIGNAL_LENGHT / 2"
+#endif
+#if CONFIG_DSP_MAX_FFT_SIZE < FFT_TABLE_SIZE
+#error "CONFIG_DSP_MAX_FFT_SIZE must be at least MAX_SIGNAL_LENGHT / 2"
+#endif
+/* Twiddles in flash (calculated at compile time). A table of size M serves 
+ * every FFT of size N <= M (powers of two):
+ * - N/2 points complex FFT (bit reversed order, as dsps_fft2r_init_fc32) 
+ * - Split into the N points real FFT (as dsps_fft4r_init_fc32) */
+#define FFT_W_CPLX          DSPS_FFT2R_W_TABLE_FC32(CONFIG_DSP_MAX_FFT_SIZE)
+#define FFT_W_REAL          DSPS_FFT4R_W_TABLE_FC32(FFT_TABLE_SIZE)
+#define FFT_W_REAL_SIZE     (2 * FFT_TABLE_SIZE)
 /*==================[internal data declaration]==============================*/
-static float fft_complex[2 * MAX_SIGNAL_LENGHT];
-static float wind[MAX_SIGNAL_LENGHT];
+struct fft_plan_s {
+    uint16_t signal_lenght;         /*!< Real FFT lenght */
+    uint16_t n_swaps;               /*!< Bit reverse swaps */
+    const float * window;           /*!< Window: the given one or the Hann window after the plan */
+    uint16_t * bit_rev;             /*!< Bit reverse table: n_swaps pairs */
+};
+
+/* A real signal of N samples is transformed as N/2 complex values (N floats) */
+static float fft_real[MAX_SIGNAL_LENGHT];
+/* Hann windows of FFTMagnitude, generated the first time each lenght is used.
+ * No flash window is referenced here, so --gc-sections keeps only the tables 
+ * the application passes to FFTMagnitudeWindow or FFTPlanCreateWindow */
+static float * wind_cache[MAX_SIGNAL_POW + 1];
+/* Same as fft_real for the fixed point path (N/2 complex values of int16) */
+static int16_t fft_q15[MAX_SIGNAL_LENGHT];
+/* Q15 Hann windows, generated the first time each lenght is used */
+static int16_t * wind_q15_cache[MAX_SIGNAL_POW + 1];
 /*==================[internal functions declaration]=========================*/
+/* Bit reverse of x (order bits), defined in dsps_fft2r_fc32_ansi.c */
+unsigned short reverse(unsigned short x, unsigned short N, int order);
 
 /*==================[internal data definition]===============================*/
 
 /*==================[external data definition]===============================*/
 
 /*==================[internal functions definition]==========================*/
+static const float * FFTWindow(uint16_t signal_lenght){
+    if(!dsp_is_power_of_two(signal_lenght) || (signal_lenght < 4) || (signal_lenght > MAX_SIGNAL_LENGHT)){
+        ESP_LOGE(TAG, "No window for %d samples", signal_lenght);
+        return NULL;
+    }
+    int pow = dsp_power_of_two(signal_lenght);
+    if(wind_cache[pow] == NULL){
+        wind_cache[pow] = malloc(signal_lenght * sizeof(float));
+        if(wind_cache[pow] == NULL){
+            ESP_LOGE(TAG, "Not enough memory for a %d samples window", signal_lenght);
+            return NULL;
+        }
+        dsps_wind_hann_f32(wind_cache[pow], signal_lenght);
+    }
+    return wind_cache[pow];
+}
+
+static const int16_t * FFTWindowQ15(uint16_t signal_lenght){
+    if(!dsp_is_power_of_two(signal_lenght) || (signal_lenght < 4) || (signal_lenght > MAX_SIGNAL_LENGHT)){
+        ESP_LOGE(TAG, "No window for %d samples", signal_lenght);
+        return NULL;
+    }
+    int pow = dsp_power_of_two(signal_lenght);
+    if(wind_q15_cache[pow] == NULL){
+        wind_q15_cache[pow] = malloc(signal_lenght * sizeof(int16_t));
+        if(wind_q15_cache[pow] == NULL){
+            ESP_LOGE(TAG, "Not enough memory for a %d samples window", signal_lenght);
+            return NULL;
+        }
+        /* Same Hann window as dsps_wind_hann_f32 */
+        float len_mult = 1 / (float)(signal_lenght - 1);
+        for(int i = 0; i < signal_lenght; i++){
+            int32_t w = lrintf(0.5f * (1 - cosf(i * 2 * M_PI * len_mult)) * 32768.0f);
+            wind_q15_cache[pow][i] = (w > INT16_MAX) ? INT16_MAX : w;
+        }
+    }
+    return wind_q15_cache[pow];
+}
+
+/* Magnitude of the N points real FFT (stored as N/2 complex values, with 
+ * the Nyquist bin as imaginary part of DC bin). Same scale as the former 
+ * complex FFT path */
+static void FFTScaleMagnitude(const float * data, float * fft, uint16_t n_cplx){
+    float scale = 4.0f / n_cplx;
+    fft[0] = fabsf(data[0]) / n_cplx;
+    for (int j = 1; j < n_cplx; j++){
+        fft[j] = scale * sqrtf(data[j*2+0]*data[j*2+0] + data[j*2+1]*data[j*2+1]);
+    }
+}
+
+/* Same as FFTScaleMagnitude, squared. Bin j is written after reading bins 
+ * 2j and 2j + 1, so fft may be data itself */
+static void FFTScalePower(const float * data, float * fft, uint16_t n_cplx){
+    float scale = 16.0f / ((float)n_cplx * n_cplx);
+    fft[0] = data[0] * data[0] / ((float)n_cplx * n_cplx);
+    for (int j = 1; j < n_cplx; j++){
+        fft[j] = scale * (data[j*2+0]*data[j*2+0] + data[j*2+1]*data[j*2+1]);
+    }
+}
+
+/* Scales a Q15 magnitude back to the FFTMagnitude units, with saturation */
+static inline int16_t FFTScaleQ15(int32_t mag, int shift){
+    mag = (shift >= 0) ? ((mag + ((1 << shift) >> 1)) >> shift) : (mag << -shift);
+    return (mag > INT16_MAX) ? INT16_MAX : mag;
+}
 
 /*==================[external functions definition]==========================*/
 bool FFTInit(void){
-    esp_err_t ret = dsps_fft2r_init_fc32(NULL, CONFIG_DSP_MAX_FFT_SIZE);
+    /* Tables in flash: nothing is calculated or allocated */
+    esp_err_t ret = dsps_fft2r_init_const_fc32(FFT_W_CPLX, CONFIG_DSP_MAX_FFT_SIZE);
+    if (ret != ESP_OK){
+        return false;
+    }
+    /* Twiddles to split the N/2 points complex FFT into the N points real FFT:
+     * dsps_cplx2real_fc32 needs a radix-4 table sized for the biggest N/2 */
+    ret = dsps_fft4r_init_const_fc32(FFT_W_REAL, FFT_TABLE_SIZE);
+    if (ret != ESP_OK){
+        return false;
+    }
+    /* Twiddles for the fixed point path (FFTMagnitudeQ15) */
+    ret = dsps_fft2r_init_sc16(NULL, MAX_SIGNAL_LENGHT / 2);
     if (ret != ESP_OK){
         return false;
     }
@@ -38,25 +151,143 @@ bool FFTInit(void){
 }
 
 void FFTMagnitude(float * signal, float * fft, uint16_t signal_lenght){
-    // Generate Hann window
-    dsps_wind_hann_f32(wind, signal_lenght);
-    // Clear fft array
-    memset(fft_complex, 0, 2 * MAX_SIGNAL_LENGHT * sizeof(float));
-    // Multiply input array with window and store as real part
-    dsps_mul_f32(signal, wind, fft_complex, signal_lenght, 1, 1, 2);    
-    // Calculate FFT  
-    dsps_fft2r_fc32(fft_complex, signal_lenght);
+    const float * wind = FFTWindow(signal_lenght);
+    if(wind == NULL){
+        return;
+    }
+    FFTMagnitudeWindow(signal, wind, fft, signal_lenght);
+}
+
+void FFTMagnitudeWindow(const float * signal, const float * window, float * fft, uint16_t signal_lenght){
+    uint16_t n_cplx = signal_lenght / 2;
+    // Multiply input array with window. Even samples are stored as real part 
+    // and odd samples as imaginary part of a N/2 complex array
+    dsps_mul_f32(signal, window, fft_real, signal_lenght, 1, 1, 1);
+    // Calculate N/2 points complex FFT
+    dsps_fft2r_fc32(fft_real, n_cplx);
     // Bit reverse
-    dsps_bit_rev_fc32(fft_complex, signal_lenght);
-    // Convert one complex vector to two complex vectors
-    dsps_cplx2reC_fc32(fft_complex, signal_lenght);
-    // Calculate FFT magnitude 
-    for (int j = 0; j < signal_lenght; j++){
-            fft_complex[j] = 2*(sqrt(fft_complex[j*2+0]*fft_complex[j*2+0] + fft_complex[j*2+1]*fft_complex[j*2+1])) / (signal_lenght/2);
-    }
-    fft_complex[0] = fft_complex[0] / 2;
-    // Copy result in fft array
-    memcpy(fft, fft_complex, (signal_lenght / 2) * sizeof(float));
+    dsps_bit_rev_fc32(fft_real, n_cplx);
+    // Convert to the first half of the N points real FFT 
+    dsps_cplx2real_fc32(fft_real, n_cplx);
+    // Calculate FFT magnitude
+    FFTScaleMagnitude(fft_real, fft, n_cplx);
+}
+
+fft_plan_t * FFTPlanCreate(uint16_t signal_lenght){
+    return FFTPlanCreateWindow(signal_lenght, NULL);
+}
+
+fft_plan_t * FFTPlanCreateWindow(uint16_t signal_lenght, const float * window){
+    if(!dsp_is_power_of_two(signal_lenght) || (signal_lenght < 4) || (signal_lenght > MAX_SIGNAL_LENGHT)){
+        ESP_LOGE(TAG, "Invalid FFT lenght: %d", signal_lenght);
+        return NULL;
+    }
+    uint16_t n_cplx = signal_lenght / 2;
+    int order = dsp_power_of_two(n_cplx);
+    /* Swaps of the bit reverse permutation, as offsets of the real part of 
+     * each complex value (in the format used by dsps_bit_rev_lookup_fc32) */
+    uint16_t n_swaps = 0;
+    for(uint16_t i = 0; i < n_cplx; i++){
+        if(i < reverse(i, n_cplx, order)){
+            n_swaps++;
+        }
+    }
+    /* Without a given window, the Hann window is stored after the plan */
+    size_t wind_size = (window == NULL) ? signal_lenght * sizeof(float) : 0;
+    fft_plan_t * plan = malloc(sizeof(fft_plan_t) + wind_size + 2 * n_swaps * sizeof(uint16_t));
+    if(plan == NULL){
+        return NULL;
+    }
+    plan->signal_lenght = signal_lenght;
+    plan->n_swaps = n_swaps;
+    plan->bit_rev = (uint16_t *)((uint8_t *)(plan + 1) + wind_size);
+    for(uint16_t i = 0, k = 0; i < n_cplx; i++){
+        uint16_t j = reverse(i, n_cplx, order);
+        if(i < j){
+            plan->bit_rev[2 * k + 0] = i * 2 * sizeof(float);
+            plan->bit_rev[2 * k + 1] = j * 2 * sizeof(float);
+            k++;
+        }
+    }
+    if(window == NULL){
+        dsps_wind_hann_f32((float *)(plan + 1), signal_lenght);
+        window = (float *)(plan + 1);
+    }
+    plan->window = window;
+    return plan;
+}
+
+void FFTPlanDelete(fft_plan_t * plan){
+    free(plan);
+}
+
+void FFTPlanMagnitude(const fft_plan_t * plan, const float * signal, float * fft, float * workspace){
+    FFTPlanMagnitudeWindow(plan, signal, plan->window, fft, workspace);
+}
+
+void FFTPlanMagnitudeWindow(const fft_plan_t * plan, const float * signal, const float * window, float * fft, float * workspace){
+    uint16_t n_cplx = plan->signal_lenght / 2;
+    // Same steps as FFTMagnitudeWindow, with the plan bit reverse table, the 
+    // twiddles in flash and the caller workspace instead of the global ones
+    dsps_mul_f32(signal, window, workspace, plan->signal_lenght, 1, 1, 1);
+    dsps_fft2r_fc32_ansi_(workspace, n_cplx, (float *)FFT_W_CPLX);
+    dsps_bit_rev_lookup_fc32_ansi(workspace, plan->n_swaps, plan->bit_rev);
+    dsps_cplx2real_fc32_ansi_(workspace, n_cplx, (float *)FFT_W_REAL, FFT_W_REAL_SIZE);
+    FFTScaleMagnitude(workspace, fft, n_cplx);
+}
+
+void FFTPlanPower(const fft_plan_t * plan, const float * signal, float * power, float * workspace){
+    uint16_t n_cplx = plan->signal_lenght / 2;
+    dsps_mul_f32(signal, plan->window, workspace, plan->signal_lenght, 1, 1, 1);
+    dsps_fft2r_fc32_ansi_(workspace, n_cplx, (float *)FFT_W_CPLX);
+    dsps_bit_rev_lookup_fc32_ansi(workspace, plan->n_swaps, plan->bit_rev);
+    dsps_cplx2real_fc32_ansi_(workspace, n_cplx, (float *)FFT_W_REAL, FFT_W_REAL_SIZE);
+    FFTScalePower(workspace, power, n_cplx);
+}
+
+void FFTMagnitudeQ15(const int16_t * signal, int16_t * fft, uint16_t signal_lenght){
+    uint16_t n_cplx = signal_lenght / 2;
+    const int16_t * wind = FFTWindowQ15(signal_lenght);
+    if(wind == NULL){
+        return;
+    }
+    // Block floating point: the whole block is shifted so its peak is just 
+    // below Q15_BFP_MAX, the headroom left by dsps_cplx2real_sc16 sums
+    int32_t peak = 1;
+    for (int i = 0; i < signal_lenght; i++){
+        int32_t a = (signal[i] < 0) ? -(int32_t)signal[i] : signal[i];
+        if (a > peak){
+            peak = a;
+        }
+    }
+    int shift = 0;
+    while ((peak << (shift + 1)) <= Q15_BFP_MAX){
+        shift++;
+    }
+    if (peak > Q15_BFP_MAX){
+        shift = -1;
+    }
+    // Multiply input array with Q15 window, packed as N/2 complex values
+    for (int i = 0; i < signal_lenght; i++){
+        fft_q15[i] = ((int32_t)signal[i] * wind[i]) >> (15 - shift);
+    }
+    // N/2 points complex FFT (each stage halves the data), bit reverse and 
+    // conversion to the N points real FFT: the result is X[k] * 2^shift / N
+    dsps_fft2r_sc16(fft_q15, n_cplx);
+    dsps_bit_rev_sc16(fft_q15, n_cplx);
+    dsps_cplx2real_sc16(fft_q15, n_cplx);
+    // Magnitude by alpha-max-plus-beta-min, then back to FFTMagnitude scale 
+    // (4 * |X[k]| / (N/2) = 8 * |X[k]| / N)
+    int32_t dc = fft_q15[0];
+    fft[0] = FFTScaleQ15(((dc < 0) ? -dc : dc) << 1, shift);
+    for (int j = 1; j < n_cplx; j++){
+        int32_t re = fft_q15[j*2+0];
+        int32_t im = fft_q15[j*2+1];
+        re = (re < 0) ? -re : re;
+        im = (im < 0) ? -im : im;
+        int32_t mag = (re > im) ? (AMBM_ALPHA * re + AMBM_BETA * im) : (AMBM_ALPHA * im + AMBM_BETA * re);
+        fft[j] = FFTScaleQ15(mag >> 12, shift);
+    }
 }
 
 void FFTFrequency(float sample_freq, uint16_t signal_lenght, float * f){
@@ -0,0 +1,265 @@
+/**
+ * @file hrv.c
+ * @author Albano Peñalva (albano.penalva@uner.edu.ar)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "hrv.h"
+#include "fft.h"
+#include "esp_dsp.h"
+/*==================[macros and definitions]=================================*/
+#define LF_LOW              0.04f   /*!< Bands (Hz) */
+#define LF_HIGH             0.15f
+#define HF_HIGH             0.40f
+#define ECTOPIC_PERCENT     20      /*!< Maximun change from the previous RR interval (%) */
+#define NN_LIMIT_MS         50      /*!< Successive differences counted by pNN50 (ms) */
+#define HANN_POWER          12.0f   /*!< Sum of the FFTPlanPower bins of a sine over its power (Hann window) */
+#define BEAT_VALID          0x01    /*!< RR interval used by the metrics */
+#define BEAT_DIFF           0x02    /*!< Previous RR interval is valid too: successive difference used */
+/*==================[internal data declaration]==============================*/
+typedef struct {
+    uint16_t rr;                /*!< RR interval (ms) */
+    uint16_t diff;              /*!< Absolute difference with the previous RR interval (ms) */
+    uint8_t flags;              /*!< BEAT_VALID, BEAT_DIFF */
+} hrv_beat_t;
+
+struct hrv_analyzer_s {
+    fft_plan_t * plan;          /*!< FFT of the tachogram */
+    uint32_t window_ms;         /*!< Window lenght (ms) */
+    float sample_period;        /*!< Tachogram sample period (ms) */
+    uint16_t n_samples;         /*!< Tachogram samples (power of two) */
+    uint16_t lf_start;          /*!< Bins of the bands: [lf_start, hf_start) and [hf_start, hf_end) */
+    uint16_t hf_start;
+    uint16_t hf_end;
+    uint16_t capacity;          /*!< Maximun number of beats in the window */
+    hrv_beat_t * beats;         /*!< Beats of the window (circular buffer): capacity */
+    uint16_t first;             /*!< Oldest beat */
+    uint16_t n_beats;           /*!< Beats in the window (valid or not) */
+    uint32_t time;              /*!< Sum of the RR intervals of every beat in the window (ms) */
+    uint16_t n_valid;           /*!< Sums of valid RR intervals */
+    uint32_t sum_rr;
+    uint64_t sum_rr2;
+    uint16_t n_diff;            /*!< Sums of successive differences */
+    uint16_t nn50;
+    uint64_t sum_diff2;
+    uint16_t last_rr;           /*!< Last RR interval added (ms), 0: none */
+    bool last_valid;            /*!< Last RR interval added is valid */
+    float * tachogram;          /*!< Resampled RR intervals (circular buffer): n_samples */
+    uint16_t pos;               /*!< Next sample of the tachogram */
+    uint16_t n_written;         /*!< Tachogram samples written (up to n_samples) */
+    float tachogram_last;       /*!< Tachogram value at the last beat (ms), 0: not started */
+    float phase;                /*!< Time from the last beat to the next tachogram sample (ms) */
+};
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/* Removes the oldest beat of the window from the sums */
+static void HrvRemoveOldest(hrv_analyzer_t * hrv){
+    hrv_beat_t * beat = &hrv->beats[hrv->first];
+    hrv->time -= beat->rr;
+    if(beat->flags & BEAT_VALID){
+        hrv->n_valid--;
+        hrv->sum_rr -= beat->rr;
+        hrv->sum_rr2 -= (uint32_t)beat->rr * beat->rr;
+    }
+    if(beat->flags & BEAT_DIFF){
+        hrv->n_diff--;
+        hrv->sum_diff2 -= (uint32_t)beat->diff * beat->diff;
+        hrv->nn50 -= (beat->diff > NN_LIMIT_MS);
+    }
+    hrv->first = (hrv->first + 1 < hrv->capacity) ? hrv->first + 1 : 0;
+    hrv->n_beats--;
+    /* The next beat loses its predecessor */
+    if(hrv->n_beats > 0){
+        beat = &hrv->beats[hrv->first];
+        if(beat->flags & BEAT_DIFF){
+            beat->flags &= ~BEAT_DIFF;
+            hrv->n_diff--;
+            hrv->sum_diff2 -= (uint32_t)beat->diff * beat->diff;
+            hrv->nn50 -= (beat->diff > NN_LIMIT_MS);
+        }
+    }
+}
+
+/* Tachogram samples until the new beat: linear interpolation from the last
+ * value (or the last one held, for not valid intervals) */
+static void HrvResample(hrv_analyzer_t * hrv, float rr, float value){
+    float slope = (value - hrv->tachogram_last) / rr;
+    while(hrv->phase < rr){
+        hrv->tachogram[hrv->pos] = hrv->tachogram_last + slope * hrv->phase;
+        hrv->pos = (hrv->pos + 1) & (hrv->n_samples - 1);
+        if(hrv->n_written < hrv->n_samples){
+            hrv->n_written++;
+        }
+        hrv->phase += hrv->sample_period;
+    }
+    hrv->phase -= rr;
+    hrv->tachogram_last = value;
+}
+
+/*==================[external functions definition]==========================*/
+hrv_analyzer_t * HrvCreate(uint16_t window_s){
+    if((window_s < HRV_MIN_WINDOW_S) || (window_s > HRV_MAX_WINDOW_S)){
+        return NULL;
+    }
+    /* Power of two samples per window, at HRV_MIN_RESAMPLE_FREC or more */
+    uint16_t n_samples = 1;
+    while(n_samples < HRV_MIN_RESAMPLE_FREC * window_s){
+        n_samples *= 2;
+    }
+    uint16_t capacity = (uint32_t)window_s * 1000 / HRV_MIN_RR_MS + 1;
+    hrv_analyzer_t * hrv = calloc(1, sizeof(hrv_analyzer_t) + capacity * sizeof(hrv_beat_t) + n_samples * sizeof(float));
+    if(hrv == NULL){
+        return NULL;
+    }
+    hrv->plan = FFTPlanCreate(n_samples);
+    if(hrv->plan == NULL){
+        HrvDelete(hrv);
+        return NULL;
+    }
+    hrv->window_ms = (uint32_t)window_s * 1000;
+    hrv->n_samples = n_samples;
+    hrv->sample_period = (float)hrv->window_ms / n_samples;
+    /* Bin k: k / window_s Hz */
+    hrv->lf_start = ceilf(LF_LOW * window_s);
+    hrv->hf_start = ceilf(LF_HIGH * window_s);
+    hrv->hf_end = ceilf(HF_HIGH * window_s);
+    hrv->capacity = capacity;
+    /* Beats and tachogram follow the struct */
+    hrv->tachogram = (float *)(hrv + 1);
+    hrv->beats = (hrv_beat_t *)(hrv->tachogram + n_samples);
+    HrvReset(hrv);
+    return hrv;
+}
+
+void HrvDelete(hrv_analyzer_t * hrv){
+    if(hrv == NULL){
+        return;
+    }
+    FFTPlanDelete(hrv->plan);
+    free(hrv);
+}
+
+void HrvReset(hrv_analyzer_t * hrv){
+    hrv->first = 0;
+    hrv->n_beats = 0;
+    hrv->time = 0;
+    hrv->n_valid = 0;
+    hrv->sum_rr = 0;
+    hrv->sum_rr2 = 0;
+    hrv->n_diff = 0;
+    hrv->nn50 = 0;
+    hrv->sum_diff2 = 0;
+    hrv->last_rr = 0;
+    hrv->last_valid = false;
+    hrv->pos = 0;
+    hrv->n_written = 0;
+    hrv->tachogram_last = 0;
+    hrv->phase = 0;
+}
+
+void HrvAddBeat(hrv_analyzer_t * hrv, float rr){
+    if(rr <= 0){
+        return;
+    }
+    /* Longer intervals fill the whole window anyway */
+    float rr_ms = fminf(rr * 1000, (float)hrv->window_ms);
+    hrv_beat_t beat = {.rr = (rr_ms < UINT16_MAX) ? rr_ms + 0.5f : UINT16_MAX, .diff = 0, .flags = 0};
+    if((beat.rr >= HRV_MIN_RR_MS) && (beat.rr <= HRV_MAX_RR_MS) &&
+       ((hrv->last_rr == 0) || (abs(beat.rr - hrv->last_rr) * 100 <= hrv->last_rr * ECTOPIC_PERCENT))){
+        beat.flags = BEAT_VALID;
+        if(hrv->last_valid){
+            beat.flags |= BEAT_DIFF;
+            beat.diff = abs(beat.rr - hrv->last_rr);
+        }
+    }
+    hrv->last_rr = beat.rr;
+    hrv->last_valid = beat.flags & BEAT_VALID;
+
+    /* Tachogram: starts at the first valid beat */
+    if(hrv->tachogram_last > 0){
+        HrvResample(hrv, rr_ms, (beat.flags & BEAT_VALID) ? beat.rr : hrv->tachogram_last);
+    }else if(beat.flags & BEAT_VALID){
+        hrv->tachogram_last = beat.rr;
+    }
+
+    /* Window: beats of the last window_ms */
+    while((hrv->n_beats > 0) && ((hrv->n_beats == hrv->capacity) || (hrv->time + beat.rr > hrv->window_ms))){
+        HrvRemoveOldest(hrv);
+    }
+    uint16_t last = hrv->first + hrv->n_beats;
+    hrv->beats[(last < hrv->capacity) ? last : last - hrv->capacity] = beat;
+    hrv->n_beats++;
+    hrv->time += beat.rr;
+    if(beat.flags & BEAT_VALID){
+        hrv->n_valid++;
+        hrv->sum_rr += beat.rr;
+        hrv->sum_rr2 += (uint32_t)beat.rr * beat.rr;
+    }
+    if(beat.flags & BEAT_DIFF){
+        hrv->n_diff++;
+        hrv->sum_diff2 += (uint32_t)beat.diff * beat.diff;
+        hrv->nn50 += (beat.diff > NN_LIMIT_MS);
+    }
+}
+
+bool HrvRead(const hrv_analyzer_t * hrv, hrv_t * result, float * workspace){
+    memset(result, 0, sizeof(hrv_t));
+    result->n_beats = hrv->n_valid;
+    if(hrv->n_valid > 0){
+        result->mean_rr = (float)hrv->sum_rr / hrv->n_valid;
+        result->heart_rate = 60000.0f / result->mean_rr;
+    }
+    if(hrv->n_valid > 1){
+        /* n * sum(rr^2) - sum(rr)^2 is exact in 64 bits */
+        uint64_t n = hrv->n_valid;
+        uint64_t var = n * hrv->sum_rr2 - (uint64_t)hrv->sum_rr * hrv->sum_rr;
+        result->sdnn = sqrtf((float)var / (n * (n - 1)));
+    }
+    if(hrv->n_diff > 0){
+        result->rmssd = sqrtf((float)hrv->sum_diff2 / hrv->n_diff);
+        result->pnn50 = 100.0f * hrv->nn50 / hrv->n_diff;
+    }
+    bool complete = (hrv->n_written == hrv->n_samples);
+    if(!complete || (workspace == NULL)){
+        return complete;
+    }
+
+    /* Tachogram from the oldest sample, without its mean */
+    uint16_t n = hrv->n_samples;
+    float * signal = workspace;
+    float * power = workspace + n;
+    memcpy(signal, &hrv->tachogram[hrv->pos], (n - hrv->pos) * sizeof(float));
+    memcpy(&signal[n - hrv->pos], hrv->tachogram, hrv->pos * sizeof(float));
+    float mean = 0;
+    for(uint16_t i = 0; i < n; i++){
+        mean += signal[i];
+    }
+    dsps_addc_f32(signal, signal, n, -mean / n, 1, 1);
+    FFTPlanPower(hrv->plan, signal, power, power);
+    for(uint16_t k = hrv->lf_start; k < hrv->hf_start; k++){
+        result->lf += power[k];
+    }
+    for(uint16_t k = hrv->hf_start; (k < hrv->hf_end) && (k < n / 2); k++){
+        result->hf += power[k];
+    }
+    result->lf /= HANN_POWER;
+    result->hf /= HANN_POWER;
+    result->lf_hf = (result->hf > 0) ? result->lf / result->hf : 0;
+    return true;
+}
+
+/*==================[end of file]============================================*/
@@ -0,0 +1,375 @@
+/**
+ * @file iir_design.c
+ * @author Albano Peñalva (albano.penalva@uner.edu.ar)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include <stdbool.h>
+#include <math.h>
+#include <complex.h>
+#include "iir_design.h"
+/*==================[macros and definitions]=================================*/
+#define MAX_ROOTS           (2 * IIR_MAX_ORDER)     /*!< Band stop transform adds 2 zeros per pole */
+#define BESSEL_ITERATIONS   500                     /*!< Maximun iterations of the Bessel polynomial roots */
+#define REAL_TOL            1e-9                    /*!< Roots with a smaller imaginary part are real */
+/*==================[internal data declaration]==============================*/
+/* Zeros, poles and gain: H(s) = k * prod(s - z) / prod(s - p) */
+typedef struct {
+    double complex z[MAX_ROOTS];
+    double complex p[MAX_ROOTS];
+    uint8_t n_z;
+    uint8_t n_p;
+    double k;
+} iir_zpk_t;
+
+/* Two poles or zeros of a section: a complex conjugate pair or two real values */
+typedef struct {
+    double complex r1;
+    double complex r2;
+    bool used;
+} iir_pair_t;
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+static double complex IirProd(const double complex * r, uint8_t n, double complex s){
+    double complex prod = 1;
+    for(uint8_t i = 0; i < n; i++){
+        prod *= s - r[i];
+    }
+    return prod;
+}
+
+/* Analog Butterworth prototype, -3 dB at 1 rad/s */
+static void IirButterworth(iir_zpk_t * zpk, uint8_t n){
+    zpk->n_z = 0;
+    zpk->n_p = n;
+    for(uint8_t i = 0; i < n; i++){
+        zpk->p[i] = cexp(I * M_PI * (2 * i + n + 1) / (2.0 * n));
+    }
+    zpk->k = 1;
+}
+
+/* Analog Chebyshev I prototype, -ripple dB at 1 rad/s */
+static void IirChebyshev1(iir_zpk_t * zpk, uint8_t n, double ripple){
+    double eps = sqrt(pow(10, ripple / 10) - 1);
+    double mu = asinh(1 / eps) / n;
+    zpk->n_z = 0;
+    zpk->n_p = n;
+    for(uint8_t i = 0; i < n; i++){
+        double theta = M_PI * (2 * i + 1) / (2.0 * n);
+        zpk->p[i] = -sinh(mu) * sin(theta) + I * cosh(mu) * cos(theta);
+    }
+    zpk->k = creal(IirProd(zpk->p, n, 0));
+    if((n % 2) == 0){
+        /* Even orders start the pass band at the bottom of the ripple */
+        zpk->k /= sqrt(1 + eps * eps);
+    }
+}
+
+/* Analog Chebyshev II prototype, -ripple dB at 1 rad/s */
+static void IirChebyshev2(iir_zpk_t * zpk, uint8_t n, double ripple){
+    double eps = 1 / sqrt(pow(10, ripple / 10) - 1);
+    double mu = asinh(1 / eps) / n;
+    zpk->n_z = 0;
+    zpk->n_p = n;
+    for(uint8_t i = 0; i < n; i++){
+        double theta = M_PI * (2 * i + 1) / (2.0 * n);
+        zpk->p[i] = 1 / (-sinh(mu) * sin(theta) + I * cosh(mu) * cos(theta));
+        /* Odd orders have a zero at infinity */
+        if(fabs(cos(theta)) > REAL_TOL){
+            zpk->z[zpk->n_z++] = I / cos(theta);
+        }
+    }
+    zpk->k = creal(IirProd(zpk->p, n, 0) / IirProd(zpk->z, zpk->n_z, 0));
+}
+
+/* Analog Bessel prototype, -3 dB at 1 rad/s. Poles are the roots of the
+ * reverse Bessel polynomial (Durand-Kerner method), scaled so its constant
+ * term is 1 (same phase as a delay at low frequencies) and then moved to
+ * the -3 dB frequency */
+static void IirBessel(iir_zpk_t * zpk, uint8_t n){
+    double coeff[IIR_MAX_ORDER + 1];
+    /* a[k] = (2n - k)! / (2^(n - k) k! (n - k)!), from a[n] = 1 */
+    coeff[n] = 1;
+    for(int k = n - 1; k >= 0; k--){
+        coeff[k] = coeff[k + 1] * (2 * n - k) * (k + 1) / (2.0 * (n - k));
+    }
+    /* s = r * x, with r^n = a[0]: monic polynomial in x with constant term 1 */
+    double a0 = coeff[0];
+    double r = pow(a0, 1.0 / n);
+    double rk = 1;
+    for(int k = 0; k <= n; k++){
+        coeff[k] *= rk / a0;
+        rk *= r;
+    }
+    coeff[n] = 1;
+    for(uint8_t i = 0; i < n; i++){
+        zpk->p[i] = cpow(0.4 + 0.9 * I, i);
+    }
+    for(int iter = 0; iter < BESSEL_ITERATIONS; iter++){
+        double change = 0;
+        for(uint8_t i = 0; i < n; i++){
+            double complex value = coeff[n];
+            for(int k = n - 1; k >= 0; k--){
+                value = value * zpk->p[i] + coeff[k];
+            }
+            double complex den = 1;
+            for(uint8_t j = 0; j < n; j++){
+                if(j != i){
+                    den *= zpk->p[i] - zpk->p[j];
+                }
+            }
+            double complex delta = value / den;
+            zpk->p[i] -= delta;
+            change = fmax(change, cabs(delta));
+        }
+        if(change < 1e-12){
+            break;
+        }
+    }
+    zpk->n_z = 0;
+    zpk->n_p = n;
+    /* -3 dB frequency (|H| decreases with frequency), by bisection */
+    double complex gain = IirProd(zpk->p, n, 0);
+    double w_low = 0.1, w_high = 10;
+    for(int iter = 0; iter < 60; iter++){
+        double w = sqrt(w_low * w_high);
+        if(cabs(gain / IirProd(zpk->p, n, I * w)) > M_SQRT1_2){
+            w_low = w;
+        } else {
+            w_high = w;
+        }
+    }
+    double w_3db = sqrt(w_low * w_high);
+    for(uint8_t i = 0; i < n; i++){
+        zpk->p[i] /= w_3db;
+    }
+    zpk->k = creal(IirProd(zpk->p, n, 0));
+}
+
+/* Low pass prototype to low pass or high pass with cut-off w0 */
+static void IirLowPassToLowPass(iir_zpk_t * zpk, double w0){
+    for(uint8_t i = 0; i < zpk->n_z; i++){
+        zpk->z[i] *= w0;
+    }
+    for(uint8_t i = 0; i < zpk->n_p; i++){
+        zpk->p[i] *= w0;
+    }
+    zpk->k *= pow(w0, zpk->n_p - zpk->n_z);
+}
+
+static void IirLowPassToHighPass(iir_zpk_t * zpk, double w0){
+    zpk->k *= creal(IirProd(zpk->z, zpk->n_z, 0) / IirProd(zpk->p, zpk->n_p, 0));
+    for(uint8_t i = 0; i < zpk->n_z; i++){
+        zpk->z[i] = w0 / zpk->z[i];
+    }
+    for(uint8_t i = 0; i < zpk->n_p; i++){
+        zpk->p[i] = w0 / zpk->p[i];
+    }
+    /* Zeros at infinity go to s = 0 */
+    while(zpk->n_z < zpk->n_p){
+        zpk->z[zpk->n_z++] = 0;
+    }
+}
+
+/* Each root r of the prototype gives the two roots of s^2 - r * bw * s + w0^2 */
+static uint8_t IirBandRoots(double complex * roots, uint8_t n, double w0, double bw, bool stop){
+    for(uint8_t i = 0; i < n; i++){
+        double complex half = stop ? (bw / 2) / roots[i] : roots[i] * (bw / 2);
+        double complex d = csqrt(half * half - w0 * w0);
+        roots[i] = half + d;
+        roots[n + i] = half - d;
+    }
+    return 2 * n;
+}
+
+/* Low pass prototype to band pass or band stop, with center w0 and band bw */
+static void IirLowPassToBand(iir_zpk_t * zpk, double w0, double bw, bool stop){
+    uint8_t degree = zpk->n_p - zpk->n_z;
+    if(stop){
+        zpk->k *= creal(IirProd(zpk->z, zpk->n_z, 0) / IirProd(zpk->p, zpk->n_p, 0));
+    } else {
+        zpk->k *= pow(bw, degree);
+    }
+    zpk->n_z = IirBandRoots(zpk->z, zpk->n_z, w0, bw, stop);
+    zpk->n_p = IirBandRoots(zpk->p, zpk->n_p, w0, bw, stop);
+    /* Zeros at infinity go to s = 0 (band pass) or to s = +-j*w0 (band stop) */
+    for(uint8_t i = 0; i < degree; i++){
+        if(stop){
+            zpk->z[zpk->n_z++] = I * w0;
+            zpk->z[zpk->n_z++] = -I * w0;
+        } else {
+            zpk->z[zpk->n_z++] = 0;
+        }
+    }
+}
+
+/* Bilinear transform z = (1 + s) / (1 - s): frequencies pre-warped by tan(pi * f / fs) */
+static void IirBilinear(iir_zpk_t * zpk){
+    zpk->k *= creal(IirProd(zpk->z, zpk->n_z, 1) / IirProd(zpk->p, zpk->n_p, 1));
+    for(uint8_t i = 0; i < zpk->n_z; i++){
+        zpk->z[i] = (1 + zpk->z[i]) / (1 - zpk->z[i]);
+    }
+    for(uint8_t i = 0; i < zpk->n_p; i++){
+        zpk->p[i] = (1 + zpk->p[i]) / (1 - zpk->p[i]);
+    }
+    /* Zeros at infinity go to z = -1 (Nyquist) */
+    while(zpk->n_z < zpk->n_p){
+        zpk->z[zpk->n_z++] = -1;
+    }
+}
+
+/* Groups the roots in conjugate pairs (one root with imag > 0 each) and pairs
+ * of real roots. Real roots are sorted and the smallest is paired with the
+ * biggest, so the +1 and -1 zeros of a band pass filter share a section */
+static uint8_t IirPairs(const double complex * roots, uint8_t n, iir_pair_t * pairs){
+    double real[MAX_ROOTS];
+    uint8_t n_real = 0;
+    uint8_t n_pairs = 0;
+    for(uint8_t i = 0; i < n; i++){
+        if(fabs(cimag(roots[i])) <= REAL_TOL * fmax(1, cabs(roots[i]))){
+            real[n_real++] = creal(roots[i]);
+        } else if(cimag(roots[i]) > 0){
+            pairs[n_pairs].r1 = roots[i];
+            pairs[n_pairs].r2 = conj(roots[i]);
+            pairs[n_pairs].used = false;
+            n_pairs++;
+        }
+    }
+    for(uint8_t i = 1; i < n_real; i++){
+        double value = real[i];
+        int j = i - 1;
+        while((j >= 0) && (real[j] > value)){
+            real[j + 1] = real[j];
+            j--;
+        }
+        real[j + 1] = value;
+    }
+    for(uint8_t i = 0; i < n_real / 2; i++){
+        pairs[n_pairs].r1 = real[i];
+        pairs[n_pairs].r2 = real[n_real - 1 - i];
+        pairs[n_pairs].used = false;
+        n_pairs++;
+    }
+    return n_pairs;
+}
+
+/* Distance to the unit circle of the nearest root of a pair */
+static double IirPairRadius(const iir_pair_t * pair){
+    return fmin(1 - cabs(pair->r1), 1 - cabs(pair->r2));
+}
+
+static double IirPairDistance(const iir_pair_t * poles, const iir_pair_t * zeros){
+    return fmin(fmin(cabs(poles->r1 - zeros->r1), cabs(poles->r1 - zeros->r2)),
+                fmin(cabs(poles->r2 - zeros->r1), cabs(poles->r2 - zeros->r2)));
+}
+
+/* Second order sections: poles nearest to the unit circle are matched first
+ * with their nearest zeros, and placed at the end of the cascade */
+static uint8_t IirZpkToSOS(const iir_zpk_t * zpk, float * sos){
+    iir_pair_t poles[MAX_ROOTS / 2];
+    iir_pair_t zeros[MAX_ROOTS / 2];
+    uint8_t n_sos = IirPairs(zpk->p, zpk->n_p, poles);
+    if((n_sos * 2 != zpk->n_p) || (IirPairs(zpk->z, zpk->n_z, zeros) != n_sos)){
+        return 0;
+    }
+    for(int s = n_sos - 1; s >= 0; s--){
+        /* Remaining poles nearest to the unit circle */
+        int best_p = -1;
+        for(uint8_t i = 0; i < n_sos; i++){
+            if(!poles[i].used && ((best_p < 0) || (IirPairRadius(&poles[i]) < IirPairRadius(&poles[best_p])))){
+                best_p = i;
+            }
+        }
+        int best_z = -1;
+        for(uint8_t i = 0; i < n_sos; i++){
+            if(!zeros[i].used && ((best_z < 0) ||
+               (IirPairDistance(&poles[best_p], &zeros[i]) < IirPairDistance(&poles[best_p], &zeros[best_z])))){
+                best_z = i;
+            }
+        }
+        poles[best_p].used = true;
+        zeros[best_z].used = true;
+        float * c = &sos[s * IIR_SOS_COEFF];
+        c[0] = 1;
+        c[1] = -creal(zeros[best_z].r1 + zeros[best_z].r2);
+        c[2] = creal(zeros[best_z].r1 * zeros[best_z].r2);
+        c[3] = -creal(poles[best_p].r1 + poles[best_p].r2);
+        c[4] = creal(poles[best_p].r1 * poles[best_p].r2);
+    }
+    /* Gain in the first section */
+    for(uint8_t i = 0; i < 3; i++){
+        sos[i] *= zpk->k;
+    }
+    return n_sos;
+}
+
+/*==================[external functions definition]==========================*/
+uint8_t IirDesignSOS(const iir_design_t * design, float * sos){
+    iir_zpk_t zpk;
+    bool band = (design->type == BAND_PASS) || (design->type == BAND_STOP);
+    float nyquist = design->sample_frec / 2;
+    if((design->order == 0) || (design->order % 2) || (design->order > IIR_MAX_ORDER)){
+        return 0;
+    }
+    if((design->cut_frec <= 0) || (design->cut_frec >= nyquist)){
+        return 0;
+    }
+    if(band && ((design->cut_frec_high <= design->cut_frec) || (design->cut_frec_high >= nyquist))){
+        return 0;
+    }
+    uint8_t n = band ? design->order / 2 : design->order;
+    switch(design->prototype){
+        case BUTTERWORTH:
+            IirButterworth(&zpk, n);
+        break;
+        case CHEBYSHEV_1:
+        case CHEBYSHEV_2:
+            if(design->ripple <= 0){
+                return 0;
+            }
+            if(design->prototype == CHEBYSHEV_1){
+                IirChebyshev1(&zpk, n, design->ripple);
+            } else {
+                IirChebyshev2(&zpk, n, design->ripple);
+            }
+        break;
+        case BESSEL:
+            IirBessel(&zpk, n);
+        break;
+        default:
+            return 0;
+    }
+    /* Pre-warping: the analog frequencies that the bilinear transform maps
+     * to the requested digital ones */
+    double w1 = tan(M_PI * design->cut_frec / design->sample_frec);
+    double w2 = band ? tan(M_PI * design->cut_frec_high / design->sample_frec) : 0;
+    switch(design->type){
+        case LOW_PASS:
+            IirLowPassToLowPass(&zpk, w1);
+        break;
+        case HIGH_PASS:
+            IirLowPassToHighPass(&zpk, w1);
+        break;
+        case BAND_PASS:
+        case BAND_STOP:
+            IirLowPassToBand(&zpk, sqrt(w1 * w2), w2 - w1, design->type == BAND_STOP);
+        break;
+        default:
+            return 0;
+    }
+    IirBilinear(&zpk);
+    return IirZpkToSOS(&zpk, sos);
+}
+
+/*==================[end of file]============================================*/
@@ -10,147 +10,286 @@
  */
 
 /*==================[inclusions]=============================================*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
 #include "iir_filter.h"
 #include "esp_dsp.h"
+#include "esp_log.h"
 /*==================[macros and definitions]=================================*/
-#define N_SOS       5
+#define TAG "IirFilter"
+#define N_SOS       IIR_SOS_COEFF
 #define N_DELAY     2
-// 2nd order Butterworth 
-#define ORDER2_Q    (1 / 1.414)
-// 4th order Butterworth 
-#define ORDER4_Q1   (1 / 0.765)
-#define ORDER4_Q2   (1 / 1.848)
-// 6th order Butterworth 
-#define ORDER6_Q1   (1 / 0.518)
-#define ORDER6_Q2   (1 / 1.414)
-#define ORDER6_Q3   (1 / 1.932)
-// 8th order Butterworth 
-#define ORDER8_Q1   (1 / 0.390)
-#define ORDER8_Q2   (1 / 1.111)
-#define ORDER8_Q3   (1 / 1.663)
-#define ORDER8_Q4   (1 / 1.962)
+#define MAX_SOS     IIR_MAX_SOS
+#define N_SOS_Q15   6           /*!< b0, b1, b2, a1, a2 and shift (dsps_biquad_sos_quant_s16) */
+#define N_DELAY_Q15 5           /*!< x1, x2, y1, y2 and error (dsps_biquad_sos_s16) */
+#define SCALE_POINTS 256        /*!< Frequencies evaluated to find the peak gain of each section */
 /*==================[internal data declaration]==============================*/
-static uint8_t lp_order, hp_order;
-float hp2_delay[N_DELAY] = {0, 0};  // delay
-float hp4_delay[N_DELAY] = {0, 0};  // delay
-float hp6_delay[N_DELAY] = {0, 0};  // delay
-float hp8_delay[N_DELAY] = {0, 0};  // delay
-float lp2_delay[N_DELAY] = {0, 0};  // delay
-float lp4_delay[N_DELAY] = {0, 0};  // delay
-float lp6_delay[N_DELAY] = {0, 0};  // delay
-float lp8_delay[N_DELAY] = {0, 0};  // delay
-float lp2_sos_coeff[N_SOS]; 
-float lp4_sos_coeff[N_SOS]; 
-float lp6_sos_coeff[N_SOS]; 
-float lp8_sos_coeff[N_SOS]; 
-float hp2_sos_coeff[N_SOS]; 
-float hp4_sos_coeff[N_SOS]; 
-float hp6_sos_coeff[N_SOS]; 
-float hp8_sos_coeff[N_SOS]; 
+struct iir_filter_s {
+    uint8_t n_sos;                      /*!< Number of second order sections (order / 2) */
+    uint8_t n_channels;                 /*!< Number of interleaved channels */
+    float sos_coeff[MAX_SOS][N_SOS];    /*!< b0, b1, b2, a1, a2 of each section */
+    float *delay;                       /*!< Delay lines: [channel][MAX_SOS][N_DELAY] */
+    int16_t sos_q15[MAX_SOS][N_SOS_Q15];/*!< Fixed point coefficients (IirCreateQ15) */
+    int32_t *delay_q15;                 /*!< Fixed point delay lines: [channel][MAX_SOS][N_DELAY_Q15], NULL if not used */
+};
 /*==================[internal functions declaration]=========================*/
 
 /*==================[internal data definition]===============================*/
-
+/* Default instances used by LowPassInit/HiPassInit */
+static float lp_delay[MAX_SOS * N_DELAY];
+static float hp_delay[MAX_SOS * N_DELAY];
+static iir_filter_t lp_filter = {.n_sos = 0, .n_channels = 1, .delay = lp_delay};
+static iir_filter_t hp_filter = {.n_sos = 0, .n_channels = 1, .delay = hp_delay};
 /*==================[external data definition]===============================*/
 
 /*==================[internal functions definition]==========================*/
+static bool IirDesign(iir_filter_t * filter, const iir_design_t * design){
+    uint8_t n_sos = IirDesignSOS(design, filter->sos_coeff[0]);
+    if(n_sos == 0){
+        return false;
+    }
+    filter->n_sos = n_sos;
+    IirReset(filter);
+    return true;
+}
 
-/*==================[external functions definition]==========================*/
-
-void LowPassInit(float sample_frec, float cut_frec, filter_order_t order){
-    float f = cut_frec / sample_frec;
-    lp_order = order;
-    switch(lp_order){
+static bool IirDesignButterworth(iir_filter_t * filter, filter_type_t type, float sample_frec, float cut_frec, filter_order_t order){
+    iir_design_t design = {
+        .type = type,
+        .prototype = BUTTERWORTH,
+        .order = order,
+        .sample_frec = sample_frec,
+        .cut_frec = cut_frec,
+    };
+    switch(order){
         case ORDER_2:
-            dsps_biquad_gen_lpf_f32(lp2_sos_coeff, f, ORDER2_Q);
-        break;
         case ORDER_4:
-            dsps_biquad_gen_lpf_f32(lp2_sos_coeff, f, ORDER4_Q1);
-            dsps_biquad_gen_lpf_f32(lp4_sos_coeff, f, ORDER4_Q2);
-        break;
         case ORDER_6:
-            dsps_biquad_gen_lpf_f32(lp2_sos_coeff, f, ORDER6_Q1);
-            dsps_biquad_gen_lpf_f32(lp4_sos_coeff, f, ORDER6_Q2);
-            dsps_biquad_gen_lpf_f32(lp6_sos_coeff, f, ORDER6_Q3);
-        break;
         case ORDER_8:
-            dsps_biquad_gen_lpf_f32(lp2_sos_coeff, f, ORDER8_Q1);
-            dsps_biquad_gen_lpf_f32(lp4_sos_coeff, f, ORDER8_Q2);
-            dsps_biquad_gen_lpf_f32(lp6_sos_coeff, f, ORDER8_Q3);
-            dsps_biquad_gen_lpf_f32(lp8_sos_coeff, f, ORDER8_Q4);
         break;
+        default:
+            return false;
     }
+    return IirDesign(filter, &design);
 }
 
-void HiPassInit(float sample_frec, float cut_frec, filter_order_t order){
-    float f = cut_frec / sample_frec;
-    hp_order = order;
-    switch(hp_order){
-        case ORDER_2:
-            dsps_biquad_gen_hpf_f32(hp2_sos_coeff, f, ORDER2_Q);
-        break;
-        case ORDER_4:
-            dsps_biquad_gen_hpf_f32(hp2_sos_coeff, f, ORDER4_Q1);
-            dsps_biquad_gen_hpf_f32(hp4_sos_coeff, f, ORDER4_Q2);
-        break;
-        case ORDER_6:
-            dsps_biquad_gen_hpf_f32(hp2_sos_coeff, f, ORDER6_Q1);
-            dsps_biquad_gen_hpf_f32(hp4_sos_coeff, f, ORDER6_Q2);
-            dsps_biquad_gen_hpf_f32(hp6_sos_coeff, f, ORDER6_Q3);
-        break;
-        case ORDER_8:
-            dsps_biquad_gen_hpf_f32(hp2_sos_coeff, f, ORDER8_Q1);
-            dsps_biquad_gen_hpf_f32(hp4_sos_coeff, f, ORDER8_Q2);
-            dsps_biquad_gen_hpf_f32(hp6_sos_coeff, f, ORDER8_Q3);
-            dsps_biquad_gen_hpf_f32(hp8_sos_coeff, f, ORDER8_Q4);
-        break;
+/* Delay lines of every section in steady state for a constant input x */
+static void IirSteadyState(const iir_filter_t * filter, float x, float * delay){
+    for(uint8_t s = 0; s < filter->n_sos; s++){
+        const float * c = filter->sos_coeff[s];
+        float d = x / (1 + c[3] + c[4]);
+        delay[s * N_DELAY] = d;
+        delay[s * N_DELAY + 1] = d;
+        x = (c[0] + c[1] + c[2]) * d;
     }
 }
 
-void LowPassFilter(float * input_signal, float * output_signal, int16_t signal_lenght){
-    switch(lp_order){
-        case ORDER_2:
-            dsps_biquad_f32(input_signal, output_signal, signal_lenght, lp2_sos_coeff, lp2_delay);
-        break;
-        case ORDER_4:
-            dsps_biquad_f32(input_signal, output_signal, signal_lenght, lp2_sos_coeff, lp2_delay);
-            dsps_biquad_f32(output_signal, output_signal, signal_lenght, lp4_sos_coeff, lp4_delay);
-        break;
-        case ORDER_6:
-            dsps_biquad_f32(input_signal, output_signal, signal_lenght, lp2_sos_coeff, lp2_delay);
-            dsps_biquad_f32(output_signal, output_signal, signal_lenght, lp4_sos_coeff, lp4_delay);
-            dsps_biquad_f32(output_signal, output_signal, signal_lenght, lp6_sos_coeff, lp6_delay);
-        break;
-        case ORDER_8:
-            dsps_biquad_f32(input_signal, output_signal, signal_lenght, lp2_sos_coeff, lp2_delay);
-            dsps_biquad_f32(output_signal, output_signal, signal_lenght, lp4_sos_coeff, lp4_delay);
-            dsps_biquad_f32(output_signal, output_signal, signal_lenght, lp6_sos_coeff, lp6_delay);
-            dsps_biquad_f32(output_signal, output_signal, signal_lenght, lp8_sos_coeff, lp8_delay);
-        break;
+/* Peak gain of each section scaled to 1, so no section saturates before the 
+ * output does. The gain left is applied by the last section */
+static void IirScaleQ15(const iir_filter_t * filter, float sos[MAX_SOS][N_SOS]){
+    float residual = 1;
+    memcpy(sos[0], filter->sos_coeff[0], filter->n_sos * N_SOS * sizeof(float));
+    for(uint8_t s = 0; s < filter->n_sos; s++){
+        float * c = sos[s];
+        float peak = 0;
+        for(uint16_t i = 0; i <= SCALE_POINTS; i++){
+            float w = M_PI * i / SCALE_POINTS;
+            float num_re = c[0] + c[1] * cosf(w) + c[2] * cosf(2 * w);
+            float num_im = c[1] * sinf(w) + c[2] * sinf(2 * w);
+            float den_re = 1 + c[3] * cosf(w) + c[4] * cosf(2 * w);
+            float den_im = c[3] * sinf(w) + c[4] * sinf(2 * w);
+            float gain = sqrtf((num_re * num_re + num_im * num_im) / (den_re * den_re + den_im * den_im));
+            if(gain > peak){
+                peak = gain;
+            }
+        }
+        for(uint8_t i = 0; i < 3; i++){
+            c[i] /= peak;
+        }
+        residual *= peak;
+    }
+    for(uint8_t i = 0; i < 3; i++){
+        sos[filter->n_sos - 1][i] *= residual;
     }
 }
 
-void HiPassFilter(float * input_signal, float * output_signal, int16_t signal_lenght){
-    switch(hp_order){
-        case ORDER_2:
-            dsps_biquad_f32(input_signal, output_signal, signal_lenght, hp2_sos_coeff, hp2_delay);
-        break;
-        case ORDER_4:
-            dsps_biquad_f32(input_signal, output_signal, signal_lenght, hp2_sos_coeff, hp2_delay);
-            dsps_biquad_f32(output_signal, output_signal, signal_lenght, hp4_sos_coeff, hp4_delay);
-        break;
-        case ORDER_6:
-            dsps_biquad_f32(input_signal, output_signal, signal_lenght, hp2_sos_coeff, hp2_delay);
-            dsps_biquad_f32(output_signal, output_signal, signal_lenght, hp4_sos_coeff, hp4_delay);
-            dsps_biquad_f32(output_signal, output_signal, signal_lenght, hp6_sos_coeff, hp6_delay);
-        break;
-        case ORDER_8:
-            dsps_biquad_f32(input_signal, output_signal, signal_lenght, hp2_sos_coeff, hp2_delay);
-            dsps_biquad_f32(output_signal, output_signal, signal_lenght, hp4_sos_coeff, hp4_delay);
-            dsps_biquad_f32(output_signal, output_signal, signal_lenght, hp6_sos_coeff, hp6_delay);
-            dsps_biquad_f32(output_signal, output_signal, signal_lenght, hp8_sos_coeff, hp8_delay);
-        break;
+static void IirReverse(float * signal, int32_t signal_lenght){
+    for(int32_t i = 0, j = signal_lenght - 1; i < j; i++, j--){
+        float aux = signal[i];
+        signal[i] = signal[j];
+        signal[j] = aux;
+    }
+}
+
+static iir_filter_t * IirAlloc(uint8_t n_channels){
+    if(n_channels == 0){
+        return NULL;
     }
+    iir_filter_t * filter = malloc(sizeof(iir_filter_t));
+    if(filter == NULL){
+        return NULL;
+    }
+    filter->n_channels = n_channels;
+    filter->delay_q15 = NULL;
+    filter->delay = malloc(MAX_SOS * n_channels * N_DELAY * sizeof(float));
+    if(filter->delay == NULL){
+        free(filter);
+        return NULL;
+    }
+    return filter;
+}
+
+/*==================[external functions definition]==========================*/
+iir_filter_t * IirCreate(filter_type_t type, float sample_frec, float cut_frec, filter_order_t order, uint8_t n_channels){
+    iir_filter_t * filter = IirAlloc(n_channels);
+    if((filter != NULL) && !IirDesignButterworth(filter, type, sample_frec, cut_frec, order)){
+        IirDelete(filter);
+        return NULL;
+    }
+    return filter;
+}
+
+iir_filter_t * IirCreateDesign(const iir_design_t * design, uint8_t n_channels){
+    iir_filter_t * filter = IirAlloc(n_channels);
+    if((filter != NULL) && !IirDesign(filter, design)){
+        IirDelete(filter);
+        return NULL;
+    }
+    return filter;
+}
+
+iir_filter_t * IirCreateQ15(const iir_design_t * design, uint8_t n_channels){
+    float sos[MAX_SOS][N_SOS];
+    iir_filter_t * filter = IirCreateDesign(design, n_channels);
+    if(filter == NULL){
+        return NULL;
+    }
+    filter->delay_q15 = malloc(MAX_SOS * n_channels * N_DELAY_Q15 * sizeof(int32_t));
+    IirScaleQ15(filter, sos);
+    if((filter->delay_q15 == NULL) || (dsps_biquad_sos_quant_s16(sos[0], filter->sos_q15[0], filter->n_sos) != ESP_OK)){
+        IirDelete(filter);
+        return NULL;
+    }
+    IirReset(filter);
+    return filter;
+}
+
+void IirDelete(iir_filter_t * filter){
+    if(filter == NULL){
+        return;
+    }
+    free(filter->delay_q15);
+    free(filter->delay);
+    free(filter);
+}
+
+void IirReset(iir_filter_t * filter){
+    memset(filter->delay, 0, MAX_SOS * filter->n_channels * N_DELAY * sizeof(float));
+    if(filter->delay_q15 != NULL){
+        memset(filter->delay_q15, 0, MAX_SOS * filter->n_channels * N_DELAY_Q15 * sizeof(int32_t));
+    }
+}
+
+void IirFilter(iir_filter_t * filter, const float * input_signal, float * output_signal, int16_t signal_lenght){
+    const uint8_t n_ch = filter->n_channels;
+    for(uint8_t c = 0; c < n_ch; c++){
+        /* All sections in a single pass over each channel */
+        dsps_biquad_sos_f32(&input_signal[c], &output_signal[c], signal_lenght, filter->sos_coeff[0], 
+                            &filter->delay[c * MAX_SOS * N_DELAY], filter->n_sos, n_ch);
+    }
+}
+
+void IirFilterQ15(iir_filter_t * filter, const int16_t * input_signal, int16_t * output_signal, int16_t signal_lenght){
+    const uint8_t n_ch = filter->n_channels;
+    if(filter->delay_q15 == NULL){
+        return;
+    }
+    for(uint8_t c = 0; c < n_ch; c++){
+        dsps_biquad_sos_s16(&input_signal[c], &output_signal[c], signal_lenght, filter->sos_q15[0], 
+                            &filter->delay_q15[c * MAX_SOS * N_DELAY_Q15], filter->n_sos, n_ch);
+    }
+}
+
+void IirFiltFilt(const iir_filter_t * filter, const float * input_signal, float * output_signal, int16_t signal_lenght, float * workspace){
+    const uint8_t n_ch = filter->n_channels;
+    float delay[MAX_SOS * N_DELAY];
+    if(signal_lenght <= 0){
+        return;
+    }
+    int16_t pad = 3 * (2 * filter->n_sos + 1);
+    if(pad > signal_lenght - 1){
+        pad = signal_lenght - 1;
+    }
+    /* Up to INT16_MAX + 2 * IIR_FILTFILT_PAD samples */
+    const int32_t lenght = signal_lenght + 2 * pad;
+    float * x = &workspace[pad];
+    for(uint8_t c = 0; c < n_ch; c++){
+        for(int16_t i = 0; i < signal_lenght; i++){
+            x[i] = input_signal[i * n_ch + c];
+        }
+        /* Odd reflection around the first and the last sample */
+        for(int16_t i = 1; i <= pad; i++){
+            x[-i] = 2 * x[0] - x[i];
+            x[signal_lenght - 1 + i] = 2 * x[signal_lenght - 1] - x[signal_lenght - 1 - i];
+        }
+        IirSteadyState(filter, workspace[0], delay);
+        dsps_biquad_sos_f32(workspace, workspace, lenght, (float *)filter->sos_coeff[0], delay, filter->n_sos, 1);
+        IirReverse(workspace, lenght);
+        IirSteadyState(filter, workspace[0], delay);
+        dsps_biquad_sos_f32(workspace, workspace, lenght, (float *)filter->sos_coeff[0], delay, filter->n_sos, 1);
+        IirReverse(workspace, lenght);
+        for(int16_t i = 0; i < signal_lenght; i++){
+            output_signal[i * n_ch + c] = x[i];
+        }
+    }
+}
+
+bool IirBandPassFilter(iir_filter_t * hp_filter, iir_filter_t * lp_filter, const float * input_signal, float * output_signal, int16_t signal_lenght){
+    const uint8_t n_ch = hp_filter->n_channels;
+    const uint8_t n_hp = hp_filter->n_sos;
+    const uint8_t n_lp = lp_filter->n_sos;
+    float sos_coeff[2 * MAX_SOS][N_SOS];
+    float delay[2 * MAX_SOS * N_DELAY];
+    if(lp_filter->n_channels != n_ch){
+        ESP_LOGE(TAG, "Band pass with %d and %d channels", n_ch, lp_filter->n_channels);
+        return false;
+    }
+    /* Join both cascades so the signal is streamed only once */
+    memcpy(sos_coeff[0], hp_filter->sos_coeff[0], n_hp * N_SOS * sizeof(float));
+    memcpy(sos_coeff[n_hp], lp_filter->sos_coeff[0], n_lp * N_SOS * sizeof(float));
+    for(uint8_t c = 0; c < n_ch; c++){
+        float * hp_delay = &hp_filter->delay[c * MAX_SOS * N_DELAY];
+        float * lp_delay = &lp_filter->delay[c * MAX_SOS * N_DELAY];
+        memcpy(delay, hp_delay, n_hp * N_DELAY * sizeof(float));
+        memcpy(&delay[n_hp * N_DELAY], lp_delay, n_lp * N_DELAY * sizeof(float));
+        dsps_biquad_sos_f32(&input_signal[c], &output_signal[c], signal_lenght, sos_coeff[0], 
+                            delay, n_hp + n_lp, n_ch);
+        memcpy(hp_delay, delay, n_hp * N_DELAY * sizeof(float));
+        memcpy(lp_delay, &delay[n_hp * N_DELAY], n_lp * N_DELAY * sizeof(float));
+    }
+    return true;
+}
+
+void LowPassInit(float sample_frec, float cut_frec, filter_order_t order){
+    IirDesignButterworth(&lp_filter, LOW_PASS, sample_frec, cut_frec, order);
+}
+
+void HiPassInit(float sample_frec, float cut_frec, filter_order_t order){
+    IirDesignButterworth(&hp_filter, HIGH_PASS, sample_frec, cut_frec, order);
+}
+
+void LowPassFilter(float * input_signal, float * output_signal, int16_t signal_lenght){
+    IirFilter(&lp_filter, input_signal, output_signal, signal_lenght);
+}
+
+void HiPassFilter(float * input_signal, float * output_signal, int16_t signal_lenght){
+    IirFilter(&hp_filter, input_signal, output_signal, signal_lenght);
+}
+
+void BandPassFilter(float * input_signal, float * output_signal, int16_t signal_lenght){
+    IirBandPassFilter(&hp_filter, &lp_filter, input_signal, output_signal, signal_lenght);
 }
 
 /*==================[end of file]============================================*/
\ No newline at end of file
@@ -0,0 +1,398 @@
+/**
+ * @file qrs_detector.c
+ * @author Albano Peñalva (albano.penalva@uner.edu.ar)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <math.h>
+#include "qrs_detector.h"
+#include "iir_filter.h"
+/*==================[macros and definitions]=================================*/
+#define BAND_PASS_LOW       5.0f    /*!< Band pass filter cut-off frequencies (Hz) */
+#define BAND_PASS_HIGH      15.0f
+#define BAND_PASS_ORDER     4
+#define MWI_S               0.150f  /*!< Moving window integration lenght (s) */
+#define REFRACTORY_S        0.200f  /*!< Minimun time between QRS (s) */
+#define T_WAVE_S            0.360f  /*!< Peaks closer to the previous QRS are checked to be T waves (s) */
+#define PEAK_WAIT_S         0.200f  /*!< Maximun wait for the fall of a MWI peak (s) */
+#define RR_BEATS            8       /*!< RR intervals averaged */
+#define LEARNING_PEAKS      16      /*!< MWI peaks kept during the learning period */
+#define BLOCK_LENGHT        32      /*!< Samples band pass filtered at once */
+/*==================[internal data declaration]==============================*/
+/* Peak of the MWI */
+typedef struct {
+    float value;                /*!< MWI value */
+    uint32_t sample;            /*!< Position of the MWI peak */
+    uint32_t r_sample;          /*!< Position of the R wave */
+    float slope;                /*!< Maximun slope of the QRS */
+} qrs_peak_t;
+
+/* Last RR_BEATS intervals (samples) and their sum */
+typedef struct {
+    uint32_t rr[RR_BEATS];
+    uint32_t sum;
+    uint8_t n;
+    uint8_t pos;
+} qrs_rr_t;
+
+/* Beats returned by QrsDetect */
+typedef struct {
+    qrs_beat_t * beats;
+    uint8_t n;
+    uint8_t max;
+} qrs_output_t;
+
+struct qrs_detector_s {
+    iir_filter_t * band_pass;   /*!< 5 - 15 Hz band pass filter */
+    float sample_frec;          /*!< Sample frequency */
+    uint16_t delay;             /*!< Group delay of the band pass filter (samples) */
+    uint16_t mwi_lenght;        /*!< Lenghts in samples */
+    uint16_t refractory;
+    uint16_t t_wave;
+    uint16_t peak_wait;
+    uint32_t learning;
+    uint16_t ring_lenght;       /*!< Band pass and slope rings: mwi_lenght + peak_wait + 1 */
+    float * band;               /*!< Band pass filtered signal (circular buffer): ring_lenght */
+    float * slope;              /*!< Absolute value of the derivative (circular buffer): ring_lenght */
+    float * square;             /*!< Squared derivative (circular buffer): mwi_lenght */
+    uint16_t pos;               /*!< Position of the newest sample in band and slope */
+    uint16_t mwi_pos;           /*!< Oldest sample in square */
+    float x[4];                 /*!< Last band pass filtered samples, for the derivative */
+    float mwi_sum;              /*!< Sum of square */
+    float mwi_prev;             /*!< Previous MWI value */
+    uint32_t n;                 /*!< Samples since the creation or reset */
+    bool tracking;              /*!< A MWI peak is rising */
+    qrs_peak_t peak;            /*!< Current MWI peak */
+    float learn_max, learn_sum; /*!< Maximun and sum of the MWI during the learning period */
+    qrs_peak_t learn_peaks[LEARNING_PEAKS];
+    uint8_t n_learn;
+    float spki, npki;           /*!< Signal and noise peak levels */
+    float thr1, thr2;           /*!< Thresholds: QRS and search back */
+    qrs_peak_t back;            /*!< Biggest noise peak above thr2 since the last QRS (value 0: none) */
+    bool beat_found;            /*!< At least one QRS found */
+    qrs_peak_t last;            /*!< Last QRS */
+    qrs_rr_t rr_all;            /*!< Last RR intervals */
+    qrs_rr_t rr_regular;        /*!< Last RR intervals within 92 % and 116 % of their mean */
+    uint8_t n_irregular;        /*!< Consecutive RR intervals out of that range */
+};
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/* Group delay (samples) of a cascade of sections at w (rad/sample) */
+static float QrsGroupDelay(const float * sos, uint8_t n_sos, float w){
+    const float dw = 0.01f;
+    float delay = 0;
+    for(uint8_t s = 0; s < n_sos; s++){
+        const float * c = &sos[s * IIR_SOS_COEFF];
+        float phase[2];
+        for(int k = 0; k < 2; k++){
+            /* b0 + b1 z^-1 + b2 z^-2 over 1 + a1 z^-1 + a2 z^-2, at z = e^(jw) */
+            float wk = w + (k ? dw : -dw);
+            float c1 = cosf(wk), s1 = sinf(wk), c2 = cosf(2 * wk), s2 = sinf(2 * wk);
+            phase[k] = atan2f(-c[1] * s1 - c[2] * s2, c[0] + c[1] * c1 + c[2] * c2) -
+                       atan2f(-c[3] * s1 - c[4] * s2, 1 + c[3] * c1 + c[4] * c2);
+        }
+        float diff = phase[1] - phase[0];
+        while(diff > M_PI){
+            diff -= 2 * M_PI;
+        }
+        while(diff < -M_PI){
+            diff += 2 * M_PI;
+        }
+        delay -= diff / (2 * dw);
+    }
+    return delay;
+}
+
+static uint32_t QrsRRMean(const qrs_rr_t * rr){
+    return rr->sum / rr->n;
+}
+
+static void QrsRRAdd(qrs_rr_t * rr, uint32_t interval){
+    if(rr->n == RR_BEATS){
+        rr->sum -= rr->rr[rr->pos];
+    }else{
+        rr->n++;
+    }
+    rr->rr[rr->pos] = interval;
+    rr->sum += interval;
+    rr->pos = (rr->pos + 1) % RR_BEATS;
+}
+
+static void QrsThresholds(qrs_detector_t * det){
+    det->thr1 = det->npki + 0.25f * (det->spki - det->npki);
+    if(det->n_irregular > 0){
+        det->thr1 *= 0.5f;
+    }
+    det->thr2 = 0.5f * det->thr1;
+}
+
+/* QRS found: updates RR intervals and reports the beat */
+static void QrsBeat(qrs_detector_t * det, const qrs_peak_t * peak, qrs_output_t * out){
+    qrs_beat_t beat = {.sample = peak->r_sample};
+    if(det->beat_found){
+        uint32_t rr = peak->r_sample - det->last.r_sample;
+        beat.rr = rr / det->sample_frec;
+        beat.heart_rate = 60.0f / beat.rr;
+        QrsRRAdd(&det->rr_all, rr);
+        if(det->rr_regular.n == 0){
+            QrsRRAdd(&det->rr_regular, rr);
+        }else{
+            uint32_t mean = QrsRRMean(&det->rr_regular);
+            if((rr * 100 >= mean * 92) && (rr * 100 <= mean * 116)){
+                QrsRRAdd(&det->rr_regular, rr);
+                det->n_irregular = 0;
+            }else if(++det->n_irregular == RR_BEATS){
+                /* The heart rate has changed: start again from the last intervals */
+                det->rr_regular = det->rr_all;
+                det->n_irregular = 0;
+            }
+        }
+    }
+    det->beat_found = true;
+    det->last = *peak;
+    det->back.value = 0;
+    QrsThresholds(det);
+    if(out->n < out->max){
+        out->beats[out->n++] = beat;
+    }
+}
+
+/* Classifies a peak of the MWI as QRS or noise */
+static void QrsPeak(qrs_detector_t * det, const qrs_peak_t * peak, qrs_output_t * out){
+    uint32_t distance = peak->sample - det->last.sample;
+    if(det->beat_found && (distance < det->refractory)){
+        return;
+    }
+    bool qrs = peak->value > det->thr1;
+    if(qrs && det->beat_found && (distance < det->t_wave) && (peak->slope < 0.5f * det->last.slope)){
+        /* T wave */
+        qrs = false;
+    }
+    if(qrs){
+        det->spki = 0.125f * peak->value + 0.875f * det->spki;
+        QrsBeat(det, peak, out);
+    }else{
+        det->npki = 0.125f * peak->value + 0.875f * det->npki;
+        QrsThresholds(det);
+        if((peak->value > det->thr2) && (peak->value > det->back.value)){
+            det->back = *peak;
+        }
+    }
+}
+
+/* End of the learning period: initial levels, and classification of its peaks */
+static void QrsLearn(qrs_detector_t * det, qrs_output_t * out){
+    det->spki = det->learn_max / 3;
+    det->npki = 0.5f * det->learn_sum / det->learning;
+    QrsThresholds(det);
+    for(uint8_t i = 0; i < det->n_learn; i++){
+        QrsPeak(det, &det->learn_peaks[i], out);
+    }
+}
+
+/* The MWI peak has fallen: R wave and slope from the band pass filtered
+ * signal of the integration window */
+static void QrsPeakEnd(qrs_detector_t * det, qrs_output_t * out){
+    qrs_peak_t * peak = &det->peak;
+    uint16_t back = det->n - 1 - peak->sample;
+    int32_t i = (int32_t)det->pos - back - det->mwi_lenght;
+    if(i < 0){
+        i += det->ring_lenght;
+    }
+    float r_max = 0;
+    uint16_t r_pos = 0;
+    peak->slope = 0;
+    for(uint16_t k = 0; k <= det->mwi_lenght; k++){
+        float r = fabsf(det->band[i]);
+        if(r > r_max){
+            r_max = r;
+            r_pos = k;
+        }
+        if(det->slope[i] > peak->slope){
+            peak->slope = det->slope[i];
+        }
+        i = (i + 1 < det->ring_lenght) ? i + 1 : 0;
+    }
+    /* Minus the delay of the band pass filter */
+    int32_t r_sample = (int32_t)(peak->sample + r_pos) - det->mwi_lenght - det->delay;
+    peak->r_sample = (r_sample > 0) ? r_sample : 0;
+
+    /* Peaks of the learning period ending after it are classified as any other */
+    if(det->n <= det->learning){
+        if(det->n_learn < LEARNING_PEAKS){
+            det->learn_peaks[det->n_learn++] = *peak;
+        }
+    }else{
+        QrsPeak(det, peak, out);
+    }
+}
+
+static void QrsSample(qrs_detector_t * det, float x, qrs_output_t * out){
+    /* Derivative: (2 x[n] + x[n-1] - x[n-3] - 2 x[n-4]) / 8 */
+    float d = 0.125f * (2 * x + det->x[0] - det->x[2] - 2 * det->x[3]);
+    det->x[3] = det->x[2];
+    det->x[2] = det->x[1];
+    det->x[1] = det->x[0];
+    det->x[0] = x;
+    det->pos = (det->pos + 1 < det->ring_lenght) ? det->pos + 1 : 0;
+    det->band[det->pos] = x;
+    det->slope[det->pos] = fabsf(d);
+
+    /* Moving window integration, recalculated at every turn of the buffer
+     * to drop rounding errors */
+    float sq = d * d;
+    det->mwi_sum += sq - det->square[det->mwi_pos];
+    det->square[det->mwi_pos] = sq;
+    if(++det->mwi_pos == det->mwi_lenght){
+        det->mwi_pos = 0;
+        det->mwi_sum = 0;
+        for(uint16_t k = 0; k < det->mwi_lenght; k++){
+            det->mwi_sum += det->square[k];
+        }
+    }
+    float mwi = det->mwi_sum;
+    uint32_t n = det->n++;
+
+    if(n < det->learning){
+        det->learn_sum += mwi;
+        if(mwi > det->learn_max){
+            det->learn_max = mwi;
+        }
+    }else if(n == det->learning){
+        QrsLearn(det, out);
+    }else if((det->back.value > 0) && (det->rr_regular.n > 0) &&
+             ((n - det->last.sample) * 100 > QrsRRMean(&det->rr_regular) * 166)){
+        /* Search back: missed beat */
+        det->spki = 0.25f * det->back.value + 0.75f * det->spki;
+        qrs_peak_t back = det->back;
+        QrsBeat(det, &back, out);
+    }
+
+    /* Peaks: from a rise of the MWI until it falls to half or PEAK_WAIT_S */
+    if(!det->tracking){
+        if(mwi > det->mwi_prev){
+            det->tracking = true;
+            det->peak.value = mwi;
+            det->peak.sample = n;
+        }
+    }else if(mwi > det->peak.value){
+        det->peak.value = mwi;
+        det->peak.sample = n;
+    }else if((mwi < 0.5f * det->peak.value) || (n - det->peak.sample >= det->peak_wait)){
+        det->tracking = false;
+        QrsPeakEnd(det, out);
+    }
+    det->mwi_prev = mwi;
+}
+
+/*==================[external functions definition]==========================*/
+qrs_detector_t * QrsCreate(float sample_frec){
+    if(sample_frec < QRS_MIN_SAMPLE_FREC){
+        return NULL;
+    }
+    iir_design_t design = {
+        .type = BAND_PASS,
+        .prototype = BUTTERWORTH,
+        .order = BAND_PASS_ORDER,
+        .sample_frec = sample_frec,
+        .cut_frec = BAND_PASS_LOW,
+        .cut_frec_high = BAND_PASS_HIGH
+    };
+    float sos[IIR_MAX_SOS * IIR_SOS_COEFF];
+    uint8_t n_sos = IirDesignSOS(&design, sos);
+    uint16_t mwi_lenght = MWI_S * sample_frec + 0.5f;
+    uint16_t peak_wait = PEAK_WAIT_S * sample_frec + 0.5f;
+    uint16_t ring_lenght = mwi_lenght + peak_wait + 1;
+    qrs_detector_t * det = calloc(1, sizeof(qrs_detector_t) + (2 * ring_lenght + mwi_lenght) * sizeof(float));
+    if(det == NULL){
+        return NULL;
+    }
+    det->band_pass = IirCreateDesign(&design, 1);
+    if((n_sos == 0) || (det->band_pass == NULL)){
+        QrsDelete(det);
+        return NULL;
+    }
+    det->sample_frec = sample_frec;
+    det->delay = QrsGroupDelay(sos, n_sos, 2 * M_PI * sqrtf(BAND_PASS_LOW * BAND_PASS_HIGH) / sample_frec) + 0.5f;
+    det->mwi_lenght = mwi_lenght;
+    det->refractory = REFRACTORY_S * sample_frec + 0.5f;
+    det->t_wave = T_WAVE_S * sample_frec + 0.5f;
+    det->peak_wait = peak_wait;
+    det->learning = QRS_LEARNING_S * sample_frec + 0.5f;
+    det->ring_lenght = ring_lenght;
+    /* Rings follow the struct */
+    det->band = (float *)(det + 1);
+    det->slope = det->band + ring_lenght;
+    det->square = det->slope + ring_lenght;
+    QrsReset(det);
+    return det;
+}
+
+void QrsDelete(qrs_detector_t * detector){
+    if(detector == NULL){
+        return;
+    }
+    IirDelete(detector->band_pass);
+    free(detector);
+}
+
+void QrsReset(qrs_detector_t * detector){
+    IirReset(detector->band_pass);
+    memset(detector->band, 0, (2 * detector->ring_lenght + detector->mwi_lenght) * sizeof(float));
+    detector->pos = 0;
+    detector->mwi_pos = 0;
+    memset(detector->x, 0, sizeof(detector->x));
+    detector->mwi_sum = 0;
+    detector->mwi_prev = 0;
+    detector->n = 0;
+    detector->tracking = false;
+    detector->learn_max = 0;
+    detector->learn_sum = 0;
+    detector->n_learn = 0;
+    detector->spki = 0;
+    detector->npki = 0;
+    detector->thr1 = 0;
+    detector->thr2 = 0;
+    detector->back.value = 0;
+    detector->beat_found = false;
+    memset(&detector->last, 0, sizeof(qrs_peak_t));
+    memset(&detector->rr_all, 0, sizeof(qrs_rr_t));
+    memset(&detector->rr_regular, 0, sizeof(qrs_rr_t));
+    detector->n_irregular = 0;
+}
+
+uint8_t QrsDetect(qrs_detector_t * detector, const float * signal, uint16_t lenght, qrs_beat_t * beats, uint8_t max_beats){
+    qrs_output_t out = {.beats = beats, .n = 0, .max = max_beats};
+    float band[BLOCK_LENGHT];
+    for(uint16_t i = 0; i < lenght; i += BLOCK_LENGHT){
+        uint16_t n = (lenght - i < BLOCK_LENGHT) ? lenght - i : BLOCK_LENGHT;
+        IirFilter(detector->band_pass, &signal[i], band, n);
+        for(uint16_t k = 0; k < n; k++){
+            QrsSample(detector, band[k], &out);
+        }
+    }
+    return out.n;
+}
+
+float QrsHeartRate(const qrs_detector_t * detector){
+    if(detector->rr_all.n == 0){
+        return 0;
+    }
+    return 60.0f * detector->sample_frec * detector->rr_all.n / detector->rr_all.sum;
+}
+
+/*==================[end of file]============================================*/
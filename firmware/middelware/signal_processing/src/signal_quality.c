@@ -0,0 +1,139 @@
+/**
+ * @file signal_quality.c
+ * @author Albano Peñalva (albano.penalva@uner.edu.ar)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include <stdlib.h>
+#include <float.h>
+#include <math.h>
+#include "signal_quality.h"
+#include "esp_log.h"
+/*==================[macros and definitions]=================================*/
+#define TAG "SignalQuality"
+/*==================[internal data declaration]==============================*/
+struct signal_quality_s {
+    fft_plan_t * plan;          /*!< Plan of the window lenght */
+    float frec_step;            /*!< sample_frec / lenght */
+    uint16_t n_bins;            /*!< Power spectrum bins: lenght / 2 */
+    uint8_t n_harmonics;        /*!< Highest harmonic */
+    bool use_dc;                /*!< DC bins taken as noise */
+};
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/* Ratio in dB, finite even when some of the powers is zero */
+static float SignalQualityDb(float num, float den){
+    return 10 * log10f((num + FLT_MIN) / (den + FLT_MIN));
+}
+
+/* Metrics from the power spectrum of one channel */
+static void SignalQualitySpectrum(const signal_quality_meter_t * meter, const float * power, signal_quality_t * result){
+    int n_bins = meter->n_bins;
+    int first = meter->use_dc ? 0 : SIGNAL_QUALITY_LOBE_BINS;
+    /* Fundamental peak (never on DC bins) */
+    int peak = SIGNAL_QUALITY_LOBE_BINS;
+    for(int k = SIGNAL_QUALITY_LOBE_BINS; k < n_bins; k++){
+        if(power[k] > power[peak]){
+            peak = k;
+        }
+    }
+    /* Fundamental power and centroid */
+    int lo = (peak - SIGNAL_QUALITY_LOBE_BINS > first) ? peak - SIGNAL_QUALITY_LOBE_BINS : first;
+    int hi = (peak + SIGNAL_QUALITY_LOBE_BINS < n_bins - 1) ? peak + SIGNAL_QUALITY_LOBE_BINS : n_bins - 1;
+    float fund = 0, moment = 0;
+    for(int k = lo; k <= hi; k++){
+        fund += power[k];
+        moment += k * power[k];
+    }
+    float center = (fund > 0) ? moment / fund : peak;
+    /* Noise is added bin by bin between the tones (not as total - tones: 
+     * float cancellation would hide it with high SNR signals) */
+    float noise = 0, spur = 0;
+    for(int k = first; k < lo; k++){
+        noise += power[k];
+        spur = (power[k] > spur) ? power[k] : spur;
+    }
+    /* Harmonics, in ascending order: bins already taken by a lower one are 
+     * not counted twice */
+    float harm = 0;
+    int last = hi;
+    for(int h = 2; h <= meter->n_harmonics; h++){
+        int c = lrintf(h * center);
+        if(c + SIGNAL_QUALITY_LOBE_BINS >= n_bins){
+            break;
+        }
+        int h_lo = (c - SIGNAL_QUALITY_LOBE_BINS > last) ? c - SIGNAL_QUALITY_LOBE_BINS : last + 1;
+        int h_hi = c + SIGNAL_QUALITY_LOBE_BINS;
+        for(int k = last + 1; k < h_lo; k++){
+            noise += power[k];
+            spur = (power[k] > spur) ? power[k] : spur;
+        }
+        for(int k = h_lo; k <= h_hi; k++){
+            harm += power[k];
+            spur = (power[k] > spur) ? power[k] : spur;
+        }
+        last = h_hi;
+    }
+    for(int k = last + 1; k < n_bins; k++){
+        noise += power[k];
+        spur = (power[k] > spur) ? power[k] : spur;
+    }
+    result->frec = center * meter->frec_step;
+    result->snr = SignalQualityDb(fund, noise);
+    result->sinad = SignalQualityDb(fund, noise + harm);
+    result->thd = SignalQualityDb(harm, fund);
+    result->sfdr = SignalQualityDb(power[peak], spur);
+}
+
+/*==================[external functions definition]==========================*/
+signal_quality_meter_t * SignalQualityCreate(const signal_quality_config_t * config){
+    if((config->sample_frec <= 0) || (config->n_harmonics < 2) || (config->lenght < 4 * SIGNAL_QUALITY_LOBE_BINS)){
+        return NULL;
+    }
+    signal_quality_meter_t * meter = malloc(sizeof(signal_quality_meter_t));
+    if(meter == NULL){
+        return NULL;
+    }
+    meter->plan = FFTPlanCreate(config->lenght);
+    if(meter->plan == NULL){
+        ESP_LOGE(TAG, "Not possible to create a %d samples FFT", config->lenght);
+        free(meter);
+        return NULL;
+    }
+    meter->frec_step = config->sample_frec / config->lenght;
+    meter->n_bins = config->lenght / 2;
+    meter->n_harmonics = config->n_harmonics;
+    meter->use_dc = config->use_dc;
+    return meter;
+}
+
+void SignalQualityDelete(signal_quality_meter_t * meter){
+    if(meter == NULL){
+        return;
+    }
+    FFTPlanDelete(meter->plan);
+    free(meter);
+}
+
+void SignalQualityMeasure(const signal_quality_meter_t * meter, const float * const * signal, uint8_t n_channels,
+                          signal_quality_t * result, float * workspace){
+    /* The plan tables are shared by every channel, the power spectrum is
+     * left in the first half of the workspace */
+    for(uint8_t ch = 0; ch < n_channels; ch++){
+        FFTPlanPower(meter->plan, signal[ch], workspace, workspace);
+        SignalQualitySpectrum(meter, workspace, &result[ch]);
+    }
+}
+
+/*==================[end of file]============================================*/
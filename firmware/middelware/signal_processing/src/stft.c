@@ -0,0 +1,141 @@
+/**
+ * @file stft.c
+ * @author Albano Peñalva (albano.penalva@uner.edu.ar)
+ * @brief 
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2023
+ * 
+ */
+
+/*==================[inclusions]=============================================*/
+#include <stdlib.h>
+#include <string.h>
+#include "stft.h"
+#include "esp_dsp.h"
+/*==================[macros and definitions]=================================*/
+
+/*==================[internal data declaration]==============================*/
+struct stft_s {
+    uint16_t frame_lenght;      /*!< FFT lenght */
+    uint16_t hop_size;          /*!< Samples between frames */
+    uint16_t write_pos;         /*!< Position of the next sample (and of the oldest one) */
+    uint16_t to_next_frame;     /*!< Samples left to complete the next frame */
+    stft_frame_func func_p;     /*!< Frame callback */
+    void * param_p;             /*!< Frame callback parameter */
+    float * history;            /*!< Ring buffer, stored twice: 2 * frame_lenght */
+    float * window;             /*!< Window: frame_lenght */
+    float * magnitude;          /*!< Last frame: frame_lenght / 2 */
+    float * workspace;          /*!< FFT workspace: frame_lenght */
+    fft_plan_t * plan;          /*!< FFT plan */
+};
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+static void STFTGenWindow(float * window, uint16_t lenght, stft_window_t type){
+    switch(type){
+        case STFT_WINDOW_BLACKMAN:
+            dsps_wind_blackman_f32(window, lenght);
+        break;
+        case STFT_WINDOW_BLACKMAN_HARRIS:
+            dsps_wind_blackman_harris_f32(window, lenght);
+        break;
+        case STFT_WINDOW_BLACKMAN_NUTTALL:
+            dsps_wind_blackman_nuttall_f32(window, lenght);
+        break;
+        case STFT_WINDOW_NUTTALL:
+            dsps_wind_nuttall_f32(window, lenght);
+        break;
+        case STFT_WINDOW_FLAT_TOP:
+            dsps_wind_flat_top_f32(window, lenght);
+        break;
+        case STFT_WINDOW_HANN:
+        default:
+            dsps_wind_hann_f32(window, lenght);
+        break;
+    }
+}
+
+/*==================[external functions definition]==========================*/
+stft_t * STFTCreate(const stft_config_t * config){
+    uint16_t n = config->frame_lenght;
+    if(!dsp_is_power_of_two(n) || (n < 4) || (n > MAX_SIGNAL_LENGHT)){
+        return NULL;
+    }
+    if((config->hop_size == 0) || (config->hop_size > n) || (config->func_p == NULL)){
+        return NULL;
+    }
+    stft_t * stft = calloc(1, sizeof(stft_t));
+    if(stft == NULL){
+        return NULL;
+    }
+    stft->frame_lenght = n;
+    stft->hop_size = config->hop_size;
+    stft->func_p = config->func_p;
+    stft->param_p = config->param_p;
+    /* History, window, magnitude and FFT workspace share one allocation */
+    stft->history = malloc((2 * n + n + n / 2 + FFT_WORKSPACE_LENGHT(n)) * sizeof(float));
+    if(stft->history == NULL){
+        STFTDelete(stft);
+        return NULL;
+    }
+    /* The plan uses the STFT window, so it does not store a Hann window */
+    stft->window = &stft->history[2 * n];
+    stft->plan = FFTPlanCreateWindow(n, stft->window);
+    if(stft->plan == NULL){
+        STFTDelete(stft);
+        return NULL;
+    }
+    stft->magnitude = &stft->window[n];
+    stft->workspace = &stft->magnitude[n / 2];
+    STFTGenWindow(stft->window, n, config->window);
+    STFTReset(stft);
+    return stft;
+}
+
+void STFTDelete(stft_t * stft){
+    if(stft == NULL){
+        return;
+    }
+    FFTPlanDelete(stft->plan);
+    free(stft->history);
+    free(stft);
+}
+
+void STFTReset(stft_t * stft){
+    memset(stft->history, 0, 2 * stft->frame_lenght * sizeof(float));
+    stft->write_pos = 0;
+    /* First frame when the history is full */
+    stft->to_next_frame = stft->frame_lenght;
+}
+
+void STFTPush(stft_t * stft, const float * samples, uint16_t n_samples){
+    const uint16_t n = stft->frame_lenght;
+    float * history = stft->history;
+    while(n_samples > 0){
+        /* Copy up to the end of the current frame. Each sample is written at 
+         * pos and pos + n, so the last n samples are always contiguous at 
+         * &history[write_pos] and nothing is moved on each hop */
+        uint16_t chunk = (n_samples < stft->to_next_frame) ? n_samples : stft->to_next_frame;
+        for(uint16_t i = 0; i < chunk; i++){
+            history[stft->write_pos] = samples[i];
+            history[stft->write_pos + n] = samples[i];
+            stft->write_pos = (stft->write_pos + 1) & (n - 1);
+        }
+        samples += chunk;
+        n_samples -= chunk;
+        stft->to_next_frame -= chunk;
+        if(stft->to_next_frame == 0){
+            FFTPlanMagnitudeWindow(stft->plan, &history[stft->write_pos], stft->window, stft->magnitude, stft->workspace);
+            stft->func_p(stft->magnitude, n / 2, stft->param_p);
+            stft->to_next_frame = stft->hop_size;
+        }
+    }
+}
+
+/*==================[end of file]============================================*/
@@ -0,0 +1,219 @@
+/**
+ * @file tone_bank.c
+ * @author Albano Peñalva (albano.penalva@uner.edu.ar)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "tone_bank.h"
+#include "esp_dsp.h"
+#include "esp_log.h"
+/*==================[macros and definitions]=================================*/
+#define TAG "ToneBank"
+#define RESYNC_WINDOWS      4       /*!< Sliding DFT bins are recalculated every RESYNC_WINDOWS * lenght samples */
+/*==================[internal data declaration]==============================*/
+/* Sliding DFT of one frequency w over the last N samples, with the phase
+ * referred to the newest one: S[n] = e^(jw) * S[n-1] + x[n] - e^(jwN) * x[n-N] */
+typedef struct {
+    float cos_w, sin_w;         /*!< e^(jw): rotation of the bin on each sample */
+    float cos_wn, sin_wn;       /*!< e^(jwN): rotation of the sample leaving the window */
+    float re, im;               /*!< Bin value */
+} tone_resonator_t;
+
+typedef struct {
+    float cos_w, sin_w;         /*!< e^(jw) */
+    float cos_ref, sin_ref;     /*!< e^(-jw(N-1)): moves the phase reference to the oldest sample */
+    float scale;                /*!< |X| to magnitude */
+} tone_bin_t;
+
+struct tone_bank_s {
+    uint8_t n_bins;             /*!< Number of frequencies */
+    uint8_t n_res;              /*!< Resonators per frequency: 1 (rectangular) or 3 (Hann: w - d, w, w + d) */
+    uint16_t lenght;            /*!< Window lenght */
+    uint16_t pos;               /*!< Oldest sample in delay */
+    uint32_t resync;            /*!< Samples until the bins are recalculated */
+    tone_bin_t * bin;           /*!< Frequencies: n_bins */
+    tone_resonator_t * res;     /*!< Sliding DFT: n_bins * n_res */
+    float * window;             /*!< Hann window (NULL: rectangular): lenght */
+    float * delay;              /*!< Last samples (circular buffer): lenght */
+};
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/* Goertzel over x1 followed by x2: sliding DFT bin of w (2 * cos_w = coeff)
+ * over those samples, phase referred to the last one */
+static void ToneBankResonator(tone_resonator_t * res, const float * x1, uint16_t n1, const float * x2, uint16_t n2){
+    float coeff = 2 * res->cos_w;
+    float s1 = 0, s2 = 0;
+    for(int i = 0; i < n1; i++){
+        float s = x1[i] + coeff * s1 - s2;
+        s2 = s1;
+        s1 = s;
+    }
+    for(int i = 0; i < n2; i++){
+        float s = x2[i] + coeff * s1 - s2;
+        s2 = s1;
+        s1 = s;
+    }
+    res->re = s1 - res->cos_w * s2;
+    res->im = res->sin_w * s2;
+}
+
+/* Recalculates every resonator from the samples in delay (drops the rounding
+ * errors accumulated by the recursion) */
+static void ToneBankResync(tone_bank_t * bank){
+    uint16_t n = bank->lenght - bank->pos;
+    for(int r = 0; r < bank->n_bins * bank->n_res; r++){
+        ToneBankResonator(&bank->res[r], &bank->delay[bank->pos], n, bank->delay, bank->pos);
+    }
+    bank->resync = RESYNC_WINDOWS * bank->lenght;
+}
+
+/* Magnitude and phase of a bin (re + j im, phase referred to the newest sample) */
+static void ToneBankOutput(const tone_bin_t * bin, float re, float im, float * magnitude, float * phase){
+    float x_re = re * bin->cos_ref - im * bin->sin_ref;
+    float x_im = re * bin->sin_ref + im * bin->cos_ref;
+    *magnitude = bin->scale * sqrtf(x_re * x_re + x_im * x_im);
+    if(phase != NULL){
+        *phase = atan2f(x_im, x_re);
+    }
+}
+
+/*==================[external functions definition]==========================*/
+tone_bank_t * ToneBankCreate(const tone_bank_config_t * config){
+    if((config->sample_frec <= 0) || (config->n_bins == 0) || (config->n_bins > TONE_BANK_MAX_BINS) || (config->lenght < 2)){
+        return NULL;
+    }
+    for(uint8_t b = 0; b < config->n_bins; b++){
+        if((config->frec[b] < 0) || (config->frec[b] >= config->sample_frec / 2)){
+            ESP_LOGE(TAG, "Frequency %.1f Hz out of range", config->frec[b]);
+            return NULL;
+        }
+    }
+    uint8_t n_res = config->hann ? 3 : 1;
+    uint16_t n = config->lenght;
+    size_t mem_size = config->n_bins * (sizeof(tone_bin_t) + n_res * sizeof(tone_resonator_t)) +
+                      (config->hann ? 2 : 1) * n * sizeof(float);
+    tone_bank_t * bank = calloc(1, sizeof(tone_bank_t) + mem_size);
+    if(bank == NULL){
+        return NULL;
+    }
+    bank->n_bins = config->n_bins;
+    bank->n_res = n_res;
+    bank->lenght = n;
+    /* Bins, resonators, delay line and window follow the struct */
+    bank->bin = (tone_bin_t *)(bank + 1);
+    bank->res = (tone_resonator_t *)(bank->bin + config->n_bins);
+    bank->delay = (float *)(bank->res + config->n_bins * n_res);
+    if(config->hann){
+        bank->window = bank->delay + n;
+        dsps_wind_hann_f32(bank->window, n);
+    }
+    /* Hann window: 0.5 - 0.25 * (e^(jdm) + e^(-jdm)), with d = 2 pi / (N - 1),
+     * applied as a combination of the bins at w - d, w and w + d */
+    double d = 2 * M_PI / (n - 1);
+    for(uint8_t b = 0; b < config->n_bins; b++){
+        tone_bin_t * bin = &bank->bin[b];
+        /* Double precision: angles of whole windows are big */
+        double w = 2 * M_PI * config->frec[b] / config->sample_frec;
+        bin->cos_w = cos(w);
+        bin->sin_w = sin(w);
+        bin->cos_ref = cos(w * (n - 1));
+        bin->sin_ref = -sin(w * (n - 1));
+        /* Same scale than FFTMagnitude */
+        bin->scale = ((config->frec[b] == 0) ? 2.0f : 8.0f) / n;
+        for(uint8_t r = 0; r < n_res; r++){
+            tone_resonator_t * res = &bank->res[b * n_res + r];
+            double w_res = (n_res == 1) ? w : w + (r - 1) * d;
+            res->cos_w = cos(w_res);
+            res->sin_w = sin(w_res);
+            res->cos_wn = cos(w_res * n);
+            res->sin_wn = sin(w_res * n);
+        }
+    }
+    ToneBankReset(bank);
+    return bank;
+}
+
+void ToneBankDelete(tone_bank_t * bank){
+    free(bank);
+}
+
+void ToneBankGoertzel(const tone_bank_t * bank, const float * signal, float * magnitude, float * phase){
+    float s1[TONE_BANK_MAX_BINS] = {0};
+    float s2[TONE_BANK_MAX_BINS] = {0};
+    float coeff[TONE_BANK_MAX_BINS];
+    for(uint8_t b = 0; b < bank->n_bins; b++){
+        coeff[b] = 2 * bank->bin[b].cos_w;
+    }
+    /* Each windowed sample goes through every bin */
+    for(int i = 0; i < bank->lenght; i++){
+        float x = (bank->window != NULL) ? signal[i] * bank->window[i] : signal[i];
+        for(uint8_t b = 0; b < bank->n_bins; b++){
+            float s = x + coeff[b] * s1[b] - s2[b];
+            s2[b] = s1[b];
+            s1[b] = s;
+        }
+    }
+    for(uint8_t b = 0; b < bank->n_bins; b++){
+        const tone_bin_t * bin = &bank->bin[b];
+        ToneBankOutput(bin, s1[b] - bin->cos_w * s2[b], bin->sin_w * s2[b], &magnitude[b], (phase != NULL) ? &phase[b] : NULL);
+    }
+}
+
+void ToneBankSlide(tone_bank_t * bank, const float * signal, uint16_t lenght){
+    int n_res = bank->n_bins * bank->n_res;
+    for(int i = 0; i < lenght; i++){
+        float x = signal[i];
+        float x_old = bank->delay[bank->pos];
+        bank->delay[bank->pos] = x;
+        bank->pos = (bank->pos + 1 < bank->lenght) ? bank->pos + 1 : 0;
+        for(int r = 0; r < n_res; r++){
+            tone_resonator_t * res = &bank->res[r];
+            float re = res->cos_w * res->re - res->sin_w * res->im + x - res->cos_wn * x_old;
+            float im = res->sin_w * res->re + res->cos_w * res->im - res->sin_wn * x_old;
+            res->re = re;
+            res->im = im;
+        }
+        if(--bank->resync == 0){
+            ToneBankResync(bank);
+        }
+    }
+}
+
+void ToneBankRead(const tone_bank_t * bank, float * magnitude, float * phase){
+    for(uint8_t b = 0; b < bank->n_bins; b++){
+        const tone_resonator_t * res = &bank->res[b * bank->n_res];
+        float re = res[0].re;
+        float im = res[0].im;
+        if(bank->n_res == 3){
+            re = 0.5f * res[1].re - 0.25f * (res[0].re + res[2].re);
+            im = 0.5f * res[1].im - 0.25f * (res[0].im + res[2].im);
+        }
+        ToneBankOutput(&bank->bin[b], re, im, &magnitude[b], (phase != NULL) ? &phase[b] : NULL);
+    }
+}
+
+void ToneBankReset(tone_bank_t * bank){
+    memset(bank->delay, 0, bank->lenght * sizeof(float));
+    for(int r = 0; r < bank->n_bins * bank->n_res; r++){
+        bank->res[r].re = 0;
+        bank->res[r].im = 0;
+    }
+    bank->pos = 0;
+    bank->resync = RESYNC_WINDOWS * bank->lenght;
+}
+
+/*==================[end of file]============================================*/
@@ -0,0 +1,120 @@
+/**
+ * @file ecg_record.c
+ * @author Albano Peñalva (albano.penalva@uner.edu.ar)
+ * @brief ECG test vector of the examples and synthetic recordings built from it
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include <stdlib.h>
+#include <math.h>
+#include "ecg_record.h"
+/*==================[macros and definitions]=================================*/
+#define QRS_START       125     /*!< Template samples kept unchanged in every beat (QRS) */
+#define QRS_END         175
+#define BASELINE        90.0f   /*!< Template baseline */
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+/* ecg[] of ej_lcdcolor_ecg, ej_bluetooth_filter and ej_bluetooth_fft */
+const float ecg_template[ECG_TEMPLATE_LENGHT] = {
+     76,  76,  77,  77,  76,  83,  85,  78,  76,  85,  93,  85,  79,
+     86,  93,  93,  85,  87,  94,  98,  93,  87,  95, 104,  99,  91,
+     93, 102, 104,  99,  96, 101, 106, 102,  96,  97, 104, 106,  97,
+     94, 100, 103, 101,  91,  95, 103, 100,  94,  90,  98, 104,  94,
+     87,  93,  99,  97,  87,  86,  96,  98,  90,  83,  90,  96,  89,
+     81,  80,  87,  92,  82,  78,  84,  89,  80,  72,  78,  82,  82,
+     73,  72,  81,  82,  79,  69,  77,  82,  81,  76,  68,  78,  80,
+     76,  73,  78,  82,  82,  75,  72,  86,  84,  78,  76,  85,  95,
+     88,  81,  83,  93,  90,  86,  83,  88,  93,  86,  82,  82,  92,
+     89,  82,  82,  88,  94,  84,  82,  90,  98,  94,  87,  91,  95,
+     98,  93,  90,  97, 104, 105,  96,  93, 107, 116, 118, 127, 148,
+    181, 208, 231, 252, 241, 198, 139,  76,  43,  32,  29,  42,  65,
+     86,  90,  88,  93, 101, 107, 102,  98, 103, 110, 104,  98,  99,
+    107, 109,  96,  95, 103, 107, 102,  95,  95, 102, 105,  94,  94,
+    102, 102,  99,  94,  96, 102,  99,  90,  92, 100, 102,  95,  90,
+     98, 104,  97,  89,  94, 102, 103,  97,  93, 100, 105, 102,  93,
+     97, 104, 104, 100,  96, 108, 111, 104,  99, 101, 108, 102,  96,
+     97, 104, 104,  97,  89,  91, 100,  91,  81,  79,  85,  86,  73,
+     69,  75,  79,  75,  68,  68,  76,  76,  69,  67,  74,  81,  77,
+     71,  72,  82,  82,  76,  77,  76,  76,  75
+};
+
+/*==================[internal functions definition]==========================*/
+/* Template at a fractional position (linear interpolation) */
+static float EcgTemplate(double i){
+    if(i <= 0){
+        return ecg_template[0];
+    }
+    int k = i;
+    if(k >= ECG_TEMPLATE_LENGHT - 1){
+        return ecg_template[ECG_TEMPLATE_LENGHT - 1];
+    }
+    return ecg_template[k] + (i - k) * (ecg_template[k + 1] - ecg_template[k]);
+}
+
+/* Normal random value (Box-Muller) */
+static double EcgRandn(void){
+    double u = (rand() + 1.0) / (RAND_MAX + 2.0);
+    double v = (rand() + 1.0) / (RAND_MAX + 2.0);
+    return sqrt(-2 * log(u)) * cos(2 * M_PI * v);
+}
+
+/*==================[external functions definition]==========================*/
+uint32_t EcgRecord(float sample_frec, uint32_t lenght, float noise, float * signal, uint32_t * r_samples, uint32_t max_beats){
+    double scale = sample_frec / ECG_TEMPLATE_FREC;
+    uint32_t qrs_lenght = (QRS_END - QRS_START) * scale;
+    uint32_t r_template = 0;
+    for(int i = 1; i < ECG_TEMPLATE_LENGHT; i++){
+        if(ecg_template[i] > ecg_template[r_template]){
+            r_template = i;
+        }
+    }
+    uint32_t n_beats = 0;
+    uint32_t pos = 0;
+    double rr = 0.8;
+    while(pos < lenght){
+        /* RR: random walk between 0.45 and 1.4 s, and some premature beats */
+        double beat_rr = (rand() % 30 == 0) ? 0.65 * rr : rr;
+        rr += 0.03 * EcgRandn();
+        rr = fmin(fmax(rr, 0.45), 1.4);
+        /* The QRS keeps its width: the rest of the template is stretched */
+        uint32_t beat_lenght = beat_rr * sample_frec;
+        double stretch = (double)(beat_lenght - qrs_lenght) / (ECG_TEMPLATE_LENGHT - (QRS_END - QRS_START));
+        uint32_t qrs_pos = QRS_START * stretch;
+        for(uint32_t i = 0; (i < beat_lenght) && (pos + i < lenght); i++){
+            double t;
+            if(i < qrs_pos){
+                t = i / stretch;
+            }else if(i < qrs_pos + qrs_lenght){
+                t = QRS_START + (i - qrs_pos) / scale;
+            }else{
+                t = QRS_END + (i - qrs_pos - qrs_lenght) / stretch;
+            }
+            /* Amplitude modulated by breathing (0.25 Hz) */
+            double amplitude = 1 + 0.2 * sin(2 * M_PI * 0.25 * (pos + i) / sample_frec);
+            signal[pos + i] = BASELINE + amplitude * (EcgTemplate(t) - BASELINE);
+        }
+        uint32_t r = pos + qrs_pos + (r_template - QRS_START) * scale;
+        if((r < lenght) && (n_beats < max_beats)){
+            r_samples[n_beats++] = r;
+        }
+        pos += beat_lenght;
+    }
+    /* Baseline wander, mains interference and noise */
+    for(uint32_t i = 0; i < lenght; i++){
+        double t = i / sample_frec;
+        signal[i] += 50 * sin(2 * M_PI * 0.3 * t) + 5 * sin(2 * M_PI * 50 * t) + noise * EcgRandn();
+    }
+    return n_beats;
+}
+
+/*==================[end of file]============================================*/
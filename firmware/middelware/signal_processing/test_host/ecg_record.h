@@ -0,0 +1,54 @@
+/**
+ * @file ecg_record.h
+ * @author Albano Peñalva (albano.penalva@uner.edu.ar)
+ * @brief ECG test vector of the examples and synthetic recordings built from it
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef ECG_RECORD_H_
+#define ECG_RECORD_H_
+
+/*==================[inclusions]=============================================*/
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+/*==================[macros]=================================================*/
+#define ECG_TEMPLATE_LENGHT     256     /*!< Samples of ecg_template (one beat) */
+#define ECG_TEMPLATE_FREC       200     /*!< Sample frequency of ecg_template */
+
+/*==================[typedef]================================================*/
+
+/*==================[external data declaration]==============================*/
+/**
+ * @brief ECG test vector of the examples (ecg[]): one beat, 200 Hz
+ */
+extern const float ecg_template[ECG_TEMPLATE_LENGHT];
+
+/*==================[external functions declaration]=========================*/
+/**
+ * @brief Synthetic ECG recording built from ecg_template: variable RR interval
+ * (0.45 to 1.4 s, with premature beats), breathing amplitude modulation,
+ * baseline wander, 50 Hz interference and white noise
+ *
+ * @param sample_frec   Sample frequency
+ * @param lenght        Number of samples
+ * @param noise         Standard deviation of the white noise (template units, QRS amplitude ~ 220)
+ * @param signal        Array to store the recording (of lenght = lenght)
+ * @param r_samples     Array to store the position of each R wave (of lenght = max_beats)
+ * @param max_beats     Maximun number of beats to store
+ * @return uint32_t     Number of beats stored in r_samples
+ */
+uint32_t EcgRecord(float sample_frec, uint32_t lenght, float noise, float * signal, uint32_t * r_samples, uint32_t max_beats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ECG_RECORD_H_ */
+
+/*==================[end of file]============================================*/
@@ -0,0 +1,96 @@
+/**
+ * @file fft_check.c
+ * @author Albano Peñalva (albano.penalva@uner.edu.ar)
+ * @brief Host check of the fixed point FFT: FFTMagnitudeQ15 against
+ * FFTMagnitude for every lenght, with tones of several amplitudes (up to full
+ * scale). Each bin must be within the bound stated in fft.h: 4% plus the int16
+ * quantization (a fraction of the biggest bin). Returns non zero if a check fails.
+ *
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "fft.h"
+/*==================[macros and definitions]=================================*/
+#define MIN_LENGHT          64
+#define MAX_ERROR           0.04f       /*!< Maximun relative error of a bin (magnitude approximation) */
+#define MAX_QUANT_ERROR     0.003f      /*!< Maximun int16 quantization error, relative to the biggest bin */
+#define MAX_ROUND_ERROR     1.0f        /*!< Rounding of the output (counts) */
+#define NOISE               8           /*!< Peak noise of the samples (counts) */
+
+typedef struct {
+    float dc;                   /*!< DC level (counts) */
+    float amplitude;            /*!< Amplitude of the main tone (counts), second tone of a third of it */
+} fft_case_t;
+/*==================[internal data declaration]==============================*/
+static int16_t signal_q15[MAX_SIGNAL_LENGHT];
+static int16_t fft_q15[MAX_SIGNAL_LENGHT / 2];
+static float signal_f[MAX_SIGNAL_LENGHT];
+static float fft_f[MAX_SIGNAL_LENGHT / 2];
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+/* From small signals to full scale (block floating point shifts right) */
+static const fft_case_t fft_cases[] = {
+    {0, 1000}, {2048, 1500}, {0, 8000}, {-3000, 12000}, {0, 30000}
+};
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/* Two tones (not centered on a bin) and noise, the same samples for both paths */
+static int CheckQ15(const fft_case_t * fft_case, uint16_t lenght){
+    srand(lenght);
+    for(uint16_t i = 0; i < lenght; i++){
+        float x = fft_case->dc + fft_case->amplitude * sinf(2 * M_PI * 5.3f * i / lenght) +
+                  fft_case->amplitude / 3 * cosf(2 * M_PI * (lenght / 5.0f + 0.4f) * i / lenght) +
+                  rand() % (2 * NOISE + 1) - NOISE;
+        x = fmaxf(fminf(x, INT16_MAX), INT16_MIN);
+        signal_q15[i] = lrintf(x);
+        signal_f[i] = signal_q15[i];
+    }
+    FFTMagnitude(signal_f, fft_f, lenght);
+    FFTMagnitudeQ15(signal_q15, fft_q15, lenght);
+
+    /* Output saturated to INT16_MAX */
+    float peak = 0;
+    for(uint16_t j = 0; j < lenght / 2; j++){
+        fft_f[j] = fminf(fft_f[j], INT16_MAX);
+        peak = fmaxf(peak, fft_f[j]);
+    }
+    int errors = 0;
+    float max_error = 0, max_weak_error = 0;
+    for(uint16_t j = 0; j < lenght / 2; j++){
+        float error = fabsf(fft_q15[j] - fft_f[j]);
+        errors += error > MAX_ERROR * fft_f[j] + MAX_QUANT_ERROR * peak + MAX_ROUND_ERROR;
+        /* Relative error of the strong bins, error of the weak ones relative to the peak */
+        if(fft_f[j] >= 0.1f * peak){
+            max_error = fmaxf(max_error, error / fft_f[j]);
+        }else{
+            max_weak_error = fmaxf(max_weak_error, error / peak);
+        }
+    }
+    printf("%4u samples, DC %6.0f, amplitude %5.0f: max error %4.2f %% (weak bins %5.3f %% of the peak): %s\n",
+           lenght, fft_case->dc, fft_case->amplitude, 100 * max_error, 100 * max_weak_error, errors ? "FAIL" : "ok");
+    return errors;
+}
+
+/*==================[external functions definition]==========================*/
+int main(void){
+    FFTInit();
+    int errors = 0;
+    for(uint16_t n = MIN_LENGHT; n <= MAX_SIGNAL_LENGHT; n *= 2){
+        for(uint32_t i = 0; i < sizeof(fft_cases) / sizeof(fft_cases[0]); i++){
+            errors += CheckQ15(&fft_cases[i], n);
+        }
+    }
+    return errors ? 1 : 0;
+}
+
+/*==================[end of file]============================================*/
@@ -0,0 +1,261 @@
+/**
+ * @file heart_rate_check.c
+ * @author Albano Peñalva (albano.penalva@uner.edu.ar)
+ * @brief Host check of the PBA beat detector (drivers/devices/src/heartRate.c):
+ * checkForBeat(), beatDetectorCheck() and beatDetectorCheckBlock() against the
+ * original single sensor implementation on synthetic PPG recordings, three
+ * detectors fed interleaved, and saturation of the low pass filter. Returns
+ * non zero if a check fails.
+ *
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "heartRate.h"
+/*==================[macros and definitions]=================================*/
+#define N_SAMPLES           200000      /*!< Samples of each recording (over 30 minutes at 100 Hz) */
+#define FREQ                100         /*!< Sample rate (Hz) */
+#define N_DETECTORS         3
+#define IR_DC               20000       /*!< DC level (counts): the original DC estimator is int16 */
+#define NOISE               4           /*!< Peak noise of the samples (counts) */
+#define AMBIENT             100         /*!< Ambient light level without finger (counts) */
+#define RISE_S              2           /*!< The finger is placed during the first seconds: the original
+                                             implementation overflows with the AC of a step from 0 */
+#define MAX_BLOCK           32          /*!< MAX3010X FIFO depth */
+#define MIN_BEATS           0.8f        /*!< Minimun beats detected, relative to the beats of the recording */
+
+typedef struct {
+    float hr;                   /*!< Heart rate (bpm) */
+    float amplitude;            /*!< Pulse amplitude (counts) */
+} ppg_case_t;
+/*==================[internal data declaration]==============================*/
+static uint32_t record[N_DETECTORS][N_SAMPLES];
+static uint8_t ref_beats[N_DETECTORS][N_SAMPLES];
+static int16_t ref_ac[N_SAMPLES];
+static uint16_t block_beats[MAX_BLOCK];
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+static const ppg_case_t ppg_cases[N_DETECTORS] = {
+    {60, 150}, {85, 300}, {130, 60}
+};
+
+/* Original implementation (single sensor, state in globals) */
+static const uint16_t old_FIRCoeffs[12] = {172, 321, 579, 927, 1360, 1858, 2390, 2916, 3391, 3768, 4012, 4096};
+static int16_t old_IR_AC_Max;
+static int16_t old_IR_AC_Min;
+static int16_t old_IR_AC_Signal_Current;
+static int16_t old_IR_AC_Signal_Previous;
+static int16_t old_IR_AC_Signal_min;
+static int16_t old_IR_AC_Signal_max;
+static int16_t old_IR_Average_Estimated;
+static int16_t old_positiveEdge;
+static int16_t old_negativeEdge;
+static int32_t old_ir_avg_reg;
+static int16_t old_cbuf[32];
+static uint8_t old_offset;
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+static void OldReset(void){
+    old_IR_AC_Max = 20;
+    old_IR_AC_Min = -20;
+    old_IR_AC_Signal_Current = 0;
+    old_IR_AC_Signal_min = 0;
+    old_IR_AC_Signal_max = 0;
+    old_positiveEdge = 0;
+    old_negativeEdge = 0;
+    old_ir_avg_reg = 0;
+    memset(old_cbuf, 0, sizeof(old_cbuf));
+    old_offset = 0;
+}
+
+static int16_t OldAverageDCEstimator(int32_t *p, uint16_t x){
+    *p += ((((long) x << 15) - *p) >> 4);
+    return (*p >> 15);
+}
+
+static int16_t OldLowPassFIRFilter(int16_t din){
+    old_cbuf[old_offset] = din;
+    int32_t z = mul16(old_FIRCoeffs[11], old_cbuf[(old_offset - 11) & 0x1F]);
+    for(uint8_t i = 0; i < 11; i++){
+        z += mul16(old_FIRCoeffs[i], old_cbuf[(old_offset - i) & 0x1F] + old_cbuf[(old_offset - 22 + i) & 0x1F]);
+    }
+    old_offset++;
+    old_offset %= 32;
+    return(z >> 15);
+}
+
+static bool OldCheckForBeat(int32_t sample){
+    bool beatDetected = false;
+    old_IR_AC_Signal_Previous = old_IR_AC_Signal_Current;
+    old_IR_Average_Estimated = OldAverageDCEstimator(&old_ir_avg_reg, sample);
+    old_IR_AC_Signal_Current = OldLowPassFIRFilter(sample - old_IR_Average_Estimated);
+    if((old_IR_AC_Signal_Previous < 0) & (old_IR_AC_Signal_Current >= 0)){
+        old_IR_AC_Max = old_IR_AC_Signal_max;
+        old_IR_AC_Min = old_IR_AC_Signal_min;
+        old_positiveEdge = 1;
+        old_negativeEdge = 0;
+        old_IR_AC_Signal_max = 0;
+        if(((old_IR_AC_Max - old_IR_AC_Min) > 20) & ((old_IR_AC_Max - old_IR_AC_Min) < 1000)){
+            beatDetected = true;
+        }
+    }
+    if((old_IR_AC_Signal_Previous > 0) & (old_IR_AC_Signal_Current <= 0)){
+        old_positiveEdge = 0;
+        old_negativeEdge = 1;
+        old_IR_AC_Signal_min = 0;
+    }
+    if(old_positiveEdge & (old_IR_AC_Signal_Current > old_IR_AC_Signal_Previous)){
+        old_IR_AC_Signal_max = old_IR_AC_Signal_Current;
+    }
+    if(old_negativeEdge & (old_IR_AC_Signal_Current < old_IR_AC_Signal_Previous)){
+        old_IR_AC_Signal_min = old_IR_AC_Signal_Current;
+    }
+    return(beatDetected);
+}
+
+/* Blood volume during a beat (phase 0..1): fast systolic rise, slow decay */
+static float Pulse(float phase){
+    return (phase < 0.2f) ? sinf(phase / 0.2f * M_PI / 2) : 0.5f * (1 + cosf((phase - 0.2f) / 0.8f * M_PI));
+}
+
+/* IR PPG with an irregular rhythm, a changing amplitude and a slow baseline
+ * drift, rising from 0 during RISE_S. Returns the number of beats of the recording */
+static uint32_t PpgRecord(const ppg_case_t * ppg, uint32_t * samples, unsigned seed){
+    float phase = 0;
+    uint32_t beats = 0;
+    srand(seed);
+    for(uint32_t i = 0; i < N_SAMPLES; i++){
+        float t = (float)i / FREQ;
+        float amplitude = ppg->amplitude * (1 + 0.4f * sinf(2 * M_PI * t / 97));
+        float drift = 2000 * sinf(2 * M_PI * t / 300);
+        float rise = fminf(t / RISE_S, 1);
+        samples[i] = AMBIENT + rise * (IR_DC + drift - amplitude * Pulse(phase)) + rand() % (2 * NOISE + 1) - NOISE;
+        phase += ppg->hr / 60 / FREQ * (1 + 0.1f * sinf(2 * M_PI * t / 41));
+        if(phase >= 1){
+            phase -= 1;
+            beats++;
+        }
+    }
+    return beats;
+}
+
+/* Original implementation over a recording: beats and filtered AC signal */
+static uint32_t OldRun(const uint32_t * samples, uint8_t * beats, int16_t * ac){
+    uint32_t count = 0;
+    OldReset();
+    for(uint32_t i = 0; i < N_SAMPLES; i++){
+        beats[i] = OldCheckForBeat(samples[i]);
+        count += beats[i];
+        if(ac != NULL){
+            ac[i] = old_IR_AC_Signal_Current;
+        }
+    }
+    return count;
+}
+
+/* checkForBeat() and beatDetectorCheck() sample by sample */
+static int CheckSingle(uint32_t record_beats){
+    beat_detector_t detector;
+    uint32_t beats = OldRun(record[0], ref_beats[0], ref_ac);
+    uint32_t beat_errors = 0, ac_errors = 0;
+    beatDetectorInit(&detector);
+    for(uint32_t i = 0; i < N_SAMPLES; i++){
+        bool beat = checkForBeat(record[0][i]);
+        bool beat_detector = beatDetectorCheck(&detector, record[0][i]);
+        beat_errors += (beat != ref_beats[0][i]) + (beat_detector != ref_beats[0][i]);
+        ac_errors += detector.state.acSignalCurrent != ref_ac[i];
+    }
+    int errors = (beat_errors != 0) || (ac_errors != 0) || (beats < MIN_BEATS * record_beats);
+    printf("Single detector, %u samples: %u beats (%u in the recording), %u beats and %u filtered samples differ: %s\n",
+           N_SAMPLES, beats, record_beats, beat_errors, ac_errors, errors ? "FAIL" : "ok");
+    return errors;
+}
+
+/* beatDetectorCheckBlock() with blocks of 1 to MAX_BLOCK samples */
+static int CheckBlock(void){
+    beat_detector_t detector;
+    uint32_t beats = 0, errors = 0;
+    uint16_t length = 1;
+    beatDetectorInit(&detector);
+    for(uint32_t i = 0; i < N_SAMPLES; i += length){
+        length = (length % MAX_BLOCK) + 1;
+        if(i + length > N_SAMPLES){
+            length = N_SAMPLES - i;
+        }
+        uint16_t count = beatDetectorCheckBlock(&detector, &record[0][i], length, block_beats);
+        uint16_t k = 0;
+        for(uint16_t n = 0; n < length; n++){
+            if(ref_beats[0][i + n]){
+                errors += (k >= count) || (block_beats[k] != n);
+                k++;
+            }
+        }
+        errors += k != count;
+        beats += count;
+    }
+    printf("Block detector, blocks of 1 to %d samples: %u beats, %u differ: %s\n",
+           MAX_BLOCK, beats, errors, errors ? "FAIL" : "ok");
+    return errors != 0;
+}
+
+/* N_DETECTORS detectors fed interleaved, each one must match the original
+ * implementation over its own recording */
+static int CheckInstances(const uint32_t * record_beats){
+    beat_detector_t detectors[N_DETECTORS];
+    uint32_t beats[N_DETECTORS], errors[N_DETECTORS] = {0};
+    for(uint8_t d = 0; d < N_DETECTORS; d++){
+        beats[d] = OldRun(record[d], ref_beats[d], NULL);
+        beatDetectorInit(&detectors[d]);
+    }
+    for(uint32_t i = 0; i < N_SAMPLES; i++){
+        for(uint8_t d = 0; d < N_DETECTORS; d++){
+            errors[d] += beatDetectorCheck(&detectors[d], record[d][i]) != ref_beats[d][i];
+        }
+    }
+    int failed = 0;
+    for(uint8_t d = 0; d < N_DETECTORS; d++){
+        failed |= (errors[d] != 0) || (beats[d] < MIN_BEATS * record_beats[d]);
+        printf("Detector %d of %d (%3.0f bpm): %u beats (%u in the recording), %u differ: %s\n",
+               d + 1, N_DETECTORS, ppg_cases[d].hr, beats[d], record_beats[d], errors[d], failed ? "FAIL" : "ok");
+    }
+    return failed;
+}
+
+/* Full scale input: the filter output saturates (DC gain of 1.45) */
+static int CheckSaturation(void){
+    int16_t max = 0, min = 0;
+    for(uint8_t i = 0; i < BEAT_FIR_TAPS; i++){
+        max = lowPassFIRFilter(INT16_MAX);
+    }
+    for(uint8_t i = 0; i < BEAT_FIR_TAPS; i++){
+        min = lowPassFIRFilter(INT16_MIN);
+    }
+    int errors = (max != INT16_MAX) || (min != INT16_MIN);
+    printf("Low pass filter, full scale input: %d, %d: %s\n", max, min, errors ? "FAIL" : "ok");
+    return errors;
+}
+
+/*==================[external functions definition]==========================*/
+int main(void){
+    uint32_t record_beats[N_DETECTORS];
+    for(uint8_t d = 0; d < N_DETECTORS; d++){
+        record_beats[d] = PpgRecord(&ppg_cases[d], record[d], d + 1);
+    }
+    int errors = CheckSingle(record_beats[0]);
+    errors += CheckBlock();
+    errors += CheckInstances(record_beats);
+    errors += CheckSaturation();
+    return errors ? 1 : 0;
+}
+
+/*==================[end of file]============================================*/
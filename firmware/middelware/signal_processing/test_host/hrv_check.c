@@ -0,0 +1,159 @@
+/**
+ * @file hrv_check.c
+ * @author Albano Peñalva (albano.penalva@uner.edu.ar)
+ * @brief Host check of the HRV analyzer: time domain metrics against a
+ * recalculation over the whole window (RR intervals with ectopic beats) and
+ * LF / HF power of RR intervals modulated with known sines. Returns non zero
+ * if a check fails.
+ *
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "hrv.h"
+#include "fft.h"
+/*==================[macros and definitions]=================================*/
+#define N_BEATS             20000       /*!< RR intervals of the time domain check */
+#define MAX_ERROR           1e-3        /*!< Maximun relative error of the time domain metrics */
+#define SPECTRUM_BEATS      1000        /*!< RR intervals of the frequency domain check */
+#define MEAN_RR             0.8         /*!< Mean RR interval of the frequency domain check (s) */
+#define LF_TONE             0.1         /*!< Modulation frequencies (Hz) */
+#define HF_TONE             0.25
+#define MAX_LF_ERROR        0.15f       /*!< Maximun relative error of the band powers */
+#define MAX_HF_ERROR        0.30f       /*!< Linear interpolation attenuates HF */
+
+typedef struct {
+    uint16_t rr;                /*!< RR interval (ms) */
+    uint8_t valid;
+    uint8_t diff;               /*!< Previous one valid too */
+} ref_beat_t;
+/*==================[internal data declaration]==============================*/
+static ref_beat_t ref[N_BEATS];
+static float workspace[HRV_WORKSPACE_LENGHT];
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+static const uint16_t windows[] = {HRV_MIN_WINDOW_S, 120, HRV_MAX_WINDOW_S};
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+static int Differ(double value, double expected){
+    return fabs(value - expected) > MAX_ERROR * fmax(fabs(expected), 1.0);
+}
+
+/* Random RR intervals with ectopic beats, missed and false detections: each
+ * read compared with the metrics of the beats of the last window_s seconds */
+static int CheckTimeDomain(uint16_t window_s){
+    hrv_analyzer_t * hrv = HrvCreate(window_s);
+    srand(window_s);
+    uint32_t window_ms = (uint32_t)window_s * 1000;
+    uint32_t capacity = window_ms / HRV_MIN_RR_MS + 1;
+    uint16_t last_rr = 0;
+    int errors = 0;
+    for(uint32_t b = 0; b < N_BEATS; b++){
+        float rr = 0.8f + 0.15f * sinf(b * 0.05f) + 0.12f * (rand() / (float)RAND_MAX - 0.5f);
+        int event = rand() % 100;
+        if(event == 0){
+            rr *= 0.55f;            /* ectopic beat */
+        }else if(event == 1){
+            rr *= 2.0f;             /* missed beat */
+        }else if(event == 2){
+            rr = 0.25f;             /* false detection */
+        }
+        HrvAddBeat(hrv, rr);
+        /* Same rules as the analyzer */
+        ref[b].rr = rr * 1000 + 0.5f;
+        ref[b].valid = (ref[b].rr >= HRV_MIN_RR_MS) && (ref[b].rr <= HRV_MAX_RR_MS) &&
+                       ((last_rr == 0) || (abs(ref[b].rr - last_rr) * 100 <= last_rr * 20));
+        ref[b].diff = ref[b].valid && (b > 0) && ref[b - 1].valid;
+        last_rr = ref[b].rr;
+
+        if(b % 97 != 0){
+            continue;
+        }
+        /* Beats of the window, newest first */
+        uint32_t time = 0, n = 0;
+        uint32_t first = b + 1;
+        while((first > 0) && (b + 1 - first < capacity) && (time + ref[first - 1].rr <= window_ms)){
+            first--;
+            time += ref[first].rr;
+        }
+        double sum = 0, sum2 = 0, sum_diff2 = 0;
+        uint32_t n_diff = 0, nn50 = 0;
+        for(uint32_t i = first; i <= b; i++){
+            if(ref[i].valid){
+                n++;
+                sum += ref[i].rr;
+            }
+            if(ref[i].diff && (i > first)){
+                int diff = abs(ref[i].rr - ref[i - 1].rr);
+                n_diff++;
+                sum_diff2 += (double)diff * diff;
+                nn50 += (diff > 50);
+            }
+        }
+        double mean = n ? sum / n : 0;
+        for(uint32_t i = first; i <= b; i++){
+            if(ref[i].valid){
+                sum2 += (ref[i].rr - mean) * (ref[i].rr - mean);
+            }
+        }
+        hrv_t result;
+        HrvRead(hrv, &result, NULL);
+        errors += (result.n_beats != n) || Differ(result.mean_rr, mean) ||
+                  Differ(result.sdnn, (n > 1) ? sqrt(sum2 / (n - 1)) : 0) ||
+                  Differ(result.rmssd, n_diff ? sqrt(sum_diff2 / n_diff) : 0) ||
+                  Differ(result.pnn50, n_diff ? 100.0 * nn50 / n_diff : 0);
+    }
+    hrv_t result;
+    HrvRead(hrv, &result, NULL);
+    printf("%3u s window, %u RR intervals: %u valid, SDNN %.1f ms, RMSSD %.1f ms, pNN50 %.1f %%: %s\n",
+           window_s, N_BEATS, result.n_beats, result.sdnn, result.rmssd, result.pnn50, errors ? "FAIL" : "ok");
+    HrvDelete(hrv);
+    return errors;
+}
+
+/* RR intervals modulated by a LF and a HF sine: power of each one is A^2 / 2 */
+static int CheckSpectrum(uint16_t window_s, float lf_amplitude, float hf_amplitude){
+    hrv_analyzer_t * hrv = HrvCreate(window_s);
+    double t = 0;
+    for(uint32_t b = 0; b < SPECTRUM_BEATS; b++){
+        double rr = MEAN_RR + (lf_amplitude * sin(2 * M_PI * LF_TONE * t) + hf_amplitude * sin(2 * M_PI * HF_TONE * t)) / 1000;
+        HrvAddBeat(hrv, rr);
+        t += rr;
+    }
+    hrv_t result;
+    int errors = !HrvRead(hrv, &result, workspace);
+    float lf = lf_amplitude * lf_amplitude / 2;
+    float hf = hf_amplitude * hf_amplitude / 2;
+    errors += fabsf(result.lf - lf) > MAX_LF_ERROR * lf + 1;
+    errors += fabsf(result.hf - hf) > MAX_HF_ERROR * hf + 1;
+    printf("%3u s window, LF %4.1f ms, HF %4.1f ms: LF %6.1f ms^2 (%6.1f), HF %6.1f ms^2 (%6.1f), LF/HF %.2f: %s\n",
+           window_s, lf_amplitude, hf_amplitude, result.lf, lf, result.hf, hf, result.lf_hf, errors ? "FAIL" : "ok");
+    HrvDelete(hrv);
+    return errors;
+}
+
+/*==================[external functions definition]==========================*/
+int main(void){
+    FFTInit();
+    int errors = 0;
+    for(uint32_t i = 0; i < sizeof(windows) / sizeof(windows[0]); i++){
+        errors += CheckTimeDomain(windows[i]);
+    }
+    for(uint32_t i = 0; i < sizeof(windows) / sizeof(windows[0]); i++){
+        errors += CheckSpectrum(windows[i], 40, 20);
+        errors += CheckSpectrum(windows[i], 20, 0);
+        errors += CheckSpectrum(windows[i], 0, 30);
+    }
+    return errors ? 1 : 0;
+}
+
+/*==================[end of file]============================================*/
@@ -0,0 +1,214 @@
+/**
+ * @file qrs_check.c
+ * @author Albano Peñalva (albano.penalva@uner.edu.ar)
+ * @brief Host check of the QRS detector: ecg[] test vector of the examples
+ * and long synthetic recordings (sensitivity, positive predictivity, R wave
+ * position error and latency). Returns non zero if a check fails.
+ *
+ * Usage: qrs_check                     (checks)
+ *        qrs_check file sample_frec    (beats of a recording: text file, one sample per line)
+ *
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+#include "qrs_detector.h"
+#include "iir_filter.h"
+#include "ecg_record.h"
+/*==================[macros and definitions]=================================*/
+#define CHUNK               16          /*!< Samples per call, as ej_lcdcolor_ecg */
+#define MAX_BEATS           32          /*!< Beats per call */
+#define TEMPLATE_LOOPS      40          /*!< Repetitions of the test vector */
+#define RECORD_S            600         /*!< Lenght of the synthetic recordings (s) */
+#define MAX_RECORD_BEATS    2000
+#define MATCH_S             0.075f      /*!< Maximun distance between a detection and a beat */
+#define MIN_SE              99.5f       /*!< Minimun sensitivity and positive predictivity (%) */
+#define MAX_ERROR_S         0.010f      /*!< Maximun mean error of the R wave position (s), or one sample */
+#define SETTLE_S            0.1f        /*!< Start up of the ecg[] filters: step of the first sample */
+
+typedef struct {
+    float sample_frec;
+    float noise;
+} record_case_t;
+/*==================[internal data declaration]==============================*/
+static float record[(uint32_t)(RECORD_S * 1000)];
+static uint32_t r_samples[MAX_RECORD_BEATS];
+static qrs_beat_t beats[MAX_RECORD_BEATS];
+static uint32_t reported[MAX_RECORD_BEATS];
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+static const record_case_t record_cases[] = {
+    {100, 3}, {200, 3}, {200, 10}, {200, 20}, {250, 3}, {360, 8}, {500, 15}, {1000, 3}
+};
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/* Detector fed with blocks of CHUNK samples: position of each beat and sample
+ * at which it was reported */
+static uint32_t QrsRun(float sample_frec, const float * signal, uint32_t lenght){
+    qrs_detector_t * detector = QrsCreate(sample_frec);
+    uint32_t n_beats = 0;
+    for(uint32_t i = 0; i < lenght; i += CHUNK){
+        uint16_t n = (lenght - i < CHUNK) ? lenght - i : CHUNK;
+        uint32_t max_beats = MAX_RECORD_BEATS - n_beats;
+        uint8_t found = QrsDetect(detector, &signal[i], n, &beats[n_beats], (max_beats < MAX_BEATS) ? max_beats : MAX_BEATS);
+        for(uint8_t k = 0; k < found; k++){
+            reported[n_beats++] = i + n;
+        }
+    }
+    QrsDelete(detector);
+    return n_beats;
+}
+
+/* ecg[] played in a loop from sample phase and filtered as in ej_lcdcolor_ecg:
+ * one beat per loop, the first one from the first whole R wave */
+static int CheckTemplate(uint16_t phase, bool verbose){
+    static float signal[TEMPLATE_LOOPS * ECG_TEMPLATE_LENGHT];
+    HiPassInit(ECG_TEMPLATE_FREC, 1, ORDER_2);
+    LowPassInit(ECG_TEMPLATE_FREC, 30, ORDER_2);
+    for(uint32_t i = 0; i < TEMPLATE_LOOPS * ECG_TEMPLATE_LENGHT; i += CHUNK){
+        for(uint16_t k = 0; k < CHUNK; k++){
+            signal[i + k] = ecg_template[(i + k + phase) % ECG_TEMPLATE_LENGHT];
+        }
+        HiPassFilter(&signal[i], &signal[i], CHUNK);
+        LowPassFilter(&signal[i], &signal[i], CHUNK);
+    }
+    uint32_t n_beats = QrsRun(ECG_TEMPLATE_FREC, signal, TEMPLATE_LOOPS * ECG_TEMPLATE_LENGHT);
+    uint32_t r_template = 0;
+    for(int i = 1; i < ECG_TEMPLATE_LENGHT; i++){
+        if(ecg_template[i] > ecg_template[r_template]){
+            r_template = i;
+        }
+    }
+    /* R waves of the signal: r_first + k * ECG_TEMPLATE_LENGHT. Each one after
+     * the start up of the filters and with time to be reported must be found
+     * once, every detection after the start up must be one of them */
+    uint32_t settle = SETTLE_S * ECG_TEMPLATE_FREC;
+    uint32_t end = TEMPLATE_LOOPS * ECG_TEMPLATE_LENGHT - (QRS_MAX_LATENCY_S * ECG_TEMPLATE_FREC + CHUNK);
+    uint32_t r_first = (r_template + ECG_TEMPLATE_LENGHT - phase) % ECG_TEMPLATE_LENGHT;
+    uint32_t n_true = 0, n_found = 0;
+    int32_t last = -1;
+    int errors = 0;
+    for(uint32_t r = r_first; r < end; r += ECG_TEMPLATE_LENGHT){
+        n_true += (r >= settle);
+    }
+    for(uint32_t b = 0; b < n_beats; b++){
+        int32_t k = ((int32_t)beats[b].sample - (int32_t)r_first + ECG_TEMPLATE_LENGHT / 2) / ECG_TEMPLATE_LENGHT;
+        uint32_t r = r_first + k * ECG_TEMPLATE_LENGHT;
+        if((beats[b].sample < settle) || (r < settle)){
+            continue;
+        }
+        if((abs((int)beats[b].sample - (int)r) > MAX_ERROR_S * ECG_TEMPLATE_FREC) || (k == last)){
+            errors++;
+            continue;
+        }
+        if((last >= 0) && (k == last + 1) && (fabsf(beats[b].rr - (float)ECG_TEMPLATE_LENGHT / ECG_TEMPLATE_FREC) > 1.0f / ECG_TEMPLATE_FREC)){
+            errors++;
+        }
+        n_found += (r < end);
+        last = k;
+    }
+    errors += (n_found != n_true);
+    if(verbose || errors){
+        printf("ecg[] x %d, 200 Hz, phase %3u: %u of %u beats, first R at %u, RR %.3f s, HR %.1f bpm: %s\n",
+               TEMPLATE_LOOPS, phase, n_found, n_true, (n_beats > 0) ? beats[0].sample : 0,
+               (n_beats > 1) ? beats[1].rr : 0, (n_beats > 1) ? beats[n_beats - 1].heart_rate : 0, errors ? "FAIL" : "ok");
+    }
+    return errors;
+}
+
+/* Every start phase of ecg[]: R waves before, at and after the end of the
+ * learning period */
+static int CheckTemplatePhases(void){
+    int failed = 0;
+    for(uint16_t phase = 0; phase < ECG_TEMPLATE_LENGHT; phase++){
+        failed += (CheckTemplate(phase, false) != 0);
+    }
+    printf("ecg[] x %d, 200 Hz, %d start phases: %d failed: %s\n", TEMPLATE_LOOPS, ECG_TEMPLATE_LENGHT, failed, failed ? "FAIL" : "ok");
+    return failed;
+}
+
+/* Synthetic recording: detections matched to the beats */
+static int CheckRecord(const record_case_t * c){
+    uint32_t lenght = RECORD_S * c->sample_frec;
+    srand(7);
+    uint32_t n_true = EcgRecord(c->sample_frec, lenght, c->noise, record, r_samples, MAX_RECORD_BEATS);
+    uint32_t n_beats = QrsRun(c->sample_frec, record, lenght);
+    /* Beats at the end of the recording may not be reported yet */
+    uint32_t end = lenght - (QRS_MAX_LATENCY_S * c->sample_frec + CHUNK);
+    while((n_true > 0) && (r_samples[n_true - 1] >= end)){
+        n_true--;
+    }
+    while((n_beats > 0) && (beats[n_beats - 1].sample >= end)){
+        n_beats--;
+    }
+    uint32_t match = MATCH_S * c->sample_frec;
+    uint32_t tp = 0;
+    double error = 0, latency = 0;
+    for(uint32_t b = 0, t = 0; b < n_beats; b++){
+        while((t < n_true) && (r_samples[t] + match < beats[b].sample)){
+            t++;
+        }
+        if((t < n_true) && (r_samples[t] <= beats[b].sample + match)){
+            tp++;
+            error += fabs((double)beats[b].sample - r_samples[t]) / c->sample_frec;
+            /* Beats of the learning period are reported at its end */
+            if(r_samples[t] > (QRS_LEARNING_S + 0.5) * c->sample_frec){
+                latency = fmax(latency, (double)(reported[b] - r_samples[t]) / c->sample_frec);
+            }
+            t++;
+        }
+    }
+    float se = 100.0f * tp / n_true;
+    float pp = 100.0f * tp / n_beats;
+    error /= tp;
+    /* Latency includes the wait for a whole block */
+    int fail = (se < MIN_SE) || (pp < MIN_SE) || (error > fmax(MAX_ERROR_S, 1.0 / c->sample_frec)) || (latency > QRS_MAX_LATENCY_S + (float)CHUNK / c->sample_frec);
+    printf("%d s, %4.0f Hz, noise %4.1f: %4u beats, %4u found, Se %6.2f %%, +P %6.2f %%, R error %4.1f ms, latency %.3f s: %s\n",
+           RECORD_S, c->sample_frec, c->noise, n_true, n_beats, se, pp, 1000 * error, latency, fail ? "FAIL" : "ok");
+    return fail;
+}
+
+/* Beats of a recording */
+static int PrintRecord(const char * file_name, float sample_frec){
+    FILE * file = fopen(file_name, "r");
+    if(file == NULL){
+        printf("Can't open %s\n", file_name);
+        return 1;
+    }
+    uint32_t lenght = 0;
+    while((lenght < sizeof(record) / sizeof(float)) && (fscanf(file, "%f", &record[lenght]) == 1)){
+        lenght++;
+    }
+    fclose(file);
+    uint32_t n_beats = QrsRun(sample_frec, record, lenght);
+    for(uint32_t b = 0; b < n_beats; b++){
+        printf("%u\t%.3f\t%.3f\t%.1f\n", beats[b].sample, beats[b].sample / sample_frec, beats[b].rr, beats[b].heart_rate);
+    }
+    printf("%u samples, %u beats\n", lenght, n_beats);
+    return 0;
+}
+
+/*==================[external functions definition]==========================*/
+int main(int argc, char * argv[]){
+    if(argc > 2){
+        return PrintRecord(argv[1], atof(argv[2]));
+    }
+    int errors = CheckTemplate(0, true);
+    errors += CheckTemplatePhases();
+    for(uint32_t i = 0; i < sizeof(record_cases) / sizeof(record_cases[0]); i++){
+        errors += CheckRecord(&record_cases[i]);
+    }
+    return errors ? 1 : 0;
+}
+
+/*==================[end of file]============================================*/
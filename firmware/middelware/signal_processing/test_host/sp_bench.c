@@ -0,0 +1,611 @@
+/**
+ * @file sp_bench.c
+ * @author Albano Peñalva (albano.penalva@uner.edu.ar)
+ * @brief Host benchmark of the signal processing middleware and the esp-dsp 
+ * ANSI C kernels. Reports ns/sample and samples/s of each case.
+ * 
+ * Usage: sp_bench [--quick]
+ * 
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+/*==================[inclusions]=============================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "sp_bench.h"
+#include "fft.h"
+#include "iir_filter.h"
+#include "decimator.h"
+#include "tone_bank.h"
+#include "signal_quality.h"
+#include "qrs_detector.h"
+#include "hrv.h"
+#include "ecg_record.h"
+#include "spo2_algorithm.h"
+#include "esp_dsp.h"
+/*==================[macros and definitions]=================================*/
+#define BENCH_TIME_NS       200000000   /*!< Minimum run time of each case */
+#define BENCH_QUICK_TIME_NS 2000000     /*!< Minimum run time of each case with --quick */
+#define SAMPLE_FREC         1000        /*!< Sample frequency used to design filters */
+#define MAX_FIR_TAPS        256
+#define MAX_CONV_KERNEL     256
+#define DECIM_FREC          8000        /*!< Decimator input frequency */
+#define DECIM_RATIO         32          /*!< Decimator ratio (8 kHz -> 250 Hz) */
+#define DECIM_TAPS          881         /*!< Single stage dsps_fird_f32 with the same transition band */
+#define TONE_LENGHT         1024        /*!< Tone bank window */
+#define QUALITY_LENGHT      1024        /*!< Signal quality window */
+#define QUALITY_CHANNELS    8           /*!< Signal quality maximun channels */
+#define QRS_LENGHT          1024        /*!< QRS detector block */
+#define PPG_DC              120000      /*!< SpO2 synthetic PPG: IR DC level (counts), a beat per second */
+
+typedef struct {
+    float * input;
+    float * output;
+    uint16_t lenght;
+} signal_param_t;
+
+typedef struct {
+    fft_plan_t * plan;
+    float * input;
+    float * output;
+    float * workspace;
+} fft_plan_param_t;
+
+typedef struct {
+    int16_t * input;
+    int16_t * output;
+    uint16_t lenght;
+} signal_q15_param_t;
+
+typedef struct {
+    fir_f32_t fir;
+    float * input;
+    float * output;
+    uint16_t lenght;
+} fir_param_t;
+
+typedef struct {
+    iir_filter_t * filter;
+    iir_design_t design;
+    float * input;
+    float * output;
+    uint16_t lenght;
+} iir_param_t;
+
+typedef struct {
+    iir_filter_t * filter;
+    int16_t * input;
+    int16_t * output;
+    uint16_t lenght;
+} iir_q15_param_t;
+
+typedef struct {
+    float * input;
+    float * kernel;
+    float * output;
+    uint16_t lenght;
+    uint16_t kernel_lenght;
+} conv_param_t;
+typedef struct {
+    decimator_t * decimator;
+    const void * input;
+    void * output;
+    uint16_t lenght;
+} decimator_param_t;
+
+typedef struct {
+    tone_bank_t * bank;
+    float * input;
+    float * output;
+    uint16_t lenght;
+} tone_bank_param_t;
+
+typedef struct {
+    signal_quality_meter_t * meter;
+    const float * signal[QUALITY_CHANNELS];
+    signal_quality_t result[QUALITY_CHANNELS];
+    uint8_t n_channels;
+} signal_quality_param_t;
+
+typedef struct {
+    qrs_detector_t * detector;
+    float * input;
+    uint16_t lenght;
+} qrs_param_t;
+
+typedef struct {
+    hrv_analyzer_t * hrv;
+    hrv_t result;
+    uint32_t beat;
+} hrv_param_t;
+
+typedef struct {
+    maxim_spo2_stream_t stream;
+    uint32_t ir[MAXIM_STREAM_MAX_FREQ];     /*!< One second (a beat) of PPG */
+    uint32_t red[MAXIM_STREAM_MAX_FREQ];
+    int32_t frec;
+} spo2_stream_param_t;
+
+typedef struct {
+    uint32_t ir[BUFFER_SIZE];               /*!< 4 s window at FreqS */
+    uint32_t red[BUFFER_SIZE];
+} spo2_batch_param_t;
+
+typedef struct {
+    dct_plan_f32_t plan;
+    float * input;
+    float * output;
+    float * workspace;
+} dct_param_t;
+/*==================[internal data declaration]==============================*/
+static uint64_t bench_time = BENCH_TIME_NS;
+static float input[MAX_SIGNAL_LENGHT];
+static float output[MAX_SIGNAL_LENGHT + MAX_CONV_KERNEL];
+static float workspace[FFT_WORKSPACE_LENGHT(MAX_SIGNAL_LENGHT)];
+static int16_t input_q15[MAX_SIGNAL_LENGHT];
+static int16_t output_q15[MAX_SIGNAL_LENGHT];
+static float fir_coeffs[MAX_FIR_TAPS];
+static float fir_delay[MAX_FIR_TAPS];
+static float conv_kernel[MAX_CONV_KERNEL];
+static float decim_coeffs[DECIM_TAPS];
+static float decim_delay[DECIM_TAPS];
+static float ecg_input[QRS_LENGHT];
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+static uint64_t BenchNow(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/* Init and deinit of the FFT tables (size: table size in floats) */
+static void Fft2rInitCase(void * param){
+    (void)param;
+    dsps_fft2r_deinit_fc32();
+    dsps_fft2r_init_fc32(NULL, CONFIG_DSP_MAX_FFT_SIZE);
+}
+
+static void Fft2rInitConstCase(void * param){
+    (void)param;
+    dsps_fft2r_deinit_fc32();
+    dsps_fft2r_init_const_fc32(DSPS_FFT2R_W_TABLE_FC32(CONFIG_DSP_MAX_FFT_SIZE), CONFIG_DSP_MAX_FFT_SIZE);
+}
+
+static void Fft4rInitCase(void * param){
+    (void)param;
+    dsps_fft4r_deinit_fc32();
+    dsps_fft4r_init_fc32(NULL, MAX_SIGNAL_LENGHT / 2);
+}
+
+static void Fft4rInitConstCase(void * param){
+    (void)param;
+    dsps_fft4r_deinit_fc32();
+    dsps_fft4r_init_const_fc32(DSPS_FFT4R_W_TABLE_FC32(1024), MAX_SIGNAL_LENGHT / 2);
+}
+
+static void WindHannCase(void * param){
+    signal_param_t * p = param;
+    dsps_wind_hann_f32(p->output, p->lenght);
+}
+
+static void FFTMagnitudeCase(void * param){
+    signal_param_t * p = param;
+    FFTMagnitude(p->input, p->output, p->lenght);
+}
+
+static void FFTPlanMagnitudeCase(void * param){
+    fft_plan_param_t * p = param;
+    FFTPlanMagnitude(p->plan, p->input, p->output, p->workspace);
+}
+
+static void FFTMagnitudeQ15Case(void * param){
+    signal_q15_param_t * p = param;
+    FFTMagnitudeQ15(p->input, p->output, p->lenght);
+}
+
+static void LowPassCase(void * param){
+    signal_param_t * p = param;
+    LowPassFilter(p->input, p->output, p->lenght);
+}
+
+static void HiPassCase(void * param){
+    signal_param_t * p = param;
+    HiPassFilter(p->input, p->output, p->lenght);
+}
+
+static void IirFilterCase(void * param){
+    iir_param_t * p = param;
+    IirFilter(p->filter, p->input, p->output, p->lenght);
+}
+
+static void IirFilterQ15Case(void * param){
+    iir_q15_param_t * p = param;
+    IirFilterQ15(p->filter, p->input, p->output, p->lenght);
+}
+
+static void IirFiltFiltCase(void * param){
+    iir_param_t * p = param;
+    IirFiltFilt(p->filter, p->input, p->output, p->lenght, workspace);
+}
+
+static void IirDesignCase(void * param){
+    iir_param_t * p = param;
+    IirDesignSOS(&p->design, p->output);
+}
+
+static void FirCase(void * param){
+    fir_param_t * p = param;
+    dsps_fir_f32(&p->fir, p->input, p->output, p->lenght);
+}
+
+static void ConvCase(void * param){
+    conv_param_t * p = param;
+    dsps_conv_f32(p->input, p->lenght, p->kernel, p->kernel_lenght, p->output);
+}
+
+static void ConvFFTCase(void * param){
+    conv_param_t * p = param;
+    dsps_conv_fft_f32(p->input, p->lenght, p->kernel, p->kernel_lenght, p->output);
+}
+
+static void DecimatorCase(void * param){
+    decimator_param_t * p = param;
+    DecimatorFilter(p->decimator, p->input, p->output, p->lenght);
+}
+
+static void DecimatorQ15Case(void * param){
+    decimator_param_t * p = param;
+    DecimatorFilterQ15(p->decimator, p->input, p->output, p->lenght);
+}
+
+static void FirdCase(void * param){
+    fir_param_t * p = param;
+    dsps_fird_f32(&p->fir, p->input, p->output, p->lenght / p->fir.decim);
+}
+
+static void ToneBankGoertzelCase(void * param){
+    tone_bank_param_t * p = param;
+    ToneBankGoertzel(p->bank, p->input, p->output, NULL);
+}
+
+static void ToneBankSlideCase(void * param){
+    tone_bank_param_t * p = param;
+    ToneBankSlide(p->bank, p->input, p->lenght);
+    ToneBankRead(p->bank, p->output, NULL);
+}
+
+static void SignalQualityCase(void * param){
+    signal_quality_param_t * p = param;
+    SignalQualityMeasure(p->meter, p->signal, p->n_channels, p->result, workspace);
+}
+
+static void QrsCase(void * param){
+    qrs_param_t * p = param;
+    qrs_beat_t beats[8];
+    QrsDetect(p->detector, p->input, p->lenght, beats, 8);
+}
+
+static void Spo2StreamCase(void * param){
+    spo2_stream_param_t * p = param;
+    for(int32_t i = 0; i < p->frec; i++){
+        maxim_spo2_stream_add_sample(&p->stream, p->ir[i], p->red[i]);
+    }
+}
+
+static void Spo2BatchCase(void * param){
+    spo2_batch_param_t * p = param;
+    int32_t spo2, hr;
+    int8_t spo2_valid, hr_valid;
+    maxim_heart_rate_and_oxygen_saturation(p->ir, BUFFER_SIZE, p->red, &spo2, &spo2_valid, &hr, &hr_valid);
+}
+
+static void HrvAddBeatCase(void * param){
+    hrv_param_t * p = param;
+    HrvAddBeat(p->hrv, 0.8f + 0.05f * sinf(p->beat++ * 0.5f));
+}
+
+static void HrvReadCase(void * param){
+    hrv_param_t * p = param;
+    HrvRead(p->hrv, &p->result, workspace);
+}
+
+/* dsps_snr_f32 logs every result, so only dsps_sfdr_f32 is measured: 
+ * same steps (allocation, window, FFT tables, FFT) */
+static void SfdrCase(void * param){
+    signal_quality_param_t * p = param;
+    for(uint8_t ch = 0; ch < p->n_channels; ch++){
+        p->result[ch].sfdr = dsps_sfdr_f32(p->signal[ch], QUALITY_LENGHT, 0);
+    }
+}
+
+static void DCTCase(void * param){
+    dct_param_t * p = param;
+    memcpy(p->output, p->input, p->plan.N * sizeof(float));
+    dsps_dct_f32(p->output, p->plan.N);
+}
+
+static void DCTPlanCase(void * param){
+    dct_param_t * p = param;
+    dsps_dct_plan_f32(&p->plan, p->input, p->output, p->workspace);
+}
+
+static void MDCTCase(void * param){
+    dct_param_t * p = param;
+    dsps_mdct_f32(&p->plan, p->input, NULL, p->output, p->workspace);
+}
+
+static void BenchFFTTables(void){
+    BenchSection("FFT tables: calculated at init or in flash (size = floats)");
+    BenchRun("fft2r init, calculated", CONFIG_DSP_MAX_FFT_SIZE, CONFIG_DSP_MAX_FFT_SIZE, Fft2rInitCase, NULL);
+    BenchRun("fft2r init, flash", CONFIG_DSP_MAX_FFT_SIZE, CONFIG_DSP_MAX_FFT_SIZE, Fft2rInitConstCase, NULL);
+    BenchRun("fft4r init, calculated", 2 * MAX_SIGNAL_LENGHT, 2 * MAX_SIGNAL_LENGHT, Fft4rInitCase, NULL);
+    BenchRun("fft4r init, flash", 2 * MAX_SIGNAL_LENGHT, 2 * MAX_SIGNAL_LENGHT, Fft4rInitConstCase, NULL);
+    signal_param_t p = {input, output, MAX_SIGNAL_LENGHT};
+    BenchRun("dsps_wind_hann_f32", MAX_SIGNAL_LENGHT, MAX_SIGNAL_LENGHT, WindHannCase, &p);
+    dsps_fft2r_deinit_fc32();
+    dsps_fft4r_deinit_fc32();
+}
+
+static void BenchFFT(void){
+    BenchSection("FFT");
+    FFTInit();
+    for(uint16_t n = 64; n <= MAX_SIGNAL_LENGHT; n *= 2){
+        signal_param_t p = {input, output, n};
+        BenchRun("FFTMagnitude", n, n, FFTMagnitudeCase, &p);
+    }
+    for(uint16_t n = 64; n <= MAX_SIGNAL_LENGHT; n *= 2){
+        fft_plan_param_t p = {FFTPlanCreate(n), input, output, workspace};
+        BenchRun("FFTPlanMagnitude", n, n, FFTPlanMagnitudeCase, &p);
+        FFTPlanDelete(p.plan);
+    }
+    for(uint16_t n = 64; n <= MAX_SIGNAL_LENGHT; n *= 2){
+        signal_q15_param_t p = {input_q15, output_q15, n};
+        BenchRun("FFTMagnitudeQ15", n, n, FFTMagnitudeQ15Case, &p);
+    }
+}
+
+static void BenchDCT(void){
+    BenchSection("DCT (size = N, MDCT: N outputs of 2N samples)");
+    for(uint16_t n = 64; n <= MAX_SIGNAL_LENGHT / 2; n *= 2){
+        dct_param_t p = {.input = input, .output = output, .workspace = workspace};
+        dsps_dct_plan_init_f32(&p.plan, n);
+        BenchRun("dsps_dct_f32", n, n, DCTCase, &p);
+        BenchRun("dsps_dct_plan_f32", n, n, DCTPlanCase, &p);
+        BenchRun("dsps_mdct_f32", n, n, MDCTCase, &p);
+        dsps_dct_plan_free_f32(&p.plan);
+    }
+}
+
+static void BenchToneBank(void){
+    float frec[TONE_BANK_MAX_BINS];
+    BenchSection("Tone bank, 1024 samples window (size = bins, FFTMagnitude: all of them)");
+    signal_param_t p_fft = {input, output, TONE_LENGHT};
+    BenchRun("FFTMagnitude", TONE_LENGHT / 2, TONE_LENGHT, FFTMagnitudeCase, &p_fft);
+    for(int i = 0; i < TONE_BANK_MAX_BINS; i++){
+        frec[i] = 10 + 7.3f * i;
+    }
+    for(uint8_t k = 1; k <= TONE_BANK_MAX_BINS; k *= 2){
+        tone_bank_config_t config = {.sample_frec = SAMPLE_FREC, .frec = frec, .n_bins = k, .lenght = TONE_LENGHT, .hann = true};
+        tone_bank_param_t p = {ToneBankCreate(&config), input, output, TONE_LENGHT};
+        BenchRun("ToneBankGoertzel", k, p.lenght, ToneBankGoertzelCase, &p);
+        BenchRun("ToneBankSlide", k, p.lenght, ToneBankSlideCase, &p);
+        ToneBankDelete(p.bank);
+    }
+}
+
+static void BenchSignalQuality(void){
+    BenchSection("Signal quality, 1024 samples window (size = channels)");
+    signal_quality_config_t config = {.sample_frec = SAMPLE_FREC, .lenght = QUALITY_LENGHT, .n_harmonics = 5};
+    signal_quality_param_t p = {.meter = SignalQualityCreate(&config)};
+    for(uint8_t ch = 0; ch < QUALITY_CHANNELS; ch++){
+        p.signal[ch] = &input[(ch * 128) % (MAX_SIGNAL_LENGHT - QUALITY_LENGHT)];
+    }
+    for(p.n_channels = 1; p.n_channels <= QUALITY_CHANNELS; p.n_channels *= 2){
+        BenchRun("dsps_sfdr_f32", p.n_channels, p.n_channels * QUALITY_LENGHT, SfdrCase, &p);
+        BenchRun("SignalQualityMeasure", p.n_channels, p.n_channels * QUALITY_LENGHT, SignalQualityCase, &p);
+    }
+    SignalQualityDelete(p.meter);
+}
+
+static void BenchQRS(void){
+    BenchSection("QRS detector, synthetic ECG (size = sample frequency, 1024 samples block)");
+    static const uint16_t frecs[] = {200, 500, 1000};
+    uint32_t r_samples[16];
+    for(size_t i = 0; i < sizeof(frecs) / sizeof(frecs[0]); i++){
+        qrs_param_t p = {QrsCreate(frecs[i]), ecg_input, QRS_LENGHT};
+        /* Detector runs over and over the same block: beats and noise peaks as in a recording */
+        EcgRecord(frecs[i], p.lenght, 3, ecg_input, r_samples, 16);
+        BenchRun("QrsDetect", frecs[i], p.lenght, QrsCase, &p);
+        QrsDelete(p.detector);
+    }
+}
+
+static void BenchHRV(void){
+    BenchSection("HRV analyzer (size = window in s, HrvRead: whole window)");
+    static const uint16_t windows[] = {HRV_MIN_WINDOW_S, 120, HRV_MAX_WINDOW_S};
+    for(size_t i = 0; i < sizeof(windows) / sizeof(windows[0]); i++){
+        hrv_param_t p = {HrvCreate(windows[i]), {0}, 0};
+        BenchRun("HrvAddBeat", windows[i], 1, HrvAddBeatCase, &p);
+        /* Complete window for the frequency domain metrics */
+        for(uint32_t b = 0; b < 1.25f * windows[i] / 0.8f; b++){
+            HrvAddBeatCase(&p);
+        }
+        BenchRun("HrvRead", windows[i], 1, HrvReadCase, &p);
+        HrvDelete(p.hrv);
+    }
+}
+
+/* Synthetic PPG of 60 bpm: a sharp pulse per second, less AC on red */
+static void PpgSecond(uint32_t * ir, uint32_t * red, int32_t frec){
+    for(int32_t i = 0; i < frec; i++){
+        float pulse = powf(0.5f * (1 + cosf(2 * M_PI * i / frec)), 4);
+        ir[i] = PPG_DC * (1 - 0.01f * pulse);
+        red[i] = 0.75f * PPG_DC * (1 - 0.007f * pulse);
+    }
+}
+
+static void BenchSpO2(void){
+    BenchSection("SpO2, 4 s window (size = sample frequency, batch: called every second, ns per input sample)");
+    static const int32_t frecs[] = {FreqS, MAXIM_STREAM_MAX_FREQ};
+    static spo2_stream_param_t p;
+    for(size_t i = 0; i < sizeof(frecs) / sizeof(frecs[0]); i++){
+        p.frec = frecs[i];
+        PpgSecond(p.ir, p.red, p.frec);
+        maxim_spo2_stream_init(&p.stream, p.frec);
+        /* Full window: constant work per sample */
+        for(int32_t s = 0; s < STREAM_WINDOW_S; s++){
+            Spo2StreamCase(&p);
+        }
+        BenchRun("maxim_spo2_stream", p.frec, p.frec, Spo2StreamCase, &p);
+    }
+    static spo2_batch_param_t p_batch;
+    for(int32_t s = 0; s < STREAM_WINDOW_S; s++){
+        PpgSecond(&p_batch.ir[s * FreqS], &p_batch.red[s * FreqS], FreqS);
+    }
+    BenchRun("maxim_heart_rate (batch)", FreqS, FreqS, Spo2BatchCase, &p_batch);
+}
+
+static void BenchIIR(void){
+    const filter_order_t orders[] = {ORDER_2, ORDER_4, ORDER_6, ORDER_8};
+    BenchSection("IIR filters (size = order, 1024 samples blocks)");
+    for(size_t i = 0; i < sizeof(orders) / sizeof(orders[0]); i++){
+        signal_param_t p = {input, output, 1024};
+        LowPassInit(SAMPLE_FREC, 50, orders[i]);
+        HiPassInit(SAMPLE_FREC, 5, orders[i]);
+        BenchRun("LowPassFilter", orders[i], p.lenght, LowPassCase, &p);
+        BenchRun("HiPassFilter", orders[i], p.lenght, HiPassCase, &p);
+    }
+    const char * names[] = {"IirDesignSOS butter", "IirDesignSOS cheby1", "IirDesignSOS cheby2", "IirDesignSOS bessel"};
+    for(uint8_t order = 4; order <= IIR_MAX_ORDER; order += 8){
+        for(filter_prototype_t prototype = BUTTERWORTH; prototype <= BESSEL; prototype++){
+            iir_param_t p = {.output = output, .lenght = 1};
+            p.design = (iir_design_t){.type = BAND_PASS, .prototype = prototype, .order = order, 
+                                      .sample_frec = SAMPLE_FREC, .cut_frec = 5, .cut_frec_high = 50, .ripple = 1};
+            if(prototype == CHEBYSHEV_2){
+                p.design.ripple = 40;
+            }
+            BenchRun(names[prototype], order, p.lenght, IirDesignCase, &p);
+        }
+    }
+    for(uint8_t order = 4; order <= IIR_MAX_ORDER; order += 8){
+        iir_design_t design = {.type = BAND_PASS, .prototype = BUTTERWORTH, .order = order, 
+                               .sample_frec = SAMPLE_FREC, .cut_frec = 5, .cut_frec_high = 50};
+        iir_param_t p = {.filter = IirCreateDesign(&design, 1), .input = input, .output = output, .lenght = 1024};
+        BenchRun("IirFilter band pass", order, p.lenght, IirFilterCase, &p);
+        BenchRun("IirFiltFilt band pass", order, p.lenght, IirFiltFiltCase, &p);
+        IirDelete(p.filter);
+    }
+    for(uint8_t order = 2; order <= 8; order += 2){
+        iir_design_t design = {.type = LOW_PASS, .prototype = BUTTERWORTH, .order = order, 
+                               .sample_frec = SAMPLE_FREC, .cut_frec = 50};
+        iir_param_t p = {.filter = IirCreateQ15(&design, 1), .input = input, .output = output, .lenght = 1024};
+        iir_q15_param_t p_q15 = {.filter = p.filter, .input = input_q15, .output = output_q15, .lenght = 1024};
+        BenchRun("IirFilter low pass", order, p.lenght, IirFilterCase, &p);
+        BenchRun("IirFilterQ15 low pass", order, p_q15.lenght, IirFilterQ15Case, &p_q15);
+        IirDelete(p.filter);
+    }
+}
+
+static void BenchFIR(void){
+    BenchSection("FIR (size = taps, 1024 samples blocks)");
+    for(int taps = 8; taps <= MAX_FIR_TAPS; taps *= 2){
+        fir_param_t p = {.input = input, .output = output, .lenght = 1024};
+        for(int i = 0; i < taps; i++){
+            fir_coeffs[i] = 1.0f / taps;
+        }
+        memset(fir_delay, 0, sizeof(fir_delay));
+        dsps_fir_init_f32(&p.fir, fir_coeffs, fir_delay, taps);
+        BenchRun("dsps_fir_f32", taps, p.lenght, FirCase, &p);
+    }
+}
+
+static void BenchConv(void){
+    BenchSection("Convolution (size = kernel lenght, 1024 samples signal)");
+    for(int i = 0; i < MAX_CONV_KERNEL; i++){
+        conv_kernel[i] = 1.0f / (i + 1);
+    }
+    for(uint16_t k = 4; k <= MAX_CONV_KERNEL; k *= 2){
+        conv_param_t p = {input, conv_kernel, output, 1024, k};
+        BenchRun("dsps_conv_f32", k, p.lenght, ConvCase, &p);
+        BenchRun("dsps_conv_fft_f32", k, p.lenght, ConvFFTCase, &p);
+    }
+}
+
+static void BenchDecimator(void){
+    BenchSection("Decimation 8 kHz -> 250 Hz (size = input block, ns per input sample)");
+    decimator_config_t config = {.sample_frec = DECIM_FREC, .ratio = DECIM_RATIO};
+    decimator_param_t p = {DecimatorCreate(&config), input, output, 1024};
+    BenchRun("DecimatorFilter", p.lenght, p.lenght, DecimatorCase, &p);
+    DecimatorDelete(p.decimator);
+    config.fixed_point = true;
+    decimator_param_t p_q15 = {DecimatorCreate(&config), input_q15, output_q15, 1024};
+    BenchRun("DecimatorFilterQ15", p_q15.lenght, p_q15.lenght, DecimatorQ15Case, &p_q15);
+    DecimatorDelete(p_q15.decimator);
+    /* Reference: one stage with the transition band of the last one */
+    fir_param_t p_fird = {.input = input, .output = output, .lenght = 1024};
+    for(int i = 0; i < DECIM_TAPS; i++){
+        decim_coeffs[i] = 1.0f / DECIM_TAPS;
+    }
+    memset(decim_delay, 0, sizeof(decim_delay));
+    dsps_fird_init_f32(&p_fird.fir, decim_coeffs, decim_delay, DECIM_TAPS, DECIM_RATIO);
+    BenchRun("dsps_fird_f32 (1 stage)", p_fird.lenght, p_fird.lenght, FirdCase, &p_fird);
+}
+
+/*==================[external functions definition]==========================*/
+void BenchRun(const char * name, int size, uint32_t samples, bench_func func, void * param){
+    /* One call to warm up caches and lazy initializations (e.g. FFT windows) */
+    func(param);
+    uint64_t calls = 0;
+    uint64_t start = BenchNow();
+    uint64_t elapsed;
+    do {
+        func(param);
+        calls++;
+        elapsed = BenchNow() - start;
+    } while(elapsed < bench_time);
+    double ns_sample = (double)elapsed / ((double)calls * samples);
+    printf("%-24s %6d %12.2f ns/sample %14.0f samples/s\n", name, size, ns_sample, 1e9 / ns_sample);
+}
+
+void BenchSection(const char * title){
+    printf("\n== %s\n", title);
+}
+
+int main(int argc, char * argv[]){
+    if(argc > 1 && strcmp(argv[1], "--quick") == 0){
+        bench_time = BENCH_QUICK_TIME_NS;
+    }
+    srand(1);
+    for(int i = 0; i < MAX_SIGNAL_LENGHT; i++){
+        input[i] = sinf(2 * M_PI * 10 * i / SAMPLE_FREC) + 0.1f * ((float)rand() / RAND_MAX - 0.5f);
+        input_q15[i] = 2000 * input[i];
+    }
+    BenchFFTTables();
+    BenchFFT();
+    BenchDCT();
+    BenchToneBank();
+    BenchSignalQuality();
+    BenchQRS();
+    BenchHRV();
+    BenchSpO2();
+    BenchIIR();
+    BenchFIR();
+    BenchConv();
+    BenchDecimator();
+    BenchMat();
+    return 0;
+}
+
+/*==================[end of file]============================================*/
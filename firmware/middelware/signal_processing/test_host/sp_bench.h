@@ -0,0 +1,62 @@
+/**
+ * @file sp_bench.h
+ * @author Albano Peñalva (albano.penalva@uner.edu.ar)
+ * @brief Host benchmark harness for the signal processing middleware
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef SP_BENCH_H_
+#define SP_BENCH_H_
+
+/*==================[inclusions]=============================================*/
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+/*==================[macros]=================================================*/
+
+/*==================[typedef]================================================*/
+/**
+ * @brief Function under test, called once per benchmark iteration
+ */
+typedef void (*bench_func)(void * param);
+
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/**
+ * @brief Runs func until the minimum benchmark time elapses and prints a 
+ * result line (ns/sample and samples/s)
+ * 
+ * @param name          Name of the benchmarked function
+ * @param size          Size parameter of the case (signal lenght, taps, matrix size...)
+ * @param samples       Samples processed by each call of func
+ * @param func          Function under test
+ * @param param         Parameter passed to func
+ */
+void BenchRun(const char * name, int size, uint32_t samples, bench_func func, void * param);
+
+/**
+ * @brief Prints a section title
+ * 
+ * @param title         Section title
+ */
+void BenchSection(const char * title);
+
+/**
+ * @brief Benchmarks dspm::Mat operations (sp_bench_mat.cpp)
+ */
+void BenchMat(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SP_BENCH_H_ */
+
+/*==================[end of file]============================================*/
@@ -0,0 +1,276 @@
+/**
+ * @file sp_bench_mat.cpp
+ * @author Albano Peñalva (albano.penalva@uner.edu.ar)
+ * @brief Host benchmark of the dspm::Mat and dspm::MatN operations. A "sample"
+ * is an element of the resulting matrix (a step, for the EKF).
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+/*==================[inclusions]=============================================*/
+#include <stdlib.h>
+#include "sp_bench.h"
+#include "mat.h"
+#include "mat_n.h"
+#include "ekf_imu13states.h"
+#include "ekf_imu13states_fusion.h"
+/*==================[macros and definitions]=================================*/
+#define MAX_MAT_SIZE        32
+#define MAX_INVERSE_SIZE    8   /*!< Mat::inverse() uses cofactors, its cost grows factorially */
+#define MIN_SOLVE_SIZE      3
+#define MAX_SOLVE_SIZE      13  /*!< States of ekf_imu13states */
+
+typedef struct {
+    dspm::Mat * a;
+    dspm::Mat * b;
+    dspm::Mat * c;
+} mat_param_t;
+
+typedef struct {
+    dspm::Mat * a;      /*!< Symmetric positive definite */
+    dspm::Mat * b;      /*!< Right hand sides */
+    dspm::Mat * f;      /*!< Factorization */
+    dspm::Mat * x;      /*!< Solution */
+    dspm::Mat * tau;
+} solve_param_t;
+
+template <int N>
+struct mat_n_param_t {
+    dspm::MatN<N, N> a;
+    dspm::MatN<N, N> b;
+    dspm::MatN<N, N> c;
+};
+
+typedef struct {
+    ekf_imu13states * ekf;
+    float gyro[3];
+    float accel[3];
+    float magn[3];
+    float R[6];
+    int sample;     /*!< gyroscope sample, 1 kHz*/
+} ekf_param_t;
+
+typedef struct {
+    ekf_imu13states_fusion * fusion;
+    float gyro[3];
+    float accel[3];
+    float magn[3];
+    int sample;     /*!< gyroscope sample, 1 kHz*/
+} fusion_param_t;
+/*==================[internal functions definition]==========================*/
+static void MatAddCase(void * param){
+    mat_param_t * p = (mat_param_t *)param;
+    *p->c = *p->a + *p->b;
+}
+
+/* Runge-Kutta like element-wise chain, evaluated in one loop */
+static void MatChainCase(void * param){
+    mat_param_t * p = (mat_param_t *)param;
+    *p->c = *p->c + (*p->a + 2.0f * *p->b + *p->a) * 0.001f;
+}
+
+static void MatMulCase(void * param){
+    mat_param_t * p = (mat_param_t *)param;
+    *p->c = *p->a * *p->b;
+}
+
+static void MatMulcCase(void * param){
+    mat_param_t * p = (mat_param_t *)param;
+    *p->c = *p->a * 0.5f;
+}
+
+static void MatTransposeCase(void * param){
+    mat_param_t * p = (mat_param_t *)param;
+    *p->c = p->a->t();
+}
+
+static void MatInverseCase(void * param){
+    mat_param_t * p = (mat_param_t *)param;
+    *p->c = p->a->inverse();
+}
+
+static void SolveInverseCase(void * param){
+    solve_param_t * p = (solve_param_t *)param;
+    *p->x = p->a->inverse() * *p->b;
+}
+
+static void SolveCholeskyCase(void * param){
+    solve_param_t * p = (solve_param_t *)param;
+    *p->f = *p->a;
+    p->f->cholesky();
+    *p->x = p->f->choleskySolve(*p->b);
+}
+
+static void SolveLdltCase(void * param){
+    solve_param_t * p = (solve_param_t *)param;
+    *p->f = *p->a;
+    p->f->ldlt();
+    *p->x = p->f->ldltSolve(*p->b);
+}
+
+static void SolveQrCase(void * param){
+    solve_param_t * p = (solve_param_t *)param;
+    *p->f = *p->a;
+    p->f->qr(*p->tau);
+    *p->x = p->f->qrSolve(*p->tau, *p->b);
+}
+
+template <int N>
+static void MatNChainCase(void * param){
+    mat_n_param_t<N> * p = (mat_n_param_t<N> *)param;
+    p->c = p->c + (p->a + 2.0f * p->b + p->a) * 0.001f;
+}
+
+template <int N>
+static void MatNMulCase(void * param){
+    mat_n_param_t<N> * p = (mat_n_param_t<N> *)param;
+    dspm::mult(p->a, p->b, p->c);
+}
+
+template <int N>
+static void MatNMultTransSymCase(void * param){
+    mat_n_param_t<N> * p = (mat_n_param_t<N> *)param;
+    dspm::mult_t_sym(p->a, p->b, p->c);
+}
+
+/* Accelerometer / magnetometer correction of the 13 states EKF: 6 sequential scalar updates */
+static void EkfUpdateCase(void * param){
+    ekf_param_t * p = (ekf_param_t *)param;
+    p->ekf->UpdateRefMeasurement(p->accel, p->magn, p->R);
+}
+
+/* Gyroscope 1 kHz, accelerometer 200 Hz, magnetometer 100 Hz: Process(...) for every gyroscope sample */
+static void EkfMultiRateCase(void * param){
+    ekf_param_t * p = (ekf_param_t *)param;
+    p->ekf->Process(p->gyro, 0.001f);
+    if((p->sample % 5) == 0){
+        p->ekf->UpdateRefAccel(p->accel, p->R);
+    }
+    if((p->sample % 10) == 0){
+        p->ekf->UpdateRefMagn(p->magn, p->R);
+    }
+    p->sample++;
+}
+
+/* Same sensors with ekf_imu13states_fusion: one covariance prediction for 4 gyroscope samples */
+static void FusionCase(void * param){
+    fusion_param_t * p = (fusion_param_t *)param;
+    int64_t time = (int64_t)p->sample * 1000;
+    p->fusion->PushGyro(time, p->gyro);
+    if((p->sample % 5) == 0){
+        p->fusion->PushAccel(time, p->accel);
+    }
+    if((p->sample % 10) == 0){
+        p->fusion->PushMagn(time, p->magn);
+    }
+    p->fusion->Run();
+    p->sample++;
+}
+
+/* Prediction and accelerometer / magnetometer correction of the 13 states EKF */
+static void EkfStepCase(void * param){
+    ekf_param_t * p = (ekf_param_t *)param;
+    p->ekf->Process(p->gyro, 0.01f);
+    p->ekf->UpdateRefMeasurement(p->accel, p->magn, p->R);
+}
+
+template <int N>
+static void BenchMatN(void){
+    static mat_n_param_t<N> p;
+    for(int i = 0; i < N; i++){
+        for(int j = 0; j < N; j++){
+            p.a(i, j) = (float)rand() / RAND_MAX;
+            p.b(i, j) = (float)rand() / RAND_MAX;
+        }
+    }
+    BenchRun("MatN c + (a + 2b + a) * k", N, N * N, MatNChainCase<N>, &p);
+    BenchRun("MatN mult", N, N * N, MatNMulCase<N>, &p);
+    BenchRun("MatN mult_t_sym (a * b')", N, N * N, MatNMultTransSymCase<N>, &p);
+}
+
+/*==================[external functions definition]==========================*/
+void BenchMat(void){
+    BenchSection("dspm::Mat (size = rows = cols)");
+    for(int n = 4; n <= MAX_MAT_SIZE; n *= 2){
+        dspm::Mat a(n, n);
+        dspm::Mat b(n, n);
+        dspm::Mat c(n, n);
+        for(int i = 0; i < n; i++){
+            for(int j = 0; j < n; j++){
+                a(i, j) = (float)rand() / RAND_MAX;
+                b(i, j) = (float)rand() / RAND_MAX;
+            }
+            /* Diagonally dominant, so it can be inverted */
+            a(i, i) += n;
+        }
+        mat_param_t p = {&a, &b, &c};
+        BenchRun("Mat operator+", n, n * n, MatAddCase, &p);
+        BenchRun("Mat c + (a + 2b + a) * k", n, n * n, MatChainCase, &p);
+        BenchRun("Mat operator*", n, n * n, MatMulCase, &p);
+        BenchRun("Mat operator*(float)", n, n * n, MatMulcCase, &p);
+        BenchRun("Mat t()", n, n * n, MatTransposeCase, &p);
+        if(n <= MAX_INVERSE_SIZE){
+            BenchRun("Mat inverse()", n, n * n, MatInverseCase, &p);
+        }
+    }
+
+    BenchSection("dspm::Mat A \\ B, B with n columns (size = n)");
+    for(int n = MIN_SOLVE_SIZE; n <= MAX_SOLVE_SIZE; n++){
+        dspm::Mat m(n, n);
+        dspm::Mat b(n, n);
+        dspm::Mat f(n, n);
+        dspm::Mat x(n, n);
+        dspm::Mat tau(n, 1);
+        for(int i = 0; i < n; i++){
+            for(int j = 0; j < n; j++){
+                m(i, j) = (float)rand() / RAND_MAX;
+                b(i, j) = (float)rand() / RAND_MAX;
+            }
+        }
+        /* Like a covariance matrix */
+        dspm::Mat a = m * m.t() + n * dspm::Mat::eye(n);
+        solve_param_t p = {&a, &b, &f, &x, &tau};
+        if(n <= MAX_INVERSE_SIZE){
+            BenchRun("inverse() * B", n, n * n, SolveInverseCase, &p);
+        }
+        BenchRun("cholesky + solve", n, n * n, SolveCholeskyCase, &p);
+        BenchRun("ldlt + solve", n, n * n, SolveLdltCase, &p);
+        BenchRun("qr + solve", n, n * n, SolveQrCase, &p);
+    }
+
+    BenchSection("dspm::MatN (size = rows = cols)");
+    BenchMatN<4>();
+    BenchMatN<8>();
+    BenchMatN<13>();
+    BenchMatN<16>();
+
+    BenchSection("ekf_imu13states (size = states)");
+    ekf_param_t e = {
+        new ekf_imu13states(),
+        {0.1f, 0.2f, 0.3f},
+        {0.0f, 0.0f, 1.0f},
+        {1.0f, 0.0f, 0.0f},
+        {0.01f, 0.01f, 0.01f, 0.01f, 0.01f, 0.01f},
+        0,
+    };
+    e.ekf->Init();
+    BenchRun("ekf13 step", 13, 1, EkfStepCase, &e);
+    BenchRun("ekf13 update", 13, 1, EkfUpdateCase, &e);
+    BenchRun("ekf13 1 kHz gyro, Process", 13, 1, EkfMultiRateCase, &e);
+    delete e.ekf;
+
+    fusion_param_t f = {
+        new ekf_imu13states_fusion(),
+        {0.1f, 0.2f, 0.3f},
+        {0.0f, 0.0f, 1.0f},
+        {1.0f, 0.0f, 0.0f},
+        0,
+    };
+    BenchRun("ekf13 1 kHz gyro, fusion", 13, 1, FusionCase, &f);
+    delete f.fusion;
+}
+
+/*==================[end of file]============================================*/
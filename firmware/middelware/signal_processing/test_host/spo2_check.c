@@ -0,0 +1,192 @@
+/**
+ * @file spo2_check.c
+ * @author Albano Peñalva (albano.penalva@uner.edu.ar)
+ * @brief Host check of the SpO2 streaming engine (maxim_spo2_stream_*,
+ * drivers/devices/src/spo2_algorithm.c): heart rate and SpO2 of synthetic
+ * PPG signals against maxim_heart_rate_and_oxygen_saturation() over the same
+ * 4 s windows, at 25 and 100 Hz, and invalidation when the finger is removed.
+ * Returns non zero if a check fails.
+ *
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "spo2_algorithm.h"
+/*==================[macros and definitions]=================================*/
+#define RECORD_S            60          /*!< Lenght of each synthetic recording (s) */
+#define SETTLE_S            8           /*!< Windows ending before this time are not compared (s) */
+#define FINGER_OFF_S        40          /*!< Finger removed at this time in the no finger check (s) */
+#define IR_DC               120000      /*!< DC level of the IR and red signals (counts) */
+#define RED_DC              90000
+#define IR_AC               0.01f       /*!< AC / DC of the IR signal */
+#define NO_FINGER_LEVEL     400         /*!< Ambient light level without finger (counts) */
+#define NOISE               20          /*!< Peak noise of the samples (counts) */
+#define MAX_HR_DIFF         0.10f       /*!< Maximun relative difference with the batch algorithm in a window 
+                                             (an interval of one 25 Hz sample is 8 % at 120 bpm) */
+#define MAX_SPO2_DIFF       2           /*!< Maximun difference with the batch algorithm in a window (%) */
+#define MAX_MISMATCH        15.0f       /*!< Maximun percentage of windows out of the limits */
+#define MAX_MEAN_HR_DIFF    0.03f       /*!< Maximun relative difference of the mean heart rates (same 
+                                             samples, at 100 Hz MAX_HR_DIFF: the batch algorithm rounds
+                                             the intervals to 25 Hz samples) */
+#define MAX_MEAN_SPO2_DIFF  1.0f        /*!< Maximun difference of the mean SpO2 (%) */
+#define MAX_HR_ERROR        0.05f       /*!< Maximun relative error of the mean heart rate */
+
+typedef struct {
+    uint32_t ir;
+    uint32_t red;
+} ppg_sample_t;
+
+typedef struct {
+    float hr;                   /*!< Heart rate (bpm) */
+    float ratio;                /*!< (AC / DC of red) / (AC / DC of IR) */
+} ppg_case_t;
+/*==================[internal data declaration]==============================*/
+static ppg_sample_t record[RECORD_S * MAXIM_STREAM_MAX_FREQ];
+static uint32_t ir_window[BUFFER_SIZE];
+static uint32_t red_window[BUFFER_SIZE];
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+/* Ratios of 0.5 and 1.0: SpO2 of 99 % and 80 % in uch_spo2_table */
+static const ppg_case_t ppg_cases[] = {
+    {60, 0.5f}, {75, 0.5f}, {100, 1.0f}, {120, 0.7f}
+};
+static const int32_t freqs[] = {FreqS, MAXIM_STREAM_MAX_FREQ};
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/* Blood volume during a beat (phase 0..1): fast systolic rise, slow decay */
+static float Pulse(float phase){
+    return (phase < 0.2f) ? sinf(phase / 0.2f * M_PI / 2) : 0.5f * (1 + cosf((phase - 0.2f) / 0.8f * M_PI));
+}
+
+/* PPG of n seconds at freq Hz: the light received drops with the blood
+ * volume. After off_s seconds (if not zero) only ambient light is received */
+static uint32_t PpgRecord(const ppg_case_t * ppg, int32_t freq, uint32_t off_s){
+    uint32_t n = RECORD_S * freq;
+    float phase = 0;
+    srand(freq + (int)ppg->hr);
+    for(uint32_t i = 0; i < n; i++){
+        float p = Pulse(phase);
+        int noise_ir = rand() % (2 * NOISE + 1) - NOISE;
+        int noise_red = rand() % (2 * NOISE + 1) - NOISE;
+        if((off_s != 0) && (i >= off_s * freq)){
+            record[i].ir = NO_FINGER_LEVEL + noise_ir / 4;
+            record[i].red = NO_FINGER_LEVEL + noise_red / 4;
+        }else{
+            record[i].ir = IR_DC * (1 - IR_AC * p) + noise_ir;
+            record[i].red = RED_DC * (1 - ppg->ratio * IR_AC * p) + noise_red;
+        }
+        /* Slightly irregular rhythm */
+        phase += ppg->hr / 60 / freq * (1 + 0.03f * sinf(i * 0.9f / freq));
+        if(phase >= 1){
+            phase -= 1;
+        }
+    }
+    return n;
+}
+
+/* Batch algorithm over the last 4 s at 25 Hz (every decim samples) */
+static void Spo2Batch(uint32_t end, uint32_t decim, int32_t * spo2, int8_t * spo2_valid, int32_t * hr, int8_t * hr_valid){
+    for(uint32_t k = 0; k < BUFFER_SIZE; k++){
+        uint32_t i = end + 1 - (BUFFER_SIZE - k) * decim;
+        ir_window[k] = record[i].ir;
+        red_window[k] = record[i].red;
+    }
+    maxim_heart_rate_and_oxygen_saturation(ir_window, BUFFER_SIZE, red_window, spo2, spo2_valid, hr, hr_valid);
+}
+
+/* Stream fed sample by sample, compared with the batch algorithm at the end
+ * of each second (at 100 Hz the batch algorithm gets the 25 Hz samples) */
+static int CheckAgreement(const ppg_case_t * ppg, int32_t freq){
+    maxim_spo2_stream_t stream;
+    uint32_t n = PpgRecord(ppg, freq, 0);
+    uint32_t decim = freq / FreqS;
+    uint32_t windows = 0, mismatch = 0;
+    float hr_sum = 0, spo2_sum = 0, ref_hr_sum = 0, ref_spo2_sum = 0;
+    maxim_spo2_stream_init(&stream, freq);
+    for(uint32_t i = 0; i < n; i++){
+        maxim_spo2_stream_add_sample(&stream, record[i].ir, record[i].red);
+        if(((i + 1) % freq != 0) || (i + 1 < SETTLE_S * (uint32_t)freq)){
+            continue;
+        }
+        int32_t spo2, hr, ref_spo2, ref_hr;
+        int8_t spo2_valid, hr_valid, ref_spo2_valid, ref_hr_valid;
+        maxim_spo2_stream_get(&stream, &spo2, &spo2_valid, &hr, &hr_valid);
+        Spo2Batch(i, decim, &ref_spo2, &ref_spo2_valid, &ref_hr, &ref_hr_valid);
+        windows++;
+        hr_sum += hr;
+        spo2_sum += spo2;
+        ref_hr_sum += ref_hr;
+        ref_spo2_sum += ref_spo2;
+        if(!hr_valid || !spo2_valid || !ref_hr_valid || !ref_spo2_valid ||
+           (abs(hr - ref_hr) > MAX_HR_DIFF * ref_hr) || (abs(spo2 - ref_spo2) > MAX_SPO2_DIFF)){
+            mismatch++;
+        }
+    }
+    if(windows == 0){
+        return 1;
+    }
+    float hr_mean = hr_sum / windows, ref_hr_mean = ref_hr_sum / windows;
+    float spo2_mean = spo2_sum / windows, ref_spo2_mean = ref_spo2_sum / windows;
+    float max_mean_hr_diff = (freq == FreqS) ? MAX_MEAN_HR_DIFF : MAX_HR_DIFF;
+    int errors = (mismatch * 100.0f > MAX_MISMATCH * windows) ||
+                 (fabsf(hr_mean - ref_hr_mean) > max_mean_hr_diff * ref_hr_mean) ||
+                 (fabsf(spo2_mean - ref_spo2_mean) > MAX_MEAN_SPO2_DIFF) ||
+                 (fabsf(hr_mean - ppg->hr) > MAX_HR_ERROR * ppg->hr);
+    printf("%3d Hz, %3.0f bpm, ratio %.1f: %2u / %u windows differ, HR %5.1f bpm (%5.1f), SpO2 %4.1f %% (%4.1f): %s\n",
+           freq, ppg->hr, ppg->ratio, mismatch, windows, hr_mean, ref_hr_mean, spo2_mean, ref_spo2_mean,
+           errors ? "FAIL" : "ok");
+    return errors;
+}
+
+/* Valid readings before the finger is removed, none once the last beat has
+ * left the window */
+static int CheckNoFinger(int32_t freq){
+    maxim_spo2_stream_t stream;
+    uint32_t n = PpgRecord(&ppg_cases[1], freq, FINGER_OFF_S);
+    uint32_t off = FINGER_OFF_S * freq;
+    uint32_t invalid_at = off + STREAM_WINDOW_S * freq;
+    int8_t valid_before = 0;
+    int errors = 0;
+    maxim_spo2_stream_init(&stream, freq);
+    for(uint32_t i = 0; i < n; i++){
+        maxim_spo2_stream_add_sample(&stream, record[i].ir, record[i].red);
+        int32_t spo2, hr;
+        int8_t spo2_valid, hr_valid;
+        maxim_spo2_stream_get(&stream, &spo2, &spo2_valid, &hr, &hr_valid);
+        if(i + 1 == off){
+            valid_before = hr_valid && spo2_valid;
+        }else if((i >= invalid_at) && (hr_valid || spo2_valid || (hr != -999) || (spo2 != -999))){
+            errors++;
+        }
+    }
+    int32_t ref_spo2, ref_hr;
+    int8_t ref_spo2_valid, ref_hr_valid;
+    Spo2Batch(n - 1, freq / FreqS, &ref_spo2, &ref_spo2_valid, &ref_hr, &ref_hr_valid);
+    errors += !valid_before + ref_hr_valid + ref_spo2_valid;
+    printf("%3d Hz, finger removed: valid before %d, invalid after %d s %d (batch algorithm %d): %s\n",
+           freq, valid_before, STREAM_WINDOW_S, errors == 0, !ref_hr_valid && !ref_spo2_valid, errors ? "FAIL" : "ok");
+    return errors;
+}
+
+/*==================[external functions definition]==========================*/
+int main(void){
+    int errors = 0;
+    for(uint32_t f = 0; f < sizeof(freqs) / sizeof(freqs[0]); f++){
+        for(uint32_t i = 0; i < sizeof(ppg_cases) / sizeof(ppg_cases[0]); i++){
+            errors += CheckAgreement(&ppg_cases[i], freqs[f]);
+        }
+        errors += CheckNoFinger(freqs[f]);
+    }
+    return errors ? 1 : 0;
+}
+
+/*==================[end of file]============================================*/